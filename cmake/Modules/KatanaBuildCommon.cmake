@@ -49,6 +49,7 @@ set(CPACK_DEBIAN_PACKAGE_DEPENDS "" CACHE STRING "Semi-colon separated list of D
 
 ###### Developer features ######
 set(KATANA_PER_ROUND_STATS OFF CACHE BOOL "Report statistics of each round of execution")
+set(KATANA_ENABLE_STATS ON CACHE BOOL "Collect statistics and trace events of parallel loops")
 set(KATANA_NUM_TEST_GPUS "" CACHE STRING "Number of test GPUs to use (on a single machine) for running the tests.")
 set(KATANA_USE_LCI OFF CACHE BOOL "Use LCI network runtime instead of MPI")
 set(KATANA_NUM_TEST_THREADS "" CACHE STRING "Maximum number of threads to use when running tests (default: number of physical core)")
@@ -232,6 +233,10 @@ if (KATANA_ENABLE_PAPI)
   add_definitions(-DKATANA_ENABLE_PAPI)
 endif ()
 
+if (NOT KATANA_ENABLE_STATS)
+  add_definitions(-DKATANA_DISABLE_STATS)
+endif ()
+
 find_package(NUMA)
 
 find_package(Threads REQUIRED)
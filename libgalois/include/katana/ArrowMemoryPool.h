@@ -0,0 +1,74 @@
+#ifndef KATANA_LIBGALOIS_KATANA_ARROWMEMORYPOOL_H_
+#define KATANA_LIBGALOIS_KATANA_ARROWMEMORYPOOL_H_
+
+#include <atomic>
+#include <cstdint>
+#include <string>
+
+#include <arrow/memory_pool.h>
+
+#include "katana/NumaBuffer.h"
+#include "katana/config.h"
+
+namespace katana {
+
+/// An arrow::MemoryPool that serves large allocations from huge pages
+/// (see allocPages) and places them on NUMA nodes according to a
+/// NumaPlacement.
+///
+/// Allocations smaller than a huge page are passed to an underlying pool, by
+/// default arrow::default_memory_pool(), so that the many small buffers of
+/// builders and metadata do not each take a huge page. Statistics of both
+/// kinds of allocation are reported to the StatManager by ReportStats.
+///
+/// When pages cannot be mapped, Allocate and Reallocate return OutOfMemory
+/// and leave the pointer passed to them unchanged.
+class KATANA_EXPORT ArrowMemoryPool : public arrow::MemoryPool {
+public:
+  /// The pool katana::SharedMemSys installs as DefaultArrowMemoryPool. It
+  /// interleaves pages over the active threads and lives until the process
+  /// exits, so buffers may outlive the SharedMemSys.
+  static ArrowMemoryPool* Default();
+
+  explicit ArrowMemoryPool(
+      std::string name, NumaPlacement placement = NumaPlacement::kInterleaved,
+      arrow::MemoryPool* small_pool = arrow::default_memory_pool());
+
+  arrow::Status Allocate(int64_t size, uint8_t** out) override;
+  arrow::Status Reallocate(
+      int64_t old_size, int64_t new_size, uint8_t** ptr) override;
+  void Free(uint8_t* buffer, int64_t size) override;
+
+  int64_t bytes_allocated() const override;
+  int64_t max_memory() const override;
+  std::string backend_name() const override;
+
+  /// Report the number of allocations, the number and size of huge page
+  /// allocations and the peak number of bytes allocated under the region
+  /// name of this pool
+  void ReportStats() const;
+
+  const std::string& name() const { return name_; }
+  NumaPlacement placement() const { return placement_; }
+
+private:
+  bool IsHuge(int64_t size) const;
+  //! nullptr if the pages cannot be mapped
+  uint8_t* AllocateHuge(int64_t size);
+  void FreeHuge(uint8_t* buffer, int64_t size);
+  void Allocated(int64_t size);
+
+  std::string name_;
+  NumaPlacement placement_;
+  arrow::MemoryPool* small_pool_;
+
+  std::atomic<int64_t> bytes_allocated_{0};
+  std::atomic<int64_t> max_memory_{0};
+  std::atomic<int64_t> num_allocations_{0};
+  std::atomic<int64_t> num_huge_allocations_{0};
+  std::atomic<int64_t> huge_bytes_mapped_{0};
+};
+
+}  // namespace katana
+
+#endif
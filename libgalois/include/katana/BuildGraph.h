@@ -26,7 +26,7 @@ using NullMaps = std::pair<
     std::unordered_map<int, std::shared_ptr<arrow::Array>>,
     std::unordered_map<int, std::shared_ptr<arrow::Array>>>;
 
-enum SourceType { kGraphml, kKatana };
+enum SourceType { kGraphml, kKatana, kCsv, kJsonl };
 enum SourceDatabase { kNone, kNeo4j, kMongodb, kMysql };
 enum ImportDataType {
   kString,
@@ -149,6 +149,8 @@ struct GraphComponents {
   GraphComponent nodes;
   GraphComponent edges;
   std::shared_ptr<katana::GraphTopology> topology;
+  /// The IDs nodes had in the input (local_to_user_id), if known
+  std::shared_ptr<arrow::ChunkedArray> user_ids;
 
   GraphComponents(
       GraphComponent nodes_, GraphComponent edges_,
@@ -217,6 +219,14 @@ public:
 
   GraphComponents Finish(bool verbose = true);
 
+  /// Build one graph out of builders that each imported a consecutive part
+  /// of the same input, in input order. Nodes keep the order of the builders;
+  /// edges may refer to nodes added by any builder and IDs that no builder
+  /// added become empty nodes, as in Finish. Columns are matched by name. The
+  /// builders are consumed.
+  static GraphComponents Merge(
+      std::vector<PropertyGraphBuilder>* builders, bool verbose = true);
+
   size_t GetNodeIndex();
   size_t GetNodes();
   size_t GetEdges();
@@ -23,13 +23,13 @@
 #include "katana/FixedSizeRing.h"
 #include "katana/Mem.h"
 #include "katana/PaddedLock.h"
+#include "katana/Threads.h"
 #include "katana/WLCompileCheck.h"
 #include "katana/WorkListHelpers.h"
 #include "katana/config.h"
 
 namespace katana {
 
-extern unsigned activeThreads;
 
 namespace internal {
 // This overly complex specialization avoids a pointer indirection for
@@ -40,7 +40,7 @@ struct squeue {
   TQ& get(int i) { return *queues.getRemote(i); }
   TQ& get() { return *queues.getLocal(); }
   int myEffectiveID() { return ThreadPool::getTID(); }
-  int size() { return activeThreads; }
+  int size() { return getActiveThreads(); }
 };
 
 template <template <typename> class PS, typename TQ>
@@ -69,6 +69,8 @@ struct ChunkMaster {
   using rethread =
       ChunkMaster<T, QT, Distributed, IsStack, ChunkSize, _Concurrent>;
 
+  static constexpr int chunk_size = ChunkSize;
+
 private:
   class Chunk : public FixedSizeRing<T, ChunkSize>,
                 public QT<Chunk, Concurrent>::ListNode {};
@@ -110,16 +112,17 @@ private:
   Chunk* popChunk() {
     int id = Q.myEffectiveID();
     Chunk* r = popChunkByID(id);
-    if (r)
+    if (r || !Distributed)
       return r;
 
-    for (int i = id + 1; i < (int)Q.size(); ++i) {
-      r = popChunkByID(i);
-      if (r)
-        return r;
-    }
-
-    for (int i = 0; i < id; ++i) {
+    // Queues are per socket, so only visit the leader of each other socket,
+    // nearest socket first
+    auto& tp = GetThreadPool();
+    unsigned mySocket = ThreadPool::getSocket();
+    for (unsigned i : tp.getStealOrder(id)) {
+      if (i >= (unsigned)Q.size() || !tp.isLeader(i) ||
+          tp.getSocket(i) == mySocket)
+        continue;
       r = popChunkByID(i);
       if (r)
         return r;
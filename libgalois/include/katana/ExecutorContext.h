@@ -0,0 +1,102 @@
+#ifndef KATANA_LIBGALOIS_KATANA_EXECUTORCONTEXT_H_
+#define KATANA_LIBGALOIS_KATANA_EXECUTORCONTEXT_H_
+
+#include <functional>
+#include <future>
+#include <memory>
+#include <type_traits>
+#include <utility>
+
+#include "katana/Result.h"
+#include "katana/config.h"
+
+namespace katana {
+
+class Barrier;
+class ExecutorContext;
+class TerminationDetection;
+
+namespace internal {
+
+/// Hooks that make the runtime use the state of the ExecutorContext of the
+/// calling thread. Each returns false or null if the calling thread does not
+/// run in an ExecutorContext.
+bool ContextSetActiveThreads(unsigned num);
+bool ContextGetActiveThreads(unsigned* num);
+Barrier* ContextBarrier(unsigned active_threads);
+TerminationDetection* ContextTerminationDetection();
+
+}  // namespace internal
+
+/// An ExecutorContext runs parallel loops on its own threads, isolated from
+/// the loops of other contexts and of the system thread pool.
+///
+/// A context takes num_threads threads, and so their cores, out of the
+/// system thread pool. Functions passed to Run or Submit execute on the
+/// master thread of the context, and the do_all, for_each and on_each loops
+/// they start run only on the threads of the context, with its own barrier,
+/// termination detection and number of active threads (setActiveThreads
+/// called by such a function changes only the context). Thread ids are local
+/// to the context, and as the threads of different contexts are disjoint, so
+/// are their PerThreadStorage slots.
+///
+/// Functions submitted to one context run one at a time in submission order;
+/// functions submitted to different contexts run concurrently. Contexts must
+/// be created and destroyed while no loop runs on the system thread pool and
+/// within the lifetime of the SharedMemSys.
+class KATANA_EXPORT ExecutorContext {
+public:
+  /// Create a context with num_threads threads. Thread 0 of the system pool
+  /// is never given to a context, so this fails if fewer than num_threads
+  /// other threads are free. If the active threads of the system pool exceed
+  /// the threads it has left, they are reduced to fit.
+  static Result<std::unique_ptr<ExecutorContext>> Make(unsigned num_threads);
+
+  ~ExecutorContext();
+
+  ExecutorContext(const ExecutorContext&) = delete;
+  ExecutorContext& operator=(const ExecutorContext&) = delete;
+  ExecutorContext(ExecutorContext&&) = delete;
+  ExecutorContext& operator=(ExecutorContext&&) = delete;
+
+  /// Queue fn to run on this context. The future holds its result or the
+  /// exception it threw.
+  template <typename F>
+  std::future<std::invoke_result_t<F>> Submit(F&& fn) {
+    using R = std::invoke_result_t<F>;
+    auto task = std::make_shared<std::packaged_task<R()>>(std::forward<F>(fn));
+    std::future<R> result = task->get_future();
+    Enqueue([task]() { (*task)(); });
+    return result;
+  }
+
+  /// Run fn on this context and wait for its result
+  template <typename F>
+  std::invoke_result_t<F> Run(F&& fn) {
+    return Submit(std::forward<F>(fn)).get();
+  }
+
+  unsigned num_threads() const;
+
+  /// The context the calling thread runs in, or null
+  static ExecutorContext* Current();
+
+private:
+  struct Impl;
+
+  explicit ExecutorContext(std::unique_ptr<Impl> impl);
+
+  void Enqueue(std::function<void()> job);
+  void MasterLoop();
+
+  friend bool internal::ContextSetActiveThreads(unsigned num);
+  friend bool internal::ContextGetActiveThreads(unsigned* num);
+  friend Barrier* internal::ContextBarrier(unsigned active_threads);
+  friend TerminationDetection* internal::ContextTerminationDetection();
+
+  std::unique_ptr<Impl> impl_;
+};
+
+}  // namespace katana
+
+#endif
@@ -559,8 +559,8 @@ class DAGManagerBase<OptionsTy, true> {
 
 public:
   DAGManagerBase()
-      : term(GetTerminationDetection(activeThreads)),
-        barrier(GetBarrier(activeThreads)) {}
+      : term(GetTerminationDetection(getActiveThreads())),
+        barrier(GetBarrier(getActiveThreads())) {}
 
   void destroyDAGManager() { data.getLocal()->heap.clear(); }
 
@@ -755,7 +755,7 @@ class BreakManagerBase<OptionsTy, true> {
 public:
   BreakManagerBase(const OptionsTy& o)
       : breakFn(get_trait_value<det_parallel_break_tag>(o.args).value),
-        barrier(GetBarrier(activeThreads)) {}
+        barrier(GetBarrier(getActiveThreads())) {}
 
   bool checkBreak() {
     if (ThreadPool::getTID() == 0)
@@ -785,7 +785,7 @@ class IntentToReadManagerBase<OptionsTy, true> {
   Barrier& barrier;
 
 public:
-  IntentToReadManagerBase() : barrier(GetBarrier(activeThreads)) {}
+  IntentToReadManagerBase() : barrier(GetBarrier(getActiveThreads())) {}
 
   void pushIntentToReadTask(Context* ctx) {
     pending.getLocal()->push_back(ctx);
@@ -1262,7 +1262,7 @@ public:
         alloc(&heap),
         mergeBuf(alloc),
         distributeBuf(alloc),
-        barrier(GetBarrier(activeThreads)) {
+        barrier(GetBarrier(getActiveThreads())) {
     numActive = getActiveThreads();
   }
 
@@ -1393,7 +1393,7 @@ public:
       : BreakManager<OptionsTy>(o),
         NewWorkManager<OptionsTy>(o),
         options(o),
-        barrier(GetBarrier(activeThreads)),
+        barrier(GetBarrier(getActiveThreads())),
         loopname(katana::internal::getLoopName(o.args)) {
     static_assert(
         !OptionsTy::needsBreak || OptionsTy::hasBreak,
@@ -25,10 +25,13 @@
 #include "katana/Executor_OnEach.h"
 #include "katana/OperatorReferenceTypes.h"
 #include "katana/PaddedLock.h"
+#include "katana/PerfCounters.h"
 #include "katana/PerThreadStorage.h"
 #include "katana/Statistics.h"
 #include "katana/TerminationDetection.h"
+#include "katana/ThreadArena.h"
 #include "katana/ThreadPool.h"
+#include "katana/Threads.h"
 #include "katana/Timer.h"
 #include "katana/config.h"
 #include "katana/gIO.h"
@@ -48,6 +51,10 @@ class DoAllStealingExec {
       katana::internal::NeedStats<ArgsTuple>::value;
   constexpr static const bool MORE_STATS =
       NEED_STATS && has_trait<more_stats_tag, ArgsTuple>();
+  constexpr static const bool PERF_COUNTERS =
+      NEED_STATS && has_trait<perf_counters_tag, ArgsTuple>();
+  constexpr static const bool THREAD_ARENA =
+      has_trait<thread_arena_tag, ArgsTuple>();
   constexpr static const bool USE_TERM = false;
 
   struct ThreadContext {
@@ -80,7 +87,9 @@ class DoAllStealingExec {
           m_size(std::distance(beg, end)),
           num_iter(0) {}
 
-    bool doWork(F func, const unsigned chunk_size) {
+    bool doWork(
+        F func, const unsigned chunk_size,
+        IterationArena<THREAD_ARENA>& arena) {
       Iter beg(shared_beg);
       Iter end(shared_end);
 
@@ -94,6 +103,7 @@ class DoAllStealingExec {
             ++num_iter;
           }
           func(*beg);
+          arena.reset();
         }
       }
 
@@ -259,97 +269,39 @@ private:
     return succ;
   }
 
-  KATANA_ATTRIBUTE_NOINLINE bool stealWithinSocket(ThreadContext& poor) {
+  KATANA_ATTRIBUTE_NOINLINE bool trySteal(ThreadContext& poor) {
     bool sawWork = false;
-    bool stoleWork = false;
 
     auto& tp = GetThreadPool();
-
     const unsigned maxT = katana::getActiveThreads();
-    const unsigned my_pack = ThreadPool::getSocket();
-    const unsigned per_pack = tp.getMaxThreads() / tp.getMaxSockets();
-
-    const unsigned pack_beg = my_pack * per_pack;
-    const unsigned pack_end = (my_pack + 1) * per_pack;
-
-    for (unsigned i = 1; i < pack_end; ++i) {
-      // go around the socket in circle starting from the next thread
-      unsigned t = (poor.id + i) % per_pack + pack_beg;
-      KATANA_LOG_DEBUG_ASSERT((t >= pack_beg) && (t < pack_end));
-
-      if (t < maxT) {
-        if (workers.getRemote(t)->hasWorkWeak()) {
-          sawWork = true;
+    auto level = ThreadPool::Locality::kCore;
 
-          stoleWork = transferWork(*workers.getRemote(t), poor, HALF);
-
-          if (stoleWork) {
-            break;
-          }
-        }
+    // Visit victims nearest first: SMT siblings, then threads sharing the
+    // last level cache, then the NUMA node, the socket and finally remote
+    // threads. Work seen at one level is retried before moving further out.
+    for (unsigned t : tp.getStealOrder(poor.id)) {
+      if (t >= maxT) {
+        continue;
       }
-    }
-
-    return sawWork || stoleWork;
-  }
-
-  KATANA_ATTRIBUTE_NOINLINE bool stealOutsideSocket(
-      ThreadContext& poor, const StealAmt& amt) {
-    bool sawWork = false;
-    bool stoleWork = false;
-
-    auto& tp = GetThreadPool();
-    unsigned myPkg = ThreadPool::getSocket();
-    // unsigned maxT = LL::getMaxThreads ();
-    unsigned maxT = katana::getActiveThreads();
-
-    for (unsigned i = 0; i < maxT; ++i) {
-      ThreadContext& rich = *(workers.getRemote((poor.id + i) % maxT));
-
-      if (tp.getSocket(rich.id) != myPkg) {
-        if (rich.hasWorkWeak()) {
-          sawWork = true;
-
-          stoleWork = transferWork(rich, poor, amt);
-          // stoleWork = transferWork (rich, poor, HALF);
-
-          if (stoleWork) {
-            break;
-          }
+      auto locality = tp.getLocality(poor.id, t);
+      if (locality != level) {
+        if (sawWork) {
+          return true;
         }
+        asmPause();
+        level = locality;
       }
-    }
-
-    return sawWork || stoleWork;
-  }
-
-  KATANA_ATTRIBUTE_NOINLINE bool trySteal(ThreadContext& poor) {
-    bool ret = false;
 
-    ret = stealWithinSocket(poor);
-
-    if (ret) {
-      return true;
-    }
-
-    asmPause();
-
-    if (GetThreadPool().isLeader(poor.id)) {
-      ret = stealOutsideSocket(poor, HALF);
-
-      if (ret) {
-        return true;
+      ThreadContext& rich = *workers.getRemote(t);
+      if (rich.hasWorkWeak()) {
+        sawWork = true;
+        if (transferWork(rich, poor, HALF)) {
+          return true;
+        }
       }
-      asmPause();
-    }
-
-    ret = stealOutsideSocket(poor, HALF);
-    if (ret) {
-      return true;
     }
-    asmPause();
 
-    return ret;
+    return sawWork;
   }
 
 private:
@@ -374,7 +326,7 @@ public:
         func(_func),
         loopname(katana::internal::getLoopName(argsTuple)),
         chunk_size(get_trait_value<chunk_size_tag>(argsTuple).value),
-        term(GetTerminationDetection(activeThreads)),
+        term(GetTerminationDetection(getActiveThreads())),
         totalTime(loopname, "Total"),
         initTime(loopname, "Init"),
         execTime(loopname, "Execute"),
@@ -411,6 +363,13 @@ public:
 
   void operator()(void) {
     ThreadContext& ctx = *workers.getLocal();
+    TraceSpan<NEED_STATS> execSpan(loopname, "Execute");
+    // one span for all steal attempts; tracing each would dwarf them
+    TraceTotal<NEED_STATS> stealSpan(loopname, "Steal");
+    CondPerfCounters<PERF_COUNTERS> counters(loopname);
+    IterationArena<THREAD_ARENA> arena;
+    execSpan.start();
+    counters.start();
     totalTime.start();
 
     while (true) {
@@ -418,7 +377,7 @@ public:
 
       execTime.start();
 
-      if (ctx.doWork(func, chunk_size)) {
+      if (ctx.doWork(func, chunk_size, arena)) {
         workHappened = true;
       }
 
@@ -426,9 +385,11 @@ public:
 
       KATANA_LOG_DEBUG_ASSERT(!ctx.hasWork());
 
+      stealSpan.start();
       stealTime.start();
       bool stole = trySteal(ctx);
       stealTime.stop();
+      stealSpan.stop();
 
       if (stole) {
         continue;
@@ -452,10 +413,14 @@ public:
     }
 
     totalTime.stop();
+    counters.stop();
+    stealSpan.report();
+    execSpan.stop();
     KATANA_LOG_DEBUG_ASSERT(!ctx.hasWork());
 
     if (NEED_STATS) {
       katana::ReportStatSum(loopname, "Iterations", ctx.num_iter);
+      arena.report(loopname);
     }
   }
 };
@@ -468,11 +433,19 @@ struct ChooseDoAllImpl {
         R, OperatorReferenceType<decltype(std::forward<F>(func))>, ArgsT>
         exec(range, std::forward<F>(func), argsTuple);
 
-    Barrier& barrier = GetBarrier(activeThreads);
+    Barrier& barrier = GetBarrier(getActiveThreads());
+    const char* const loopname = katana::internal::getLoopName(argsTuple);
 
     GetThreadPool().run(
-        activeThreads, [&exec]() { exec.initThread(); },
-        [&barrier]() { barrier.Wait(); }, std::ref(exec));
+        getActiveThreads(), [&exec]() { exec.initThread(); },
+        [&barrier, loopname]() {
+          TraceSpan<katana::internal::NeedStats<ArgsT>::value> span(
+              loopname, "Barrier");
+          span.start();
+          barrier.Wait();
+          span.stop();
+        },
+        std::ref(exec));
   }
 };
 
@@ -486,13 +459,22 @@ struct ChooseDoAllImpl<false> {
               katana::internal::NeedStats<ArgsT>::value;
           static constexpr bool MORE_STATS =
               NEED_STATS && has_trait<more_stats_tag, ArgsT>();
+          static constexpr bool PERF_COUNTERS =
+              NEED_STATS && has_trait<perf_counters_tag, ArgsT>();
+          static constexpr bool THREAD_ARENA =
+              has_trait<thread_arena_tag, ArgsT>();
 
           const char* const loopname = katana::internal::getLoopName(argsTuple);
 
           PerThreadTimer<MORE_STATS> totalTime(loopname, "Total");
           PerThreadTimer<MORE_STATS> initTime(loopname, "Init");
           PerThreadTimer<MORE_STATS> execTime(loopname, "Work");
+          TraceSpan<NEED_STATS> execSpan(loopname, "Execute");
+          CondPerfCounters<PERF_COUNTERS> counters(loopname);
+          IterationArena<THREAD_ARENA> arena;
 
+          execSpan.start();
+          counters.start();
           totalTime.start();
           initTime.start();
 
@@ -507,6 +489,7 @@ struct ChooseDoAllImpl<false> {
 
           while (begin != end) {
             func(*begin++);
+            arena.reset();
             if (NEED_STATS) {
               ++iter;
             }
@@ -514,9 +497,12 @@ struct ChooseDoAllImpl<false> {
           execTime.stop();
 
           totalTime.stop();
+          counters.stop();
+          execSpan.stop();
 
           if (NEED_STATS) {
             katana::ReportStatSum(loopname, "Iterations", iter);
+            arena.report(loopname);
           }
         },
         std::make_tuple());
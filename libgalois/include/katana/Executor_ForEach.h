@@ -31,9 +31,11 @@
 #include "katana/LoopStatistics.h"
 #include "katana/Mem.h"
 #include "katana/OperatorReferenceTypes.h"
+#include "katana/PerfCounters.h"
 #include "katana/Range.h"
 #include "katana/Simple.h"
 #include "katana/TerminationDetection.h"
+#include "katana/ThreadArena.h"
 #include "katana/ThreadPool.h"
 #include "katana/ThreadTimer.h"
 #include "katana/Threads.h"
@@ -139,6 +141,19 @@ public:
   AbortedList* getQueue() { return queues.getLocal(); }
 };
 
+template <typename WLTy>
+constexpr auto
+has_report_stats(int)
+    -> decltype(std::declval<WLTy&>().reportStats(""), bool()) {
+  return true;
+}
+
+template <typename>
+constexpr auto
+has_report_stats(...) -> bool {
+  return false;
+}
+
 // TODO(ddn): Implement wrapper to allow calling without UserContext
 // TODO(ddn): Check for operators that implement both with and without context
 template <class WorkListTy, class FunctionTy, typename ArgsTy>
@@ -149,9 +164,12 @@ public:
   static constexpr bool needsAborts =
       !has_trait<disable_conflict_detection_tag, ArgsTy>();
   static constexpr bool needsPia = has_trait<per_iter_alloc_tag, ArgsTy>();
+  static constexpr bool needsArena = has_trait<thread_arena_tag, ArgsTy>();
   static constexpr bool needsBreak = has_trait<parallel_break_tag, ArgsTy>();
   static constexpr bool MORE_STATS =
       needStats && has_trait<more_stats_tag, ArgsTy>();
+  static constexpr bool PERF_COUNTERS =
+      needStats && has_trait<perf_counters_tag, ArgsTy>();
 
 protected:
   typedef typename WorkListTy::value_type value_type;
@@ -160,6 +178,7 @@ protected:
     UserContextAccess<value_type> facing;
     FunctionTy function;
     SimpleRuntimeContext ctx;
+    IterationArena<needsArena> arena;
 
     explicit ThreadLocalBasics(FunctionTy fn) : facing(), function(fn), ctx() {}
   };
@@ -208,6 +227,8 @@ protected:
     }
     if (needsPia)
       tld.facing.resetAlloc();
+    if (needsArena)
+      tld.arena.reset();
     if (needsAborts)
       tld.ctx.commitIteration();
     //++tld.stat_commits;
@@ -226,6 +247,8 @@ protected:
     // reset allocator
     if (needsPia)
       tld.facing.resetAlloc();
+    if (needsArena)
+      tld.arena.reset();
   }
 
   inline void doProcess(value_type& val, ThreadLocalData& tld) {
@@ -299,7 +322,12 @@ protected:
 
   template <bool couldAbort, bool isLeader>
   void go() {
+    TraceSpan<needStats> execSpan(loopname, "Execute");
+    TraceSpan<needStats> barrierSpan(loopname, "Barrier");
+    CondPerfCounters<PERF_COUNTERS> counters(loopname);
     execTime.start();
+    execSpan.start();
+    counters.start();
 
     // Thread-local data goes on the local stack to be NUMA friendly
     ThreadLocalData tld(origFunction, loopname);
@@ -337,18 +365,27 @@ protected:
 
       if (checkEmpty(wl, tld, 0)) {
         execTime.stop();
+        execSpan.stop();
         break;
       }
 
       if (needsBreak && broke) {
         execTime.stop();
+        execSpan.stop();
         break;
       }
 
+      execSpan.stop();
       term.InitializeThread();
+      barrierSpan.start();
       barrier.Wait();
+      barrierSpan.stop();
+      execSpan.start();
     }
 
+    counters.stop();
+    if (needStats)
+      tld.arena.report(loopname);
     if (couldAbort)
       setThreadContext(0);
   }
@@ -358,8 +395,8 @@ protected:
 
   template <typename... WArgsTy>
   ForEachExecutor(T2, FunctionTy f, const ArgsTy& args, WArgsTy... wargs)
-      : term(GetTerminationDetection(activeThreads)),
-        barrier(GetBarrier(activeThreads)),
+      : term(GetTerminationDetection(getActiveThreads())),
+        barrier(GetBarrier(getActiveThreads())),
         wl(std::forward<WArgsTy>(wargs)...),
         origFunction(f),
         loopname(katana::internal::getLoopName(args)),
@@ -386,22 +423,32 @@ public:
             std::make_index_sequence<std::tuple_size<decltype(
                 get_trait_value<wl_tag>(args).args)>::value>{}) {}
 
+  ~ForEachExecutor() {
+    // worklists that tune themselves report how
+    if constexpr (needStats && has_report_stats<WorkListTy>(0)) {
+      wl.reportStats(loopname);
+    }
+  }
+
   template <typename RangeTy>
   void init(const RangeTy&) {}
 
   template <typename RangeTy>
   void initThread(const RangeTy& range) {
+    TraceSpan<needStats> initSpan(loopname, "Init");
+    initSpan.start();
     initTime.start();
 
     wl.push_initial(range);
     term.InitializeThread();
 
     initTime.stop();
+    initSpan.stop();
   }
 
   void operator()() {
     bool isLeader = ThreadPool::isLeader();
-    bool couldAbort = needsAborts && activeThreads > 1;
+    bool couldAbort = needsAborts && getActiveThreads() > 1;
     if (couldAbort && isLeader)
       go<true, true>();
     else if (couldAbort && !isLeader)
@@ -451,13 +498,20 @@ for_each_impl(const RangeTy& range, FunctionTy&& fn, const ArgsTy& args) {
       OperatorReferenceType<decltype(std::forward<FunctionTy>(fn))>;
   typedef ForEachExecutor<WorkListTy, FuncRefType, ArgsTy> WorkTy;
 
-  auto& barrier = GetBarrier(activeThreads);
+  auto& barrier = GetBarrier(getActiveThreads());
+  const char* const loopname = katana::internal::getLoopName(args);
   FuncRefType fn_ref = fn;
   WorkTy W(fn_ref, args);
   W.init(range);
   GetThreadPool().run(
-      activeThreads, [&W, &range]() { W.initThread(range); },
-      [&barrier] { barrier.Wait(); }, std::ref(W));
+      getActiveThreads(), [&W, &range]() { W.initThread(range); },
+      [&barrier, loopname] {
+        TraceSpan<WorkTy::needStats> span(loopname, "Barrier");
+        span.start();
+        barrier.Wait();
+        span.stop();
+      },
+      std::ref(W));
 }
 
 // TODO: Need to decide whether user should provide num_run tag or
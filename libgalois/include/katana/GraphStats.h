@@ -0,0 +1,95 @@
+#ifndef KATANA_LIBGALOIS_KATANA_GRAPHSTATS_H_
+#define KATANA_LIBGALOIS_KATANA_GRAPHSTATS_H_
+
+#include <cstdint>
+#include <map>
+#include <optional>
+#include <string>
+#include <vector>
+
+#include <nlohmann/json.hpp>
+
+#include "katana/PropertyGraph.h"
+#include "katana/Result.h"
+#include "katana/config.h"
+
+namespace katana {
+
+/// Summary of the degrees of the nodes of a graph
+struct KATANA_EXPORT DegreeDistribution {
+  uint64_t min{0};
+  uint64_t max{0};
+  double mean{0};
+  /// Number of nodes without edges
+  uint64_t num_zero{0};
+  /// Median degree of the nodes with at least one edge. Exact when it is
+  /// below 1024, otherwise interpolated from log2_histogram.
+  uint64_t nonzero_median{0};
+  /// Element 0 counts the nodes of degree 0 and element i > 0 counts the
+  /// nodes with degree in [2^(i-1), 2^i)
+  std::vector<uint64_t> log2_histogram;
+};
+
+/// Summary of a property column
+struct KATANA_EXPORT ColumnSummary {
+  std::string type;
+  uint64_t null_count{0};
+  /// Smallest and largest value of numeric columns
+  std::optional<double> min;
+  std::optional<double> max;
+};
+
+/// Summary statistics of a PropertyGraph
+struct KATANA_EXPORT GraphStats {
+  uint64_t num_nodes{0};
+  uint64_t num_edges{0};
+  DegreeDistribution out_degree;
+  DegreeDistribution in_degree;
+  /// Number of edges from a node to itself
+  uint64_t num_self_loops{0};
+  /// Number of edges with the same source and destination as another edge
+  /// of the same source, not counting one edge of each such group
+  uint64_t num_duplicate_edges{0};
+  /// Number of nodes whose edges are not sorted by destination
+  uint64_t num_unsorted_nodes{0};
+  /// Number of weakly connected components
+  uint64_t num_components{0};
+  /// Lower bound on the diameter of the directed graph: the larger
+  /// eccentricity found by a double sweep of breadth-first searches from the
+  /// node of largest out-degree
+  uint64_t approximate_diameter{0};
+  std::map<std::string, ColumnSummary> node_columns;
+  std::map<std::string, ColumnSummary> edge_columns;
+
+  bool edges_sorted() const { return num_unsorted_nodes == 0; }
+};
+
+KATANA_EXPORT void to_json(nlohmann::json& j, const DegreeDistribution& dist);
+KATANA_EXPORT void from_json(const nlohmann::json& j, DegreeDistribution& dist);
+KATANA_EXPORT void to_json(nlohmann::json& j, const ColumnSummary& summary);
+KATANA_EXPORT void from_json(const nlohmann::json& j, ColumnSummary& summary);
+KATANA_EXPORT void to_json(nlohmann::json& j, const GraphStats& stats);
+KATANA_EXPORT void from_json(const nlohmann::json& j, GraphStats& stats);
+
+/// Compute the statistics of pg.
+///
+/// Degrees, self loops, duplicate edges, sortedness and components are
+/// collected in a single parallel pass over the edges; the diameter bound
+/// takes two more breadth-first searches. Columns are summarized with Arrow
+/// compute kernels.
+KATANA_EXPORT Result<GraphStats> ComputeGraphStats(const PropertyGraph& pg);
+
+/// \returns the statistics cached in pg, if they are present and describe
+/// its current topology
+KATANA_EXPORT std::optional<GraphStats> CachedGraphStats(
+    const PropertyGraph& pg);
+
+/// Return the statistics of pg, computing whatever is not cached in pg and
+/// caching the result. The cache is stored with the RDG the next time pg is
+/// written, so later loads reuse it. Summaries of properties added since the
+/// statistics were cached are computed without recomputing the rest.
+KATANA_EXPORT Result<GraphStats> GetGraphStats(PropertyGraph* pg);
+
+}  // namespace katana
+
+#endif
@@ -35,6 +35,9 @@ struct KATANA_EXPORT ThreadTopoInfo {
   unsigned cumulativeMaxSocket;  // max socket id seen from [0, tid]
   unsigned osContext;            // OS ID to use for thread binding
   unsigned osNumaNode;           // OS ID for numa node
+  unsigned core;                 // physical core. same for SMT siblings
+  unsigned cacheDomain;          // last level cache (e.g., L3 complex)
+  unsigned cacheLeader;          // first thread id in tid's cacheDomain
 };
 
 struct KATANA_EXPORT MachineTopoInfo {
@@ -42,6 +45,7 @@ struct KATANA_EXPORT MachineTopoInfo {
   unsigned maxCores;
   unsigned maxSockets;
   unsigned maxNumaNodes;
+  unsigned maxCacheDomains;
 };
 
 struct KATANA_EXPORT HWTopoInfo {
@@ -51,7 +55,9 @@ struct KATANA_EXPORT HWTopoInfo {
 
 /**
  * getHWTopo determines the machine topology from the process information
- * exposed in /proc and /dev filesystems.
+ * exposed in /proc and /sys filesystems. Threads are numbered so that SMT
+ * siblings come last and threads sharing a socket and then a last level
+ * cache get consecutive ids.
  */
 KATANA_EXPORT HWTopoInfo getHWTopo();
 
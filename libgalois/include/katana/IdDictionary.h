@@ -0,0 +1,233 @@
+#ifndef KATANA_LIBGALOIS_KATANA_IDDICTIONARY_H_
+#define KATANA_LIBGALOIS_KATANA_IDDICTIONARY_H_
+
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <limits>
+#include <memory>
+#include <optional>
+#include <string_view>
+#include <type_traits>
+#include <utility>
+
+#include <arrow/api.h>
+
+#include "katana/CompilerSpecific.h"
+#include "katana/Galois.h"
+#include "katana/Logging.h"
+#include "katana/PropertyGraph.h"
+#include "katana/Result.h"
+#include "katana/config.h"
+
+namespace katana {
+
+/// A concurrent map from the IDs nodes have in an input (user IDs) to dense
+/// node IDs.
+///
+/// The map is an open-addressing hash table with linear probing. Its
+/// capacity is fixed when it is made, so threads inserting and looking up
+/// keys only contend on the slots they probe. Keys are uint64_t or
+/// std::string_view; the characters of string keys are not copied and must
+/// outlive the map.
+///
+/// The persisted form of a dictionary is the local_to_user_id array of an
+/// RDG, which holds the user ID of each node in node order; see
+/// MakeUserIdArray and MakeUserIdDictionary.
+template <typename Key>
+class IdDictionary {
+  static_assert(
+      std::is_same_v<Key, uint64_t> || std::is_same_v<Key, std::string_view>,
+      "IdDictionary keys are uint64_t or std::string_view");
+
+public:
+  using NodeId = uint32_t;
+  static constexpr NodeId kNoNode = std::numeric_limits<NodeId>::max();
+
+private:
+  struct Slot {
+    // 0 while the slot is empty, otherwise the hash of its key with the
+    // lowest bit set
+    std::atomic<uint64_t> tag;
+    Key key;
+    // kNoNode until key and node are written
+    std::atomic<NodeId> node;
+  };
+
+  std::unique_ptr<Slot[]> slots_;
+  uint64_t mask_{0};
+  std::atomic<NodeId> next_node_{0};
+
+  static uint64_t Hash(const Key& key) {
+    uint64_t h;
+    if constexpr (std::is_same_v<Key, std::string_view>) {
+      h = std::hash<std::string_view>{}(key);
+    } else {
+      h = key;
+    }
+    // splitmix64 finalizer; spreads consecutive IDs over the table
+    h ^= h >> 30;
+    h *= UINT64_C(0xbf58476d1ce4e5b9);
+    h ^= h >> 27;
+    h *= UINT64_C(0x94d049bb133111eb);
+    h ^= h >> 31;
+    return h | 1;
+  }
+
+  static NodeId WaitForNode(const Slot& slot) {
+    NodeId node;
+    while ((node = slot.node.load(std::memory_order_acquire)) == kNoNode) {
+      asmPause();
+    }
+    return node;
+  }
+
+  /// Find the slot of key and claim an empty one for it if it is absent
+  ///
+  /// \returns the slot and whether this call claimed it
+  std::pair<Slot*, bool> Claim(const Key& key) {
+    uint64_t tag = Hash(key);
+    for (uint64_t i = tag & mask_, probes = 0; probes <= mask_;
+         i = (i + 1) & mask_, ++probes) {
+      Slot& slot = slots_[i];
+      uint64_t current = slot.tag.load(std::memory_order_acquire);
+      if (current == 0) {
+        if (slot.tag.compare_exchange_strong(
+                current, tag, std::memory_order_acq_rel)) {
+          slot.key = key;
+          return std::make_pair(&slot, true);
+        }
+        // another thread claimed the slot; current is its tag
+      }
+      if (current == tag) {
+        WaitForNode(slot);
+        if (slot.key == key) {
+          return std::make_pair(&slot, false);
+        }
+      }
+    }
+    KATANA_LOG_FATAL("IdDictionary with {} slots is full", mask_ + 1);
+  }
+
+public:
+  /// Make a dictionary with room for max_keys keys
+  explicit IdDictionary(size_t max_keys) {
+    // keep the load factor at most 1/2 so that probe sequences stay short
+    uint64_t capacity = 16;
+    while (capacity < 2 * static_cast<uint64_t>(max_keys)) {
+      capacity <<= 1;
+    }
+    slots_.reset(new Slot[capacity]);
+    mask_ = capacity - 1;
+    katana::do_all(
+        katana::iterate(UINT64_C(0), capacity),
+        [&](uint64_t i) {
+          slots_[i].tag.store(0, std::memory_order_relaxed);
+          slots_[i].node.store(kNoNode, std::memory_order_relaxed);
+        },
+        katana::no_stats());
+  }
+
+  IdDictionary(IdDictionary&& other) noexcept
+      : slots_(std::move(other.slots_)),
+        mask_(other.mask_),
+        next_node_(other.next_node_.load()) {}
+  IdDictionary& operator=(IdDictionary&& other) noexcept {
+    slots_ = std::move(other.slots_);
+    mask_ = other.mask_;
+    next_node_ = other.next_node_.load();
+    return *this;
+  }
+  IdDictionary(const IdDictionary&) = delete;
+  IdDictionary& operator=(const IdDictionary&) = delete;
+
+  /// Map key to node unless it maps to a smaller node already. Once all
+  /// inserts are done, each key maps to the smallest node it was inserted
+  /// with, which is the first node with that key when nodes are numbered in
+  /// input order.
+  ///
+  /// \returns the node key maps to when the call returns
+  NodeId Insert(const Key& key, NodeId node) {
+    auto [slot, claimed] = Claim(key);
+    if (claimed) {
+      slot->node.store(node, std::memory_order_release);
+      return node;
+    }
+    NodeId current = slot->node.load(std::memory_order_acquire);
+    while (node < current && !slot->node.compare_exchange_weak(
+                                 current, node, std::memory_order_acq_rel)) {
+    }
+    return std::min(current, node);
+  }
+
+  /// \returns the node of key, mapping key to the next unused node if it is
+  /// absent. Nodes are assigned densely from 0 in the order keys are first
+  /// seen, which is nondeterministic when several threads assign. Do not
+  /// mix with Insert.
+  NodeId GetOrAssign(const Key& key) {
+    auto [slot, claimed] = Claim(key);
+    if (claimed) {
+      NodeId node = next_node_.fetch_add(1, std::memory_order_relaxed);
+      slot->node.store(node, std::memory_order_release);
+      return node;
+    }
+    return WaitForNode(*slot);
+  }
+
+  /// \returns the node of key, if it is in the dictionary
+  std::optional<NodeId> Find(const Key& key) const {
+    uint64_t tag = Hash(key);
+    for (uint64_t i = tag & mask_, probes = 0; probes <= mask_;
+         i = (i + 1) & mask_, ++probes) {
+      const Slot& slot = slots_[i];
+      uint64_t current = slot.tag.load(std::memory_order_acquire);
+      if (current == 0) {
+        return std::nullopt;
+      }
+      if (current == tag) {
+        NodeId node = WaitForNode(slot);
+        if (slot.key == key) {
+          return node;
+        }
+      }
+    }
+    return std::nullopt;
+  }
+
+  /// The number of nodes assigned by GetOrAssign
+  NodeId num_assigned() const {
+    return next_node_.load(std::memory_order_relaxed);
+  }
+
+  /// Call fn(key, node) for every key in parallel; must not run concurrently
+  /// with updates
+  template <typename F>
+  void ForEach(F fn) const {
+    katana::do_all(
+        katana::iterate(UINT64_C(0), mask_ + 1),
+        [&](uint64_t i) {
+          const Slot& slot = slots_[i];
+          if (slot.tag.load(std::memory_order_relaxed) != 0) {
+            fn(slot.key, slot.node.load(std::memory_order_relaxed));
+          }
+        },
+        katana::no_stats());
+  }
+};
+
+/// Make the local_to_user_id array of a graph of num_nodes nodes whose user
+/// IDs are the keys of dict: element i is the key that maps to node i. Nodes
+/// that no key maps to get null.
+KATANA_EXPORT Result<std::shared_ptr<arrow::ChunkedArray>> MakeUserIdArray(
+    const IdDictionary<uint64_t>& dict, uint64_t num_nodes);
+
+/// Make a dictionary from the user IDs of pg, as stored in its
+/// local_to_user_id array, to its nodes.
+///
+/// \returns NotFound if pg has no user IDs
+KATANA_EXPORT Result<IdDictionary<uint64_t>> MakeUserIdDictionary(
+    const PropertyGraph& pg);
+
+}  // namespace katana
+
+#endif
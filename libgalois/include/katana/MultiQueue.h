@@ -0,0 +1,351 @@
+#ifndef KATANA_LIBGALOIS_KATANA_MULTIQUEUE_H_
+#define KATANA_LIBGALOIS_KATANA_MULTIQUEUE_H_
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <optional>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include <boost/noncopyable.hpp>
+
+#include "katana/CompilerSpecific.h"
+#include "katana/PaddedLock.h"
+#include "katana/PerThreadStorage.h"
+#include "katana/ThreadPool.h"
+#include "katana/Threads.h"
+#include "katana/WLCompileCheck.h"
+#include "katana/WorkListHelpers.h"
+
+namespace katana {
+
+namespace internal {
+
+//! A sequential binary heap behind a lock whose best priority can be read
+//! without taking the lock
+template <typename T, typename Index, typename Compare, bool Concurrent>
+struct alignas(KATANA_CACHE_LINE_SIZE) MultiQueueHeap {
+  using Entry = std::pair<Index, T>;
+
+  PaddedLock<Concurrent> lock;
+  std::vector<Entry> heap;
+  std::atomic<bool> nonEmpty{false};
+  std::atomic<Index> top{};
+
+  //! the standard heap functions keep the greatest element first, so order
+  //! entries in reverse to keep the best priority first
+  struct HeapCompare {
+    Compare compare;
+    bool operator()(const Entry& a, const Entry& b) const {
+      return compare(b.first, a.first);
+    }
+  };
+
+  void push(Entry&& e) {
+    heap.emplace_back(std::move(e));
+    std::push_heap(heap.begin(), heap.end(), HeapCompare());
+  }
+
+  T pop() {
+    std::pop_heap(heap.begin(), heap.end(), HeapCompare());
+    T item = std::move(heap.back().second);
+    heap.pop_back();
+    return item;
+  }
+
+  //! make the state of the heap visible to threads that do not hold the lock
+  void publish() {
+    if (heap.empty()) {
+      nonEmpty.store(false, std::memory_order_release);
+    } else {
+      top.store(heap.front().first, std::memory_order_relaxed);
+      nonEmpty.store(true, std::memory_order_release);
+    }
+  }
+};
+
+}  // namespace internal
+
+/**
+ * Relaxed priority scheduling with a MultiQueue. Items are spread over
+ * QueuesPerThread sequential heaps per thread. A pop locks the better of two
+ * randomly chosen heaps, so it returns an item close to the best one overall
+ * without any global synchronization.
+ *
+ * Unlike \ref OrderedByIntegerMetric, priorities need not be small integers:
+ * Indexer maps an item to any trivially copyable priority with a strict weak
+ * order, e.g., a floating point distance, and no bucket width has to be
+ * tuned.
+ *
+ * To cut contention and improve locality, each thread pushes to and pops
+ * from the same heap for Stickiness consecutive operations, and it moves
+ * items in batches of BatchSize: pushes are buffered and inserted together,
+ * and a pop takes the BatchSize best items of a heap for the thread to
+ * process in order. A thread's buffered pushes are flushed by its next pop.
+ *
+ * \code
+ * struct Indexer {
+ *   double operator()(const Request& r) const { return r.dist; }
+ * };
+ * katana::for_each(katana::iterate(init), fn,
+ *     katana::wl<katana::MultiQueue<Indexer>>());
+ * \endcode
+ *
+ * @tparam Indexer          Indexer class
+ * @tparam QueuesPerThread  Number of heaps per active thread
+ * @tparam BatchSize        Number of items pushed or popped at a time
+ * @tparam Stickiness       Number of batches a thread moves through one heap
+ *                          before picking another one
+ * @tparam UseDescending    Process the greatest priority first instead
+ */
+template <
+    class Indexer = DummyIndexer<int>, typename T = int, typename Index = int,
+    unsigned QueuesPerThread = 2, unsigned BatchSize = 8,
+    unsigned Stickiness = 8, bool UseDescending = false,
+    bool Concurrent = true>
+class MultiQueue : private boost::noncopyable {
+  static_assert(
+      std::is_trivially_copyable_v<Index>,
+      "MultiQueue priorities must be trivially copyable");
+  static_assert(QueuesPerThread > 0 && BatchSize > 0 && Stickiness > 0);
+
+public:
+  template <typename _T>
+  using retype = MultiQueue<
+      Indexer, _T, typename std::result_of<Indexer(_T)>::type,
+      QueuesPerThread, BatchSize, Stickiness, UseDescending, Concurrent>;
+
+  template <bool _b>
+  using rethread = MultiQueue<
+      Indexer, T, Index, QueuesPerThread, BatchSize, Stickiness, UseDescending,
+      _b>;
+
+  template <typename _indexer>
+  struct with_indexer {
+    typedef MultiQueue<
+        _indexer, T, Index, QueuesPerThread, BatchSize, Stickiness,
+        UseDescending, Concurrent>
+        type;
+  };
+
+  template <unsigned _queues_per_thread>
+  struct with_queues_per_thread {
+    typedef MultiQueue<
+        Indexer, T, Index, _queues_per_thread, BatchSize, Stickiness,
+        UseDescending, Concurrent>
+        type;
+  };
+
+  template <unsigned _batch_size>
+  struct with_batch_size {
+    typedef MultiQueue<
+        Indexer, T, Index, QueuesPerThread, _batch_size, Stickiness,
+        UseDescending, Concurrent>
+        type;
+  };
+
+  template <unsigned _stickiness>
+  struct with_stickiness {
+    typedef MultiQueue<
+        Indexer, T, Index, QueuesPerThread, BatchSize, _stickiness,
+        UseDescending, Concurrent>
+        type;
+  };
+
+  template <bool _use_descending>
+  struct with_descending {
+    typedef MultiQueue<
+        Indexer, T, Index, QueuesPerThread, BatchSize, Stickiness,
+        _use_descending, Concurrent>
+        type;
+  };
+
+  typedef T value_type;
+  typedef Index index_type;
+
+private:
+  using Compare =
+      std::conditional_t<UseDescending, std::greater<Index>, std::less<Index>>;
+  using Heap = internal::MultiQueueHeap<T, Index, Compare, Concurrent>;
+  using Entry = typename Heap::Entry;
+
+  struct ThreadData {
+    uint64_t rng{0};
+    unsigned pushHeap{0};
+    unsigned pushUses{0};
+    unsigned popHeap{0};
+    unsigned popUses{0};
+    std::vector<Entry> pushBuffer;
+    //! popped items, best last
+    std::vector<T> popBuffer;
+  };
+
+  PerThreadStorage<ThreadData> data;
+  unsigned numHeaps;
+  std::unique_ptr<Heap[]> heaps;
+  Indexer indexer;
+  Compare compare;
+
+  //! xorshift64* over a per-thread state
+  unsigned randomHeap(ThreadData& p) {
+    if (!p.rng) {
+      p.rng = 0x9E3779B97F4A7C15ULL * (ThreadPool::getTID() + 1);
+    }
+    p.rng ^= p.rng >> 12;
+    p.rng ^= p.rng << 25;
+    p.rng ^= p.rng >> 27;
+    return ((p.rng * 0x2545F4914F6CDD1DULL) >> 32) % numHeaps;
+  }
+
+  void flush(ThreadData& p) {
+    if (p.pushBuffer.empty()) {
+      return;
+    }
+    Heap* h = nullptr;
+    while (true) {
+      if (!p.pushUses) {
+        p.pushHeap = randomHeap(p);
+        p.pushUses = Stickiness;
+      }
+      h = &heaps[p.pushHeap];
+      if (h->lock.try_lock()) {
+        break;
+      }
+      // contended; move on to another heap
+      p.pushUses = 0;
+    }
+    --p.pushUses;
+    for (Entry& e : p.pushBuffer) {
+      h->push(std::move(e));
+    }
+    h->publish();
+    h->lock.unlock();
+    p.pushBuffer.clear();
+  }
+
+  //! move the best items of a locked heap to the pop buffer and unlock it
+  void takeBatch(ThreadData& p, Heap& h) {
+    for (unsigned i = 0; i < BatchSize && !h.heap.empty(); ++i) {
+      p.popBuffer.emplace_back(h.pop());
+    }
+    h.publish();
+    h.lock.unlock();
+    std::reverse(p.popBuffer.begin(), p.popBuffer.end());
+  }
+
+  //! the better of two random heaps, or numHeaps if both are empty
+  unsigned chooseHeap(ThreadData& p) {
+    unsigned a = randomHeap(p);
+    unsigned b = randomHeap(p);
+    bool hasA = heaps[a].nonEmpty.load(std::memory_order_acquire);
+    bool hasB = heaps[b].nonEmpty.load(std::memory_order_acquire);
+    if (hasA && hasB) {
+      Index topA = heaps[a].top.load(std::memory_order_relaxed);
+      Index topB = heaps[b].top.load(std::memory_order_relaxed);
+      return compare(topB, topA) ? b : a;
+    }
+    if (hasA) {
+      return a;
+    }
+    return hasB ? b : numHeaps;
+  }
+
+  KATANA_ATTRIBUTE_NOINLINE
+  bool refill(ThreadData& p) {
+    for (unsigned attempt = 0; attempt < numHeaps; ++attempt) {
+      if (!p.popUses ||
+          !heaps[p.popHeap].nonEmpty.load(std::memory_order_relaxed)) {
+        unsigned choice = chooseHeap(p);
+        if (choice == numHeaps) {
+          continue;
+        }
+        p.popHeap = choice;
+        p.popUses = Stickiness;
+      }
+      Heap& h = heaps[p.popHeap];
+      if (!h.lock.try_lock()) {
+        p.popUses = 0;
+        continue;
+      }
+      if (h.heap.empty()) {
+        h.lock.unlock();
+        p.popUses = 0;
+        continue;
+      }
+      --p.popUses;
+      takeBatch(p, h);
+      return true;
+    }
+
+    // Random choices keep missing; scan every heap so that no work is left
+    // behind when this thread reports that it found none
+    unsigned start = randomHeap(p);
+    for (unsigned i = 0; i < numHeaps; ++i) {
+      unsigned idx = (start + i) % numHeaps;
+      Heap& h = heaps[idx];
+      if (!h.nonEmpty.load(std::memory_order_acquire)) {
+        continue;
+      }
+      h.lock.lock();
+      if (h.heap.empty()) {
+        h.lock.unlock();
+        continue;
+      }
+      p.popHeap = idx;
+      p.popUses = Stickiness;
+      takeBatch(p, h);
+      return true;
+    }
+    return false;
+  }
+
+public:
+  MultiQueue(const Indexer& x = Indexer())
+      : numHeaps(
+            Concurrent ? QueuesPerThread * std::max(getActiveThreads(), 1U)
+                       : 1),
+        heaps(new Heap[numHeaps]),
+        indexer(x) {}
+
+  void push(const value_type& val) {
+    ThreadData& p = *data.getLocal();
+    p.pushBuffer.emplace_back(indexer(val), val);
+    if (p.pushBuffer.size() >= BatchSize) {
+      flush(p);
+    }
+  }
+
+  template <typename Iter>
+  void push(Iter b, Iter e) {
+    while (b != e) {
+      push(*b++);
+    }
+  }
+
+  template <typename RangeTy>
+  void push_initial(const RangeTy& range) {
+    push(range.local_begin(), range.local_end());
+  }
+
+  std::optional<value_type> pop() {
+    ThreadData& p = *data.getLocal();
+    if (p.popBuffer.empty()) {
+      flush(p);
+      if (!refill(p)) {
+        return std::nullopt;
+      }
+    }
+    std::optional<value_type> item(std::move(p.popBuffer.back()));
+    p.popBuffer.pop_back();
+    return item;
+  }
+};
+KATANA_WLCOMPILECHECK(MultiQueue)
+
+}  // namespace katana
+
+#endif
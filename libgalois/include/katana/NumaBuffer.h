@@ -0,0 +1,60 @@
+#ifndef KATANA_LIBGALOIS_KATANA_NUMABUFFER_H_
+#define KATANA_LIBGALOIS_KATANA_NUMABUFFER_H_
+
+#include <cstdint>
+#include <memory>
+
+#include <arrow/buffer.h>
+
+#include "katana/NumaMem.h"
+#include "katana/Result.h"
+#include "katana/config.h"
+
+namespace katana {
+
+/// How the pages of a buffer are spread over the NUMA nodes of the threads
+/// that first touch them
+enum class NumaPlacement {
+  /// Pages are dealt round robin to the active threads, like
+  /// largeMallocInterleaved. Suits data that is accessed irregularly.
+  kInterleaved,
+  /// The buffer is split into one contiguous block per active thread, like
+  /// largeMallocBlocked. Suits data indexed by node or edge that is processed
+  /// by do_all over the same range.
+  kBlocked,
+  /// Pages are touched by the allocating thread and so land on its NUMA
+  /// node, like largeMallocLocal
+  kLocal,
+};
+
+/// Touch the pages of [data, data + len) from the threads that placement
+/// assigns them to, writing zeros to the whole range if zero is true and to
+/// one byte per small page otherwise. With kLocal, inside a parallel loop,
+/// or on a thread other than the master of its thread pool, the calling
+/// thread touches every page.
+KATANA_EXPORT void PlacePages(
+    uint8_t* data, size_t len, NumaPlacement placement, bool zero);
+
+/// An arrow::Buffer that owns memory from the large page allocator
+class KATANA_EXPORT NumaBuffer : public arrow::MutableBuffer {
+public:
+  NumaBuffer(LAptr memory, int64_t size)
+      : arrow::MutableBuffer(static_cast<uint8_t*>(memory.get()), size),
+        memory_(std::move(memory)) {}
+
+private:
+  LAptr memory_;
+};
+
+/// Allocate a zero-filled buffer of size bytes.
+///
+/// Buffers of at least a huge page are freshly mapped, and so already zero,
+/// pages from tryLargeMallocFloating. The active threads touch them in
+/// parallel, so that the first touch of each page places it according to
+/// placement. Smaller buffers come from the default arrow memory pool.
+KATANA_EXPORT Result<std::shared_ptr<arrow::Buffer>> AllocateNumaBuffer(
+    int64_t size, NumaPlacement placement = NumaPlacement::kBlocked);
+
+}  // namespace katana
+
+#endif
@@ -40,6 +40,8 @@ typedef std::unique_ptr<void, internal::largeFreer> LAptr;
 KATANA_EXPORT LAptr largeMallocLocal(size_t bytes);  // fault in locally
 KATANA_EXPORT LAptr
 largeMallocFloating(size_t bytes);  // leave numa mapping undefined
+// like largeMallocFloating, but empty instead of aborting on failure
+KATANA_EXPORT LAptr tryLargeMallocFloating(size_t bytes);
 // fault in interleaved mapping
 KATANA_EXPORT LAptr largeMallocInterleaved(size_t bytes, unsigned numThreads);
 // fault in block interleaved mapping
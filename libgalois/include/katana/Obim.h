@@ -20,6 +20,9 @@
 #ifndef KATANA_LIBGALOIS_KATANA_OBIM_H_
 #define KATANA_LIBGALOIS_KATANA_OBIM_H_
 
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
 #include <deque>
 #include <limits>
 #include <type_traits>
@@ -28,7 +31,9 @@
 #include "katana/Chunk.h"
 #include "katana/FlatMap.h"
 #include "katana/PerThreadStorage.h"
+#include "katana/Statistics.h"
 #include "katana/TerminationDetection.h"
+#include "katana/Threads.h"
 #include "katana/WorkListHelpers.h"
 
 namespace katana {
@@ -53,7 +58,7 @@ protected:
 
   Barrier& barrier;
 
-  OrderedByIntegerMetricData() : barrier(GetBarrier(activeThreads)) {}
+  OrderedByIntegerMetricData() : barrier(GetBarrier(getActiveThreads())) {}
 
   bool hasStored(ThreadData& p, Index idx) {
     for (auto& e : p.stored) {
@@ -108,6 +113,176 @@ struct OrderedByIntegerMetricComparator<Index, true> {
         earliest(std::numeric_limits<Index>::max()) {}
 };
 
+
+template <typename Index, typename C, bool UseDescending, bool UseAdaptive>
+class OrderedByIntegerMetricTuner {
+protected:
+  struct ThreadData {};
+  explicit OrderedByIntegerMetricTuner(unsigned) {}
+  Index bucketOf(Index index) const { return index; }
+  void recordPush(ThreadData&, C*, bool) {}
+  void recordPop(ThreadData&, bool, Index) {}
+  template <typename PTS>
+  void reportTuning(const char*, PTS&) {}
+};
+
+/// Tunes the bucket width and the chunk size of an adaptive OBIM. Each
+/// thread counts what happens to its pushes and pops and, every kWindow
+/// pops, nudges the shared settings:
+///
+/// - Many pops that find no work mean that threads starve while others hold
+///   partially filled chunks, so chunks shrink; few mean that chunks can
+///   grow to cut traffic on the shared queues. A chunk is cut short by
+///   flushing it to the shared queue of its bucket.
+/// - Much new work landing in the bucket being processed, or an earlier one,
+///   means that buckets are too wide to keep work in priority order, so they
+///   split; buckets with only a few items make threads look for the next
+///   bucket too often, so they merge.
+///
+/// Buckets are named by the first priority they hold, so buckets of
+/// different widths stay ordered and changing the width needs no
+/// redistribution of the work already queued.
+template <typename Index, typename C, bool UseDescending>
+class OrderedByIntegerMetricTuner<Index, C, UseDescending, true> {
+  static_assert(
+      std::is_integral_v<Index>,
+      "adaptive OBIM needs integral priorities to merge buckets");
+
+protected:
+  static constexpr unsigned kWindow = 1024;
+  static constexpr unsigned kMaxShift = std::numeric_limits<Index>::digits - 1;
+  static constexpr unsigned kMaxChunk = C::chunk_size;
+  static constexpr unsigned kMinChunk = std::min(4U, kMaxChunk);
+  static constexpr uint64_t kMinBucketItems = 64;
+
+  struct Counters {
+    uint64_t pops{0};
+    uint64_t emptyPops{0};
+    uint64_t pushes{0};
+    uint64_t inversions{0};
+    uint64_t bucketChanges{0};
+
+    Counters& operator+=(const Counters& o) {
+      pops += o.pops;
+      emptyPops += o.emptyPops;
+      pushes += o.pushes;
+      inversions += o.inversions;
+      bucketChanges += o.bucketChanges;
+      return *this;
+    }
+  };
+
+  struct ThreadData {
+    Counters window;
+    Counters total;
+    Index lastPopped{};
+    const C* lastPushed{nullptr};
+    unsigned sinceFlush{0};
+  };
+
+  std::atomic<unsigned> shift;
+  std::atomic<unsigned> chunkLimit{kMaxChunk};
+  std::atomic<uint64_t> merges{0};
+  std::atomic<uint64_t> splits{0};
+  std::atomic<uint64_t> chunkChanges{0};
+
+  explicit OrderedByIntegerMetricTuner(unsigned initialShift)
+      : shift(std::min(initialShift, kMaxShift)) {}
+
+  Index bucketOf(Index index) const {
+    unsigned s = shift.load(std::memory_order_relaxed);
+    Index mask = static_cast<Index>((Index{1} << s) - 1);
+    return UseDescending ? static_cast<Index>(index | mask)
+                         : static_cast<Index>(index & ~mask);
+  }
+
+  void recordPush(ThreadData& p, C* c, bool inversion) {
+    ++p.window.pushes;
+    p.window.inversions += inversion;
+
+    unsigned limit = chunkLimit.load(std::memory_order_relaxed);
+    if (limit >= kMaxChunk) {
+      // full chunks are published anyway
+      return;
+    }
+    if (c != p.lastPushed) {
+      p.lastPushed = c;
+      p.sinceFlush = 0;
+    }
+    if (++p.sinceFlush >= limit) {
+      c->flush();
+      p.sinceFlush = 0;
+    }
+  }
+
+  void recordPop(ThreadData& p, bool gotItem, Index index) {
+    Counters& w = p.window;
+    ++w.pops;
+    if (!gotItem) {
+      ++w.emptyPops;
+    } else if (index != p.lastPopped) {
+      ++w.bucketChanges;
+      p.lastPopped = index;
+    }
+    if (w.pops >= kWindow) {
+      adjust(w);
+      p.total += w;
+      w = Counters{};
+    }
+  }
+
+  KATANA_ATTRIBUTE_NOINLINE
+  void adjust(const Counters& w) {
+    unsigned limit = chunkLimit.load(std::memory_order_relaxed);
+    unsigned nextLimit = limit;
+    if (w.emptyPops * 4 > w.pops && limit > kMinChunk) {
+      nextLimit = std::max(limit / 2, kMinChunk);
+    } else if (w.emptyPops * 64 < w.pops && limit < kMaxChunk) {
+      nextLimit = std::min(limit * 2, kMaxChunk);
+    }
+    // other threads may have made the same adjustment already
+    if (nextLimit != limit &&
+        chunkLimit.compare_exchange_strong(limit, nextLimit)) {
+      ++chunkChanges;
+    }
+
+    uint64_t items = w.pops - w.emptyPops;
+    if (items < kWindow / 2) {
+      return;
+    }
+    unsigned current = shift.load(std::memory_order_relaxed);
+    if (w.inversions * 2 > w.pushes && current > 0) {
+      if (shift.compare_exchange_strong(current, current - 1)) {
+        ++splits;
+      }
+    } else if (
+        w.inversions * 8 < w.pushes &&
+        w.bucketChanges * kMinBucketItems > items && current < kMaxShift) {
+      if (shift.compare_exchange_strong(current, current + 1)) {
+        ++merges;
+      }
+    }
+  }
+
+  template <typename PTS>
+  void reportTuning(const char* loopname, PTS& data) {
+    Counters sum;
+    for (unsigned i = 0; i < data.size(); ++i) {
+      const ThreadData& p = *data.getRemote(i);
+      sum += p.total;
+      sum += p.window;
+    }
+    ReportStatSingle(loopname, "OBIMBucketShift", shift.load());
+    ReportStatSingle(loopname, "OBIMBucketMerges", merges.load());
+    ReportStatSingle(loopname, "OBIMBucketSplits", splits.load());
+    ReportStatSingle(loopname, "OBIMChunkSize", chunkLimit.load());
+    ReportStatSingle(loopname, "OBIMChunkChanges", chunkChanges.load());
+    ReportStatSingle(loopname, "OBIMEmptyPops", sum.emptyPops);
+    ReportStatSingle(loopname, "OBIMPriorityInversions", sum.inversions);
+    ReportStatSingle(loopname, "OBIMBucketChanges", sum.bucketChanges);
+  }
+};
+
 }  // namespace internal
 
 /**
@@ -139,6 +314,11 @@ struct OrderedByIntegerMetricComparator<Index, true> {
  * @tparam UseMonotonic   Assume that an activity at priority p will not
  * schedule work at priority p or any priority p1 where p1 < p.
  * @tparam UseDescending  Use descending order instead
+ * @tparam UseAdaptive    Tune the bucket width and the chunk size while the
+ * loop runs. The indexer then returns fine grained integral priorities, which
+ * are grouped into buckets of 2^shift consecutive priorities, starting from
+ * the shift passed to the constructor. Container must be a chunked worklist.
+ * The tuning counters are reported as statistics of the loop.
  */
 // TODO could move to general comparator but there are issues with atomic reads
 // and initial values for arbitrary types
@@ -147,30 +327,37 @@ template <
     typename Container = PerSocketChunkFIFO<>, unsigned BlockPeriod = 0,
     bool BSP = true, typename T = int, typename Index = int,
     bool UseBarrier = false, bool UseMonotonic = false,
-    bool UseDescending = false, bool Concurrent = true>
+    bool UseDescending = false, bool UseAdaptive = false,
+    bool Concurrent = true>
 struct OrderedByIntegerMetric
     : private boost::noncopyable,
       public internal::OrderedByIntegerMetricData<T, Index, UseBarrier>,
-      public internal::OrderedByIntegerMetricComparator<Index, UseDescending> {
+      public internal::OrderedByIntegerMetricComparator<Index, UseDescending>,
+      public internal::OrderedByIntegerMetricTuner<
+          Index, typename Container::template rethread<Concurrent>,
+          UseDescending, UseAdaptive> {
   // static_assert(std::is_integral<Index>::value, "only integral index types
   // supported");
+  static_assert(
+      !(UseAdaptive && UseMonotonic),
+      "merging buckets breaks the monotonic order of priorities");
 
   template <typename _T>
   using retype = OrderedByIntegerMetric<
       Indexer, typename Container::template retype<_T>, BlockPeriod, BSP, _T,
       typename std::result_of<Indexer(_T)>::type, UseBarrier, UseMonotonic,
-      UseDescending, Concurrent>;
+      UseDescending, UseAdaptive, Concurrent>;
 
   template <bool _b>
   using rethread = OrderedByIntegerMetric<
       Indexer, Container, BlockPeriod, BSP, T, Index, UseBarrier, UseMonotonic,
-      UseDescending, _b>;
+      UseDescending, UseAdaptive, _b>;
 
   template <unsigned _period>
   struct with_block_period {
     typedef OrderedByIntegerMetric<
         Indexer, Container, _period, BSP, T, Index, UseBarrier, UseMonotonic,
-        UseDescending, Concurrent>
+        UseDescending, UseAdaptive, Concurrent>
         type;
   };
 
@@ -178,7 +365,7 @@ struct OrderedByIntegerMetric
   struct with_container {
     typedef OrderedByIntegerMetric<
         Indexer, _container, BlockPeriod, BSP, T, Index, UseBarrier,
-        UseMonotonic, UseDescending, Concurrent>
+        UseMonotonic, UseDescending, UseAdaptive, Concurrent>
         type;
   };
 
@@ -186,7 +373,7 @@ struct OrderedByIntegerMetric
   struct with_indexer {
     typedef OrderedByIntegerMetric<
         _indexer, Container, BlockPeriod, BSP, T, Index, UseBarrier,
-        UseMonotonic, UseDescending, Concurrent>
+        UseMonotonic, UseDescending, UseAdaptive, Concurrent>
         type;
   };
 
@@ -194,7 +381,7 @@ struct OrderedByIntegerMetric
   struct with_back_scan_prevention {
     typedef OrderedByIntegerMetric<
         Indexer, Container, BlockPeriod, _bsp, T, Index, UseBarrier,
-        UseMonotonic, UseDescending, Concurrent>
+        UseMonotonic, UseDescending, UseAdaptive, Concurrent>
         type;
   };
 
@@ -202,7 +389,7 @@ struct OrderedByIntegerMetric
   struct with_barrier {
     typedef OrderedByIntegerMetric<
         Indexer, Container, BlockPeriod, BSP, T, Index, _use_barrier,
-        UseMonotonic, UseDescending, Concurrent>
+        UseMonotonic, UseDescending, UseAdaptive, Concurrent>
         type;
   };
 
@@ -210,7 +397,7 @@ struct OrderedByIntegerMetric
   struct with_monotonic {
     typedef OrderedByIntegerMetric<
         Indexer, Container, BlockPeriod, BSP, T, Index, UseBarrier,
-        _use_monotonic, UseDescending, Concurrent>
+        _use_monotonic, UseDescending, UseAdaptive, Concurrent>
         type;
   };
 
@@ -218,7 +405,15 @@ struct OrderedByIntegerMetric
   struct with_descending {
     typedef OrderedByIntegerMetric<
         Indexer, Container, BlockPeriod, BSP, T, Index, UseBarrier,
-        UseMonotonic, _use_descending, Concurrent>
+        UseMonotonic, _use_descending, UseAdaptive, Concurrent>
+        type;
+  };
+
+  template <bool _use_adaptive>
+  struct with_adaptive {
+    typedef OrderedByIntegerMetric<
+        Indexer, Container, BlockPeriod, BSP, T, Index, UseBarrier,
+        UseMonotonic, UseDescending, _use_adaptive, Concurrent>
         type;
   };
 
@@ -229,10 +424,14 @@ private:
   typedef typename Container::template rethread<Concurrent> CTy;
   typedef internal::OrderedByIntegerMetricComparator<Index, UseDescending>
       Comparator;
+  typedef internal::OrderedByIntegerMetricTuner<
+      Index, CTy, UseDescending, UseAdaptive>
+      Tuner;
   typedef typename Comparator::template with_local_map<CTy*>::type LMapTy;
 
   struct ThreadData : public internal::OrderedByIntegerMetricData<
-                          T, Index, UseBarrier>::ThreadData {
+                          T, Index, UseBarrier>::ThreadData,
+                      public Tuner::ThreadData {
     LMapTy local;
     Index curIndex;
     Index scanStart;
@@ -283,7 +482,7 @@ private:
     if (BSP && !UseMonotonic) {
       msS = p.scanStart;
       if (localLeader) {
-        for (unsigned i = 0; i < activeThreads; ++i) {
+        for (unsigned i = 0; i < getActiveThreads(); ++i) {
           Index o = data.getRemote(i)->scanStart;
           if (this->compare(o, msS))
             msS = o;
@@ -344,8 +543,14 @@ private:
   }
 
 public:
-  OrderedByIntegerMetric(const Indexer& x = Indexer())
-      : data(this->earliest), masterVersion(0), indexer(x) {}
+  //! initialShift is the initial bucket width (2^initialShift priorities)
+  //! of an adaptive worklist
+  OrderedByIntegerMetric(
+      const Indexer& x = Indexer(), unsigned initialShift = 0)
+      : Tuner(initialShift),
+        data(this->earliest),
+        masterVersion(0),
+        indexer(x) {}
 
   ~OrderedByIntegerMetric() {
     // Deallocate in LIFO order to give opportunity for simple garbage
@@ -356,7 +561,7 @@ public:
   }
 
   void push(const value_type& val) {
-    Index index = indexer(val);
+    Index index = this->bucketOf(indexer(val));
     ThreadData& p = *data.getLocal();
 
     KATANA_LOG_DEBUG_ASSERT(!UseMonotonic || this->compare(p.curIndex, index));
@@ -364,10 +569,12 @@ public:
     // Fast path
     if (index == p.curIndex && p.current) {
       p.current->push(val);
+      this->recordPush(p, p.current, true);
       return;
     }
 
     // Slow path
+    bool inversion = !this->compare(p.curIndex, index);
     CTy* C = updateLocalOrCreate(p, index);
     if (BSP && this->compare(index, p.scanStart))
       p.scanStart = index;
@@ -377,6 +584,7 @@ public:
       p.current = C;
     }
     C->push(val);
+    this->recordPush(p, C, inversion);
   }
 
   template <typename Iter>
@@ -391,8 +599,19 @@ public:
   }
 
   std::optional<value_type> pop() {
-    // Find a successful pop
     ThreadData& p = *data.getLocal();
+    std::optional<value_type> item = popFrom(p);
+    this->recordPop(p, item.has_value(), p.curIndex);
+    return item;
+  }
+
+  //! Report the tuning counters of an adaptive worklist as statistics of
+  //! loopname
+  void reportStats(const char* loopname) { this->reportTuning(loopname, data); }
+
+private:
+  std::optional<value_type> popFrom(ThreadData& p) {
+    // Find a successful pop
     CTy* C = p.current;
 
     if (this->hasStored(p, p.curIndex))
@@ -413,6 +632,7 @@ public:
     return slowPop(p);
   }
 
+public:
   template <bool Barrier = UseBarrier>
   auto empty() -> typename std::enable_if<Barrier, bool>::type {
     std::optional<value_type> item;
@@ -443,7 +663,7 @@ public:
     Index curIndex = (hasWork) ? p.curIndex : this->identity;
     CTy* C = (hasWork) ? p.current : nullptr;
 
-    for (unsigned i = 0; i < activeThreads; ++i) {
+    for (unsigned i = 0; i < getActiveThreads(); ++i) {
       ThreadData& o = *data.getRemote(i);
       if (o.hasWork && this->compare(o.curIndex, curIndex)) {
         curIndex = o.curIndex;
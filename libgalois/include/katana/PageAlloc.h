@@ -32,6 +32,10 @@ KATANA_EXPORT size_t allocSize();
 // allocate contiguous pages, optionally faulting them in
 KATANA_EXPORT void* allocPages(unsigned num, bool preFault);
 
+// like allocPages, but return nullptr instead of aborting when the pages
+// cannot be mapped
+KATANA_EXPORT void* tryAllocPages(unsigned num, bool preFault);
+
 // free page range
 KATANA_EXPORT void freePages(void* ptr, unsigned num);
 
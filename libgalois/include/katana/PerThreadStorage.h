@@ -70,11 +70,20 @@ public:
 
   unsigned allocOffset(unsigned size);
   void deallocOffset(unsigned offset, unsigned size);
+  // thread is a tid in the thread pool of the calling thread
   void* getRemote(unsigned thread, unsigned offset);
   void* getLocal(unsigned offset, char* base) { return &base[offset]; }
   // faster when (1) you already know the id and (2) shared access to heads is
   // not to expensive; otherwise use getLocal(unsigned,char*)
-  void* getLocal(unsigned offset, unsigned id) { return &heads[id][offset]; }
+  void* getLocal(unsigned offset, unsigned id) {
+    return &heads[ThreadPool::getBase() + id][offset];
+  }
+  // slot is a tid in the system thread pool
+  void* getSlot(unsigned slot, unsigned offset) {
+    return &heads[slot][offset];
+  }
+  // storage of slot, for threads that take over the slot of another thread
+  char* getHead(unsigned slot) { return heads[slot]; }
 };
 
 extern thread_local char* ptsBase;
@@ -95,8 +104,10 @@ class PerThreadStorage {
       return;
     }
 
-    for (unsigned n = 0; n < GetThreadPool().getMaxThreads(); ++n) {
-      reinterpret_cast<T*>(b->getRemote(n, offset))->~T();
+    // objects live in every slot of the system thread pool so that threads
+    // of any ExecutorContext can use them
+    for (unsigned n = 0; n < GetThreadPool().getRoot().getMaxThreads(); ++n) {
+      reinterpret_cast<T*>(b->getSlot(n, offset))->~T();
     }
     b->deallocOffset(offset, sizeof(T));
     offset = ~0U;
@@ -138,11 +149,11 @@ public:
   PerThreadStorage(Args&&... args) : b(&getPTSBackend()) {
     // In case we make one of these before initializing the thread pool, this
     // will call initPTS for each thread if it hasn't already
-    auto& tp = GetThreadPool();
+    auto& tp = GetThreadPool().getRoot();
 
     offset = b->allocOffset(sizeof(T));
     for (unsigned n = 0; n < tp.getMaxThreads(); ++n) {
-      new (b->getRemote(n, offset)) T(std::forward<Args>(args)...);
+      new (b->getSlot(n, offset)) T(std::forward<Args>(args)...);
     }
   }
 
@@ -211,10 +222,9 @@ class PerSocketStorage {
   PerBackend* b;
 
   void destruct() {
-    auto& tp = GetThreadPool();
+    auto& tp = GetThreadPool().getRoot();
     for (unsigned n = 0; n < tp.getMaxSockets(); ++n) {
-      reinterpret_cast<T*>(b->getRemote(tp.getLeaderForSocket(n), offset))
-          ->~T();
+      reinterpret_cast<T*>(b->getSlot(tp.getLeaderForSocket(n), offset))->~T();
     }
     b->deallocOffset(offset, sizeof(T));
   }
@@ -227,9 +237,9 @@ public:
     GetThreadPool();
 
     offset = b->allocOffset(sizeof(T));
-    auto& tp = GetThreadPool();
+    auto& tp = GetThreadPool().getRoot();
     for (unsigned n = 0; n < tp.getMaxSockets(); ++n) {
-      new (b->getRemote(tp.getLeaderForSocket(n), offset))
+      new (b->getSlot(tp.getLeaderForSocket(n), offset))
           T(std::forward<Args>(args)...);
     }
   }
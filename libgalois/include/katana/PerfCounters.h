@@ -0,0 +1,91 @@
+#ifndef KATANA_LIBGALOIS_KATANA_PERFCOUNTERS_H_
+#define KATANA_LIBGALOIS_KATANA_PERFCOUNTERS_H_
+
+#include <array>
+#include <cstdint>
+
+#include "katana/config.h"
+
+namespace katana {
+
+/// Counts hardware events of the calling thread with the Linux
+/// perf_event_open interface, so unlike profilePapi it needs no library.
+///
+/// The counters of a thread are opened as one group the first time the
+/// thread calls start and stay open until it exits; start and stop only read
+/// them, so counting the same thread with nested PerfCounters is fine.
+/// Counts are scaled up when the kernel had to multiplex the counters.
+///
+/// Events the processor or the kernel does not support are skipped, and if
+/// perf_event_open is not permitted (see
+/// /proc/sys/kernel/perf_event_paranoid) nothing is counted; a warning is
+/// logged once in either case.
+class KATANA_EXPORT PerfCounters {
+public:
+  enum Event {
+    kCycles = 0,
+    kInstructions,
+    kLLCMisses,
+    kDTLBMisses,
+    /// Loads served by the memory or caches of another NUMA node
+    kRemoteNodeAccesses,
+    kNumEvents,
+  };
+
+  /// The statistic category under which an event is reported
+  static const char* EventName(Event e);
+
+  /// Start counting the events of the calling thread
+  void start();
+
+  /// Stop counting and add the events since start to the counts
+  void stop();
+
+  /// Whether event e could be counted by the thread that called start
+  bool has(Event e) const { return available_ & (1U << e); }
+
+  uint64_t get(Event e) const { return counts_[e]; }
+
+  /// Report the counts of the available events with ReportStatSum, so that
+  /// each thread contributes one value to the per-thread values of region
+  void report(const char* region) const;
+
+private:
+  struct Sample {
+    std::array<uint64_t, kNumEvents> values{};
+    uint64_t enabled_ns{};
+    uint64_t running_ns{};
+  };
+
+  Sample begin_;
+  std::array<uint64_t, kNumEvents> counts_{};
+  unsigned available_{};
+};
+
+/// PerfCounters of each thread running a loop, enabled by the perf_counters
+/// trait
+template <bool Enable>
+class CondPerfCounters : public PerfCounters {
+  const char* const region_;
+
+public:
+  explicit CondPerfCounters(const char* region) : region_(region) {}
+
+  void stop() {
+    PerfCounters::stop();
+    report(region_);
+  }
+};
+
+template <>
+class CondPerfCounters<false> {
+public:
+  explicit CondPerfCounters(const char*) {}
+
+  void start() const {}
+  void stop() const {}
+};
+
+}  // namespace katana
+
+#endif
@@ -34,6 +34,7 @@ extern "C" {
 #endif
 
 #include "katana/Galois.h"
+#include "katana/PerfCounters.h"
 #include "katana/Timer.h"
 #include "katana/config.h"
 #include "katana/gIO.h"
@@ -244,6 +245,32 @@ profilePapi(const F& func, const char* region) {
 
 #endif
 
+//! Run func and report the hardware events that each thread counted while it
+//! ran under region. Unlike profilePapi, this needs neither PAPI nor
+//! configuration; to count a single loop, pass it the perf_counters trait
+//! instead.
+template <typename F>
+void
+profilePerf(const F& func, const char* region) {
+  region = region ? region : "(NULL)";
+
+  katana::PerThreadStorage<PerfCounters> counters;
+  katana::on_each(
+      [&](unsigned, unsigned) { counters.getLocal()->start(); });
+
+  {
+    katana::StatTimer timer(region);
+    katana::TimerGuard timer_guard(timer);
+    func();
+  }
+
+  katana::on_each([&](unsigned, unsigned) {
+    PerfCounters& local = *counters.getLocal();
+    local.stop();
+    local.report(region);
+  });
+}
+
 }  // namespace katana
 
 #endif
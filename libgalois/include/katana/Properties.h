@@ -6,12 +6,14 @@
 #include <utility>
 
 #include <arrow/array.h>
+#include <arrow/table.h>
 #include <arrow/stl.h>
 #include <arrow/type_fwd.h>
 #include <arrow/type_traits.h>
 
 #include "katana/ErrorCode.h"
 #include "katana/Logging.h"
+#include "katana/NumaBuffer.h"
 #include "katana/Result.h"
 #include "katana/Traits.h"
 
@@ -387,22 +389,65 @@ struct LargeStringReadOnlyProperty {
   using ViewType = StringPropertyReadOnlyView<arrow::LargeStringArray>;
 };
 
+namespace internal {
+
+template <typename Prop>
+Result<std::shared_ptr<arrow::Array>>
+AllocateColumn(uint64_t num_rows, NumaPlacement placement) {
+  using ArrowType = PropertyArrowType<Prop>;
+  using Traits = arrow::TypeTraits<ArrowType>;
+  static_assert(
+      arrow::is_fixed_width_type<ArrowType>::value,
+      "only fixed width properties can be allocated");
+
+  auto res = AllocateNumaBuffer(Traits::bytes_required(num_rows), placement);
+  if (!res) {
+    return res.error();
+  }
+  return arrow::MakeArray(arrow::ArrayData::Make(
+      Traits::type_singleton(), num_rows, {nullptr, std::move(res.value())},
+      0));
+}
+
+template <typename Props, size_t... Is>
+std::vector<Result<std::shared_ptr<arrow::Array>>>
+AllocateColumns(
+    uint64_t num_rows, NumaPlacement placement, std::index_sequence<Is...>) {
+  return {AllocateColumn<std::tuple_element_t<Is, Props>>(
+      num_rows, placement)...};
+}
+
+}  // namespace internal
+
+/// Allocate a table of num_rows zero-initialized rows with one column per
+/// property in Props, named by names.
+///
+/// Each column is a single buffer placed on NUMA nodes according to
+/// placement (see AllocateNumaBuffer), so the default of kBlocked puts the
+/// values of a node or edge near the thread that owns it in a do_all.
 template <typename Props>
 Result<std::shared_ptr<arrow::Table>>
-AllocateTable(uint64_t num_rows, const std::vector<std::string>& names) {
+AllocateTable(
+    uint64_t num_rows, const std::vector<std::string>& names,
+    NumaPlacement placement = NumaPlacement::kBlocked) {
   constexpr auto num_tuple_elem = std::tuple_size<Props>::value;
   static_assert(num_tuple_elem != 0);
-  std::shared_ptr<arrow::Table> table;
-  std::vector<katana::PropertyArrowTuple<Props>> rows(num_rows);
   KATANA_LOG_ASSERT(names.size() == num_tuple_elem);
-  // TODO(gill): Replace this with NUMA allocated buffers.
-  if (auto r = arrow::stl::TableFromTupleRange(
-          arrow::default_memory_pool(), std::move(rows), names, &table);
-      !r.ok()) {
-    KATANA_LOG_DEBUG("arrow error: {}", r);
-    return katana::ErrorCode::ArrowError;
+
+  auto results = internal::AllocateColumns<Props>(
+      num_rows, placement, std::make_index_sequence<num_tuple_elem>());
+
+  std::vector<std::shared_ptr<arrow::Field>> fields;
+  std::vector<std::shared_ptr<arrow::Array>> columns;
+  for (size_t i = 0; i < num_tuple_elem; ++i) {
+    if (!results[i]) {
+      return results[i].error().WithContext(
+          "allocating property {}", names[i]);
+    }
+    columns.emplace_back(std::move(results[i].value()));
+    fields.emplace_back(arrow::field(names[i], columns.back()->type()));
   }
-  return table;
+  return arrow::Table::Make(arrow::schema(fields), columns, num_rows);
 }
 
 }  // namespace katana
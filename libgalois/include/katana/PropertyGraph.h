@@ -103,9 +103,11 @@ class KATANA_EXPORT PropertyGraph {
   Result<void> Validate();
 
   Result<void> DoWrite(
-      tsuba::RDGHandle handle, const std::string& command_line);
+      tsuba::RDGHandle handle, const std::string& command_line,
+      const tsuba::ParquetWriter::WriteOpts& opts);
   Result<void> WriteGraph(
-      const std::string& uri, const std::string& command_line);
+      const std::string& uri, const std::string& command_line,
+      const tsuba::ParquetWriter::WriteOpts& opts);
 
   tsuba::RDG rdg_;
   std::unique_ptr<tsuba::RDGFile> file_;
@@ -265,17 +267,30 @@ public:
     rdg_.set_local_to_global_id(std::move(a));
   }
 
-  /// Write the property graph to the given RDG name.
+  /// Cached summary statistics; see katana::GetGraphStats
+  const nlohmann::json& graph_stats() const { return rdg_.graph_stats(); }
+  void set_graph_stats(nlohmann::json stats) {
+    rdg_.set_graph_stats(std::move(stats));
+  }
+
+  /// Write the property graph to the given RDG name. Properties stored as
+  /// Parquet are encoded according to \param opts (compression, dictionary
+  /// encoding, row group and page sizes).
   ///
   /// \returns io_error if, for instance, a file already exists
   Result<void> Write(
-      const std::string& rdg_name, const std::string& command_line);
+      const std::string& rdg_name, const std::string& command_line,
+      const tsuba::ParquetWriter::WriteOpts& opts =
+          tsuba::ParquetWriter::WriteOpts::Defaults());
 
   /// Write updates to the property graph
   ///
   /// Like \ref Write(const std::string&, const std::string&) but update
   /// the original read location of the graph
-  Result<void> Commit(const std::string& command_line);
+  Result<void> Commit(
+      const std::string& command_line,
+      const tsuba::ParquetWriter::WriteOpts& opts =
+          tsuba::ParquetWriter::WriteOpts::Defaults());
   /// Tell the RDG where it's data is coming from
   Result<void> InformPath(const std::string& input_path) {
     if (!rdg_.rdg_dir().empty()) {
@@ -410,6 +425,28 @@ public:
     return rdg_.MarkEdgePropertiesPersistent(persist_edge_props);
   }
 
+  /// SetNodePropertiesFileFormat selects how the named node properties are
+  /// encoded when this graph is written. kArrowIpc trades file size for
+  /// loading without decoding or copying.
+  Result<void> SetNodePropertiesFileFormat(
+      const std::vector<std::string>& node_props,
+      tsuba::PropertyFileFormat format) {
+    return rdg_.SetNodePropertiesFileFormat(node_props, format);
+  }
+
+  Result<void> SetEdgePropertiesFileFormat(
+      const std::vector<std::string>& edge_props,
+      tsuba::PropertyFileFormat format) {
+    return rdg_.SetEdgePropertiesFileFormat(edge_props, format);
+  }
+
+  /// Upserting a stored property that changes only a few of its rows makes
+  /// the next Write or Commit store just those rows as a delta file.
+  /// CompactProperties rewrites properties that have deltas as single files
+  /// on the next Write or Commit. Properties are also compacted automatically
+  /// once they accumulate many deltas.
+  void CompactProperties() { rdg_.CompactProperties(); }
+
   const GraphTopology& topology() const { return topology_; }
 
   /// Add Node properties that do not exist in the current graph
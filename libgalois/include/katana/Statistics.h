@@ -20,6 +20,8 @@
 #ifndef KATANA_LIBGALOIS_KATANA_STATISTICS_H_
 #define KATANA_LIBGALOIS_KATANA_STATISTICS_H_
 
+#include <chrono>
+#include <cstdint>
 #include <limits>
 #include <string>
 #include <type_traits>
@@ -30,6 +32,16 @@
 
 namespace katana {
 
+/// Whether statistics and trace events are collected at all. Building with
+/// KATANA_ENABLE_STATS=OFF defines KATANA_DISABLE_STATS, which turns every
+/// Report function into a no-op and removes the per-loop bookkeeping of the
+/// executors (see internal::NeedStats).
+#ifdef KATANA_DISABLE_STATS
+constexpr bool kStatsEnabled = false;
+#else
+constexpr bool kStatsEnabled = true;
+#endif
+
 template <typename T>
 class RunningMin {
   T m_min;
@@ -206,6 +218,13 @@ public:
   }
 
   const Stat& stat(const const_iterator& i) const { return i->second; }
+
+  bool empty() const { return statMap.empty(); }
+
+  void clear() {
+    statMap.clear();
+    symbols.clear();
+  }
 };
 
 template <typename T>
@@ -359,6 +378,43 @@ public:
   void AddParam(
       const std::string& region, const std::string& category, const Str& val);
 
+  /// Record that the calling thread spent [begin_ns, end_ns) of TraceNow()
+  /// on category of region, if tracing is enabled. Events are kept per
+  /// thread, up to kMaxEventsPerThread each; later ones are counted as
+  /// dropped. region and category are copied the first time each name is
+  /// seen, so they need not outlive the call.
+  void AddEvent(
+      const char* region, const char* category, uint64_t begin_ns,
+      uint64_t end_ns);
+
+  static constexpr size_t kMaxEventsPerThread = size_t{1} << 16;
+
+  /// Trace events are only recorded while tracing is enabled, which it is
+  /// not by default. Must not be changed while a parallel loop runs.
+  void SetTracing(bool enabled);
+
+  bool IsTracing() const;
+
+  /// Print writes the trace events to this file in addition to the
+  /// statistics. Enables tracing.
+  void SetTraceFile(const std::string& outfile);
+
+  /// Write all statistics collected so far as a JSON object with one entry
+  /// per statistic, including its per-thread values. Unlike PrintStats, this
+  /// may be called any number of times.
+  void PrintJson(std::ostream& out) const;
+
+  /// Write the trace events collected so far in the Chrome trace event
+  /// format, which chrome://tracing and Perfetto load
+  void PrintTrace(std::ostream& out) const;
+
+  /// Discard the statistics and trace events collected so far. Must not be
+  /// called while a parallel loop runs.
+  void Reset();
+
+  /// Print statistics to standard out or to the file set by SetStatFile. If
+  /// the name of that file ends with ".json", they are written as by
+  /// PrintJson instead of as a table.
   void Print();
 };
 
@@ -373,7 +429,10 @@ template <typename T>
 void
 ReportParam(
     const std::string& region, const std::string& category, const T& value) {
-  internal::sysStatManager()->AddParam(region, category, gstl::makeStr(value));
+  if constexpr (kStatsEnabled) {
+    internal::sysStatManager()->AddParam(
+        region, category, gstl::makeStr(value));
+  }
 }
 
 template <typename T>
@@ -382,7 +441,10 @@ ReportStat(
     const std::string& region, const std::string& category, const T& value,
     const StatTotal::Type& type,
     std::enable_if_t<std::is_integral_v<T>>* = nullptr) {
-  internal::sysStatManager()->AddInt(region, category, int64_t(value), type);
+  if constexpr (kStatsEnabled) {
+    internal::sysStatManager()->AddInt(
+        region, category, int64_t(value), type);
+  }
 }
 
 template <typename T>
@@ -391,7 +453,9 @@ ReportStat(
     const std::string& region, const std::string& category, const T& value,
     const StatTotal::Type& type,
     std::enable_if_t<std::is_floating_point_v<T>>* = nullptr) {
-  internal::sysStatManager()->AddFP(region, category, double(value), type);
+  if constexpr (kStatsEnabled) {
+    internal::sysStatManager()->AddFP(region, category, double(value), type);
+  }
 }
 
 template <typename T>
@@ -429,6 +493,120 @@ ReportStatAvg(
   ReportStat(region, category, value, StatTotal::TAVG);
 }
 
+/// The clock of trace events, in nanoseconds
+inline uint64_t
+TraceNow() {
+  return std::chrono::duration_cast<std::chrono::nanoseconds>(
+             std::chrono::steady_clock::now().time_since_epoch())
+      .count();
+}
+
+/// Whether trace events are recorded; see SetTracing
+inline bool
+IsTracing() {
+  if constexpr (kStatsEnabled) {
+    return internal::sysStatManager()->IsTracing();
+  }
+  return false;
+}
+
+inline void
+ReportTraceEvent(
+    const char* region, const char* category, uint64_t begin_ns,
+    uint64_t end_ns) {
+  if constexpr (kStatsEnabled) {
+    internal::sysStatManager()->AddEvent(region, category, begin_ns, end_ns);
+  }
+}
+
+/// Records the interval between start and stop as a trace event of the
+/// calling thread. Unlike PerThreadTimer, it measures wall clock time and
+/// keeps each interval rather than their sum. Whether tracing is enabled is
+/// read once at construction, so a disabled span does not read the clock.
+template <bool enabled>
+class TraceSpan {
+  const char* const region_;
+  const char* const category_;
+  const bool tracing_;
+  uint64_t begin_{};
+
+public:
+  TraceSpan(const char* const region, const char* const category)
+      : region_(region), category_(category), tracing_(IsTracing()) {}
+
+  void start() {
+    if (tracing_) {
+      begin_ = TraceNow();
+    }
+  }
+
+  void stop() {
+    if (tracing_) {
+      ReportTraceEvent(region_, category_, begin_, TraceNow());
+    }
+  }
+};
+
+template <>
+class TraceSpan<false> {
+public:
+  TraceSpan(const char* const, const char* const) {}
+
+  void start() const {}
+
+  void stop() const {}
+};
+
+/// Sums the intervals between start and stop, and report records the sum as
+/// one trace event of the calling thread beginning at the first start. For
+/// phases too short and frequent to trace one by one, like steal attempts.
+template <bool enabled>
+class TraceTotal {
+  const char* const region_;
+  const char* const category_;
+  const bool tracing_;
+  uint64_t first_{};
+  uint64_t begin_{};
+  uint64_t total_{};
+
+public:
+  TraceTotal(const char* const region, const char* const category)
+      : region_(region), category_(category), tracing_(IsTracing()) {}
+
+  void start() {
+    if (tracing_) {
+      begin_ = TraceNow();
+      if (!first_) {
+        first_ = begin_;
+      }
+    }
+  }
+
+  void stop() {
+    if (tracing_) {
+      total_ += TraceNow() - begin_;
+    }
+  }
+
+  void report() const {
+    if (tracing_ && first_) {
+      ReportTraceEvent(region_, category_, first_, first_ + total_);
+    }
+  }
+};
+
+template <>
+class TraceTotal<false> {
+public:
+  TraceTotal(const char* const, const char* const) {}
+
+  void start() const {}
+
+  void stop() const {}
+
+  void report() const {}
+};
+
 //! Reports maximum resident set size and page faults stats using
 //! rusage
 //! @param id Identifier to prefix stat with in statistics output
@@ -443,6 +621,29 @@ KATANA_EXPORT void PrintStats();
 
 KATANA_EXPORT void SetStatFile(const std::string& f);
 
+/// Makes PrintStats also write the trace events to a file, and enables
+/// tracing
+KATANA_EXPORT void SetTraceFile(const std::string& f);
+
+/// Enables or disables recording trace events, e.g., to trace a single call
+/// without writing a trace file. Tracing is off by default.
+KATANA_EXPORT void SetTracing(bool enabled);
+
+/// Returns the statistics collected since the last ResetStats as JSON, e.g.,
+/// to fetch the breakdown of a single analytics call:
+///
+///     katana::ResetStats();
+///     Sssp(...);
+///     std::string stats = katana::GetStatsJson();
+KATANA_EXPORT std::string GetStatsJson();
+
+/// Returns the trace events collected since the last ResetStats in the Chrome
+/// trace event format
+KATANA_EXPORT std::string GetTraceJson();
+
+/// Discards the statistics and trace events collected so far
+KATANA_EXPORT void ResetStats();
+
 }  // end namespace katana
 
 #endif
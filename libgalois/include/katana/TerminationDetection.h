@@ -21,6 +21,7 @@
 #define KATANA_LIBGALOIS_KATANA_TERMINATIONDETECTION_H_
 
 #include <atomic>
+#include <memory>
 
 #include "katana/CacheLineStorage.h"
 #include "katana/PerThreadStorage.h"
@@ -110,6 +111,9 @@ public:
 
 namespace internal {
 void SetTerminationDetection(TerminationDetection* term);
+
+/// Create an instance of the termination detection that SharedMem installs
+std::unique_ptr<TerminationDetection> CreateTerminationDetection();
 }  // end namespace internal
 
 }  // end namespace katana
@@ -0,0 +1,225 @@
+#ifndef KATANA_LIBGALOIS_KATANA_THREADARENA_H_
+#define KATANA_LIBGALOIS_KATANA_THREADARENA_H_
+
+#include <algorithm>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <map>
+#include <new>
+#include <set>
+#include <unordered_map>
+#include <unordered_set>
+#include <utility>
+#include <vector>
+
+#include "katana/Statistics.h"
+#include "katana/config.h"
+
+namespace katana {
+
+/// A bump allocator private to a thread. Allocation moves a pointer through
+/// huge pages owned by the thread, and memory is only released in bulk by
+/// rewinding the arena to an earlier Mark, which keeps the pages for reuse.
+/// So temporaries of an operator cost neither malloc calls nor contention on
+/// the malloc heap.
+///
+/// Loops with the thread_arena trait rewind the arena of each thread after
+/// every iteration; containers using ThreadArenaAllocator, e.g.,
+/// arena::Vector, must then not outlive the iteration that created them.
+/// Allocations that do not fit in a page come from operator new and are
+/// freed on rewind as well.
+class KATANA_EXPORT ThreadArena {
+public:
+  /// A position to rewind the arena to
+  struct Mark {
+    size_t num_blocks;
+    size_t offset;
+    size_t num_large;
+  };
+
+  ThreadArena();
+  ~ThreadArena();
+
+  ThreadArena(const ThreadArena&) = delete;
+  ThreadArena& operator=(const ThreadArena&) = delete;
+  ThreadArena(ThreadArena&&) = delete;
+  ThreadArena& operator=(ThreadArena&&) = delete;
+
+  /// The arena of the calling thread
+  static ThreadArena& Local();
+
+  /// Allocate size bytes aligned to align, which must be a power of two
+  void* Allocate(size_t size, size_t align = alignof(std::max_align_t)) {
+    size_t begin = (offset_ + align - 1) & ~(align - 1);
+    if (begin + size > block_size_) {
+      return AllocateSlow(size, align);
+    }
+    offset_ = begin + size;
+    high_water_ = std::max(high_water_, bytes_in_use());
+    return current_ + begin;
+  }
+
+  Mark GetMark() const { return Mark{num_blocks_, offset_, large_.size()}; }
+
+  /// Release everything allocated since mark was taken
+  void Rewind(const Mark& mark);
+
+  /// Release everything
+  void Reset() { Rewind(Mark{0, block_size_, 0}); }
+
+  /// The bytes allocated and not released, including alignment padding and
+  /// the unused ends of pages that allocations did not fit in
+  size_t bytes_in_use() const {
+    return (num_blocks_ ? (num_blocks_ - 1) * block_size_ + offset_ : 0) +
+           large_bytes_;
+  }
+
+  /// The largest bytes_in_use since the last ResetHighWater
+  size_t high_water() const { return high_water_; }
+
+  /// Start measuring the high water mark anew from the current bytes in use
+  /// and return the previous mark
+  size_t ResetHighWater() {
+    return std::exchange(high_water_, bytes_in_use());
+  }
+
+  /// Merge the high water mark of an enclosing measurement back in
+  void RestoreHighWater(size_t high_water) {
+    high_water_ = std::max(high_water_, high_water);
+  }
+
+private:
+  struct Large {
+    void* ptr;
+    size_t size;
+    size_t align;
+  };
+
+  void* AllocateSlow(size_t size, size_t align);
+
+  size_t block_size_;
+  //! pages of the arena; those past num_blocks_ are free for reuse
+  std::vector<char*> blocks_;
+  size_t num_blocks_{};
+  char* current_{};
+  //! offset into current_; block_size_ while there is no current block
+  size_t offset_;
+  std::vector<Large> large_;
+  size_t large_bytes_{};
+  size_t high_water_{};
+};
+
+/// STL allocator that allocates from a ThreadArena, by default the one of
+/// the thread that constructs it. Deallocation is a no-op; memory is
+/// reclaimed when the arena is rewound.
+template <typename T>
+class ThreadArenaAllocator {
+  ThreadArena* arena_;
+
+public:
+  using value_type = T;
+
+  ThreadArenaAllocator() noexcept : arena_(&ThreadArena::Local()) {}
+
+  explicit ThreadArenaAllocator(ThreadArena* arena) noexcept : arena_(arena) {}
+
+  template <typename U>
+  ThreadArenaAllocator(const ThreadArenaAllocator<U>& other) noexcept
+      : arena_(other.arena()) {}
+
+  T* allocate(size_t n) {
+    if (n > size_t(-1) / sizeof(T)) {
+      throw std::bad_array_new_length();
+    }
+    return static_cast<T*>(arena_->Allocate(n * sizeof(T), alignof(T)));
+  }
+
+  void deallocate(T*, size_t) noexcept {}
+
+  ThreadArena* arena() const { return arena_; }
+
+  template <typename U>
+  bool operator==(const ThreadArenaAllocator<U>& other) const {
+    return arena_ == other.arena();
+  }
+
+  template <typename U>
+  bool operator!=(const ThreadArenaAllocator<U>& other) const {
+    return arena_ != other.arena();
+  }
+};
+
+/// STL containers that allocate from the ThreadArena of the calling thread
+namespace arena {
+
+template <typename T>
+using Vector = std::vector<T, ThreadArenaAllocator<T>>;
+
+template <typename T>
+using Deque = std::deque<T, ThreadArenaAllocator<T>>;
+
+template <typename T, typename C = std::less<T>>
+using Set = std::set<T, C, ThreadArenaAllocator<T>>;
+
+template <typename K, typename V, typename C = std::less<K>>
+using Map = std::map<K, V, C, ThreadArenaAllocator<std::pair<const K, V>>>;
+
+template <
+    typename T, typename Hash = std::hash<T>,
+    typename KeyEqual = std::equal_to<T>>
+using UnorderedSet =
+    std::unordered_set<T, Hash, KeyEqual, ThreadArenaAllocator<T>>;
+
+template <
+    typename K, typename V, typename Hash = std::hash<K>,
+    typename KeyEqual = std::equal_to<K>>
+using UnorderedMap = std::unordered_map<
+    K, V, Hash, KeyEqual, ThreadArenaAllocator<std::pair<const K, V>>>;
+
+}  // namespace arena
+
+/// Rewinds the ThreadArena of the thread that runs a loop with the
+/// thread_arena trait after each iteration
+template <bool Enable>
+class IterationArena {
+  ThreadArena& arena_;
+  ThreadArena::Mark mark_;
+  size_t base_bytes_;
+  size_t outer_high_water_;
+
+public:
+  IterationArena()
+      : arena_(ThreadArena::Local()),
+        mark_(arena_.GetMark()),
+        base_bytes_(arena_.bytes_in_use()),
+        outer_high_water_(arena_.ResetHighWater()) {}
+
+  ~IterationArena() {
+    arena_.Rewind(mark_);
+    arena_.RestoreHighWater(outer_high_water_);
+  }
+
+  IterationArena(const IterationArena&) = delete;
+  IterationArena& operator=(const IterationArena&) = delete;
+
+  void reset() { arena_.Rewind(mark_); }
+
+  /// Report the most arena memory an iteration of this thread used
+  void report(const char* loopname) const {
+    ReportStatMax(
+        loopname, "ArenaHighWaterBytes", arena_.high_water() - base_bytes_);
+  }
+};
+
+template <>
+class IterationArena<false> {
+public:
+  void reset() const {}
+
+  void report(const char*) const {}
+};
+
+}  // namespace katana
+
+#endif
@@ -23,9 +23,11 @@
 #include <atomic>
 #include <cassert>
 #include <condition_variable>
+#include <cstdint>
 #include <cstdlib>
 #include <functional>
 #include <thread>
+#include <utility>
 #include <vector>
 
 #include "katana/CacheLineStorage.h"
@@ -53,12 +55,37 @@ namespace katana {
 
 class KATANA_EXPORT ThreadPool {
   friend class SharedMem;
+  friend class ExecutorContext;
+  friend ThreadPool& GetThreadPool();
+
+public:
+  //! how threads wait for work between parallel sections
+  enum class WaitMode {
+    //! sleep on a condition variable; see beKind
+    kSleep,
+    //! busy wait; see burnPower
+    kSpin,
+    //! busy wait for about the recent time between parallel sections, then
+    //! sleep on a futex; see beAdaptive
+    kAdaptive,
+  };
+
+  //! how close two threads are in the memory hierarchy, nearest first
+  enum class Locality {
+    //! SMT siblings on one core
+    kCore,
+    //! sharing a last level cache
+    kCacheDomain,
+    kNumaNode,
+    kSocket,
+    kRemote,
+  };
 
 protected:
   struct shutdown_ty {};  //! type for shutting down thread
   struct fastmode_ty {
-    bool mode;
-  };  //! type for setting fastmode
+    WaitMode mode;
+  };  //! type for setting the wait mode
   struct dedicated_ty {
     std::function<void(void)> fn;
   };  //! type to switch to dedicated mode
@@ -71,9 +98,17 @@ protected:
     std::atomic<int> done;
     std::atomic<int> fastRelease;
     ThreadTopoInfo topo;
-
-    void wakeup(bool fastmode) {
-      if (fastmode) {
+    //! partition whose work this thread runs, or null for the system pool
+    ThreadPool* pool{nullptr};
+    //! tid in the system pool of tid 0 of pool
+    unsigned base{0};
+    //! moving average of the ns this thread waited for work in kAdaptive
+    uint64_t avgIdle{0};
+
+    //! release the thread; in kAdaptive the caller must follow up with
+    //! wakeSleepers once all threads are released
+    void wakeup(WaitMode mode) {
+      if (mode != WaitMode::kSleep) {
         done = 0;
         fastRelease = 1;
       } else {
@@ -84,30 +119,49 @@ protected:
       }
     }
 
-    void wait(bool fastmode) {
-      if (fastmode) {
+    void wait(WaitMode mode) {
+      if (mode == WaitMode::kSpin) {
         while (!fastRelease.load(std::memory_order_relaxed)) {
           asmPause();
         }
         fastRelease = 0;
+      } else if (mode == WaitMode::kAdaptive) {
+        waitAdaptive();
       } else {
         std::unique_lock<std::mutex> lg(m);
         cv.wait(lg, [=] { return !done; });
         // start.acquire();
       }
     }
+
+    //! spin for a budget derived from avgIdle, then sleep until released
+    void waitAdaptive();
   };
 
   thread_local static per_signal my_box;
 
   MachineTopoInfo mi;
+  //! topology of each thread as seen by this pool
+  std::vector<ThreadTopoInfo> threadTopo;
+  //! for each thread, the other threads ordered nearest first
+  std::vector<std::vector<unsigned>> stealOrder;
   std::vector<per_signal*> signals;
   std::vector<std::thread> threads;
   unsigned reserved;
+  unsigned dedicated{0};
+  //! number of threads in masterMode, or 0 if they sleep
   unsigned masterFastmode;
+  WaitMode masterMode{WaitMode::kSleep};
   bool running;
   std::function<void(void)> work;
 
+  //! pool this pool was partitioned from, or null for the system pool
+  ThreadPool* parent{nullptr};
+  //! tid in the parent of tid 0 of this pool
+  unsigned base{0};
+  //! (base, size) of the partitions of this pool, see reserveThreads
+  std::vector<std::pair<unsigned, unsigned>> partitions;
+
   //! destroy all threads
   void destroyCommon();
 
@@ -118,7 +172,22 @@ protected:
   void threadLoop(unsigned tid);
 
   //! spin up for run
-  void cascade(bool fastmode);
+  void cascade(WaitMode mode);
+
+  //! spin up threads [1, num) for run at once in kAdaptive: the tree of
+  //! cascade is set up by the caller and sleeping threads are woken by a
+  //! single broadcast rather than one hop of the tree at a time
+  void broadcast(unsigned num);
+
+  //! set the cascade ranges of the subtree rooted at the parent of
+  //! [wbegin, wend) and mark its threads not done
+  void prepareTree(unsigned wbegin, unsigned wend);
+
+  //! wake threads that sleep in kAdaptive to check whether they are released
+  static void wakeSleepers();
+
+  //! switch num threads to mode unless they already are in it
+  void setWaitMode(WaitMode mode, unsigned num);
 
   //! spin down after run
   void decascade();
@@ -128,6 +197,29 @@ protected:
 
   ThreadPool();
 
+  //! make a pool of the num threads of parent starting at tid begin; the
+  //! thread that calls initPartitionMaster becomes its tid 0
+  ThreadPool(ThreadPool& parent, unsigned begin, unsigned num);
+
+  //! make the calling thread tid 0 of this partition
+  void initPartitionMaster();
+
+  //! topology of threads [begin, begin + num) of this pool renumbered from 0
+  std::vector<ThreadTopoInfo> partitionTopo(unsigned begin, unsigned num) const;
+
+  //! take num threads out of the threads that run the loops of this pool and
+  //! return the tid of the first one, or 0 if there are not enough threads
+  unsigned reserveThreads(unsigned num);
+
+  //! return threads taken by reserveThreads
+  void releaseThreads(unsigned begin);
+
+  //! recompute reserved from partitions
+  void updateReserved();
+
+  //! compute stealOrder from threadTopo
+  void initStealOrder();
+
 public:
   ~ThreadPool();
 
@@ -169,9 +261,28 @@ public:
   void burnPower(unsigned num);
   // experimental: leave busy wait
   void beKind();
+  //! Wait for work in WaitMode::kAdaptive on all usable threads. Threads spin
+  //! for up to about twice the recent time between parallel sections (capped
+  //! at tens of microseconds) and then sleep, so back-to-back small loops
+  //! start nearly as fast as with burnPower while idle threads do not burn
+  //! their cores. Undone by beKind or burnPower.
+  void beAdaptive();
+
+  WaitMode getWaitMode() const { return masterMode; }
 
   bool isRunning() const { return running; }
 
+  //! is the calling thread the one that runs the loops of this pool, i.e.,
+  //! its thread 0
+  bool isMaster() const { return !signals.empty() && signals[0] == &my_box; }
+
+  //! is this pool a partition of the system thread pool owned by an
+  //! ExecutorContext
+  bool isPartition() const { return parent != nullptr; }
+
+  //! the system thread pool this pool was partitioned from
+  ThreadPool& getRoot() { return parent ? parent->getRoot() : *this; }
+
   //! return the number of non-reserved threads in the pool
   unsigned getMaxUsableThreads() const { return mi.maxThreads - reserved; }
   //! return the number of threads supported by the thread pool on the current
@@ -180,6 +291,7 @@ public:
   unsigned getMaxCores() const { return mi.maxCores; }
   unsigned getMaxSockets() const { return mi.maxSockets; }
   unsigned getMaxNumaNodes() const { return mi.maxNumaNodes; }
+  unsigned getMaxCacheDomains() const { return mi.maxCacheDomains; }
 
   unsigned getLeaderForSocket(unsigned pid) const {
     for (unsigned i = 0; i < getMaxThreads(); ++i)
@@ -189,20 +301,58 @@ public:
   }
 
   bool isLeader(unsigned tid) const {
-    return signals[tid]->topo.socketLeader == tid;
+    return threadTopo[tid].socketLeader == tid;
   }
-  unsigned getSocket(unsigned tid) const { return signals[tid]->topo.socket; }
+  unsigned getSocket(unsigned tid) const { return threadTopo[tid].socket; }
   unsigned getLeader(unsigned tid) const {
-    return signals[tid]->topo.socketLeader;
+    return threadTopo[tid].socketLeader;
   }
   unsigned getCumulativeMaxSocket(unsigned tid) const {
-    return signals[tid]->topo.cumulativeMaxSocket;
+    return threadTopo[tid].cumulativeMaxSocket;
   }
   unsigned getNumaNode(unsigned tid) const {
-    return signals[tid]->topo.numaNode;
+    return threadTopo[tid].numaNode;
+  }
+  unsigned getCore(unsigned tid) const { return threadTopo[tid].core; }
+  unsigned getCacheDomain(unsigned tid) const {
+    return threadTopo[tid].cacheDomain;
+  }
+  unsigned getCacheLeader(unsigned tid) const {
+    return threadTopo[tid].cacheLeader;
+  }
+  bool isCacheLeader(unsigned tid) const {
+    return threadTopo[tid].cacheLeader == tid;
+  }
+
+  Locality getLocality(unsigned a, unsigned b) const {
+    const ThreadTopoInfo& x = threadTopo[a];
+    const ThreadTopoInfo& y = threadTopo[b];
+    if (x.core == y.core) {
+      return Locality::kCore;
+    }
+    if (x.cacheDomain == y.cacheDomain) {
+      return Locality::kCacheDomain;
+    }
+    if (x.numaNode == y.numaNode) {
+      return Locality::kNumaNode;
+    }
+    if (x.socket == y.socket) {
+      return Locality::kSocket;
+    }
+    return Locality::kRemote;
+  }
+
+  //! the threads other than tid ordered by getLocality to tid and then
+  //! round robin starting after tid; the order in which tid should look for
+  //! work to steal
+  const std::vector<unsigned>& getStealOrder(unsigned tid) const {
+    return stealOrder[tid];
   }
 
   static unsigned getTID() { return my_box.topo.tid; }
+  //! tid in the system thread pool of tid 0 of the pool of the calling
+  //! thread; getTID() + getBase() is unique across partitions
+  static unsigned getBase() { return my_box.base; }
   static bool isLeader() { return my_box.topo.tid == my_box.topo.socketLeader; }
   static unsigned getLeader() { return my_box.topo.socketLeader; }
   static unsigned getSocket() { return my_box.topo.socket; }
@@ -210,10 +360,14 @@ public:
     return my_box.topo.cumulativeMaxSocket;
   }
   static unsigned getNumaNode() { return my_box.topo.numaNode; }
+  static unsigned getCacheDomain() { return my_box.topo.cacheDomain; }
+  static unsigned getCacheLeader() { return my_box.topo.cacheLeader; }
 };
 
 /**
- * return a reference to system thread pool
+ * return a reference to the thread pool of the calling thread: the partition
+ * of its ExecutorContext if it runs in one and the system thread pool
+ * otherwise
  */
 KATANA_EXPORT ThreadPool& GetThreadPool();
 
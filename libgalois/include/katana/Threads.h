@@ -29,11 +29,15 @@ namespace katana {
  * the actual value of threads used, which could be less than the requested
  * value. System behavior is undefined if this function is called during
  * parallel execution or after the first parallel execution.
+ *
+ * When called from a function running on an ExecutorContext, this sets the
+ * threads of that context only.
  */
 KATANA_EXPORT unsigned int setActiveThreads(unsigned int num) noexcept;
 
 /**
- * Returns the number of threads in use.
+ * Returns the number of threads in use, which for a function running on an
+ * ExecutorContext are the active threads of that context.
  */
 KATANA_EXPORT unsigned int getActiveThreads() noexcept;
 
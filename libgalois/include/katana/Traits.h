@@ -255,6 +255,13 @@ struct no_pushes : public trait_has_type<bool>, no_pushes_tag {};
 struct per_iter_alloc_tag {};
 struct per_iter_alloc : public trait_has_type<bool>, per_iter_alloc_tag {};
 
+/**
+ * Indicates the operator allocates temporaries from the ThreadArena of its
+ * thread, which is rewound after each iteration
+ */
+struct thread_arena_tag {};
+struct thread_arena : public trait_has_type<bool>, thread_arena_tag {};
+
 /**
  * Indicates the operator doesn't need its execution stats recorded
  */
@@ -268,6 +275,14 @@ struct no_stats : public trait_has_type<bool>, no_stats_tag {};
 struct more_stats_tag {};
 struct more_stats : public trait_has_type<bool>, more_stats_tag {};
 
+/**
+ * Indicates that hardware events of each thread running the loop should be
+ * counted and reported (see PerfCounters)
+ * Must provide loopname to enable this flag
+ */
+struct perf_counters_tag {};
+struct perf_counters : public trait_has_type<bool>, perf_counters_tag {};
+
 /**
  * Indicates the operator doesn't need abort support
  */
@@ -389,8 +404,12 @@ namespace internal {
 
 template <typename Tup>
 struct NeedStats {
+#ifdef KATANA_DISABLE_STATS
+  constexpr static const bool value = false;
+#else
   constexpr static const bool value =
       !has_trait<no_stats_tag, Tup>() && has_trait<loopname_tag, Tup>();
+#endif
 };
 
 template <typename Tup>
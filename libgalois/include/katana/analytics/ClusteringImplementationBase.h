@@ -27,6 +27,7 @@
 #include "katana/AtomicHelpers.h"
 #include "katana/Galois.h"
 #include "katana/LargeArray.h"
+#include "katana/ThreadArena.h"
 #include "katana/analytics/Utils.h"
 
 namespace katana::analytics {
@@ -71,8 +72,8 @@ struct ClusteringImplementationBase {
   template <typename EdgeWeightType>
   void FindNeighboringClusters(
       const Graph& graph, GNode& n,
-      std::map<uint64_t, uint64_t>& cluster_local_map,
-      std::vector<EdgeTy>& counter, EdgeTy& self_loop_wt) {
+      katana::arena::Map<uint64_t, uint64_t>& cluster_local_map,
+      katana::arena::Vector<EdgeTy>& counter, EdgeTy& self_loop_wt) {
     uint64_t num_unique_clusters = 0;
 
     // Add the node's current cluster to be considered
@@ -207,8 +208,8 @@ struct ClusteringImplementationBase {
    * without swapping the cluster assignment.
    */
   uint64_t MaxModularityWithoutSwaps(
-      std::map<uint64_t, uint64_t>& cluster_local_map,
-      std::vector<EdgeTy>& counter, uint64_t self_loop_wt,
+      katana::arena::Map<uint64_t, uint64_t>& cluster_local_map,
+      katana::arena::Vector<EdgeTy>& counter, uint64_t self_loop_wt,
       CommunityArray& c_info, EdgeTy degree_wt, uint64_t sc, double constant) {
     uint64_t max_index = sc;  // Assign the intial value as self community
     double cur_gain = 0;
@@ -553,7 +554,7 @@ struct ClusteringImplementationBase {
     katana::do_all(
         katana::iterate((uint64_t)0, num_unique_clusters),
         [&](uint64_t c) {
-          std::map<uint64_t, uint64_t> cluster_local_map;
+          katana::arena::Map<uint64_t, uint64_t> cluster_local_map;
           uint64_t num_unique_clusters = 0;
           for (auto cb_ii = cluster_bags[c].begin();
                cb_ii != cluster_bags[c].end(); ++cb_ii) {
@@ -582,7 +583,8 @@ struct ClusteringImplementationBase {
             }  // End edge loop
           }
         },
-        katana::steal(), katana::loopname("BuildGraph: Find edges"));
+        katana::steal(), katana::thread_arena(),
+        katana::loopname("BuildGraph: Find edges"));
 
     /* Serial loop to reduce all the edge counts */
     std::vector<uint64_t> prefix_edges_count(num_unique_clusters);
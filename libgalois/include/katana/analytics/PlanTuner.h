@@ -0,0 +1,74 @@
+#ifndef KATANA_LIBGALOIS_KATANA_ANALYTICS_PLANTUNER_H_
+#define KATANA_LIBGALOIS_KATANA_ANALYTICS_PLANTUNER_H_
+
+#include <cstdint>
+#include <string>
+
+#include "katana/PropertyGraph.h"
+#include "katana/Result.h"
+#include "katana/analytics/bfs/bfs.h"
+#include "katana/analytics/connected_components/connected_components.h"
+#include "katana/analytics/sssp/sssp.h"
+#include "katana/analytics/triangle_count/triangle_count.h"
+
+namespace katana::analytics {
+
+/// Options of the plan tuner.
+///
+/// Tuned plans are recorded in a profile, a JSON file keyed by a fingerprint
+/// of the graph statistics (see katana::GetGraphStats), the number of active
+/// threads and the algorithm. A plan found in the profile is returned without
+/// running any trials, so the cost of tuning is paid once per graph and
+/// thread count.
+///
+/// Trials run the algorithm on the whole graph. To bound their cost, a
+/// candidate is abandoned as soon as it is slower than the best one so far,
+/// and no more candidates are tried once time_budget_seconds have passed.
+struct KATANA_EXPORT PlanTunerOptions {
+  /// The profile to read and update. If empty, the value of the
+  /// KATANA_PLAN_PROFILE environment variable is used; if that is unset too,
+  /// plans are tuned on every call and not recorded.
+  std::string profile_path;
+  /// Number of sources each SSSP or BFS candidate is run from. The sources
+  /// are sampled once and shared by all candidates.
+  uint32_t num_sources{4};
+  /// Number of times each candidate is timed; the fastest run counts
+  uint32_t num_repetitions{1};
+  /// Run the trials even if the profile has a plan for the graph
+  bool retune{false};
+  /// Time after which the best plan so far is taken instead of trying the
+  /// remaining candidates; at least one candidate is always timed. Zero or
+  /// less means no limit.
+  double time_budget_seconds{60};
+};
+
+/// Choose an SSSP plan for pg by timing candidate plans on it.
+///
+/// Parameters are searched one at a time: first the algorithm (delta stepping
+/// with or without barriers, edge tiled, or with an adaptive delta), then the
+/// delta around the one suggested by the largest edge weight, then the edge
+/// tile size if the tiled algorithm won.
+KATANA_EXPORT Result<SsspPlan> TuneSsspPlan(
+    PropertyGraph* pg, const std::string& edge_weight_property_name,
+    const PlanTunerOptions& options = {});
+
+/// Choose a BFS plan for pg by timing candidate plans on it: the four
+/// algorithms, then the edge tile size if a tiled algorithm won.
+KATANA_EXPORT Result<BfsPlan> TuneBfsPlan(
+    PropertyGraph* pg, const PlanTunerOptions& options = {});
+
+/// Choose a connected components plan for pg by timing candidate plans on it:
+/// the Afforest and asynchronous union-find variants, then the edge tile size
+/// if a tiled algorithm won. The graph must be symmetric.
+KATANA_EXPORT Result<ConnectedComponentsPlan> TuneConnectedComponentsPlan(
+    PropertyGraph* pg, const PlanTunerOptions& options = {});
+
+/// Choose a triangle counting plan for pg by timing candidate plans on it:
+/// the three algorithms, then whether to relabel nodes. The graph must be
+/// symmetric.
+KATANA_EXPORT Result<TriangleCountPlan> TuneTriangleCountPlan(
+    PropertyGraph* pg, const PlanTunerOptions& options = {});
+
+}  // namespace katana::analytics
+
+#endif
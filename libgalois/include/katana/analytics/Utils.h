@@ -30,6 +30,8 @@ public:
 //! by sampling some of the vertices in the graph randomly
 //! This code has been copied from GAP benchmark suite
 //! (https://github.com/sbeamer/gapbs/blob/master/src/tc.cc WorthRelabelling())
+//! Uses the full degree distribution instead of a sample if the graph has
+//! cached statistics (see katana::GetGraphStats)
 KATANA_EXPORT bool IsApproximateDegreeDistributionPowerLaw(
     const PropertyGraph& graph);
 
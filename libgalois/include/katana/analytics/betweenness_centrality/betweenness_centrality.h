@@ -18,16 +18,44 @@ public:
   enum Algorithm {
     kLevel,
     kOuter,
+    kAdaptiveSampling,
+    kBatched,
     // TODO(gill): Reinstate async and auto once we have bidirectional graphs.
     // kAsynchronous,
     // kAutomatic,
   };
 
+  static constexpr double kDefaultEpsilon = 0.01;
+  static constexpr double kDefaultFailureProbability = 0.1;
+  static const uint64_t kDefaultSeed = 0;
+  static const uint32_t kDefaultBatchSize = 16;
+  static const uint32_t kMaxBatchSize = 64;
+
 private:
   Algorithm algorithm_;
+  // Adaptive sampling: maximum absolute error of the normalized centrality
+  double epsilon_;
+  // Adaptive sampling: probability that the error bound does not hold
+  double failure_probability_;
+  // Adaptive sampling: seed of the pair sampler
+  uint64_t seed_;
+  // Batched: number of sources traversed together
+  uint32_t batch_size_;
+
+  BetweennessCentralityPlan(
+      Architecture architecture, Algorithm algorithm, double epsilon,
+      double failure_probability, uint64_t seed, uint32_t batch_size)
+      : Plan(architecture),
+        algorithm_(algorithm),
+        epsilon_(epsilon),
+        failure_probability_(failure_probability),
+        seed_(seed),
+        batch_size_(batch_size) {}
 
   BetweennessCentralityPlan(Architecture architecture, Algorithm algorithm)
-      : Plan(architecture), algorithm_(algorithm) {}
+      : BetweennessCentralityPlan(
+            architecture, algorithm, kDefaultEpsilon,
+            kDefaultFailureProbability, kDefaultSeed, kDefaultBatchSize) {}
 
 public:
   BetweennessCentralityPlan() : BetweennessCentralityPlan{kCPU, kLevel} {}
@@ -50,11 +78,49 @@ public:
   }
 
   Algorithm algorithm() const { return algorithm_; }
+  double epsilon() const { return epsilon_; }
+  double failure_probability() const { return failure_probability_; }
+  uint64_t seed() const { return seed_; }
+  uint32_t batch_size() const { return batch_size_; }
 
   static BetweennessCentralityPlan Level() { return {kCPU, kLevel}; }
 
   static BetweennessCentralityPlan Outer() { return {kCPU, kOuter}; }
 
+  /**
+   * Approximate betweenness centrality by sampling shortest paths between
+   * random pairs of nodes (Riondato and Kornaropoulos), stopping as soon as
+   * the adaptive bounds of KADABRA (Borassi and Natale) guarantee that, with
+   * probability at least 1 - failure_probability, every normalized centrality
+   * is within epsilon of its exact value.
+   *
+   * The sample size never exceeds the static bound derived from the vertex
+   * diameter, which is estimated from a BFS; on directed graphs that estimate
+   * is a heuristic. The sources argument is ignored.
+   */
+  static BetweennessCentralityPlan AdaptiveSampling(
+      double epsilon = kDefaultEpsilon,
+      double failure_probability = kDefaultFailureProbability,
+      uint64_t seed = kDefaultSeed) {
+    return {
+        kCPU, kAdaptiveSampling, epsilon, failure_probability, seed,
+        kDefaultBatchSize};
+  }
+
+  /**
+   * Exact Brandes over the requested sources, traversing batch_size
+   * (at most kMaxBatchSize) sources at once. The per-source distances, path
+   * counts and dependencies of a node are stored next to each other so that
+   * every edge scan serves the whole batch. Uses 16 * batch_size bytes of
+   * scratch memory per node.
+   */
+  static BetweennessCentralityPlan Batched(
+      uint32_t batch_size = kDefaultBatchSize) {
+    return {
+        kCPU, kBatched, kDefaultEpsilon, kDefaultFailureProbability,
+        kDefaultSeed, batch_size};
+  }
+
   static BetweennessCentralityPlan FromAlgorithm(Algorithm algo) {
     return BetweennessCentralityPlan(kCPU, algo);
   }
@@ -74,11 +140,17 @@ KATANA_EXPORT extern const BetweennessCentralitySources
  * The property named output_property_name is created by this function and may
  * not exist before the call.
  *
+ * For every algorithm but kAdaptiveSampling the values are the sum of the
+ * dependencies over the processed sources. kAdaptiveSampling scales its
+ * estimate of the normalized centrality by n * (n - 1) so that all algorithms
+ * report values on the same scale.
+ *
  * @param pg The graph to process.
  * @param output_property_name The parameter to create with the computed value.
  * @param sources Only process some sources, producing an approximate
  *          betweenness centrality. If this is a vector process those source
  *          nodes; if this is an int process that number of source nodes.
+ *          Ignored by kAdaptiveSampling, which picks its own samples.
  * @param plan
  */
 KATANA_EXPORT Result<void> BetweennessCentrality(
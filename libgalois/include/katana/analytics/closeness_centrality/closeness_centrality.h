@@ -0,0 +1,130 @@
+#ifndef KATANA_LIBGALOIS_KATANA_ANALYTICS_CLOSENESSCENTRALITY_CLOSENESSCENTRALITY_H_
+#define KATANA_LIBGALOIS_KATANA_ANALYTICS_CLOSENESSCENTRALITY_CLOSENESSCENTRALITY_H_
+
+#include <iostream>
+
+#include "katana/PropertyGraph.h"
+#include "katana/analytics/Plan.h"
+
+// API
+
+namespace katana::analytics {
+
+/// A computational plan for Closeness and Harmonic Centrality, specifying the
+/// algorithm and any parameters associated with it. Both centralities are
+/// computed from the same distance sums, so they share this plan.
+class ClosenessCentralityPlan : public Plan {
+public:
+  /// Algorithm selectors for Closeness and Harmonic Centrality
+  enum Algorithm {
+    kExact,
+    kSampled,
+    kHyperBall,
+  };
+
+  static const uint32_t kDefaultNumSamples = 256;
+  static const uint32_t kDefaultLog2Registers = 6;
+  static const uint32_t kMinLog2Registers = 4;
+  static const uint32_t kMaxLog2Registers = 12;
+  static const uint64_t kDefaultSeed = 0;
+
+  // Don't allow people to directly construct these, so as to have only one
+  // consistent way to configure.
+private:
+  Algorithm algorithm_;
+  // Number of BFS sources for kSampled
+  uint32_t num_samples_;
+  // log2 of the number of HyperLogLog registers per node for kHyperBall
+  uint32_t log2_registers_;
+  // Seed of the source sampler or of the HyperLogLog hash
+  uint64_t seed_;
+
+  ClosenessCentralityPlan(
+      Architecture architecture, Algorithm algorithm, uint32_t num_samples,
+      uint32_t log2_registers, uint64_t seed)
+      : Plan(architecture),
+        algorithm_(algorithm),
+        num_samples_(num_samples),
+        log2_registers_(log2_registers),
+        seed_(seed) {}
+
+public:
+  ClosenessCentralityPlan()
+      : ClosenessCentralityPlan{
+            kCPU, kExact, kDefaultNumSamples, kDefaultLog2Registers,
+            kDefaultSeed} {}
+
+  Algorithm algorithm() const { return algorithm_; }
+  uint32_t num_samples() const { return num_samples_; }
+  uint32_t log2_registers() const { return log2_registers_; }
+  uint64_t seed() const { return seed_; }
+
+  /// Exact distance sums from a BFS out of every node. BFSs run 64 sources at
+  /// a time, sharing every edge scan (multi-source BFS with bit masks).
+  /// O(|V| * |E| / 64) time; only practical for small graphs.
+  static ClosenessCentralityPlan Exact() {
+    return {
+        kCPU, kExact, kDefaultNumSamples, kDefaultLog2Registers, kDefaultSeed};
+  }
+
+  /// Estimate the distance sums of every node from num_samples randomly
+  /// chosen BFS sources (Eppstein and Wang). Distances are measured from the
+  /// sampled sources, so the estimate matches the exact definition only on
+  /// symmetric graphs.
+  static ClosenessCentralityPlan Sampled(
+      uint32_t num_samples = kDefaultNumSamples, uint64_t seed = kDefaultSeed) {
+    return {kCPU, kSampled, num_samples, kDefaultLog2Registers, seed};
+  }
+
+  /// Estimate the neighborhood function of every node with HyperLogLog
+  /// counters of 2^log2_registers registers (HyperBall, Boldi and Vigna).
+  /// Runs one pass over the edges per level of the graph and uses
+  /// 2^(log2_registers + 1) bytes per node; the relative standard error of
+  /// each counter is about 1.04 / sqrt(2^log2_registers).
+  static ClosenessCentralityPlan HyperBall(
+      uint32_t log2_registers = kDefaultLog2Registers,
+      uint64_t seed = kDefaultSeed) {
+    return {kCPU, kHyperBall, kDefaultNumSamples, log2_registers, seed};
+  }
+};
+
+/// Compute the closeness centrality of each node in pg from the distances of
+/// its shortest out-paths. With r the number of nodes reachable from a node
+/// and S the sum of their distances, the centrality is
+/// (r / (n - 1)) * (r / S) (Wasserman and Faust), which stays meaningful on
+/// graphs that are not strongly connected; nodes that reach nothing get 0.
+/// The result is stored in the property named output_property_name (as
+/// double), which is created by this function and may not exist before the
+/// call.
+KATANA_EXPORT Result<void> ClosenessCentrality(
+    PropertyGraph* pg, const std::string& output_property_name,
+    ClosenessCentralityPlan plan = {});
+
+/// Compute the harmonic centrality of each node in pg: the sum of 1 / d over
+/// the distances d of its shortest out-paths to every other reachable node.
+/// The result is stored in the property named output_property_name (as
+/// double), which is created by this function and may not exist before the
+/// call.
+KATANA_EXPORT Result<void> HarmonicCentrality(
+    PropertyGraph* pg, const std::string& output_property_name,
+    ClosenessCentralityPlan plan = {});
+
+struct KATANA_EXPORT ClosenessCentralityStatistics {
+  /// The maximum centrality across all nodes.
+  double max_centrality;
+  /// The minimum centrality across all nodes.
+  double min_centrality;
+  /// The average centrality across all nodes.
+  double average_centrality;
+
+  /// Print the statistics in a human readable form.
+  void Print(std::ostream& os = std::cout) const;
+
+  /// Compute statistics of either a closeness or a harmonic centrality.
+  static katana::Result<ClosenessCentralityStatistics> Compute(
+      PropertyGraph* pg, const std::string& output_property_name);
+};
+
+}  // namespace katana::analytics
+
+#endif
@@ -145,7 +145,7 @@ public:
       uint32_t neighbor_sample_size = kDefaultNeighborSampleSize,
       uint32_t component_sample_frequency = kDefaultComponentSampleFrequency) {
     return {
-        kCPU, kEdgeAfforest, edge_tile_size, neighbor_sample_size,
+        kCPU, kEdgeTiledAfforest, edge_tile_size, neighbor_sample_size,
         component_sample_frequency};
   }
 };
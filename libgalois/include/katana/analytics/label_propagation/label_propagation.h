@@ -0,0 +1,114 @@
+#ifndef KATANA_LIBGALOIS_KATANA_ANALYTICS_LABELPROPAGATION_LABELPROPAGATION_H_
+#define KATANA_LIBGALOIS_KATANA_ANALYTICS_LABELPROPAGATION_LABELPROPAGATION_H_
+
+#include <iostream>
+
+#include "katana/AtomicHelpers.h"
+#include "katana/analytics/Plan.h"
+#include "katana/analytics/Utils.h"
+
+namespace katana::analytics {
+
+/// A computational plan to for Label Propagation community detection,
+/// specifying the algorithm and any parameters associated with it.
+class LabelPropagationPlan : public Plan {
+public:
+  /// Algorithm selectors for Label Propagation
+  enum Algorithm {
+    kSynchronous,
+    kAsynchronous,
+  };
+
+  static const uint32_t kMaxIterations = 20;
+  static const uint64_t kDefaultSeed = 0;
+
+  // Don't allow people to directly construct these, so as to have only one
+  // consistent way to configure.
+private:
+  Algorithm algorithm_;
+  // Maximum number of rounds to execute.
+  uint32_t max_iterations_;
+  // Seed used to hash labels when breaking ties between equally heavy labels.
+  uint64_t seed_;
+
+  LabelPropagationPlan(
+      Architecture architecture, Algorithm algorithm, uint32_t max_iterations,
+      uint64_t seed)
+      : Plan(architecture),
+        algorithm_(algorithm),
+        max_iterations_(max_iterations),
+        seed_(seed) {}
+
+public:
+  // kChunkSize is a fixed const int (default value: 64)
+  static const int kChunkSize;
+
+  LabelPropagationPlan()
+      : LabelPropagationPlan{
+            kCPU, kAsynchronous, kMaxIterations, kDefaultSeed} {}
+
+  Algorithm algorithm() const { return algorithm_; }
+  uint32_t max_iterations() const { return max_iterations_; }
+  uint64_t seed() const { return seed_; }
+
+  /// Synchronous (Jacobi-style) label propagation. Every round, each node
+  /// adopts the label with the largest total incident edge weight among its
+  /// neighbors, reading only the labels computed in the previous round. The
+  /// result is deterministic for a given seed regardless of the number of
+  /// threads.
+  static LabelPropagationPlan Synchronous(
+      uint32_t max_iterations = kMaxIterations, uint64_t seed = kDefaultSeed) {
+    return {kCPU, kSynchronous, max_iterations, seed};
+  }
+
+  /// Asynchronous (Gauss-Seidel-style) label propagation. Labels are updated
+  /// in place and each round only re-evaluates the frontier of nodes that
+  /// have at least one neighbor whose label changed in the previous round.
+  /// Converges in far fewer edge visits than Synchronous, but the result may
+  /// depend on the thread schedule.
+  static LabelPropagationPlan Asynchronous(
+      uint32_t max_iterations = kMaxIterations, uint64_t seed = kDefaultSeed) {
+    return {kCPU, kAsynchronous, max_iterations, seed};
+  }
+};
+
+/// Compute communities of pg using label propagation. The pg is expected to
+/// be symmetric.
+/// The edge weights are taken from the property named
+/// edge_weight_property_name (which may be a 32- or 64-bit sign or unsigned
+/// int, or a float or double). If edge_weight_property_name is empty, every
+/// edge has weight 1.
+/// Ties between equally heavy labels are broken by a hash of the label and
+/// the plan's seed. The computed community ids are stored in the property
+/// named output_property_name (as uint64_t); every community id is the node
+/// id of some node in the graph.
+/// The property named output_property_name is created by this function and may
+/// not exist before the call.
+KATANA_EXPORT Result<void> LabelPropagation(
+    PropertyGraph* pg, const std::string& edge_weight_property_name,
+    const std::string& output_property_name,
+    LabelPropagationPlan plan = LabelPropagationPlan());
+
+KATANA_EXPORT Result<void> LabelPropagationAssertValid(
+    PropertyGraph* pg, const std::string& property_name);
+
+struct KATANA_EXPORT LabelPropagationStatistics {
+  /// Total number of unique communities in the graph.
+  uint64_t total_communities;
+  /// Total number of communities with more than 1 node.
+  uint64_t total_non_trivial_communities;
+  /// The number of nodes present in the largest community.
+  uint64_t largest_community_size;
+  /// The ratio of nodes present in the largest community.
+  double largest_community_ratio;
+
+  /// Print the statistics in a human readable form.
+  void Print(std::ostream& os = std::cout) const;
+
+  static katana::Result<LabelPropagationStatistics> Compute(
+      katana::PropertyGraph* pg, const std::string& property_name);
+};
+
+}  // namespace katana::analytics
+
+#endif
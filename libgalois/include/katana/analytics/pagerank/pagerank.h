@@ -2,6 +2,7 @@
 #define KATANA_LIBGALOIS_KATANA_ANALYTICS_PAGERANK_PAGERANK_H_
 
 #include <iostream>
+#include <vector>
 
 #include "katana/Properties.h"
 #include "katana/PropertyGraph.h"
@@ -105,6 +106,100 @@ public:
   }
 };
 
+/// A computational plan for Personalized Page Rank, specifying the algorithm
+/// and any parameters associated with it. Personalized Page Rank teleports
+/// back to a set of seed nodes instead of to every node of the graph.
+class PersonalizedPagerankPlan : public Plan {
+public:
+  enum Algorithm {
+    kForwardPush,
+    kPowerIteration,
+  };
+
+  static constexpr double kDefaultEpsilon = 1.0e-4;
+  static constexpr double kDefaultTolerance = 1.0e-6;
+  static const int kDefaultMaxIterations = 1000;
+  static constexpr double kDefaultAlpha = 0.85;
+  static const uint32_t kDefaultBatchSize = 16;
+  static const uint32_t kMaxBatchSize = 64;
+
+  // Don't allow people to directly construct these, so as to have only one
+  // consistent way to configure.
+private:
+  Algorithm algorithm_;
+  // Residual threshold per unit of out-degree for kForwardPush
+  float epsilon_;
+  // L1 change per personalization vector that ends kPowerIteration
+  float tolerance_;
+  unsigned int max_iterations_;
+  float alpha_;
+  // Number of personalization vectors of one edge sweep for kPowerIteration
+  uint32_t batch_size_;
+
+  PersonalizedPagerankPlan(
+      Architecture architecture, Algorithm algorithm, float epsilon,
+      float tolerance, unsigned int max_iterations, float alpha,
+      uint32_t batch_size)
+      : Plan(architecture),
+        algorithm_(algorithm),
+        epsilon_(epsilon),
+        tolerance_(tolerance),
+        max_iterations_(max_iterations),
+        alpha_(alpha),
+        batch_size_(batch_size) {}
+
+public:
+  PersonalizedPagerankPlan()
+      : PersonalizedPagerankPlan{
+            kCPU, kForwardPush, kDefaultEpsilon, kDefaultTolerance,
+            kDefaultMaxIterations, kDefaultAlpha, kDefaultBatchSize} {}
+
+  Algorithm algorithm() const { return algorithm_; }
+  float epsilon() const { return epsilon_; }
+  float tolerance() const { return tolerance_; }
+  unsigned int max_iterations() const { return max_iterations_; }
+  float alpha() const { return alpha_; }
+  uint32_t batch_size() const { return batch_size_; }
+
+  /// Approximate forward push (Andersen, Chung and Lang). A node pushes its
+  /// residual to its out-neighbors while the residual is at least epsilon
+  /// times its out-degree, so only the neighborhood of the seeds is touched:
+  /// the work per personalization vector is O(1 / (epsilon * (1 - alpha)))
+  /// independently of the size of the graph. Ranks and residuals live in
+  /// per-thread sparse maps and independent seeds run in parallel.
+  ///
+  /// ANDERSEN, Reid; CHUNG, Fan; LANG, Kevin. Local graph partitioning using
+  /// pagerank vectors. In: 47th Annual IEEE Symposium on Foundations of
+  /// Computer Science (FOCS'06). IEEE, 2006. p. 475-486.
+  static PersonalizedPagerankPlan ForwardPush(
+      float epsilon = kDefaultEpsilon, float alpha = kDefaultAlpha) {
+    return {
+        kCPU, kForwardPush, epsilon, kDefaultTolerance, kDefaultMaxIterations,
+        alpha, kDefaultBatchSize};
+  }
+
+  /// Exact power iteration over batch_size personalization vectors at once.
+  /// The ranks of a node for every vector of the batch are contiguous, so each
+  /// iteration pulls along every in-edge once for the whole batch (a sparse
+  /// matrix times dense matrix product). Builds the transpose of the graph
+  /// once per call.
+  static PersonalizedPagerankPlan PowerIteration(
+      float tolerance = kDefaultTolerance,
+      unsigned int max_iterations = kDefaultMaxIterations,
+      float alpha = kDefaultAlpha, uint32_t batch_size = kDefaultBatchSize) {
+    return {
+        kCPU, kPowerIteration, kDefaultEpsilon, tolerance, max_iterations,
+        alpha, batch_size};
+  }
+};
+
+/// The personalized ranks of one seed, as parallel arrays ordered by
+/// decreasing rank. Nodes with a zero rank are left out.
+struct KATANA_EXPORT PersonalizedPagerankVector {
+  std::vector<uint32_t> nodes;
+  std::vector<float> ranks;
+};
+
 /// Compute the Page Rank of each node in the graph.
 /// The property named output_property_name is created by this function and may
 /// not exist before the call.
@@ -112,6 +207,23 @@ KATANA_EXPORT Result<void> Pagerank(
     PropertyGraph* pg, const std::string& output_property_name,
     PagerankPlan plan = {});
 
+/// Compute the Page Rank of each node in the graph personalized to the seed
+/// nodes: every random-walk restart jumps to one of the seeds chosen
+/// uniformly. The property named output_property_name is created by this
+/// function and may not exist before the call.
+KATANA_EXPORT Result<void> PersonalizedPagerank(
+    PropertyGraph* pg, const std::vector<uint32_t>& seeds,
+    const std::string& output_property_name,
+    PersonalizedPagerankPlan plan = {});
+
+/// Compute one independent Personalized Page Rank vector per seed. The i-th
+/// result holds the top_k highest ranked nodes for seeds[i], or every node
+/// with a non-zero rank if top_k is 0.
+KATANA_EXPORT Result<std::vector<PersonalizedPagerankVector>>
+PersonalizedPagerankBatch(
+    PropertyGraph* pg, const std::vector<uint32_t>& seeds, uint32_t top_k = 0,
+    PersonalizedPagerankPlan plan = {});
+
 KATANA_EXPORT Result<void> PagerankAssertValid(
     PropertyGraph* pg, const std::string& property_name);
 
@@ -2,6 +2,7 @@
 #define KATANA_LIBGALOIS_KATANA_ANALYTICS_SSSP_SSSP_H_
 
 #include <iostream>
+#include <limits>
 
 #include "katana/AtomicHelpers.h"
 #include "katana/analytics/Plan.h"
@@ -25,11 +26,24 @@ public:
     kDijkstra,
     kTopological,
     kTopologicalTile,
+    kMultiQueue,
     kAutomatic,
   };
 
   static const int kDefaultDelta = 13;
   static const int kDefaultEdgeTileSize = 512;
+  /// Passing this as delta makes the algorithm choose delta from a sample of
+  /// the edge weights. The parallel delta stepping algorithms without
+  /// barriers also let their worklist adjust it, and its chunk size, while
+  /// they run, based on how work is pushed to and popped from its buckets.
+  static const unsigned kAdaptiveDelta = std::numeric_limits<unsigned>::max();
+  /// Maximum number of items a thread keeps processing from its own bucket
+  /// before returning the rest of its work to the shared worklist. Bucket
+  /// fusion is off unless a plan asks for it.
+  static const unsigned kDefaultFusionThreshold = 0;
+  /// Fusion threshold of the adaptive plans, i.e., those with kAdaptiveDelta
+  /// that sssp-cli -adaptiveDelta and the plan tuner make
+  static const unsigned kAdaptiveFusionThreshold = 1000;
 
   // Don't allow people to directly construct these, so as to have only one
   // consistent way to configure.
@@ -37,6 +51,7 @@ private:
   Algorithm algorithm_;
   unsigned delta_;
   ptrdiff_t edge_tile_size_;
+  unsigned fusion_threshold_;
   // TODO: should chunk_size be in the plan? Or fixed?
   //  It cannot be in the plan currently because it is a template parameter and
   //  cannot be easily changed since the value is statically passed on to
@@ -45,11 +60,12 @@ private:
 
   SsspPlan(
       Architecture architecture, Algorithm algorithm, unsigned delta,
-      ptrdiff_t edge_tile_size)
+      ptrdiff_t edge_tile_size, unsigned fusion_threshold = 0)
       : Plan(architecture),
         algorithm_(algorithm),
         delta_(delta),
-        edge_tile_size_(edge_tile_size) {}
+        edge_tile_size_(edge_tile_size),
+        fusion_threshold_(fusion_threshold) {}
 
 public:
   SsspPlan() : SsspPlan{kCPU, kAutomatic, 0, 0} {}
@@ -66,21 +82,33 @@ public:
   Algorithm algorithm() const { return algorithm_; }
 
   /// The exponent of the delta step size (2 based). A delta of 4 will produce a real delta step size of 16.
+  /// kAdaptiveDelta if the algorithm chooses delta itself.
   unsigned delta() const { return delta_; }
+  bool adaptive_delta() const { return delta_ == kAdaptiveDelta; }
   ptrdiff_t edge_tile_size() const { return edge_tile_size_; }
+  /// Bucket fusion threshold of the parallel delta stepping algorithms. A
+  /// thread processes the work it generates for its current bucket itself,
+  /// up to this many items, instead of pushing it to the shared worklist. 0
+  /// disables bucket fusion.
+  unsigned fusion_threshold() const { return fusion_threshold_; }
 
   static SsspPlan DeltaTile(
       unsigned delta = kDefaultDelta,
-      ptrdiff_t edge_tile_size = kDefaultEdgeTileSize) {
-    return {kCPU, kDeltaTile, delta, edge_tile_size};
+      ptrdiff_t edge_tile_size = kDefaultEdgeTileSize,
+      unsigned fusion_threshold = kDefaultFusionThreshold) {
+    return {kCPU, kDeltaTile, delta, edge_tile_size, fusion_threshold};
   }
 
-  static SsspPlan DeltaStep(unsigned delta = kDefaultDelta) {
-    return {kCPU, kDeltaStep, delta, 0};
+  static SsspPlan DeltaStep(
+      unsigned delta = kDefaultDelta,
+      unsigned fusion_threshold = kDefaultFusionThreshold) {
+    return {kCPU, kDeltaStep, delta, 0, fusion_threshold};
   }
 
-  static SsspPlan DeltaStepBarrier(unsigned delta = kDefaultDelta) {
-    return {kCPU, kDeltaStepBarrier, delta, 0};
+  static SsspPlan DeltaStepBarrier(
+      unsigned delta = kDefaultDelta,
+      unsigned fusion_threshold = kDefaultFusionThreshold) {
+    return {kCPU, kDeltaStepBarrier, delta, 0, fusion_threshold};
   }
 
   static SsspPlan SerialDeltaTile(
@@ -106,6 +134,12 @@ public:
       ptrdiff_t edge_tile_size = kDefaultEdgeTileSize) {
     return {kCPU, kTopologicalTile, 0, edge_tile_size};
   }
+
+  /// Asynchronous SSSP on a \ref katana::MultiQueue, which processes
+  /// requests in approximate order of their distance and so needs no delta.
+  static SsspPlan MultiQueue(unsigned fusion_threshold = 0) {
+    return {kCPU, kMultiQueue, 0, 0, fusion_threshold};
+  }
 };
 
 /// Compute the Single-Source Shortest Path for pg starting from start_node.
@@ -1,6 +1,9 @@
 #ifndef KATANA_LIBGALOIS_KATANA_ANALYTICS_SUBGRAPHEXTRACTION_SUBGRAPHEXTRACTION_H_
 #define KATANA_LIBGALOIS_KATANA_ANALYTICS_SUBGRAPHEXTRACTION_SUBGRAPHEXTRACTION_H_
 
+#include <functional>
+#include <limits>
+
 #include "katana/PropertyGraph.h"
 #include "katana/analytics/Plan.h"
 
@@ -13,42 +16,142 @@ class SubGraphExtractionPlan : public Plan {
 public:
   enum Algorithm {
     kNodeSet,
+    kKHop,
   };
 
+  static const uint32_t kDefaultNumHops = 1;
+
 private:
   Algorithm algorithm_;
+  uint32_t num_hops_;
 
-  SubGraphExtractionPlan(Architecture architecture, Algorithm algorithm)
-      : Plan(architecture), algorithm_(algorithm) {}
+  SubGraphExtractionPlan(
+      Architecture architecture, Algorithm algorithm, uint32_t num_hops)
+      : Plan(architecture), algorithm_(algorithm), num_hops_(num_hops) {}
 
 public:
-  SubGraphExtractionPlan() : SubGraphExtractionPlan{kCPU, kNodeSet} {}
+  SubGraphExtractionPlan() : SubGraphExtractionPlan{kCPU, kNodeSet, 0} {}
 
   Algorithm algorithm() const { return algorithm_; }
+  uint32_t num_hops() const { return num_hops_; }
 
   /**
    * The node-set algorithm:
    *    Given a set of node ids, this algorithm constructs a new sub-graph
    *    connecting all the nodes in the set along with the properties requested.
    */
-  static SubGraphExtractionPlan NodeSet() { return {kCPU, kNodeSet}; }
+  static SubGraphExtractionPlan NodeSet() { return {kCPU, kNodeSet, 0}; }
+
+  /**
+   * The k-hop algorithm:
+   *    Given a set of seed node ids, this algorithm constructs the sub-graph
+   *    induced by every node reachable from a seed by following at most
+   *    num_hops out-edges.
+   */
+  static SubGraphExtractionPlan KHop(uint32_t num_hops = kDefaultNumHops) {
+    return {kCPU, kKHop, num_hops};
+  }
+};
+
+/// The properties carried over from the original graph to an extracted
+/// sub-graph, and the names of the id mapping properties to create.
+struct KATANA_EXPORT SubGraphExtractionProperties {
+  /// Copy every node property; node_properties is ignored.
+  bool all_node_properties{false};
+  /// Names of the node properties to copy.
+  std::vector<std::string> node_properties;
+  /// Copy every edge property; edge_properties is ignored.
+  bool all_edge_properties{false};
+  /// Names of the edge properties to copy.
+  std::vector<std::string> edge_properties;
+  /// If not empty, a uint32_t node property with this name is added to the
+  /// sub-graph holding, for each sub-graph node, its id in the original graph.
+  std::string original_id_property;
+  /// If not empty, a uint32_t node property with this name is added to the
+  /// original graph holding, for each node, its id in the sub-graph. Nodes
+  /// that are not part of the sub-graph have kNotInSubGraph.
+  std::string subgraph_id_property;
+
+  static constexpr uint32_t kNotInSubGraph =
+      std::numeric_limits<uint32_t>::max();
+
+  /// Copy every node and edge property.
+  static SubGraphExtractionProperties All() {
+    SubGraphExtractionProperties p;
+    p.all_node_properties = true;
+    p.all_edge_properties = true;
+    return p;
+  }
 };
 
 /**
  * Construct a new sub-graph from the original graph.
  *
  * By default only topology of the sub-graph is constructed.
- * The new sub-graph is independent of the original graph.
+ * The new sub-graph is independent of the original graph. Nodes of the
+ * sub-graph are numbered in the order of their ids in the original graph.
+ *
+ * @param pg The graph to process.
+ * @param node_vec Set of node ids (or seed node ids for the k-hop algorithm)
+ * @param plan
+ */
+KATANA_EXPORT katana::Result<std::unique_ptr<katana::PropertyGraph>>
+SubGraphExtraction(
+    katana::PropertyGraph* pg, const std::vector<uint32_t>& node_vec,
+    SubGraphExtractionPlan plan = {});
+
+/**
+ * Construct a new sub-graph from the original graph, copying the requested
+ * node and edge properties.
  *
  * @param pg The graph to process.
- * @param node_vec Set of node ids
+ * @param node_vec Set of node ids (or seed node ids for the k-hop algorithm)
+ * @param properties The properties to carry over and id mappings to create
  * @param plan
  */
 KATANA_EXPORT katana::Result<std::unique_ptr<katana::PropertyGraph>>
 SubGraphExtraction(
     katana::PropertyGraph* pg, const std::vector<uint32_t>& node_vec,
+    const SubGraphExtractionProperties& properties,
     SubGraphExtractionPlan plan = {});
-// const std::vector<std::string>& node_properties_to_copy, const std::vector<std::string>& edge_properties_to_copy);
+
+/**
+ * Construct the sub-graph induced by the nodes for which node_predicate
+ * returns true.
+ *
+ * The predicate is called concurrently from many threads. To select by a node
+ * property, capture the property array, e.g.,
+ *
+ *     auto tenant = pg->GetNodePropertyTyped<uint32_t>("tenant").value();
+ *     SubGraphExtractionByNodePredicate(
+ *         pg, [&](uint32_t n) { return tenant->Value(n) == 7; }, props);
+ *
+ * @param pg The graph to process.
+ * @param node_predicate Returns true for the nodes to keep
+ * @param properties The properties to carry over and id mappings to create
+ */
+KATANA_EXPORT katana::Result<std::unique_ptr<katana::PropertyGraph>>
+SubGraphExtractionByNodePredicate(
+    katana::PropertyGraph* pg,
+    const std::function<bool(GraphTopology::Node)>& node_predicate,
+    const SubGraphExtractionProperties& properties = {});
+
+/**
+ * Construct the sub-graph made of the edges for which edge_predicate returns
+ * true and of the nodes incident to at least one of those edges.
+ *
+ * The predicate is called concurrently from many threads with edge ids of the
+ * original graph.
+ *
+ * @param pg The graph to process.
+ * @param edge_predicate Returns true for the edges to keep
+ * @param properties The properties to carry over and id mappings to create
+ */
+KATANA_EXPORT katana::Result<std::unique_ptr<katana::PropertyGraph>>
+SubGraphExtractionByEdgePredicate(
+    katana::PropertyGraph* pg,
+    const std::function<bool(GraphTopology::Edge)>& edge_predicate,
+    const SubGraphExtractionProperties& properties = {});
 
 }  // namespace katana::analytics
 
@@ -0,0 +1,157 @@
+#include "katana/ArrowMemoryPool.h"
+
+#include <algorithm>
+#include <cstring>
+#include <limits>
+
+#include "katana/PageAlloc.h"
+#include "katana/Statistics.h"
+
+namespace {
+
+size_t
+NumPages(int64_t size) {
+  return (size + katana::allocSize() - 1) / katana::allocSize();
+}
+
+}  // namespace
+
+katana::ArrowMemoryPool*
+katana::ArrowMemoryPool::Default() {
+  // Never destroyed: buffers from the pool may be freed during static
+  // destruction
+  static auto* pool = new ArrowMemoryPool("ArrowMemoryPool");
+  return pool;
+}
+
+katana::ArrowMemoryPool::ArrowMemoryPool(
+    std::string name, NumaPlacement placement, arrow::MemoryPool* small_pool)
+    : name_(std::move(name)), placement_(placement), small_pool_(small_pool) {}
+
+bool
+katana::ArrowMemoryPool::IsHuge(int64_t size) const {
+  return static_cast<size_t>(size) >= allocSize();
+}
+
+uint8_t*
+katana::ArrowMemoryPool::AllocateHuge(int64_t size) {
+  size_t num_pages = NumPages(size);
+  if (num_pages > std::numeric_limits<unsigned>::max()) {
+    return nullptr;
+  }
+  auto* data = static_cast<uint8_t*>(tryAllocPages(num_pages, false));
+  if (!data) {
+    return nullptr;
+  }
+  PlacePages(data, num_pages * allocSize(), placement_, false);
+
+  num_huge_allocations_.fetch_add(1, std::memory_order_relaxed);
+  huge_bytes_mapped_.fetch_add(
+      num_pages * allocSize(), std::memory_order_relaxed);
+  return data;
+}
+
+void
+katana::ArrowMemoryPool::FreeHuge(uint8_t* buffer, int64_t size) {
+  freePages(buffer, NumPages(size));
+}
+
+void
+katana::ArrowMemoryPool::Allocated(int64_t size) {
+  int64_t current =
+      bytes_allocated_.fetch_add(size, std::memory_order_relaxed) + size;
+  int64_t max = max_memory_.load(std::memory_order_relaxed);
+  while (current > max && !max_memory_.compare_exchange_weak(
+                              max, current, std::memory_order_relaxed)) {
+  }
+}
+
+arrow::Status
+katana::ArrowMemoryPool::Allocate(int64_t size, uint8_t** out) {
+  if (size < 0) {
+    return arrow::Status::Invalid("negative allocation size");
+  }
+  if (!IsHuge(size)) {
+    ARROW_RETURN_NOT_OK(small_pool_->Allocate(size, out));
+  } else {
+    uint8_t* data = AllocateHuge(size);
+    if (!data) {
+      return arrow::Status::OutOfMemory(
+          "failed to map ", size, " bytes for ", name_);
+    }
+    *out = data;
+  }
+  num_allocations_.fetch_add(1, std::memory_order_relaxed);
+  Allocated(size);
+  return arrow::Status::OK();
+}
+
+arrow::Status
+katana::ArrowMemoryPool::Reallocate(
+    int64_t old_size, int64_t new_size, uint8_t** ptr) {
+  if (new_size < 0) {
+    return arrow::Status::Invalid("negative allocation size");
+  }
+
+  bool old_huge = IsHuge(old_size);
+  bool new_huge = IsHuge(new_size);
+  if (!old_huge && !new_huge) {
+    ARROW_RETURN_NOT_OK(small_pool_->Reallocate(old_size, new_size, ptr));
+  } else if (old_huge && new_huge && NumPages(old_size) == NumPages(new_size)) {
+    // the pages already mapped cover the new size
+  } else {
+    uint8_t* data{};
+    if (new_huge) {
+      data = AllocateHuge(new_size);
+      if (!data) {
+        return arrow::Status::OutOfMemory(
+            "failed to map ", new_size, " bytes for ", name_);
+      }
+    } else {
+      ARROW_RETURN_NOT_OK(small_pool_->Allocate(new_size, &data));
+    }
+    std::memcpy(data, *ptr, std::min(old_size, new_size));
+    if (old_huge) {
+      FreeHuge(*ptr, old_size);
+    } else {
+      small_pool_->Free(*ptr, old_size);
+    }
+    *ptr = data;
+  }
+  Allocated(new_size - old_size);
+  return arrow::Status::OK();
+}
+
+void
+katana::ArrowMemoryPool::Free(uint8_t* buffer, int64_t size) {
+  if (IsHuge(size)) {
+    FreeHuge(buffer, size);
+  } else {
+    small_pool_->Free(buffer, size);
+  }
+  bytes_allocated_.fetch_sub(size, std::memory_order_relaxed);
+}
+
+int64_t
+katana::ArrowMemoryPool::bytes_allocated() const {
+  return bytes_allocated_.load(std::memory_order_relaxed);
+}
+
+int64_t
+katana::ArrowMemoryPool::max_memory() const {
+  return max_memory_.load(std::memory_order_relaxed);
+}
+
+std::string
+katana::ArrowMemoryPool::backend_name() const {
+  return "katana";
+}
+
+void
+katana::ArrowMemoryPool::ReportStats() const {
+  ReportStatSingle(name_, "Allocations", num_allocations_.load());
+  ReportStatSingle(name_, "HugeAllocations", num_huge_allocations_.load());
+  ReportStatSingle(name_, "HugePageBytes", huge_bytes_mapped_.load());
+  ReportStatSingle(name_, "MaxBytesAllocated", max_memory());
+  ReportStatSingle(name_, "BytesAllocated", bytes_allocated());
+}
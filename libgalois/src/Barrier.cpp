@@ -19,6 +19,7 @@
 
 #include "katana/Barrier.h"
 
+#include "katana/ExecutorContext.h"
 #include "katana/Logging.h"
 #include "katana/ThreadPool.h"
 
@@ -48,6 +49,10 @@ katana::GetBarrier(unsigned active_threads) {
       std::min(active_threads, GetThreadPool().getMaxUsableThreads());
   active_threads = std::max(active_threads, 1U);
 
+  if (Barrier* barrier = internal::ContextBarrier(active_threads)) {
+    return *barrier;
+  }
+
   if (active_threads != kBarrierThreads) {
     kBarrierThreads = active_threads;
     kBarrier->Reinit(kBarrierThreads);
@@ -40,8 +40,19 @@ class TopoBarrier : public katana::Barrier {
   };
 
   katana::PerSocketStorage<TreeNode> nodes_;
+  // Threads of a last level cache domain other than the one of the socket
+  // leader gather at the first thread of their domain, which alone reports
+  // to the socket, so that arrival and release cross caches once per domain
+  // rather than once per thread. Only the nodes of such cache leaders are
+  // used.
+  katana::PerThreadStorage<TreeNode> cacheNodes_;
   katana::PerThreadStorage<unsigned> sense_;
 
+  //! does tid gather the threads of its cache domain for the socket
+  static bool isCacheRoot(katana::ThreadPool& tp, unsigned tid) {
+    return tp.isCacheLeader(tid) && !tp.isLeader(tid);
+  }
+
   void _reinit(unsigned P) {
     auto& tp = katana::GetThreadPool();
     unsigned pkgs = tp.getCumulativeMaxSocket(P - 1) + 1;
@@ -56,7 +67,12 @@ class TopoBarrier : public katana::Barrier {
         }
       }
       for (unsigned j = 0; j < P; ++j) {
-        if (tp.getSocket(j) == i && !tp.isLeader(j)) {
+        if (tp.getSocket(j) != i || tp.isLeader(j)) {
+          continue;
+        }
+        // cache roots and the threads sharing the cache of the leader
+        // report to the socket directly
+        if (isCacheRoot(tp, j) || tp.isLeader(tp.getCacheLeader(j))) {
           ++n.child_not_ready;
           ++n.have_child;
         }
@@ -70,6 +86,19 @@ class TopoBarrier : public katana::Barrier {
     }
     for (unsigned i = 0; i < P; ++i) {
       *sense_.getRemote(i) = 1;
+      if (!isCacheRoot(tp, i)) {
+        continue;
+      }
+      TreeNode& c = *cacheNodes_.getRemote(i);
+      c.child_not_ready = 0;
+      c.have_child = 0;
+      for (unsigned j = i + 1; j < P; ++j) {
+        if (tp.getCacheLeader(j) == i) {
+          ++c.child_not_ready;
+          ++c.have_child;
+        }
+      }
+      c.parent_sense = 0;
     }
   }
 
@@ -84,6 +113,15 @@ public:
     TreeNode& n = *nodes_.getLocal();
     unsigned& s = *sense_.getLocal();
     bool leader = katana::ThreadPool::isLeader();
+    unsigned cacheLeader = katana::ThreadPool::getCacheLeader();
+    bool cacheRoot = !leader && cacheLeader == id;
+    // node this thread reports to and waits on when it is not a leader
+    TreeNode* up = &n;
+    if (!leader && !cacheRoot &&
+        cacheLeader != katana::ThreadPool::getLeader()) {
+      up = cacheNodes_.getRemote(cacheLeader);
+    }
+
     // completion tree
     if (leader) {
       while (n.child_not_ready) {
@@ -93,17 +131,29 @@ public:
       if (n.parent_pointer) {
         --n.parent_pointer->child_not_ready;
       }
-    } else {
+    } else if (cacheRoot) {
+      TreeNode& c = *cacheNodes_.getLocal();
+      while (c.child_not_ready) {
+        katana::asmPause();
+      }
+      c.child_not_ready = c.have_child;
       --n.child_not_ready;
+    } else {
+      --up->child_not_ready;
     }
 
     // wait for signal
     if (id != 0) {
-      while (n.parent_sense != s) {
+      while (up->parent_sense != s) {
         katana::asmPause();
       }
     }
 
+    // release the rest of the cache domain
+    if (cacheRoot) {
+      cacheNodes_.getLocal()->parent_sense = s;
+    }
+
     // signal children in wakeup tree
     if (leader) {
       if (n.child_pointers[0]) {
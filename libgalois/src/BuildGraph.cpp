@@ -1,6 +1,8 @@
 #include "katana/BuildGraph.h"
 
 #include <algorithm>
+#include <atomic>
+#include <charconv>
 #include <cstdint>
 #include <cstdlib>
 #include <deque>
@@ -11,12 +13,14 @@
 #include <optional>
 #include <random>
 #include <sstream>
+#include <string_view>
 #include <unordered_map>
 #include <unordered_set>
 #include <vector>
 
 #include <arrow/api.h>
 #include <arrow/array.h>
+#include <arrow/compute/api.h>
 #include <arrow/io/api.h>
 #include <boost/algorithm/string.hpp>
 #include <boost/foreach.hpp>
@@ -27,6 +31,7 @@
 #include "katana/ArrowInterchange.h"
 #include "katana/ErrorCode.h"
 #include "katana/Galois.h"
+#include "katana/IdDictionary.h"
 #include "katana/Logging.h"
 #include "katana/ParallelSTL.h"
 #include "katana/PropertyGraph.h"
@@ -97,7 +102,7 @@ AddNullArrays(
     std::unordered_map<int, std::shared_ptr<arrow::Array>>* null_map,
     std::unordered_map<int, std::shared_ptr<arrow::Array>>* lists_null_map,
     size_t elts) {
-  auto* pool = arrow::default_memory_pool();
+  auto* pool = katana::DefaultArrowMemoryPool();
 
   // the builder types are still added for the list types since the list type is
   // extraneous info
@@ -123,7 +128,7 @@ AddNullArrays(
     std::unordered_map<int, std::shared_ptr<arrow::Array>>* null_map,
     std::unordered_map<int, std::shared_ptr<arrow::Array>>* lists_null_map,
     size_t elts, std::shared_ptr<arrow::DataType> type) {
-  auto* pool = arrow::default_memory_pool();
+  auto* pool = katana::DefaultArrowMemoryPool();
 
   // the builder types are still added for the list types since the list type is
   // extraneous info
@@ -930,7 +935,7 @@ ArrowArrays
 RearrangeListArray(
     const std::shared_ptr<arrow::ChunkedArray>& list_chunked_array,
     const std::vector<size_t>& mapping, WriterProperties* properties) {
-  auto* pool = arrow::default_memory_pool();
+  auto* pool = katana::DefaultArrowMemoryPool();
   ArrowArrays chunks;
   auto list_type =
       std::static_pointer_cast<arrow::BaseListType>(list_chunked_array->type())
@@ -1064,7 +1069,7 @@ RearrangeTable(
         }
         case arrow::Type::TIMESTAMP: {
           auto tb = std::make_shared<arrow::TimestampBuilder>(
-              array->type(), arrow::default_memory_pool());
+              array->type(), katana::DefaultArrowMemoryPool());
           ca = RearrangeArray<arrow::TimestampBuilder, arrow::TimestampArray>(
               tb, array, mapping, properties);
           break;
@@ -1148,6 +1153,185 @@ BuildImportVec(
   return array;
 }
 
+/**********************************************************/
+/* Functions for merging builders of parts of one dataset */
+/**********************************************************/
+
+// An empty column of type with length rows: nulls for properties, falses for
+// labels
+std::shared_ptr<arrow::Array>
+MakeEmptyColumn(
+    const std::shared_ptr<arrow::DataType>& type, size_t length, bool labels) {
+  if (!labels) {
+    auto res = arrow::MakeArrayOfNull(type, length);
+    if (!res.ok()) {
+      KATANA_LOG_FATAL(
+          "Error building arrow null array: {}", res.status().ToString());
+    }
+    return res.ValueOrDie();
+  }
+  auto builder = std::make_shared<arrow::BooleanBuilder>();
+  if (auto st = builder->AppendValues(length, false); !st.ok()) {
+    KATANA_LOG_FATAL(
+        "Error appending to an arrow array builder: {}", st.ToString());
+  }
+  return BuildArray(builder);
+}
+
+// Split column into chunks of chunk_size rows, the layout the builders
+// produce; chunks are sliced without copying where possible
+std::shared_ptr<arrow::ChunkedArray>
+Rechunk(const std::shared_ptr<arrow::ChunkedArray>& column, size_t chunk_size) {
+  const ArrowArrays& chunks = column->chunks();
+  auto length = static_cast<int64_t>(chunk_size);
+  bool aligned = chunks.empty() || chunks.back()->length() <= length;
+  for (size_t i = 0; aligned && i + 1 < chunks.size(); ++i) {
+    aligned = chunks[i]->length() == length;
+  }
+  if (aligned) {
+    return column;
+  }
+
+  std::shared_ptr<arrow::Array> whole;
+  if (chunks.size() == 1) {
+    whole = chunks[0];
+  } else {
+    auto res = arrow::Concatenate(chunks);
+    if (!res.ok()) {
+      KATANA_LOG_FATAL(
+          "Error concatenating arrow arrays: {}", res.status().ToString());
+    }
+    whole = res.ValueOrDie();
+  }
+  ArrowArrays sliced;
+  for (int64_t offset = 0; offset < whole->length(); offset += length) {
+    sliced.emplace_back(whole->Slice(offset, length));
+  }
+  return std::make_shared<arrow::ChunkedArray>(sliced, column->type());
+}
+
+// Line up the columns of states by field name, in the order in which names
+// first appear. A state missing a column contributes an empty column of its
+// length, and extra_rows empty rows are appended to every column.
+template <typename State>
+std::pair<ArrowFields, ChunkedArrays>
+MergeColumns(
+    const std::vector<State*>& states, const std::vector<size_t>& lengths,
+    size_t extra_rows, bool labels, size_t chunk_size) {
+  ArrowFields fields;
+  std::unordered_map<std::string, size_t> field_indexes;
+  // field_columns[f][k] is the column of field f in states[k], if any
+  std::vector<std::vector<std::optional<size_t>>> field_columns;
+  for (size_t k = 0; k < states.size(); ++k) {
+    const ArrowFields& schema = states[k]->schema;
+    for (size_t i = 0; i < schema.size(); ++i) {
+      auto [it, inserted] =
+          field_indexes.emplace(schema[i]->name(), fields.size());
+      if (inserted) {
+        fields.emplace_back(schema[i]);
+        field_columns.emplace_back(states.size());
+      } else if (!fields[it->second]->type()->Equals(schema[i]->type())) {
+        KATANA_LOG_FATAL(
+            "column {} has types {} and {} in different parts of the input",
+            schema[i]->name(), fields[it->second]->type()->ToString(),
+            schema[i]->type()->ToString());
+      }
+      field_columns[it->second][k] = i;
+    }
+  }
+
+  ChunkedArrays columns(fields.size());
+  katana::do_all(
+      katana::iterate(static_cast<size_t>(0), fields.size()),
+      [&](const size_t& f) {
+        const auto& type = fields[f]->type();
+        ArrowArrays arrays;
+        for (size_t k = 0; k < states.size(); ++k) {
+          if (auto i = field_columns[f][k]; i) {
+            const ArrowArrays& chunks = states[k]->chunks[*i];
+            arrays.insert(arrays.end(), chunks.begin(), chunks.end());
+          } else if (lengths[k] > 0) {
+            arrays.emplace_back(MakeEmptyColumn(type, lengths[k], labels));
+          }
+        }
+        if (extra_rows > 0) {
+          arrays.emplace_back(MakeEmptyColumn(type, extra_rows, labels));
+        }
+        columns[f] = Rechunk(
+            std::make_shared<arrow::ChunkedArray>(arrays, type), chunk_size);
+      });
+  return std::make_pair(std::move(fields), std::move(columns));
+}
+
+// Reorder the rows of every column so that row i is old row mapping[i]
+ChunkedArrays
+TakeColumns(
+    const ChunkedArrays& columns, const std::vector<size_t>& mapping,
+    size_t chunk_size) {
+  static_assert(sizeof(size_t) == sizeof(uint64_t));
+  std::shared_ptr<arrow::Array> indices = std::make_shared<arrow::UInt64Array>(
+      mapping.size(), arrow::Buffer::Wrap(mapping));
+  ChunkedArrays taken(columns.size());
+  katana::do_all(
+      katana::iterate(static_cast<size_t>(0), columns.size()),
+      [&](const size_t& n) {
+        auto res = arrow::compute::Take(columns[n], indices);
+        if (!res.ok()) {
+          KATANA_LOG_FATAL(
+              "Error reordering arrow column: {}", res.status().ToString());
+        }
+        taken[n] = Rechunk(res.ValueOrDie().chunked_array(), chunk_size);
+      });
+  return taken;
+}
+
+std::shared_ptr<arrow::Table>
+MakeTable(ArrowFields fields, const ChunkedArrays& columns, size_t rows) {
+  return arrow::Table::Make(
+      arrow::schema(std::move(fields)), columns, static_cast<int64_t>(rows));
+}
+
+/// Make the local_to_user_id array of merged nodes if every node has a
+/// distinct ID that is an unsigned integer; returns nullptr otherwise
+std::shared_ptr<arrow::ChunkedArray>
+MakeNumericUserIds(
+    const katana::IdDictionary<std::string_view>& index,
+    const std::unordered_map<std::string, size_t>& placeholders,
+    size_t num_nodes) {
+  std::vector<uint64_t> ids(num_nodes);
+  std::atomic<size_t> num_ids{0};
+  std::atomic<bool> numeric{true};
+  auto parse = [&](std::string_view id, size_t node) {
+    uint64_t value;
+    const char* end = id.data() + id.size();
+    auto res = std::from_chars(id.data(), end, value);
+    if (res.ec != std::errc() || res.ptr != end) {
+      numeric.store(false, std::memory_order_relaxed);
+      return;
+    }
+    ids[node] = value;
+    num_ids.fetch_add(1, std::memory_order_relaxed);
+  };
+  index.ForEach(parse);
+  for (const auto& [id, node] : placeholders) {
+    parse(id, node);
+  }
+  // nodes without an ID or with a duplicate one are not counted
+  if (num_nodes == 0 || !numeric || num_ids != num_nodes) {
+    return nullptr;
+  }
+
+  arrow::UInt64Builder builder;
+  std::shared_ptr<arrow::Array> array;
+  if (auto st = builder.AppendValues(ids); !st.ok()) {
+    KATANA_LOG_FATAL("Error building user IDs: {}", st);
+  }
+  if (auto st = builder.Finish(&array); !st.ok()) {
+    KATANA_LOG_FATAL("Error building user IDs: {}", st);
+  }
+  return std::make_shared<arrow::ChunkedArray>(array);
+}
+
 }  // end of unnamed namespace
 
 katana::PropertyGraphBuilder::PropertyGraphBuilder(size_t chunk_size)
@@ -1427,7 +1611,7 @@ katana::PropertyGraphBuilder::AddBuilder(const PropertyKey& key) {
   PropertiesState* properties =
       key.for_node ? &node_properties_ : &edge_properties_;
 
-  auto* pool = arrow::default_memory_pool();
+  auto* pool = katana::DefaultArrowMemoryPool();
   if (!key.is_list) {
     switch (key.type) {
     case ImportDataType::kString: {
@@ -1788,6 +1972,221 @@ katana::PropertyGraphBuilder::Finish(bool verbose) {
   return katana::GraphComponents{nodes_tables, edges_tables, topology};
 }
 
+katana::GraphComponents
+katana::PropertyGraphBuilder::Merge(
+    std::vector<PropertyGraphBuilder>* builders, bool verbose) {
+  size_t num_builders = builders->size();
+  KATANA_LOG_ASSERT(num_builders > 0);
+  size_t chunk_size = builders->front().properties_.chunk_size;
+
+  // add buffered rows and even out the columns of each builder
+  std::vector<size_t> node_offsets(num_builders + 1, 0);
+  std::vector<size_t> edge_offsets(num_builders + 1, 0);
+  for (size_t k = 0; k < num_builders; ++k) {
+    PropertyGraphBuilder& b = builders->at(k);
+    EvenOutChunkBuilders(
+        &b.node_properties_.builders, &b.node_properties_.chunks,
+        &b.properties_, b.nodes_);
+    EvenOutChunkBuilders(
+        &b.node_labels_.builders, &b.node_labels_.chunks, &b.properties_,
+        b.nodes_);
+    EvenOutChunkBuilders(
+        &b.edge_properties_.builders, &b.edge_properties_.chunks,
+        &b.properties_, b.edges_);
+    EvenOutChunkBuilders(
+        &b.edge_types_.builders, &b.edge_types_.chunks, &b.properties_,
+        b.edges_);
+    KATANA_LOG_ASSERT(b.topology_builder_.sources.size() == b.edges_);
+    node_offsets[k + 1] = node_offsets[k] + b.nodes_;
+    edge_offsets[k + 1] = edge_offsets[k] + b.edges_;
+  }
+  size_t num_nodes = node_offsets[num_builders];
+  size_t num_edges = edge_offsets[num_builders];
+
+  // index node IDs across builders; the earliest builder wins on duplicates
+  // as it would when adding all nodes to one builder. Keys point into the
+  // builders' own maps, which outlive the index.
+  size_t num_ids = 0;
+  for (const PropertyGraphBuilder& b : *builders) {
+    num_ids += b.topology_builder_.node_indexes.size();
+  }
+  katana::IdDictionary<std::string_view> index(num_ids);
+  katana::do_all(
+      katana::iterate(static_cast<size_t>(0), num_builders),
+      [&](const size_t& k) {
+        for (const auto& [id, i] :
+             builders->at(k).topology_builder_.node_indexes) {
+          index.Insert(id, i + node_offsets[k]);
+        }
+      },
+      katana::steal(), katana::chunk_size<1>());
+
+  auto find_node = [&](const std::string& id) -> std::optional<size_t> {
+    return index.Find(id);
+  };
+
+  // translate edge endpoints to global node indexes
+  std::vector<uint32_t> sources(num_edges);
+  std::vector<uint32_t> destinations(num_edges);
+  std::vector<std::vector<std::pair<size_t, std::string>>> missing_sources(
+      num_builders);
+  std::vector<std::vector<std::pair<size_t, std::string>>> missing_dests(
+      num_builders);
+  katana::do_all(
+      katana::iterate(static_cast<size_t>(0), num_builders),
+      [&](const size_t& k) {
+        const TopologyState& topology = builders->at(k).topology_builder_;
+        size_t base = edge_offsets[k];
+        // endpoints that were unresolved in the builder are overwritten below
+        for (size_t e = 0; e < topology.sources.size(); ++e) {
+          sources[base + e] = topology.sources[e] + node_offsets[k];
+          destinations[base + e] = topology.destinations[e] + node_offsets[k];
+        }
+        for (const auto& [e, id] : topology.sources_intermediate) {
+          if (auto index = find_node(id); index) {
+            sources[base + e] = *index;
+          } else {
+            missing_sources[k].emplace_back(base + e, id);
+          }
+        }
+        for (const auto& [e, id] : topology.destinations_intermediate) {
+          if (auto index = find_node(id); index) {
+            destinations[base + e] = *index;
+          } else {
+            missing_dests[k].emplace_back(base + e, id);
+          }
+        }
+      });
+
+  // create empty nodes for IDs that no builder added, as Finish does
+  std::unordered_map<std::string, size_t> placeholders;
+  auto add_placeholder = [&](const std::string& id) {
+    auto [it, inserted] =
+        placeholders.emplace(id, num_nodes + placeholders.size());
+    if (inserted && verbose) {
+      std::cout << "Adding placeholder node: " << id << "\n";
+    }
+    return it->second;
+  };
+  for (size_t k = 0; k < num_builders; ++k) {
+    for (const auto& [e, id] : missing_dests[k]) {
+      destinations[e] = add_placeholder(id);
+    }
+    for (const auto& [e, id] : missing_sources[k]) {
+      sources[e] = add_placeholder(id);
+    }
+  }
+  size_t num_placeholders = placeholders.size();
+  size_t total_nodes = num_nodes + num_placeholders;
+  if (total_nodes > std::numeric_limits<uint32_t>::max()) {
+    KATANA_LOG_FATAL("too many nodes: {}", total_nodes);
+  }
+  // keep the input's node IDs as user IDs when they are all integers
+  std::shared_ptr<arrow::ChunkedArray> user_ids =
+      MakeNumericUserIds(index, placeholders, total_nodes);
+  placeholders.clear();
+
+  // build CSR, keeping the input order of the edges of each node
+  std::vector<uint64_t> out_indices(total_nodes, 0);
+  for (uint32_t src : sources) {
+    out_indices[src]++;
+  }
+  katana::ParallelSTL::partial_sum(
+      out_indices.begin(), out_indices.end(), out_indices.begin());
+
+  std::vector<uint32_t> out_dests(num_edges);
+  std::vector<size_t> edge_mapping(num_edges);
+  std::vector<uint64_t> offsets(total_nodes, 0);
+  for (size_t e = 0; e < num_edges; ++e) {
+    uint32_t src = sources[e];
+    uint64_t i = (src ? out_indices[src - 1] : 0) + offsets[src]++;
+    out_dests[i] = destinations[e];
+    edge_mapping[i] = e;
+  }
+  sources.clear();
+  destinations.clear();
+  offsets.clear();
+
+  // line up columns and release the builders' copies as each kind is done
+  std::vector<size_t> node_lengths(num_builders);
+  std::vector<size_t> edge_lengths(num_builders);
+  std::vector<PropertiesState*> node_properties(num_builders);
+  std::vector<LabelsState*> node_labels(num_builders);
+  std::vector<PropertiesState*> edge_properties(num_builders);
+  std::vector<LabelsState*> edge_types(num_builders);
+  for (size_t k = 0; k < num_builders; ++k) {
+    PropertyGraphBuilder& b = builders->at(k);
+    node_lengths[k] = b.nodes_;
+    edge_lengths[k] = b.edges_;
+    node_properties[k] = &b.node_properties_;
+    node_labels[k] = &b.node_labels_;
+    edge_properties[k] = &b.edge_properties_;
+    edge_types[k] = &b.edge_types_;
+  }
+
+  auto [node_prop_fields, node_prop_columns] = MergeColumns(
+      node_properties, node_lengths, num_placeholders, false, chunk_size);
+  auto [node_label_fields, node_label_columns] = MergeColumns(
+      node_labels, node_lengths, num_placeholders, true, chunk_size);
+  auto [edge_prop_fields, edge_prop_columns] =
+      MergeColumns(edge_properties, edge_lengths, 0, false, chunk_size);
+  auto [edge_type_fields, edge_type_columns] =
+      MergeColumns(edge_types, edge_lengths, 0, true, chunk_size);
+  builders->clear();
+
+  GraphComponent nodes_tables{
+      MakeTable(node_prop_fields, node_prop_columns, total_nodes),
+      MakeTable(node_label_fields, node_label_columns, total_nodes)};
+  node_prop_columns.clear();
+  node_label_columns.clear();
+
+  // rearrange edges to match implicit edge IDs
+  GraphComponent edges_tables{
+      MakeTable(
+          edge_prop_fields,
+          TakeColumns(edge_prop_columns, edge_mapping, chunk_size), num_edges),
+      MakeTable(
+          edge_type_fields,
+          TakeColumns(edge_type_columns, edge_mapping, chunk_size), num_edges)};
+  edge_prop_columns.clear();
+  edge_type_columns.clear();
+
+  auto topology = std::make_shared<katana::GraphTopology>();
+  arrow::UInt64Builder topology_indices_builder;
+  arrow::UInt32Builder topology_dests_builder;
+  if (auto st = topology_indices_builder.AppendValues(out_indices);
+      !st.ok()) {
+    KATANA_LOG_FATAL("Error building topology");
+  }
+  if (auto st = topology_dests_builder.AppendValues(out_dests); !st.ok()) {
+    KATANA_LOG_FATAL("Error building topology");
+  }
+  if (auto st = topology_indices_builder.Finish(&topology->out_indices);
+      !st.ok()) {
+    KATANA_LOG_FATAL("Error building arrow array for topology");
+  }
+  if (auto st = topology_dests_builder.Finish(&topology->out_dests);
+      !st.ok()) {
+    KATANA_LOG_FATAL("Error building arrow array for topology");
+  }
+
+  if (verbose) {
+    std::cout << "Merged " << num_builders << " parts\n";
+    std::cout << "Nodes: " << topology->out_indices->length() << "\n";
+    std::cout << "Node Properties: " << nodes_tables.properties->num_columns()
+              << "\n";
+    std::cout << "Node Labels: " << nodes_tables.labels->num_columns() << "\n";
+    std::cout << "Edges: " << topology->out_dests->length() << "\n";
+    std::cout << "Edge Properties: " << edges_tables.properties->num_columns()
+              << "\n";
+    std::cout << "Edge Types: " << edges_tables.labels->num_columns() << "\n";
+  }
+
+  katana::GraphComponents components{nodes_tables, edges_tables, topology};
+  components.user_ids = std::move(user_ids);
+  return components;
+}
+
 std::unique_ptr<katana::PropertyGraph>
 katana::MakeGraph(const katana::GraphComponents& graph_comps) {
   auto graph = std::make_unique<katana::PropertyGraph>();
@@ -1820,6 +2219,10 @@ katana::MakeGraph(const katana::GraphComponents& graph_comps) {
       KATANA_LOG_FATAL("Error adding edge types: {}", result.error());
     }
   }
+  if (graph_comps.user_ids) {
+    auto user_ids = graph_comps.user_ids;
+    graph->set_local_to_user_id(std::move(user_ids));
+  }
   return graph;
 }
 
@@ -1985,7 +2388,7 @@ ToArrowArray(
     break;
   }
   case arrow::Type::TIMESTAMP: {
-    auto* pool = arrow::default_memory_pool();
+    auto* pool = katana::DefaultArrowMemoryPool();
     arrow::TimestampBuilder builder(
         arrow::timestamp(arrow::TimeUnit::NANO, "UTC"), pool);
     arrow_dst = BuildImportVec<arrow::TimestampBuilder, bool>(
@@ -0,0 +1,203 @@
+#include "katana/ExecutorContext.h"
+
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <thread>
+
+#include "katana/Barrier.h"
+#include "katana/ErrorCode.h"
+#include "katana/PerThreadStorage.h"
+#include "katana/TerminationDetection.h"
+#include "katana/ThreadPool.h"
+#include "katana/Threads.h"
+
+namespace {
+
+thread_local katana::ExecutorContext* current_context = nullptr;
+
+// Serializes reserving and releasing threads of the system thread pool
+std::mutex partition_mutex;
+
+}  // namespace
+
+struct katana::ExecutorContext::Impl {
+  ThreadPool* root{};
+  unsigned begin{};
+  unsigned num_threads{};
+  std::unique_ptr<ThreadPool> pool;
+
+  // Owned by the master thread
+  std::unique_ptr<Barrier> barrier;
+  unsigned barrier_threads{};
+  std::unique_ptr<TerminationDetection> term;
+  unsigned active_threads{};
+
+  std::mutex mutex;
+  std::condition_variable cv;
+  std::deque<std::function<void()>> jobs;
+  bool stop{false};
+  std::promise<void> ready;
+  std::thread master;
+};
+
+katana::Result<std::unique_ptr<katana::ExecutorContext>>
+katana::ExecutorContext::Make(unsigned num_threads) {
+  if (num_threads == 0) {
+    return KATANA_ERROR(
+        ErrorCode::InvalidArgument, "a context needs at least one thread");
+  }
+  if (Current()) {
+    return KATANA_ERROR(
+        ErrorCode::InvalidArgument, "contexts cannot be nested");
+  }
+
+  std::lock_guard<std::mutex> lock(partition_mutex);
+  ThreadPool& root = GetThreadPool();
+  if (root.isRunning()) {
+    return KATANA_ERROR(
+        ErrorCode::InvalidArgument,
+        "contexts cannot be created during a parallel loop");
+  }
+  // reserved threads must not be left spinning in fast mode
+  root.beKind();
+
+  unsigned begin = root.reserveThreads(num_threads);
+  if (begin == 0) {
+    return KATANA_ERROR(
+        ErrorCode::InvalidArgument,
+        "cannot reserve {} threads: the system thread pool has {} threads of "
+        "which {} are reserved",
+        num_threads, root.getMaxThreads(),
+        root.getMaxThreads() - root.getMaxUsableThreads());
+  }
+  if (getActiveThreads() > root.getMaxUsableThreads()) {
+    setActiveThreads(root.getMaxUsableThreads());
+  }
+
+  auto impl = std::make_unique<Impl>();
+  impl->root = &root;
+  impl->begin = begin;
+  impl->num_threads = num_threads;
+  impl->active_threads = num_threads;
+  impl->pool.reset(new ThreadPool(root, begin, num_threads));
+
+  std::unique_ptr<ExecutorContext> ctx(new ExecutorContext(std::move(impl)));
+  return std::unique_ptr<ExecutorContext>(std::move(ctx));
+}
+
+katana::ExecutorContext::ExecutorContext(std::unique_ptr<Impl> impl)
+    : impl_(std::move(impl)) {
+  std::future<void> ready = impl_->ready.get_future();
+  impl_->master = std::thread(&ExecutorContext::MasterLoop, this);
+  ready.wait();
+}
+
+katana::ExecutorContext::~ExecutorContext() {
+  {
+    std::lock_guard<std::mutex> lock(impl_->mutex);
+    impl_->stop = true;
+  }
+  impl_->cv.notify_one();
+  impl_->master.join();
+
+  std::lock_guard<std::mutex> lock(partition_mutex);
+  impl_->pool.reset();
+  impl_->root->releaseThreads(impl_->begin);
+}
+
+void
+katana::ExecutorContext::MasterLoop() {
+  Impl& impl = *impl_;
+
+  // Take the place of thread begin of the system pool, which stays parked
+  // while the context exists
+  impl.pool->initPartitionMaster();
+  ptsBase = getPTSBackend().getHead(impl.begin);
+  pssBase = getPPSBackend().getHead(impl.begin);
+  current_context = this;
+  impl.pool->run(impl.num_threads, [this]() { current_context = this; });
+
+  impl.barrier = CreateTopoBarrier(impl.num_threads);
+  impl.barrier_threads = impl.num_threads;
+  impl.term = internal::CreateTerminationDetection();
+  impl.ready.set_value();
+
+  while (true) {
+    std::function<void()> job;
+    {
+      std::unique_lock<std::mutex> lock(impl.mutex);
+      impl.cv.wait(lock, [&impl]() { return impl.stop || !impl.jobs.empty(); });
+      if (impl.jobs.empty()) {
+        break;
+      }
+      job = std::move(impl.jobs.front());
+      impl.jobs.pop_front();
+    }
+    job();
+  }
+
+  impl.pool->beKind();
+  impl.pool->run(impl.num_threads, []() { current_context = nullptr; });
+  impl.term.reset();
+  impl.barrier.reset();
+  current_context = nullptr;
+}
+
+void
+katana::ExecutorContext::Enqueue(std::function<void()> job) {
+  {
+    std::lock_guard<std::mutex> lock(impl_->mutex);
+    impl_->jobs.emplace_back(std::move(job));
+  }
+  impl_->cv.notify_one();
+}
+
+unsigned
+katana::ExecutorContext::num_threads() const {
+  return impl_->num_threads;
+}
+
+katana::ExecutorContext*
+katana::ExecutorContext::Current() {
+  return current_context;
+}
+
+bool
+katana::internal::ContextSetActiveThreads(unsigned num) {
+  if (!current_context) {
+    return false;
+  }
+  current_context->impl_->active_threads = num;
+  return true;
+}
+
+bool
+katana::internal::ContextGetActiveThreads(unsigned* num) {
+  if (!current_context) {
+    return false;
+  }
+  *num = current_context->impl_->active_threads;
+  return true;
+}
+
+katana::Barrier*
+katana::internal::ContextBarrier(unsigned active_threads) {
+  if (!current_context) {
+    return nullptr;
+  }
+  ExecutorContext::Impl& impl = *current_context->impl_;
+  if (impl.barrier_threads != active_threads) {
+    impl.barrier_threads = active_threads;
+    impl.barrier->Reinit(active_threads);
+  }
+  return impl.barrier.get();
+}
+
+katana::TerminationDetection*
+katana::internal::ContextTerminationDetection() {
+  if (!current_context) {
+    return nullptr;
+  }
+  return current_context->impl_->term.get();
+}
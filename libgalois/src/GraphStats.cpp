@@ -0,0 +1,545 @@
+#include "katana/GraphStats.h"
+
+#include <algorithm>
+#include <atomic>
+#include <functional>
+#include <limits>
+
+#include <arrow/compute/api.h>
+#include <arrow/type_traits.h>
+
+#include "katana/Bag.h"
+#include "katana/ErrorCode.h"
+#include "katana/Galois.h"
+#include "katana/LargeArray.h"
+#include "katana/Logging.h"
+#include "katana/PerThreadStorage.h"
+#include "katana/Reduction.h"
+#include "katana/Timer.h"
+
+namespace {
+
+using Node = katana::GraphTopology::Node;
+
+// degrees below this are counted exactly so that typical medians are exact
+constexpr uint64_t kExactDegrees = 1024;
+constexpr size_t kNumLog2Bins = 65;
+constexpr Node kUnvisited = std::numeric_limits<Node>::max();
+
+size_t
+Log2Bin(uint64_t degree) {
+  size_t bin = 0;
+  while (degree != 0) {
+    degree >>= 1;
+    ++bin;
+  }
+  return bin;
+}
+
+/// Per-thread counts of degrees
+struct DegreeCounts {
+  std::vector<uint64_t> exact = std::vector<uint64_t>(kExactDegrees, 0);
+  std::vector<uint64_t> log2 = std::vector<uint64_t>(kNumLog2Bins, 0);
+  uint64_t min{std::numeric_limits<uint64_t>::max()};
+  uint64_t max{0};
+
+  void Add(uint64_t degree) {
+    if (degree < kExactDegrees) {
+      exact[degree]++;
+    }
+    log2[Log2Bin(degree)]++;
+    min = std::min(min, degree);
+    max = std::max(max, degree);
+  }
+
+  void Merge(const DegreeCounts& other) {
+    for (size_t i = 0; i < exact.size(); ++i) {
+      exact[i] += other.exact[i];
+    }
+    for (size_t i = 0; i < log2.size(); ++i) {
+      log2[i] += other.log2[i];
+    }
+    min = std::min(min, other.min);
+    max = std::max(max, other.max);
+  }
+};
+
+katana::DegreeDistribution
+MakeDistribution(
+    const DegreeCounts& counts, uint64_t num_nodes, uint64_t num_edges) {
+  katana::DegreeDistribution dist;
+  if (num_nodes == 0) {
+    return dist;
+  }
+  dist.min = counts.min;
+  dist.max = counts.max;
+  dist.mean = static_cast<double>(num_edges) / num_nodes;
+  dist.num_zero = counts.log2[0];
+
+  size_t last_bin = Log2Bin(counts.max);
+  dist.log2_histogram.assign(
+      counts.log2.begin(), counts.log2.begin() + last_bin + 1);
+
+  uint64_t num_nonzero = num_nodes - dist.num_zero;
+  if (num_nonzero == 0) {
+    return dist;
+  }
+  // rank of the median among nodes of nonzero degree, counted as in
+  // analytics::IsApproximateDegreeDistributionPowerLaw
+  uint64_t rank = num_nonzero / 2;
+  for (uint64_t d = 1; d < kExactDegrees; ++d) {
+    if (rank < counts.exact[d]) {
+      dist.nonzero_median = d;
+      return dist;
+    }
+    rank -= counts.exact[d];
+  }
+  for (size_t bin = Log2Bin(kExactDegrees); bin <= last_bin; ++bin) {
+    if (rank < counts.log2[bin]) {
+      uint64_t low = UINT64_C(1) << (bin - 1);
+      double fraction = static_cast<double>(rank) / counts.log2[bin];
+      dist.nonzero_median = low + static_cast<uint64_t>(fraction * low);
+      return dist;
+    }
+    rank -= counts.log2[bin];
+  }
+  dist.nonzero_median = counts.max;
+  return dist;
+}
+
+/// Lock-free union-find over nodes; components are hooked onto their
+/// smallest node
+class UnionFind {
+  katana::LargeArray<std::atomic<Node>> parents_;
+
+public:
+  explicit UnionFind(uint64_t num_nodes) {
+    parents_.allocateBlocked(num_nodes);
+    katana::do_all(
+        katana::iterate(uint64_t{0}, num_nodes),
+        [&](uint64_t n) { parents_[n].store(n, std::memory_order_relaxed); },
+        katana::no_stats());
+  }
+
+  Node Find(Node n) {
+    while (true) {
+      Node parent = parents_[n].load(std::memory_order_relaxed);
+      if (parent == n) {
+        return n;
+      }
+      Node grandparent = parents_[parent].load(std::memory_order_relaxed);
+      if (parent != grandparent) {
+        // path halving
+        parents_[n].compare_exchange_weak(
+            parent, grandparent, std::memory_order_relaxed);
+      }
+      n = grandparent;
+    }
+  }
+
+  void Unite(Node a, Node b) {
+    while (true) {
+      a = Find(a);
+      b = Find(b);
+      if (a == b) {
+        return;
+      }
+      if (a < b) {
+        std::swap(a, b);
+      }
+      Node expected = a;
+      if (parents_[a].compare_exchange_strong(
+              expected, b, std::memory_order_relaxed)) {
+        return;
+      }
+    }
+  }
+
+  bool IsRoot(Node n) const {
+    return parents_[n].load(std::memory_order_relaxed) == n;
+  }
+};
+
+/// Breadth-first search from source
+///
+/// \returns the eccentricity of source and a node at that distance
+std::pair<uint64_t, Node>
+Sweep(
+    const katana::GraphTopology& topology, Node source,
+    katana::LargeArray<std::atomic<Node>>* levels) {
+  const uint32_t* dests = topology.out_dests->raw_values();
+  katana::do_all(
+      katana::iterate(uint64_t{0}, topology.num_nodes()),
+      [&](uint64_t n) {
+        (*levels)[n].store(kUnvisited, std::memory_order_relaxed);
+      },
+      katana::no_stats());
+  (*levels)[source].store(0, std::memory_order_relaxed);
+
+  katana::InsertBag<Node> frontiers[2];
+  frontiers[0].push(source);
+  uint64_t level = 0;
+  Node farthest = source;
+  for (size_t cur = 0; true; cur ^= 1) {
+    katana::InsertBag<Node>& next = frontiers[cur ^ 1];
+    katana::do_all(
+        katana::iterate(frontiers[cur]),
+        [&](Node n) {
+          auto [begin, end] = topology.edge_range(n);
+          for (auto e = begin; e < end; ++e) {
+            Node expected = kUnvisited;
+            if ((*levels)[dests[e]].compare_exchange_strong(
+                    expected, static_cast<Node>(level + 1),
+                    std::memory_order_relaxed)) {
+              next.push(dests[e]);
+            }
+          }
+        },
+        katana::steal(), katana::no_stats());
+    if (next.empty()) {
+      break;
+    }
+    ++level;
+    farthest = *next.begin();
+    frontiers[cur].clear();
+  }
+  return std::make_pair(level, farthest);
+}
+
+std::optional<double>
+ScalarToDouble(const std::shared_ptr<arrow::Scalar>& scalar) {
+  if (!scalar->is_valid) {
+    return std::nullopt;
+  }
+  auto cast_res = arrow::compute::Cast(scalar, arrow::float64());
+  if (!cast_res.ok()) {
+    return std::nullopt;
+  }
+  return std::static_pointer_cast<arrow::DoubleScalar>(
+             cast_res.ValueOrDie().scalar())
+      ->value;
+}
+
+katana::Result<katana::ColumnSummary>
+SummarizeColumn(const std::shared_ptr<arrow::ChunkedArray>& column) {
+  katana::ColumnSummary summary;
+  summary.type = column->type()->ToString();
+  summary.null_count = column->null_count();
+  if (!arrow::is_numeric(column->type()->id()) ||
+      column->null_count() == column->length()) {
+    return summary;
+  }
+
+  auto min_max_res = arrow::compute::CallFunction("min_max", {column});
+  if (!min_max_res.ok()) {
+    return KATANA_ERROR(
+        katana::ErrorCode::ArrowError, "computing min and max: {}",
+        min_max_res.status());
+  }
+  auto min_max = std::static_pointer_cast<arrow::StructScalar>(
+      min_max_res.ValueOrDie().scalar());
+  summary.min = ScalarToDouble(min_max->value[0]);
+  summary.max = ScalarToDouble(min_max->value[1]);
+  return summary;
+}
+
+/// Summarize the columns of schema that are not in summaries already
+katana::Result<void>
+SummarizeColumns(
+    const std::shared_ptr<arrow::Schema>& schema,
+    const std::function<std::shared_ptr<arrow::ChunkedArray>(int)>& column,
+    std::map<std::string, katana::ColumnSummary>* summaries) {
+  std::map<std::string, katana::ColumnSummary> current;
+  for (int i = 0; i < schema->num_fields(); ++i) {
+    const std::string& name = schema->field(i)->name();
+    if (auto it = summaries->find(name); it != summaries->end()) {
+      current.emplace(name, std::move(it->second));
+      continue;
+    }
+    auto res = SummarizeColumn(column(i));
+    if (!res) {
+      return res.error().WithContext("column {}", name);
+    }
+    current.emplace(name, std::move(res.value()));
+  }
+  // drops summaries of removed columns
+  *summaries = std::move(current);
+  return katana::ResultSuccess();
+}
+
+katana::Result<katana::GraphStats>
+ComputeTopologyStats(const katana::GraphTopology& topology) {
+  katana::GraphStats stats;
+  const uint64_t num_nodes = topology.num_nodes();
+  const uint64_t num_edges = topology.num_edges();
+  stats.num_nodes = num_nodes;
+  stats.num_edges = num_edges;
+  if (num_nodes == 0) {
+    return stats;
+  }
+  if (num_nodes > std::numeric_limits<Node>::max()) {
+    return KATANA_ERROR(
+        katana::ErrorCode::InvalidArgument, "too many nodes: {}", num_nodes);
+  }
+  const uint32_t* dests = topology.out_dests->raw_values();
+
+  katana::LargeArray<std::atomic<uint64_t>> in_degrees;
+  in_degrees.allocateBlocked(num_nodes);
+  katana::do_all(
+      katana::iterate(uint64_t{0}, num_nodes),
+      [&](uint64_t n) { in_degrees[n].store(0, std::memory_order_relaxed); },
+      katana::no_stats());
+  UnionFind components(num_nodes);
+
+  katana::PerThreadStorage<DegreeCounts> out_counts;
+  katana::PerThreadStorage<std::vector<Node>> scratch;
+  katana::GAccumulator<uint64_t> self_loops;
+  katana::GAccumulator<uint64_t> duplicates;
+  katana::GAccumulator<uint64_t> unsorted;
+  // (degree, node) of the node of largest degree seen by each thread
+  katana::PerThreadStorage<std::pair<uint64_t, Node>> max_degree_nodes;
+
+  katana::do_all(
+      katana::iterate(uint64_t{0}, num_nodes),
+      [&](uint64_t node) {
+        Node n = node;
+        auto [begin, end] = topology.edge_range(n);
+        uint64_t degree = end - begin;
+        out_counts.getLocal()->Add(degree);
+        std::pair<uint64_t, Node>& max_degree_node =
+            *max_degree_nodes.getLocal();
+        if (degree > max_degree_node.first) {
+          max_degree_node = std::make_pair(degree, n);
+        }
+
+        bool sorted = true;
+        uint64_t node_duplicates = 0;
+        for (auto e = begin; e < end; ++e) {
+          Node dst = dests[e];
+          if (dst == n) {
+            self_loops += 1;
+          }
+          in_degrees[dst].fetch_add(1, std::memory_order_relaxed);
+          if (e == begin) {
+            components.Unite(n, dst);
+            continue;
+          }
+          Node prev = dests[e - 1];
+          if (dst < prev) {
+            sorted = false;
+          } else if (dst == prev) {
+            ++node_duplicates;
+            continue;
+          }
+          components.Unite(n, dst);
+        }
+        if (!sorted) {
+          unsorted += 1;
+          std::vector<Node>& sorted_dests = *scratch.getLocal();
+          sorted_dests.assign(dests + begin, dests + end);
+          std::sort(sorted_dests.begin(), sorted_dests.end());
+          node_duplicates = (end - begin) -
+                            (std::unique(
+                                 sorted_dests.begin(), sorted_dests.end()) -
+                             sorted_dests.begin());
+        }
+        duplicates += node_duplicates;
+      },
+      katana::steal(), katana::loopname("GraphStats"));
+
+  katana::PerThreadStorage<DegreeCounts> in_counts;
+  katana::GAccumulator<uint64_t> roots;
+  katana::do_all(
+      katana::iterate(uint64_t{0}, num_nodes),
+      [&](uint64_t n) {
+        uint64_t degree = in_degrees[n].load(std::memory_order_relaxed);
+        in_counts.getLocal()->Add(degree);
+        if (components.IsRoot(n)) {
+          roots += 1;
+        }
+      },
+      katana::loopname("GraphStatsInDegrees"));
+
+  DegreeCounts out_total;
+  DegreeCounts in_total;
+  std::pair<uint64_t, Node> max_degree_node{0, 0};
+  for (unsigned i = 0; i < katana::getActiveThreads(); ++i) {
+    out_total.Merge(*out_counts.getRemote(i));
+    in_total.Merge(*in_counts.getRemote(i));
+    max_degree_node = std::max(max_degree_node, *max_degree_nodes.getRemote(i));
+  }
+  stats.out_degree = MakeDistribution(out_total, num_nodes, num_edges);
+  stats.in_degree = MakeDistribution(in_total, num_nodes, num_edges);
+  stats.num_self_loops = self_loops.reduce();
+  stats.num_duplicate_edges = duplicates.reduce();
+  stats.num_unsorted_nodes = unsorted.reduce();
+  stats.num_components = roots.reduce();
+
+  katana::LargeArray<std::atomic<Node>> levels;
+  levels.allocateBlocked(num_nodes);
+  auto [first_ecc, farthest] =
+      Sweep(topology, max_degree_node.second, &levels);
+  auto [second_ecc, ignored] = Sweep(topology, farthest, &levels);
+  stats.approximate_diameter = std::max(first_ecc, second_ecc);
+
+  return stats;
+}
+
+}  // namespace
+
+void
+katana::to_json(nlohmann::json& j, const DegreeDistribution& dist) {
+  j = nlohmann::json{
+      {"min", dist.min},
+      {"max", dist.max},
+      {"mean", dist.mean},
+      {"num_zero", dist.num_zero},
+      {"nonzero_median", dist.nonzero_median},
+      {"log2_histogram", dist.log2_histogram},
+  };
+}
+
+void
+katana::from_json(const nlohmann::json& j, DegreeDistribution& dist) {
+  j.at("min").get_to(dist.min);
+  j.at("max").get_to(dist.max);
+  j.at("mean").get_to(dist.mean);
+  j.at("num_zero").get_to(dist.num_zero);
+  j.at("nonzero_median").get_to(dist.nonzero_median);
+  j.at("log2_histogram").get_to(dist.log2_histogram);
+}
+
+void
+katana::to_json(nlohmann::json& j, const ColumnSummary& summary) {
+  j = nlohmann::json{
+      {"type", summary.type},
+      {"null_count", summary.null_count},
+  };
+  if (summary.min) {
+    j["min"] = *summary.min;
+  }
+  if (summary.max) {
+    j["max"] = *summary.max;
+  }
+}
+
+void
+katana::from_json(const nlohmann::json& j, ColumnSummary& summary) {
+  j.at("type").get_to(summary.type);
+  j.at("null_count").get_to(summary.null_count);
+  summary.min.reset();
+  summary.max.reset();
+  if (auto it = j.find("min"); it != j.end()) {
+    summary.min = it->get<double>();
+  }
+  if (auto it = j.find("max"); it != j.end()) {
+    summary.max = it->get<double>();
+  }
+}
+
+void
+katana::to_json(nlohmann::json& j, const GraphStats& stats) {
+  j = nlohmann::json{
+      {"num_nodes", stats.num_nodes},
+      {"num_edges", stats.num_edges},
+      {"out_degree", stats.out_degree},
+      {"in_degree", stats.in_degree},
+      {"num_self_loops", stats.num_self_loops},
+      {"num_duplicate_edges", stats.num_duplicate_edges},
+      {"num_unsorted_nodes", stats.num_unsorted_nodes},
+      {"num_components", stats.num_components},
+      {"approximate_diameter", stats.approximate_diameter},
+      {"node_columns", stats.node_columns},
+      {"edge_columns", stats.edge_columns},
+  };
+}
+
+void
+katana::from_json(const nlohmann::json& j, GraphStats& stats) {
+  j.at("num_nodes").get_to(stats.num_nodes);
+  j.at("num_edges").get_to(stats.num_edges);
+  j.at("out_degree").get_to(stats.out_degree);
+  j.at("in_degree").get_to(stats.in_degree);
+  j.at("num_self_loops").get_to(stats.num_self_loops);
+  j.at("num_duplicate_edges").get_to(stats.num_duplicate_edges);
+  j.at("num_unsorted_nodes").get_to(stats.num_unsorted_nodes);
+  j.at("num_components").get_to(stats.num_components);
+  j.at("approximate_diameter").get_to(stats.approximate_diameter);
+  j.at("node_columns").get_to(stats.node_columns);
+  j.at("edge_columns").get_to(stats.edge_columns);
+}
+
+katana::Result<katana::GraphStats>
+katana::ComputeGraphStats(const PropertyGraph& pg) {
+  katana::StatTimer timer("ComputeGraphStats");
+  timer.start();
+  auto stats_res = ComputeTopologyStats(pg.topology());
+  if (!stats_res) {
+    return stats_res.error();
+  }
+  GraphStats stats = std::move(stats_res.value());
+  if (auto res = SummarizeColumns(
+          pg.node_schema(), [&](int i) { return pg.GetNodeProperty(i); },
+          &stats.node_columns);
+      !res) {
+    return res.error();
+  }
+  if (auto res = SummarizeColumns(
+          pg.edge_schema(), [&](int i) { return pg.GetEdgeProperty(i); },
+          &stats.edge_columns);
+      !res) {
+    return res.error();
+  }
+  timer.stop();
+  return stats;
+}
+
+std::optional<katana::GraphStats>
+katana::CachedGraphStats(const PropertyGraph& pg) {
+  const nlohmann::json& cached = pg.graph_stats();
+  if (cached.is_null()) {
+    return std::nullopt;
+  }
+  GraphStats stats;
+  try {
+    cached.get_to(stats);
+  } catch (const std::exception& exp) {
+    KATANA_LOG_DEBUG("ignoring malformed graph stats: {}", exp.what());
+    return std::nullopt;
+  }
+  // the RDG drops the cache when the topology is replaced, but a graph
+  // built outside of it may still disagree
+  if (stats.num_nodes != pg.num_nodes() || stats.num_edges != pg.num_edges()) {
+    return std::nullopt;
+  }
+  return stats;
+}
+
+katana::Result<katana::GraphStats>
+katana::GetGraphStats(PropertyGraph* pg) {
+  std::optional<GraphStats> cached = CachedGraphStats(*pg);
+  if (!cached) {
+    auto res = ComputeGraphStats(*pg);
+    if (!res) {
+      return res.error();
+    }
+    pg->set_graph_stats(res.value());
+    return res;
+  }
+
+  GraphStats stats = std::move(cached.value());
+  if (auto res = SummarizeColumns(
+          pg->node_schema(), [&](int i) { return pg->GetNodeProperty(i); },
+          &stats.node_columns);
+      !res) {
+    return res.error();
+  }
+  if (auto res = SummarizeColumns(
+          pg->edge_schema(), [&](int i) { return pg->GetEdgeProperty(i); },
+          &stats.edge_columns);
+      !res) {
+    return res.error();
+  }
+  pg->set_graph_stats(stats);
+  return stats;
+}
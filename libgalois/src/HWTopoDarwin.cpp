@@ -56,6 +56,7 @@ makeHWTopo() {
   mti.maxThreads = getIntValue("hw.logicalcpu_max");
   mti.maxCores = getIntValue("hw.physicalcpu_max");
   mti.maxNumaNodes = mti.maxSockets;
+  mti.maxCacheDomains = mti.maxSockets;
 
   std::vector<ThreadTopoInfo> tti;
   tti.reserve(mti.maxThreads);
@@ -72,6 +73,8 @@ makeHWTopo() {
 
   const unsigned threadsPerSocket =
       (mti.maxThreads + mti.maxThreads - 1) / mti.maxSockets;
+  const unsigned logicalPerPhysical =
+      (mti.maxThreads + mti.maxThreads - 1) / mti.maxCores;
 
   // Describe dense configuration first; then, sort logical threads to the
   // back.
@@ -84,12 +87,13 @@ makeHWTopo() {
         .numaNode = socket,
         .osContext = i,
         .osNumaNode = socket,
+        .core = i / logicalPerPhysical,
+        // one last level cache per socket
+        .cacheDomain = socket,
+        .cacheLeader = leader,
     });
   }
 
-  const unsigned logicalPerPhysical =
-      (mti.maxThreads + mti.maxThreads - 1) / mti.maxCores;
-
   std::sort(
       tti.begin(), tti.end(),
       [&](const ThreadTopoInfo& a, const ThreadTopoInfo& b) {
@@ -27,6 +27,7 @@
 #include <memory>
 #include <mutex>
 #include <set>
+#include <string>
 
 #include "katana/HWTopo.h"
 #include "katana/SimpleLock.h"
@@ -51,6 +52,8 @@ struct cpuinfo {
   unsigned coreid;
   unsigned cpucores;
   unsigned numaNode;  // from libnuma
+  unsigned coreKey;   // from sysfs: equal for SMT siblings within a socket
+  unsigned cacheKey;  // from sysfs: equal for sharers of last level cache
   bool valid;         // from cpuset
   bool smt;           // computed
 };
@@ -61,8 +64,10 @@ operator<(const cpuinfo& lhs, const cpuinfo& rhs) {
     return lhs.smt < rhs.smt;
   if (lhs.physid != rhs.physid)
     return lhs.physid < rhs.physid;
-  if (lhs.coreid != rhs.coreid)
-    return lhs.coreid < rhs.coreid;
+  if (lhs.cacheKey != rhs.cacheKey)
+    return lhs.cacheKey < rhs.cacheKey;
+  if (lhs.coreKey != rhs.coreKey)
+    return lhs.coreKey < rhs.coreKey;
   return lhs.proc < rhs.proc;
 }
 
@@ -138,6 +143,59 @@ parseCPUInfo() {
   return vals;
 }
 
+bool
+readFirstLine(const std::string& path, std::string* line) {
+  std::ifstream in(path);
+  return in && std::getline(in, *line);
+}
+
+//! smallest cpu in a sysfs cpu list or -1 if it cannot be read
+int
+readFirstCPU(const std::string& path) {
+  std::string line;
+  if (!readFirstLine(path, &line)) {
+    return -1;
+  }
+  auto cpus = katana::parseCPUList(line);
+  if (cpus.empty()) {
+    return -1;
+  }
+  return *std::min_element(cpus.begin(), cpus.end());
+}
+
+//! Parse SMT siblings and the sharers of the last level cache from
+//! /sys/devices/system/cpu. When these are not available, cores are taken
+//! from /proc/cpuinfo and each socket is assumed to share one cache.
+void
+parseSysfsTopo(std::vector<cpuinfo>& info) {
+  for (auto& c : info) {
+    std::string base = "/sys/devices/system/cpu/cpu" + std::to_string(c.proc);
+
+    int sibling = readFirstCPU(base + "/topology/thread_siblings_list");
+    c.coreKey = sibling < 0 ? c.coreid : sibling;
+
+    c.cacheKey = 0;
+    int maxLevel = 0;
+    for (unsigned index = 0;; ++index) {
+      std::string dir = base + "/cache/index" + std::to_string(index);
+      std::string level;
+      if (!readFirstLine(dir + "/level", &level)) {
+        break;
+      }
+      std::string type;
+      if (readFirstLine(dir + "/type", &type) && type == "Instruction") {
+        continue;
+      }
+      int first = readFirstCPU(dir + "/shared_cpu_list");
+      int l = std::atoi(level.c_str());
+      if (first >= 0 && l > maxLevel) {
+        maxLevel = l;
+        c.cacheKey = first + 1;
+      }
+    }
+  }
+}
+
 unsigned
 countSockets(const std::vector<cpuinfo>& info) {
   std::set<unsigned> pkgs;
@@ -150,10 +208,18 @@ unsigned
 countCores(const std::vector<cpuinfo>& info) {
   std::set<std::pair<int, int>> cores;
   for (auto& c : info)
-    cores.insert(std::make_pair(c.physid, c.coreid));
+    cores.insert(std::make_pair(c.physid, c.coreKey));
   return cores.size();
 }
 
+unsigned
+countCacheDomains(const std::vector<cpuinfo>& info) {
+  std::set<std::pair<int, int>> domains;
+  for (auto& c : info)
+    domains.insert(std::make_pair(c.physid, c.cacheKey));
+  return domains.size();
+}
+
 unsigned
 countNumaNodes(const std::vector<cpuinfo>& info) {
   std::set<unsigned> nodes;
@@ -166,7 +232,7 @@ void
 markSMT(std::vector<cpuinfo>& info) {
   for (unsigned int i = 1; i < info.size(); ++i)
     if (info[i - 1].physid == info[i].physid &&
-        info[i - 1].coreid == info[i].coreid)
+        info[i - 1].coreKey == info[i].coreKey)
       info[i].smt = true;
     else
       info[i].smt = false;
@@ -224,6 +290,7 @@ makeHWTopo() {
   katana::MachineTopoInfo retMTI;
 
   auto info = parseCPUInfo();
+  parseSysfsTopo(info);
   std::sort(info.begin(), info.end());
   markSMT(info);
   markValid(info);
@@ -239,15 +306,20 @@ makeHWTopo() {
   retMTI.maxThreads = info.size();
   retMTI.maxCores = countCores(info);
   retMTI.maxNumaNodes = countNumaNodes(info);
+  retMTI.maxCacheDomains = countCacheDomains(info);
 
   std::vector<katana::ThreadTopoInfo> retTTI;
   retTTI.reserve(retMTI.maxThreads);
   // compute renumberings
   std::set<unsigned> sockets;
   std::set<unsigned> numaNodes;
+  std::set<std::pair<unsigned, unsigned>> cores;
+  std::set<std::pair<unsigned, unsigned>> cacheDomains;
   for (auto& i : info) {
     sockets.insert(i.physid);
     numaNodes.insert(i.numaNode);
+    cores.insert(std::make_pair(i.physid, i.coreKey));
+    cacheDomains.insert(std::make_pair(i.physid, i.cacheKey));
   }
   unsigned mid = 0;  // max socket id
   for (unsigned i = 0; i < info.size(); ++i) {
@@ -260,11 +332,22 @@ makeHWTopo() {
         std::find_if(info.begin(), info.end(), [pid](const cpuinfo& c) {
           return c.physid == pid;
         }));
+    unsigned ckey = info[i].cacheKey;
+    unsigned cacheLeader = std::distance(
+        info.begin(),
+        std::find_if(info.begin(), info.end(), [pid, ckey](const cpuinfo& c) {
+          return c.physid == pid && c.cacheKey == ckey;
+        }));
     retTTI.push_back(katana::ThreadTopoInfo{
         i, leader, repid,
         (unsigned)std::distance(
             numaNodes.begin(), numaNodes.find(info[i].numaNode)),
-        mid, info[i].proc, info[i].numaNode});
+        mid, info[i].proc, info[i].numaNode,
+        (unsigned)std::distance(
+            cores.begin(), cores.find(std::make_pair(pid, info[i].coreKey))),
+        (unsigned)std::distance(
+            cacheDomains.begin(), cacheDomains.find(std::make_pair(pid, ckey))),
+        cacheLeader});
   }
 
   return {
@@ -0,0 +1,77 @@
+#include "katana/IdDictionary.h"
+
+#include <vector>
+
+#include "katana/ErrorCode.h"
+
+katana::Result<std::shared_ptr<arrow::ChunkedArray>>
+katana::MakeUserIdArray(
+    const IdDictionary<uint64_t>& dict, uint64_t num_nodes) {
+  std::vector<uint64_t> ids(num_nodes);
+  std::vector<uint8_t> valid(num_nodes, 0);
+  std::atomic<bool> out_of_range{false};
+  dict.ForEach([&](uint64_t id, uint32_t node) {
+    if (node >= num_nodes) {
+      out_of_range.store(true, std::memory_order_relaxed);
+      return;
+    }
+    ids[node] = id;
+    valid[node] = 1;
+  });
+  if (out_of_range) {
+    return KATANA_ERROR(
+        ErrorCode::InvalidArgument, "dictionary maps to nodes beyond {}",
+        num_nodes);
+  }
+
+  arrow::UInt64Builder builder;
+  if (auto st = builder.AppendValues(ids.data(), num_nodes, valid.data());
+      !st.ok()) {
+    return KATANA_ERROR(
+        ErrorCode::ArrowError, "building user ID array: {}", st);
+  }
+  std::shared_ptr<arrow::Array> array;
+  if (auto st = builder.Finish(&array); !st.ok()) {
+    return KATANA_ERROR(
+        ErrorCode::ArrowError, "building user ID array: {}", st);
+  }
+  return std::make_shared<arrow::ChunkedArray>(array);
+}
+
+katana::Result<katana::IdDictionary<uint64_t>>
+katana::MakeUserIdDictionary(const PropertyGraph& pg) {
+  const std::shared_ptr<arrow::ChunkedArray>& user_ids = pg.local_to_user_id();
+  if (!user_ids || user_ids->length() == 0) {
+    return KATANA_ERROR(ErrorCode::NotFound, "graph has no user IDs");
+  }
+  if (static_cast<uint64_t>(user_ids->length()) != pg.num_nodes()) {
+    return KATANA_ERROR(
+        ErrorCode::InvalidArgument,
+        "number of user IDs {} does not match number of nodes {}",
+        user_ids->length(), pg.num_nodes());
+  }
+  if (user_ids->type()->id() != arrow::Type::UINT64) {
+    return KATANA_ERROR(
+        ErrorCode::InvalidArgument, "user IDs have type {}, expected uint64",
+        user_ids->type()->ToString());
+  }
+
+  IdDictionary<uint64_t> dict(user_ids->length());
+  std::vector<uint64_t> chunk_offsets(user_ids->num_chunks() + 1, 0);
+  for (int i = 0; i < user_ids->num_chunks(); ++i) {
+    chunk_offsets[i + 1] = chunk_offsets[i] + user_ids->chunk(i)->length();
+  }
+  katana::do_all(
+      katana::iterate(0, user_ids->num_chunks()),
+      [&](int i) {
+        auto chunk =
+            std::static_pointer_cast<arrow::UInt64Array>(user_ids->chunk(i));
+        for (int64_t j = 0; j < chunk->length(); ++j) {
+          if (chunk->IsValid(j)) {
+            dict.Insert(chunk->Value(j), chunk_offsets[i] + j);
+          }
+        }
+      },
+      katana::steal(), katana::chunk_size<1>(), katana::no_stats());
+  return dict;
+}
@@ -24,11 +24,12 @@
 
 #include "katana/Executor_OnEach.h"
 #include "katana/Mem.h"
+#include "katana/Threads.h"
 
 void
 katana::Prealloc(size_t pagesPerThread, size_t bytes) {
   size_t size =
-      (pagesPerThread * katana::activeThreads) + (bytes / allocSize());
+      (pagesPerThread * katana::getActiveThreads()) + (bytes / allocSize());
   // If the user requested a non-zero allocation, at the very least
   // allocate a page.
   if (size == 0 && bytes > 0) {
@@ -41,8 +42,8 @@ katana::Prealloc(size_t pagesPerThread, size_t bytes) {
 void
 katana::Prealloc(size_t pages) {
   unsigned pagesPerThread =
-      (pages + katana::activeThreads - 1) / katana::activeThreads;
-  katana::GetThreadPool().run(katana::activeThreads, [=]() {
+      (pages + katana::getActiveThreads() - 1) / katana::getActiveThreads();
+  katana::GetThreadPool().run(katana::getActiveThreads(), [=]() {
     katana::pagePoolPreAlloc(pagesPerThread);
   });
 }
@@ -0,0 +1,105 @@
+#include "katana/NumaBuffer.h"
+
+#include <cstring>
+#include <mutex>
+
+#include <arrow/memory_pool.h>
+
+#include "katana/ArrowInterchange.h"
+#include "katana/ErrorCode.h"
+#include "katana/Loops.h"
+#include "katana/PageAlloc.h"
+#include "katana/ThreadPool.h"
+#include "katana/Threads.h"
+#include "katana/gstl.h"
+
+void
+katana::PlacePages(
+    uint8_t* data, size_t len, NumaPlacement placement, bool zero) {
+  // touch every small page so that placement holds even when the huge page
+  // allocation fell back to regular pages
+  constexpr size_t kSmallPageSize = 4096;
+  const size_t page_size = allocSize();
+  const size_t num_pages = (len + page_size - 1) / page_size;
+
+  auto touch_page = [&](size_t page) {
+    size_t begin = page * page_size;
+    size_t end = std::min(begin + page_size, len);
+    if (zero) {
+      std::memset(data + begin, 0, end - begin);
+      return;
+    }
+    for (size_t i = begin; i < end; i += kSmallPageSize) {
+      data[i] = 0;
+    }
+  };
+
+  auto touch_local = [&]() {
+    for (size_t page = 0; page < num_pages; ++page) {
+      touch_page(page);
+    }
+  };
+
+  // Only the master of the pool may start a loop on it. Other threads, e.g.,
+  // the std::async readers of ParquetReader, allocate concurrently with it
+  // and touch their pages themselves.
+  ThreadPool& pool = GetThreadPool();
+  if (placement == NumaPlacement::kLocal || getActiveThreads() == 1 ||
+      !pool.isMaster()) {
+    touch_local();
+    return;
+  }
+
+  static std::mutex fan_out_mutex;
+  std::lock_guard<std::mutex> lock(fan_out_mutex);
+  if (pool.isRunning()) {
+    touch_local();
+    return;
+  }
+
+  on_each(
+      [&](unsigned tid, unsigned num_threads) {
+        if (placement == NumaPlacement::kInterleaved) {
+          for (size_t page = tid; page < num_pages; page += num_threads) {
+            touch_page(page);
+          }
+          return;
+        }
+        auto [begin, end] = block_range(size_t{0}, num_pages, tid, num_threads);
+        for (size_t page = begin; page < end; ++page) {
+          touch_page(page);
+        }
+      },
+      no_stats());
+}
+
+katana::Result<std::shared_ptr<arrow::Buffer>>
+katana::AllocateNumaBuffer(int64_t size, NumaPlacement placement) {
+  if (size < 0) {
+    return KATANA_ERROR(
+        ErrorCode::InvalidArgument, "negative buffer size {}", size);
+  }
+
+  if (static_cast<size_t>(size) < allocSize()) {
+    auto res = arrow::AllocateBuffer(size, DefaultArrowMemoryPool());
+    if (!res.ok()) {
+      return KATANA_ERROR(
+          ErrorCode::ArrowError, "allocating buffer: {}", res.status());
+    }
+    std::shared_ptr<arrow::Buffer> buffer = std::move(res.ValueOrDie());
+    std::memset(buffer->mutable_data(), 0, size);
+    return buffer;
+  }
+
+  LAptr memory = tryLargeMallocFloating(size);
+  if (!memory) {
+    return KATANA_ERROR(
+        std::make_error_code(std::errc::not_enough_memory),
+        "allocating {} bytes", size);
+  }
+  auto buffer = std::make_shared<NumaBuffer>(std::move(memory), size);
+  // fresh pages are already zero, so touching one byte per page places
+  // them without writing the whole buffer
+  PlacePages(buffer->mutable_data(), size, placement, false);
+  return std::shared_ptr<arrow::Buffer>(std::move(buffer));
+}
@@ -20,6 +20,7 @@
 #include "katana/NumaMem.h"
 
 #include <cassert>
+#include <limits>
 
 #include "katana/PageAlloc.h"
 #include "katana/ThreadPool.h"
@@ -195,6 +196,16 @@ katana::largeMallocFloating(size_t bytes) {
       allocPages(bytes / allocSize(), false), internal::largeFreer{bytes}};
 }
 
+LAptr
+katana::tryLargeMallocFloating(size_t bytes) {
+  bytes = roundup(bytes, allocSize());
+  size_t num_pages = bytes / allocSize();
+  if (num_pages > std::numeric_limits<unsigned>::max()) {
+    return LAptr{nullptr, internal::largeFreer{bytes}};
+  }
+  return LAptr{tryAllocPages(num_pages, false), internal::largeFreer{bytes}};
+}
+
 LAptr
 katana::largeMallocBlocked(size_t bytes, unsigned numThreads) {
   // round up to hugePageSize
@@ -76,7 +76,7 @@ katana::allocSize() {
 }
 
 void*
-katana::allocPages(unsigned num, bool preFault) {
+katana::tryAllocPages(unsigned num, bool preFault) {
   if (num == 0) {
     return nullptr;
   }
@@ -88,11 +88,7 @@ katana::allocPages(unsigned num, bool preFault) {
     ptr = trymmap(num * hugePageSize, preFault ? _MAP_POP : _MAP);
   }
 
-  if (!ptr) {
-    KATANA_LOG_FATAL("failed to allocate: {}", errno);
-  }
-
-  if (preFault && doHandMap) {
+  if (ptr && preFault && doHandMap) {
     for (size_t x = 0; x < num * hugePageSize; x += 4096) {
       static_cast<char*>(ptr)[x] = 0;
     }
@@ -101,6 +97,15 @@ katana::allocPages(unsigned num, bool preFault) {
   return ptr;
 }
 
+void*
+katana::allocPages(unsigned num, bool preFault) {
+  void* ptr = tryAllocPages(num, preFault);
+  if (num != 0 && !ptr) {
+    KATANA_LOG_FATAL("failed to allocate: {}", errno);
+  }
+  return ptr;
+}
+
 void
 katana::freePages(void* ptr, unsigned num) {
   std::lock_guard<SimpleLock> lg(allocLock);
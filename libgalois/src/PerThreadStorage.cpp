@@ -152,7 +152,8 @@ katana::PerBackend::deallocOffset(const unsigned offset, const unsigned sz) {
 
 void*
 katana::PerBackend::getRemote(unsigned thread, unsigned offset) {
-  char* rbase = heads[thread].load(std::memory_order_relaxed);
+  char* rbase =
+      heads[ThreadPool::getBase() + thread].load(std::memory_order_relaxed);
   KATANA_LOG_DEBUG_ASSERT(rbase);
   return &rbase[offset];
 }
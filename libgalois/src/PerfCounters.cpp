@@ -0,0 +1,211 @@
+#include "katana/PerfCounters.h"
+
+#include <atomic>
+
+#include "katana/Logging.h"
+#include "katana/Statistics.h"
+
+#ifdef __linux__
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+namespace {
+
+constexpr const char* kEventNames[katana::PerfCounters::kNumEvents] = {
+    "Cycles", "Instructions", "LLCMisses", "DTLBMisses", "RemoteNodeAccesses",
+};
+
+std::atomic<bool> warned{false};
+
+void
+WarnOnce(const char* reason) {
+  if (!warned.exchange(true)) {
+    KATANA_LOG_WARN("hardware counters: {}", reason);
+  }
+}
+
+#ifdef __linux__
+
+constexpr uint64_t
+CacheMissConfig(uint64_t cache) {
+  return cache | (PERF_COUNT_HW_CACHE_OP_READ << 8) |
+         (PERF_COUNT_HW_CACHE_RESULT_MISS << 16);
+}
+
+struct EventConfig {
+  uint32_t type;
+  uint64_t config;
+};
+
+constexpr EventConfig kEventConfigs[katana::PerfCounters::kNumEvents] = {
+    {PERF_TYPE_HARDWARE, PERF_COUNT_HW_CPU_CYCLES},
+    {PERF_TYPE_HARDWARE, PERF_COUNT_HW_INSTRUCTIONS},
+    {PERF_TYPE_HW_CACHE, CacheMissConfig(PERF_COUNT_HW_CACHE_LL)},
+    {PERF_TYPE_HW_CACHE, CacheMissConfig(PERF_COUNT_HW_CACHE_DTLB)},
+    {PERF_TYPE_HW_CACHE, CacheMissConfig(PERF_COUNT_HW_CACHE_NODE)},
+};
+
+/// The counters of one thread, opened as a group so that they count over the
+/// same intervals
+class CounterGroup {
+  static constexpr int kNumEvents = katana::PerfCounters::kNumEvents;
+
+  int leader_{-1};
+  std::array<int, kNumEvents> fds_;
+  //! the position of each event in a read of the group
+  std::array<unsigned, kNumEvents> slots_{};
+  unsigned available_{};
+  bool opened_{};
+
+  void Open() {
+    opened_ = true;
+
+    unsigned num_open = 0;
+    for (int e = 0; e < kNumEvents; ++e) {
+      perf_event_attr attr{};
+      attr.size = sizeof(attr);
+      attr.type = kEventConfigs[e].type;
+      attr.config = kEventConfigs[e].config;
+      attr.exclude_kernel = 1;
+      attr.exclude_hv = 1;
+      attr.read_format = PERF_FORMAT_GROUP | PERF_FORMAT_TOTAL_TIME_ENABLED |
+                         PERF_FORMAT_TOTAL_TIME_RUNNING;
+      // the group starts counting once all of it is open
+      attr.disabled = leader_ < 0;
+
+      int fd = syscall(SYS_perf_event_open, &attr, 0, -1, leader_, 0);
+      if (fd < 0) {
+        continue;
+      }
+      if (leader_ < 0) {
+        leader_ = fd;
+      }
+      fds_[e] = fd;
+      slots_[e] = num_open++;
+      available_ |= 1U << e;
+    }
+
+    if (leader_ < 0) {
+      WarnOnce(
+          "perf_event_open is not permitted or supported; check "
+          "/proc/sys/kernel/perf_event_paranoid");
+      return;
+    }
+    if (available_ != (1U << kNumEvents) - 1) {
+      WarnOnce("some events are not supported and are not reported");
+    }
+
+    ioctl(leader_, PERF_EVENT_IOC_ENABLE, PERF_IOC_FLAG_GROUP);
+  }
+
+public:
+  CounterGroup() { fds_.fill(-1); }
+
+  ~CounterGroup() {
+    for (int fd : fds_) {
+      if (fd >= 0) {
+        close(fd);
+      }
+    }
+  }
+
+  CounterGroup(const CounterGroup&) = delete;
+  CounterGroup& operator=(const CounterGroup&) = delete;
+
+  unsigned available() {
+    if (!opened_) {
+      Open();
+    }
+    return available_;
+  }
+
+  bool Read(
+      std::array<uint64_t, kNumEvents>* values, uint64_t* enabled_ns,
+      uint64_t* running_ns) const {
+    if (leader_ < 0) {
+      return false;
+    }
+
+    // nr, time enabled, time running, then one value per open event
+    uint64_t buf[3 + kNumEvents];
+    ssize_t n = read(leader_, buf, sizeof(buf));
+    if (n < static_cast<ssize_t>(3 * sizeof(uint64_t))) {
+      return false;
+    }
+
+    *enabled_ns = buf[1];
+    *running_ns = buf[2];
+    for (int e = 0; e < kNumEvents; ++e) {
+      if (available_ & (1U << e)) {
+        (*values)[e] = buf[3 + slots_[e]];
+      }
+    }
+    return true;
+  }
+};
+
+thread_local CounterGroup counter_group;
+
+#endif
+
+}  // namespace
+
+const char*
+katana::PerfCounters::EventName(Event e) {
+  return kEventNames[e];
+}
+
+void
+katana::PerfCounters::start() {
+#ifdef __linux__
+  available_ = counter_group.available();
+  if (!counter_group.Read(
+          &begin_.values, &begin_.enabled_ns, &begin_.running_ns)) {
+    available_ = 0;
+  }
+#else
+  WarnOnce("perf_event_open is only available on Linux");
+#endif
+}
+
+void
+katana::PerfCounters::stop() {
+#ifdef __linux__
+  Sample end;
+  if (!available_ ||
+      !counter_group.Read(&end.values, &end.enabled_ns, &end.running_ns)) {
+    return;
+  }
+
+  uint64_t enabled = end.enabled_ns - begin_.enabled_ns;
+  uint64_t running = end.running_ns - begin_.running_ns;
+  if (running == 0) {
+    // the group was never scheduled, so nothing is known
+    return;
+  }
+
+  for (int e = 0; e < kNumEvents; ++e) {
+    if (!has(static_cast<Event>(e))) {
+      continue;
+    }
+    uint64_t delta = end.values[e] - begin_.values[e];
+    if (running < enabled) {
+      delta = static_cast<uint64_t>(
+          static_cast<double>(delta) * enabled / running);
+    }
+    counts_[e] += delta;
+  }
+#endif
+}
+
+void
+katana::PerfCounters::report(const char* region) const {
+  for (int e = 0; e < kNumEvents; ++e) {
+    if (has(static_cast<Event>(e))) {
+      ReportStatSum(region, EventName(static_cast<Event>(e)), counts_[e]);
+    }
+  }
+}
@@ -145,6 +145,23 @@ MakePropertyGraph(
       std::move(rdg_file), std::move(rdg_result.value()));
 }
 
+/// Drop the cached summary of a column that is about to be removed so that a
+/// later column with the same name is summarized afresh. The topology
+/// statistics stay valid.
+void
+ForgetColumnSummary(
+    katana::PropertyGraph* pg, const char* key,
+    const std::shared_ptr<arrow::Schema>& schema, int i) {
+  nlohmann::json stats = pg->graph_stats();
+  if (!stats.is_object() || i < 0 || i >= schema->num_fields()) {
+    return;
+  }
+  if (auto it = stats.find(key); it != stats.end() && it->is_object()) {
+    it->erase(schema->field(i)->name());
+    pg->set_graph_stats(std::move(stats));
+  }
+}
+
 }  // namespace
 
 katana::PropertyGraph::PropertyGraph() = default;
@@ -169,16 +186,17 @@ katana::PropertyGraph::Validate() {
 
 katana::Result<void>
 katana::PropertyGraph::DoWrite(
-    tsuba::RDGHandle handle, const std::string& command_line) {
+    tsuba::RDGHandle handle, const std::string& command_line,
+    const tsuba::ParquetWriter::WriteOpts& opts) {
   if (!rdg_.topology_file_storage().Valid()) {
     auto result = WriteTopology(topology_);
     if (!result) {
       return result.error();
     }
-    return rdg_.Store(handle, command_line, std::move(result.value()));
+    return rdg_.Store(handle, command_line, std::move(result.value()), opts);
   }
 
-  return rdg_.Store(handle, command_line);
+  return rdg_.Store(handle, command_line, nullptr, opts);
 }
 
 katana::Result<std::unique_ptr<katana::PropertyGraph>>
@@ -231,14 +249,15 @@ katana::PropertyGraph::Copy(
 
 katana::Result<void>
 katana::PropertyGraph::WriteGraph(
-    const std::string& uri, const std::string& command_line) {
+    const std::string& uri, const std::string& command_line,
+    const tsuba::ParquetWriter::WriteOpts& opts) {
   auto open_res = tsuba::Open(uri, tsuba::kReadWrite);
   if (!open_res) {
     return open_res.error();
   }
   auto new_file = std::make_unique<tsuba::RDGFile>(open_res.value());
 
-  if (auto res = DoWrite(*new_file, command_line); !res) {
+  if (auto res = DoWrite(*new_file, command_line, opts); !res) {
     return res.error();
   }
 
@@ -248,15 +267,17 @@ katana::PropertyGraph::WriteGraph(
 }
 
 katana::Result<void>
-katana::PropertyGraph::Commit(const std::string& command_line) {
+katana::PropertyGraph::Commit(
+    const std::string& command_line,
+    const tsuba::ParquetWriter::WriteOpts& opts) {
   if (file_ == nullptr) {
     if (rdg_.rdg_dir().empty()) {
       return KATANA_ERROR(
           ErrorCode::InvalidArgument, "RDG commit but rdg_dir_ is empty");
     }
-    return WriteGraph(rdg_.rdg_dir().string(), command_line);
+    return WriteGraph(rdg_.rdg_dir().string(), command_line, opts);
   }
-  return DoWrite(*file_, command_line);
+  return DoWrite(*file_, command_line, opts);
 }
 
 bool
@@ -362,11 +383,12 @@ katana::PropertyGraph::ReportDiff(const PropertyGraph* other) const {
 
 katana::Result<void>
 katana::PropertyGraph::Write(
-    const std::string& rdg_name, const std::string& command_line) {
+    const std::string& rdg_name, const std::string& command_line,
+    const tsuba::ParquetWriter::WriteOpts& opts) {
   if (auto res = tsuba::Create(rdg_name); !res) {
     return res.error();
   }
-  return WriteGraph(rdg_name, command_line);
+  return WriteGraph(rdg_name, command_line, opts);
 }
 
 katana::Result<void>
@@ -403,6 +425,7 @@ katana::PropertyGraph::UpsertNodeProperties(
 
 katana::Result<void>
 katana::PropertyGraph::RemoveNodeProperty(int i) {
+  ForgetColumnSummary(this, "node_columns", node_schema(), i);
   return rdg_.RemoveNodeProperty(i);
 }
 
@@ -411,7 +434,7 @@ katana::PropertyGraph::RemoveNodeProperty(const std::string& prop_name) {
   auto col_names = node_properties()->ColumnNames();
   auto pos = std::find(col_names.cbegin(), col_names.cend(), prop_name);
   if (pos != col_names.cend()) {
-    return rdg_.RemoveNodeProperty(std::distance(col_names.cbegin(), pos));
+    return RemoveNodeProperty(std::distance(col_names.cbegin(), pos));
   }
   return katana::ErrorCode::PropertyNotFound;
 }
@@ -450,6 +473,7 @@ katana::PropertyGraph::UpsertEdgeProperties(
 
 katana::Result<void>
 katana::PropertyGraph::RemoveEdgeProperty(int i) {
+  ForgetColumnSummary(this, "edge_columns", edge_schema(), i);
   return rdg_.RemoveEdgeProperty(i);
 }
 
@@ -458,7 +482,7 @@ katana::PropertyGraph::RemoveEdgeProperty(const std::string& prop_name) {
   auto col_names = edge_properties()->ColumnNames();
   auto pos = std::find(col_names.cbegin(), col_names.cend(), prop_name);
   if (pos != col_names.cend()) {
-    return rdg_.RemoveEdgeProperty(std::distance(col_names.cbegin(), pos));
+    return RemoveEdgeProperty(std::distance(col_names.cbegin(), pos));
   }
   return katana::ErrorCode::PropertyNotFound;
 }
@@ -513,6 +537,8 @@ katana::SortAllEdgesByDest(katana::PropertyGraph* pg) {
             &out_dests_view[0] + edge_range.second);
       },
       katana::steal());
+  // the destinations were sorted in place
+  pg->set_graph_stats(nullptr);
 
   if (auto r = permutation_vec_builder.Advance(pg->topology().num_edges());
       !r.ok()) {
@@ -19,6 +19,8 @@
 
 #include "katana/SharedMemSys.h"
 
+#include "katana/ArrowInterchange.h"
+#include "katana/ArrowMemoryPool.h"
 #include "katana/CommBackend.h"
 #include "katana/Logging.h"
 #include "katana/SharedMem.h"
@@ -43,9 +45,12 @@ katana::SharedMemSys::SharedMemSys() : impl_(std::make_unique<Impl>()) {
   }
 
   katana::internal::setSysStatManager(&impl_->stat_manager);
+  katana::SetDefaultArrowMemoryPool(katana::ArrowMemoryPool::Default());
 }
 
 katana::SharedMemSys::~SharedMemSys() {
+  katana::ArrowMemoryPool::Default()->ReportStats();
+  katana::SetDefaultArrowMemoryPool(nullptr);
   katana::PrintStats();
   katana::internal::setSysStatManager(nullptr);
 
@@ -22,8 +22,14 @@
 #include <sys/resource.h>
 #include <sys/time.h>
 
+#include <atomic>
+#include <cmath>
 #include <fstream>
 #include <iostream>
+#include <sstream>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
 
 #include "katana/Env.h"
 #include "katana/Executor_OnEach.h"
@@ -37,6 +43,66 @@ CheckPrintingThreadVals() {
   return katana::GetEnv("PRINT_PER_THREAD_STATS");
 }
 
+bool
+EndsWith(const std::string& s, std::string_view suffix) {
+  return s.size() >= suffix.size() &&
+         s.compare(s.size() - suffix.size(), suffix.size(), suffix) == 0;
+}
+
+void
+PrintJsonString(std::ostream& out, std::string_view s) {
+  out << '"';
+  for (char c : s) {
+    switch (c) {
+    case '"':
+      out << "\\\"";
+      break;
+    case '\\':
+      out << "\\\\";
+      break;
+    case '\n':
+      out << "\\n";
+      break;
+    case '\t':
+      out << "\\t";
+      break;
+    default:
+      if (static_cast<unsigned char>(c) < 0x20) {
+        out << fmt::format("\\u{:04x}", c);
+      } else {
+        out << c;
+      }
+    }
+  }
+  out << '"';
+}
+
+void
+PrintJsonValue(std::ostream& out, int64_t v) {
+  out << v;
+}
+
+void
+PrintJsonValue(std::ostream& out, double v) {
+  // JSON has no representation of infinities and NaNs
+  if (std::isfinite(v)) {
+    out << fmt::format("{}", v);
+  } else {
+    out << "null";
+  }
+}
+
+void
+PrintJsonValue(std::ostream& out, const katana::gstl::Str& v) {
+  PrintJsonString(out, v);
+}
+
+//! Prints a duration in nanoseconds as the microseconds of the trace format
+void
+PrintTraceTime(std::ostream& out, uint64_t ns) {
+  out << fmt::format("{}.{:03}", ns / 1000, ns % 1000);
+}
+
 void
 PrintHeader(std::ostream& out, const char* sep) {
   out << "STAT_TYPE" << sep << "REGION" << sep << "CATEGORY" << sep;
@@ -65,25 +131,66 @@ struct StatImpl {
     perThreadManagers_.getLocal()->addToStat(region, category, val, type);
   }
 
-  void Merge() {
-    if (merged_) {
-      return;
-    }
-
+  void Collect(MergedStats* result) const {
     for (unsigned t = 0; t < perThreadManagers_.size(); ++t) {
       const auto* manager = perThreadManagers_.getRemote(t);
 
       for (auto i = manager->cbegin(), end_i = manager->cend(); i != end_i;
            ++i) {
-        result_.addToStat(
+        result->addToStat(
             manager->region(i), manager->category(i), T(manager->stat(i)),
             manager->stat(i).totalTy());
       }
     }
+  }
+
+  void Merge() {
+    if (merged_) {
+      return;
+    }
+
+    Collect(&result_);
 
     merged_ = true;
   }
 
+  void Reset() {
+    for (unsigned t = 0; t < perThreadManagers_.size(); ++t) {
+      perThreadManagers_.getRemote(t)->clear();
+    }
+    result_.clear();
+    merged_ = false;
+  }
+
+  //! Prints the statistics as elements of a JSON array, each preceded by
+  //! *sep
+  void PrintJson(std::ostream& out, const char** sep) const {
+    MergedStats merged;
+    Collect(&merged);
+
+    for (auto i = merged.cbegin(), end_i = merged.cend(); i != end_i; ++i) {
+      const auto& s = merged.stat(i);
+
+      out << *sep << "\n    {\"kind\": \"" << StatKind() << "\", \"region\": ";
+      PrintJsonString(out, merged.region(i));
+      out << ", \"category\": ";
+      PrintJsonString(out, merged.category(i));
+      out << ", \"total_type\": \"" << katana::StatTotal::str(s.totalTy())
+          << "\", \"total\": ";
+      PrintJsonValue(out, s.total());
+      out << ", \"thread_values\": [";
+      const char* vsep = "";
+      for (const auto& v : s.values()) {
+        out << vsep;
+        PrintJsonValue(out, v);
+        vsep = ", ";
+      }
+      out << "]}";
+
+      *sep = ",";
+    }
+  }
+
   void Read(
       const_iterator i, katana::gstl::Str& region, katana::gstl::Str& category,
       T& total, katana::StatTotal::Type& type,
@@ -125,6 +232,40 @@ struct StatImpl {
   }
 };
 
+struct TraceEvent {
+  const katana::gstl::Str* region;
+  const katana::gstl::Str* category;
+  uint64_t begin_ns;
+  uint64_t end_ns;
+};
+
+struct ThreadEvents {
+  katana::gstl::Set<katana::gstl::Str> symbols;
+  //! views of symbols, to look names up without copying them; keyed by
+  //! content since loop names may be temporaries whose buffers are reused
+  std::unordered_map<std::string_view, const katana::gstl::Str*> by_name;
+  std::vector<TraceEvent> events;
+  uint64_t dropped{};
+
+  const katana::gstl::Str* Intern(const char* s) {
+    auto it = by_name.find(std::string_view(s));
+    if (it != by_name.end()) {
+      return it->second;
+    }
+    const katana::gstl::Str* sym =
+        &*symbols.insert(katana::gstl::makeStr(s)).first;
+    by_name.emplace(std::string_view(sym->data(), sym->size()), sym);
+    return sym;
+  }
+
+  void Clear() {
+    events.clear();
+    by_name.clear();
+    symbols.clear();
+    dropped = 0;
+  }
+};
+
 }  // end unnamed namespace
 
 class katana::StatManager::Impl {
@@ -132,9 +273,29 @@ public:
   StatImpl<int64_t> int_stats_;
   StatImpl<double> fp_stats_;
   StatImpl<Str> str_stats_;
+  katana::PerThreadStorage<ThreadEvents> events_;
+  uint64_t trace_origin_ns_{TraceNow()};
+  std::atomic<bool> tracing_{false};
   std::string outfile_;
+  std::string tracefile_;
 };
 
+namespace {
+
+template <typename PrintFn>
+void
+PrintToFile(const std::string& file, PrintFn print) {
+  std::ofstream out(file.c_str());
+  if (!out) {
+    KATANA_LOG_ERROR("could not print stats to {} ", file);
+    return print(std::cerr);
+  }
+
+  print(out);
+}
+
+}  // end unnamed namespace
+
 katana::StatManager::StatManager() { impl_ = std::make_unique<Impl>(); }
 
 katana::StatManager::~StatManager() = default;
@@ -245,19 +406,124 @@ katana::StatManager::AddParam(
       gstl::makeStr(region), gstl::makeStr(category), val, StatTotal::SINGLE);
 }
 
+void
+katana::StatManager::AddEvent(
+    const char* region, const char* category, uint64_t begin_ns,
+    uint64_t end_ns) {
+  if (!IsTracing()) {
+    return;
+  }
+  ThreadEvents& local = *impl_->events_.getLocal();
+  if (local.events.size() >= kMaxEventsPerThread) {
+    ++local.dropped;
+    return;
+  }
+  local.events.emplace_back(TraceEvent{
+      local.Intern(region), local.Intern(category), begin_ns, end_ns});
+}
+
+void
+katana::StatManager::SetTracing(bool enabled) {
+  impl_->tracing_.store(enabled, std::memory_order_relaxed);
+}
+
+bool
+katana::StatManager::IsTracing() const {
+  return impl_->tracing_.load(std::memory_order_relaxed);
+}
+
+void
+katana::StatManager::SetTraceFile(const std::string& outfile) {
+  impl_->tracefile_ = outfile;
+  if (!outfile.empty()) {
+    SetTracing(true);
+  }
+}
+
+void
+katana::StatManager::PrintJson(std::ostream& out) const {
+  const char* sep = "";
+  out << "{\n  \"stats\": [";
+  impl_->int_stats_.PrintJson(out, &sep);
+  impl_->fp_stats_.PrintJson(out, &sep);
+  impl_->str_stats_.PrintJson(out, &sep);
+  out << "\n  ]\n}\n";
+}
+
+void
+katana::StatManager::PrintTrace(std::ostream& out) const {
+  const char* sep = "";
+  uint64_t dropped = 0;
+  out << "{\n  \"traceEvents\": [";
+  for (unsigned t = 0; t < impl_->events_.size(); ++t) {
+    const ThreadEvents& local = *impl_->events_.getRemote(t);
+    dropped += local.dropped;
+    if (local.events.empty()) {
+      continue;
+    }
+
+    out << sep << "\n    {\"name\": \"thread_name\", \"ph\": \"M\", "
+        << "\"pid\": 0, \"tid\": " << t << ", \"args\": {\"name\": "
+        << "\"thread " << t << "\"}}";
+    sep = ",";
+
+    for (const TraceEvent& e : local.events) {
+      // events of the same thread nest by time, so clamp events that began
+      // before the trace origin, e.g., because of a Reset during a loop
+      uint64_t begin = std::max(e.begin_ns, impl_->trace_origin_ns_);
+      uint64_t end = std::max(e.end_ns, begin);
+
+      out << sep << "\n    {\"name\": ";
+      std::string name(e.region->data(), e.region->size());
+      name.append(" ").append(e.category->data(), e.category->size());
+      PrintJsonString(out, name);
+      out << ", \"cat\": ";
+      PrintJsonString(out, *e.category);
+      out << ", \"ph\": \"X\", \"pid\": 0, \"tid\": " << t << ", \"ts\": ";
+      PrintTraceTime(out, begin - impl_->trace_origin_ns_);
+      out << ", \"dur\": ";
+      PrintTraceTime(out, end - begin);
+      out << ", \"args\": {\"region\": ";
+      PrintJsonString(out, *e.region);
+      out << "}}";
+    }
+  }
+  out << "\n  ],\n  \"displayTimeUnit\": \"ms\",\n"
+      << "  \"otherData\": {\"dropped_events\": " << dropped << "}\n}\n";
+}
+
+void
+katana::StatManager::Reset() {
+  impl_->int_stats_.Reset();
+  impl_->fp_stats_.Reset();
+  impl_->str_stats_.Reset();
+  for (unsigned t = 0; t < impl_->events_.size(); ++t) {
+    impl_->events_.getRemote(t)->Clear();
+  }
+  impl_->trace_origin_ns_ = TraceNow();
+}
+
 void
 katana::StatManager::Print() {
-  if (impl_->outfile_.empty()) {
-    return PrintStats(std::cout);
+  if (!impl_->tracefile_.empty()) {
+    PrintToFile(
+        impl_->tracefile_, [this](std::ostream& out) { PrintTrace(out); });
   }
 
-  std::ofstream out(impl_->outfile_.c_str());
-  if (!out) {
-    KATANA_LOG_ERROR("could not print stats to {} ", impl_->outfile_);
-    return PrintStats(std::cerr);
+  bool json = EndsWith(impl_->outfile_, ".json");
+  auto print = [this, json](std::ostream& out) {
+    if (json) {
+      PrintJson(out);
+    } else {
+      PrintStats(out);
+    }
+  };
+
+  if (impl_->outfile_.empty()) {
+    return print(std::cout);
   }
 
-  PrintStats(out);
+  PrintToFile(impl_->outfile_, print);
 }
 
 static katana::StatManager* stat_manager_singleton;
@@ -285,6 +551,35 @@ katana::PrintStats() {
   internal::sysStatManager()->Print();
 }
 
+void
+katana::SetTraceFile(const std::string& f) {
+  internal::sysStatManager()->SetTraceFile(f);
+}
+
+void
+katana::SetTracing(bool enabled) {
+  internal::sysStatManager()->SetTracing(enabled);
+}
+
+std::string
+katana::GetStatsJson() {
+  std::ostringstream out;
+  internal::sysStatManager()->PrintJson(out);
+  return out.str();
+}
+
+std::string
+katana::GetTraceJson() {
+  std::ostringstream out;
+  internal::sysStatManager()->PrintTrace(out);
+  return out.str();
+}
+
+void
+katana::ResetStats() {
+  internal::sysStatManager()->Reset();
+}
+
 void
 katana::reportPageAlloc(const char* category) {
   katana::on_each_gen(
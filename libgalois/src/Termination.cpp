@@ -17,6 +17,7 @@
  * Documentation, or loss or inaccuracy of data of any kind.
  */
 
+#include "katana/ExecutorContext.h"
 #include "katana/Logging.h"
 #include "katana/TerminationDetection.h"
 
@@ -35,6 +36,10 @@ katana::internal::SetTerminationDetection(katana::TerminationDetection* t) {
 
 katana::TerminationDetection&
 katana::GetTerminationDetection(unsigned active_threads) {
-  kTerminationDetection->Init(active_threads);
-  return *kTerminationDetection;
+  TerminationDetection* term = internal::ContextTerminationDetection();
+  if (!term) {
+    term = kTerminationDetection;
+  }
+  term->Init(active_threads);
+  return *term;
 }
@@ -0,0 +1,59 @@
+#include "katana/ThreadArena.h"
+
+#include "katana/PageAlloc.h"
+
+namespace {
+
+thread_local katana::ThreadArena local_arena;
+
+}  // namespace
+
+katana::ThreadArena::ThreadArena()
+    : block_size_(allocSize()), offset_(block_size_) {}
+
+katana::ThreadArena::~ThreadArena() {
+  Reset();
+  for (char* block : blocks_) {
+    freePages(block, 1);
+  }
+}
+
+katana::ThreadArena&
+katana::ThreadArena::Local() {
+  return local_arena;
+}
+
+void*
+katana::ThreadArena::AllocateSlow(size_t size, size_t align) {
+  void* ptr;
+  if (size + align > block_size_) {
+    ptr = ::operator new(size, std::align_val_t(align));
+    large_.emplace_back(Large{ptr, size, align});
+    large_bytes_ += size;
+  } else {
+    // the rest of the current block stays unused until the arena is rewound
+    if (num_blocks_ == blocks_.size()) {
+      blocks_.emplace_back(static_cast<char*>(allocPages(1, false)));
+    }
+    // blocks are page aligned, so the allocation needs no padding
+    current_ = blocks_[num_blocks_++];
+    ptr = current_;
+    offset_ = size;
+  }
+  high_water_ = std::max(high_water_, bytes_in_use());
+  return ptr;
+}
+
+void
+katana::ThreadArena::Rewind(const Mark& mark) {
+  while (large_.size() > mark.num_large) {
+    const Large& large = large_.back();
+    ::operator delete(large.ptr, std::align_val_t(large.align));
+    large_bytes_ -= large.size;
+    large_.pop_back();
+  }
+
+  num_blocks_ = mark.num_blocks;
+  current_ = num_blocks_ ? blocks_[num_blocks_ - 1] : nullptr;
+  offset_ = mark.offset;
+}
@@ -20,8 +20,16 @@
 #include "katana/ThreadPool.h"
 
 #include <algorithm>
+#include <chrono>
+#include <climits>
 #include <iostream>
 
+#if defined(__linux__)
+#include <linux/futex.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
 #include "katana/Env.h"
 #include "katana/HWTopo.h"
 #include "katana/Logging.h"
@@ -38,12 +46,119 @@ using katana::ThreadPool;
 
 thread_local ThreadPool::per_signal ThreadPool::my_box;
 
+namespace {
+
+// Bounds on how long a thread in kAdaptive spins before it sleeps. Threads
+// always spin a little to cover loops issued back to back and never spin
+// longer than a futex wakeup costs many times over.
+constexpr uint64_t kMinSpinNs = 2000;
+constexpr uint64_t kMaxSpinNs = 50000;
+
+// Threads sleeping in kAdaptive wait for this word to change. There is one
+// word for the process rather than one per pool because a sleeping thread
+// may be handed to a partition before it is woken.
+std::atomic<uint32_t> wake_generation{0};
+std::atomic<uint32_t> num_sleepers{0};
+
+uint64_t
+NowNs() {
+  return std::chrono::duration_cast<std::chrono::nanoseconds>(
+             std::chrono::steady_clock::now().time_since_epoch())
+      .count();
+}
+
+#if defined(__linux__)
+
+void
+FutexWait(std::atomic<uint32_t>* word, uint32_t expected) {
+  syscall(
+      SYS_futex, reinterpret_cast<uint32_t*>(word), FUTEX_WAIT_PRIVATE,
+      expected, nullptr, nullptr, 0);
+}
+
+void
+FutexWakeAll(std::atomic<uint32_t>* word) {
+  syscall(
+      SYS_futex, reinterpret_cast<uint32_t*>(word), FUTEX_WAKE_PRIVATE,
+      INT_MAX, nullptr, nullptr, 0);
+}
+
+#else
+
+std::mutex futex_mutex;
+std::condition_variable futex_cv;
+
+void
+FutexWait(std::atomic<uint32_t>* word, uint32_t expected) {
+  std::unique_lock<std::mutex> lock(futex_mutex);
+  futex_cv.wait(lock, [&]() { return word->load() != expected; });
+}
+
+void
+FutexWakeAll(std::atomic<uint32_t>*) {
+  { std::lock_guard<std::mutex> lock(futex_mutex); }
+  futex_cv.notify_all();
+}
+
+#endif
+
+// Sleep until released is set. Pairs with ThreadPool::wakeSleepers: the
+// sleeper registers before its last check of released and the waker sets
+// released before it checks for sleepers, so one of them sees the other.
+void
+SleepUntilReleased(const std::atomic<int>& released) {
+  while (!released.load()) {
+    uint32_t generation = wake_generation.load();
+    num_sleepers.fetch_add(1);
+    if (!released.load()) {
+      FutexWait(&wake_generation, generation);
+    }
+    num_sleepers.fetch_sub(1);
+  }
+}
+
+}  // namespace
+
+void
+ThreadPool::per_signal::waitAdaptive() {
+  uint64_t start = NowNs();
+  uint64_t budget = kMinSpinNs;
+  if (avgIdle <= kMaxSpinNs) {
+    budget = std::max(kMinSpinNs, std::min(2 * avgIdle, kMaxSpinNs));
+  }
+
+  for (unsigned i = 1; !fastRelease.load(std::memory_order_acquire); ++i) {
+    asmPause();
+    // reading the clock costs more than a pause, so only check it now and then
+    if (i % 64 == 0 && NowNs() - start > budget) {
+      SleepUntilReleased(fastRelease);
+      break;
+    }
+  }
+  fastRelease = 0;
+
+  // Clamp so that one long idle period does not keep the thread from
+  // spinning once loops come back to back again
+  uint64_t idle = std::min(NowNs() - start, 2 * kMaxSpinNs);
+  avgIdle = (3 * avgIdle + idle) / 4;
+}
+
+void
+ThreadPool::wakeSleepers() {
+  wake_generation.fetch_add(1);
+  if (num_sleepers.load()) {
+    FutexWakeAll(&wake_generation);
+  }
+}
+
 ThreadPool::ThreadPool()
     : mi(getHWTopo().machineTopoInfo),
+      threadTopo(getHWTopo().threadTopoInfo),
       reserved(0),
       masterFastmode(false),
       running(false) {
   signals.resize(mi.maxThreads);
+  initStealOrder();
   initThread(0);
 
   for (unsigned i = 1; i < mi.maxThreads; ++i) {
@@ -57,9 +172,177 @@ ThreadPool::ThreadPool()
   })) {
     std::atomic_thread_fence(std::memory_order_seq_cst);
   }
+
+  if (GetEnv("KATANA_ADAPTIVE_WAKEUP")) {
+    beAdaptive();
+  }
+}
+
+ThreadPool::ThreadPool(ThreadPool& p, unsigned begin, unsigned num)
+    : mi(p.mi),
+      reserved(0),
+      masterFastmode(false),
+      running(false),
+      parent(&p),
+      base(p.base + begin) {
+  std::vector<ThreadTopoInfo> topo = p.partitionTopo(begin, num);
+
+  threadTopo = topo;
+  initStealOrder();
+  mi.maxThreads = num;
+  mi.maxCores = std::max(1U, num * p.mi.maxCores / p.mi.maxThreads);
+  mi.maxSockets = topo[num - 1].cumulativeMaxSocket + 1;
+  mi.maxNumaNodes = 0;
+  mi.maxCacheDomains = 0;
+  for (const ThreadTopoInfo& t : topo) {
+    mi.maxNumaNodes = std::max(mi.maxNumaNodes, t.numaNode + 1);
+    mi.maxCacheDomains = std::max(mi.maxCacheDomains, t.cacheDomain + 1);
+  }
+
+  // tid 0 is filled in by initPartitionMaster; the other threads stay in
+  // the threadLoop of the parent and run the work of the pool that wakes them
+  signals.resize(num);
+  for (unsigned i = 1; i < num; ++i) {
+    per_signal* s = p.signals[begin + i];
+    s->topo = topo[i];
+    s->pool = this;
+    s->base = base;
+    signals[i] = s;
+  }
+}
+
+void
+ThreadPool::initPartitionMaster() {
+  KATANA_LOG_DEBUG_ASSERT(parent && !signals[0]);
+  my_box.topo = threadTopo[0];
+  my_box.pool = this;
+  my_box.base = base;
+  signals[0] = &my_box;
+
+  if (!GetEnv("KATANA_DO_NOT_BIND_THREADS")) {
+    bindThreadSelf(my_box.topo.osContext);
+  }
+  my_box.done = 1;
+}
+
+std::vector<katana::ThreadTopoInfo>
+ThreadPool::partitionTopo(unsigned begin, unsigned num) const {
+  // sockets, numa nodes and cache domains are renumbered in order of first
+  // appearance so that leaders and cumulative max sockets follow from tids as
+  // they do in the system pool
+  std::vector<unsigned> sockets;
+  std::vector<unsigned> leaders;
+  std::vector<unsigned> numa_nodes;
+  std::vector<unsigned> cache_domains;
+  std::vector<unsigned> cache_leaders;
+  std::vector<ThreadTopoInfo> topo(num);
+
+  for (unsigned i = 0; i < num; ++i) {
+    const ThreadTopoInfo& orig = threadTopo[begin + i];
+    ThreadTopoInfo& t = topo[i];
+    t = orig;
+    t.tid = i;
+
+    auto socket = std::find(sockets.begin(), sockets.end(), orig.socket);
+    t.socket = socket - sockets.begin();
+    if (socket == sockets.end()) {
+      sockets.emplace_back(orig.socket);
+      leaders.emplace_back(i);
+    }
+    t.socketLeader = leaders[t.socket];
+    t.cumulativeMaxSocket = sockets.size() - 1;
+
+    auto node = std::find(numa_nodes.begin(), numa_nodes.end(), orig.numaNode);
+    t.numaNode = node - numa_nodes.begin();
+    if (node == numa_nodes.end()) {
+      numa_nodes.emplace_back(orig.numaNode);
+    }
+
+    auto domain = std::find(
+        cache_domains.begin(), cache_domains.end(), orig.cacheDomain);
+    t.cacheDomain = domain - cache_domains.begin();
+    if (domain == cache_domains.end()) {
+      cache_domains.emplace_back(orig.cacheDomain);
+      cache_leaders.emplace_back(i);
+    }
+    t.cacheLeader = cache_leaders[t.cacheDomain];
+  }
+  return topo;
+}
+
+void
+ThreadPool::initStealOrder() {
+  unsigned num = threadTopo.size();
+  stealOrder.assign(num, {});
+  for (unsigned tid = 0; tid < num; ++tid) {
+    std::vector<unsigned>& order = stealOrder[tid];
+    for (unsigned i = 1; i < num; ++i) {
+      order.emplace_back((tid + i) % num);
+    }
+    std::stable_sort(
+        order.begin(), order.end(), [this, tid](unsigned a, unsigned b) {
+          return getLocality(tid, a) < getLocality(tid, b);
+        });
+  }
+}
+
+unsigned
+ThreadPool::reserveThreads(unsigned num) {
+  KATANA_LOG_VASSERT(!running, "Can't reserve threads during parallel section");
+  KATANA_LOG_DEBUG_ASSERT(num > 0);
+
+  // First fit from the top of the pool, below any dedicated threads. Tid 0
+  // is the master of this pool and is never reserved.
+  std::sort(partitions.begin(), partitions.end(), std::greater<>());
+  unsigned top = mi.maxThreads - dedicated;
+  for (const auto& [b, n] : partitions) {
+    if (top - (b + n) >= num) {
+      break;
+    }
+    top = b;
+  }
+  if (top < num + 1) {
+    return 0;
+  }
+
+  unsigned begin = top - num;
+  partitions.emplace_back(begin, num);
+  updateReserved();
+  return begin;
+}
+
+void
+ThreadPool::releaseThreads(unsigned begin) {
+  auto it = std::find_if(
+      partitions.begin(), partitions.end(),
+      [begin](const auto& p) { return p.first == begin; });
+  KATANA_LOG_DEBUG_ASSERT(it != partitions.end());
+  partitions.erase(it);
+  updateReserved();
+}
+
+void
+ThreadPool::updateReserved() {
+  unsigned floor = mi.maxThreads - dedicated;
+  for (const auto& p : partitions) {
+    floor = std::min(floor, p.first);
+  }
+  reserved = mi.maxThreads - floor;
 }
 
 ThreadPool::~ThreadPool() {
+  if (parent) {
+    // hand the threads back to the parent
+    for (unsigned i = 1; i < signals.size(); ++i) {
+      signals[i]->topo = parent->threadTopo[base - parent->base + i];
+      signals[i]->pool = nullptr;
+      signals[i]->base = 0;
+    }
+    return;
+  }
+
+  KATANA_LOG_VASSERT(
+      partitions.empty(), "ThreadPool destroyed before its partitions");
   destroyCommon();
   for (auto& t : threads) {
     t.join();
@@ -73,24 +356,34 @@ ThreadPool::destroyCommon() {
 }
 
 void
-ThreadPool::burnPower(unsigned num) {
-  num = std::min(num, getMaxUsableThreads());
-
-  // changing number of threads?  just do a reset
-  if (masterFastmode && masterFastmode != num) {
+ThreadPool::setWaitMode(WaitMode mode, unsigned num) {
+  // changing mode or number of threads?  just do a reset
+  if (masterFastmode && (masterMode != mode || masterFastmode != num)) {
     beKind();
   }
   if (!masterFastmode) {
-    run(num, []() { throw fastmode_ty{true}; });
+    run(num, [mode]() { throw fastmode_ty{mode}; });
     masterFastmode = num;
+    masterMode = mode;
   }
 }
 
+void
+ThreadPool::burnPower(unsigned num) {
+  setWaitMode(WaitMode::kSpin, std::min(num, getMaxUsableThreads()));
+}
+
+void
+ThreadPool::beAdaptive() {
+  setWaitMode(WaitMode::kAdaptive, getMaxUsableThreads());
+}
+
 void
 ThreadPool::beKind() {
   if (masterFastmode) {
-    run(masterFastmode, []() { throw fastmode_ty{false}; });
+    run(masterFastmode, []() { throw fastmode_ty{WaitMode::kSleep}; });
     masterFastmode = 0;
+    masterMode = WaitMode::kSleep;
   }
 }
 
@@ -129,7 +422,7 @@ getNth(std::atomic<T*>& headptr, unsigned off) {
 void
 ThreadPool::initThread(unsigned tid) {
   signals[tid] = &my_box;
-  my_box.topo = getHWTopo().threadTopoInfo[tid];
+  my_box.topo = threadTopo[tid];
   // Initialize
   initPTS(mi.maxThreads);
 
@@ -155,17 +448,19 @@ ThreadPool::initThread(unsigned tid) {
 void
 ThreadPool::threadLoop(unsigned tid) {
   initThread(tid);
-  bool fastmode = false;
+  WaitMode mode = WaitMode::kSleep;
   auto& me = my_box;
   do {
-    me.wait(fastmode);
-    cascade(fastmode);
+    me.wait(mode);
+    // a partition may have borrowed this thread since it last ran
+    ThreadPool* pool = me.pool ? me.pool : this;
+    pool->cascade(mode);
     try {
-      work();
+      pool->work();
     } catch (const shutdown_ty&) {
       return;
     } catch (const fastmode_ty& fm) {
-      fastmode = fm.mode;
+      mode = fm.mode;
     } catch (const dedicated_ty dt) {
       me.done = 1;
       dt.fn();
@@ -177,7 +472,7 @@ ThreadPool::threadLoop(unsigned tid) {
     } catch (...) {
       abort();
     }
-    decascade();
+    pool->decascade();
   } while (true);
 }
 
@@ -202,12 +497,12 @@ ThreadPool::decascade() {
 }
 
 void
-ThreadPool::cascade(bool fastmode) {
+ThreadPool::cascade(WaitMode mode) {
   auto& me = my_box;
   KATANA_LOG_DEBUG_ASSERT(me.wbegin <= me.wend);
 
-  // nothing to wake up
-  if (me.wbegin == me.wend) {
+  // nothing to wake up, or already woken by broadcast
+  if (me.wbegin == me.wend || mode == WaitMode::kAdaptive) {
     return;
   }
 
@@ -216,14 +511,47 @@ ThreadPool::cascade(bool fastmode) {
   auto* child1 = signals[me.wbegin];
   child1->wbegin = me.wbegin + 1;
   child1->wend = midpoint;
-  child1->wakeup(fastmode);
+  child1->wakeup(mode);
 
   if (midpoint < me.wend) {
     auto* child2 = signals[midpoint];
     child2->wbegin = midpoint + 1;
     child2->wend = me.wend;
-    child2->wakeup(fastmode);
+    child2->wakeup(mode);
+  }
+}
+
+void
+ThreadPool::prepareTree(unsigned wbegin, unsigned wend) {
+  if (wbegin == wend) {
+    return;
   }
+  auto midpoint = wbegin + (1 + wend - wbegin) / 2;
+
+  auto* child1 = signals[wbegin];
+  child1->wbegin = wbegin + 1;
+  child1->wend = midpoint;
+  child1->done = 0;
+  prepareTree(wbegin + 1, midpoint);
+
+  if (midpoint < wend) {
+    auto* child2 = signals[midpoint];
+    child2->wbegin = midpoint + 1;
+    child2->wend = wend;
+    child2->done = 0;
+    prepareTree(midpoint + 1, wend);
+  }
+}
+
+void
+ThreadPool::broadcast(unsigned num) {
+  // Every thread must be marked not done before any is released, as a
+  // released thread immediately waits for its children in decascade
+  prepareTree(1, num);
+  for (unsigned i = 1; i < num; ++i) {
+    signals[i]->wakeup(WaitMode::kAdaptive);
+  }
+  wakeSleepers();
 }
 
 void
@@ -235,12 +563,20 @@ ThreadPool::runInternal(unsigned num) {
   num = std::min(std::max(1U, num), getMaxUsableThreads());
   // my_box is tid 0
   auto& me = my_box;
+  KATANA_LOG_DEBUG_ASSERT(!parent || signals[0] == &me);
   me.wbegin = 1;
   me.wend = num;
 
-  KATANA_LOG_DEBUG_ASSERT(!masterFastmode || masterFastmode == num);
+  KATANA_LOG_DEBUG_ASSERT(
+      !masterFastmode || masterFastmode == num ||
+      (masterMode == WaitMode::kAdaptive && num < masterFastmode));
   // launch threads
-  cascade(masterFastmode);
+  WaitMode mode = masterFastmode ? masterMode : WaitMode::kSleep;
+  if (mode == WaitMode::kAdaptive) {
+    broadcast(num);
+  } else {
+    cascade(mode);
+  }
   // Do master thread work
   try {
     work();
@@ -262,15 +598,22 @@ ThreadPool::runDedicated(std::function<void(void)>& f) {
   // clients access katana::activeThreads directly.
   KATANA_LOG_VASSERT(
       !running, "Can't start dedicated thread during parallel section");
-  ++reserved;
+  KATANA_LOG_VASSERT(
+      partitions.empty(), "Can't start dedicated thread in partitioned pool");
+  ++dedicated;
+  updateReserved();
 
   KATANA_LOG_VASSERT(reserved < mi.maxThreads, "Too many dedicated threads");
   work = [&f]() { throw dedicated_ty{f}; };
-  auto* child = signals[mi.maxThreads - reserved];
+  auto* child = signals[mi.maxThreads - dedicated];
   child->wbegin = 0;
   child->wend = 0;
   child->done = 0;
-  child->wakeup(masterFastmode);
+  WaitMode mode = masterFastmode ? masterMode : WaitMode::kSleep;
+  child->wakeup(mode);
+  if (mode == WaitMode::kAdaptive) {
+    wakeSleepers();
+  }
   while (!child->done) {
     asmPause();
   }
@@ -288,5 +631,8 @@ katana::internal::SetThreadPool(ThreadPool* tp) {
 katana::ThreadPool&
 katana::GetThreadPool() {
   KATANA_LOG_VASSERT(TPOOL, "ThreadPool not initialized");
+  if (ThreadPool* partition = ThreadPool::my_box.pool) {
+    return *partition;
+  }
   return *TPOOL;
 }
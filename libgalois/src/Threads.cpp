@@ -21,6 +21,7 @@
 
 #include <algorithm>
 
+#include "katana/ExecutorContext.h"
 #include "katana/ThreadPool.h"
 namespace katana {
 KATANA_EXPORT unsigned int activeThreads = 1;
@@ -30,11 +31,16 @@ unsigned int
 katana::setActiveThreads(unsigned int num) noexcept {
   num = std::min(num, katana::GetThreadPool().getMaxUsableThreads());
   num = std::max(num, 1U);
-  katana::activeThreads = num;
+  if (!internal::ContextSetActiveThreads(num)) {
+    katana::activeThreads = num;
+  }
   return num;
 }
 
 unsigned int
 katana::getActiveThreads() noexcept {
+  if (unsigned num{}; internal::ContextGetActiveThreads(&num)) {
+    return num;
+  }
   return katana::activeThreads;
 }
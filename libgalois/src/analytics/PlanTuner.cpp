@@ -0,0 +1,718 @@
+#include "katana/analytics/PlanTuner.h"
+
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <fstream>
+#include <limits>
+#include <optional>
+#include <sstream>
+#include <vector>
+
+#include <nlohmann/json.hpp>
+
+#include "katana/Env.h"
+#include "katana/ErrorCode.h"
+#include "katana/GraphStats.h"
+#include "katana/JSON.h"
+#include "katana/Logging.h"
+#include "katana/Threads.h"
+#include "katana/Timer.h"
+#include "katana/analytics/Utils.h"
+
+namespace {
+
+using katana::analytics::BfsPlan;
+using katana::analytics::ConnectedComponentsPlan;
+using katana::analytics::PlanTunerOptions;
+using katana::analytics::SsspPlan;
+using katana::analytics::TriangleCountPlan;
+
+constexpr const char* kProfileEnvVar = "KATANA_PLAN_PROFILE";
+constexpr unsigned kMaxDelta = 30;
+
+/// Identify a graph by the statistics of its topology. Two graphs with the
+/// same fingerprint are not necessarily equal, but similar enough that a plan
+/// tuned for one suits the other.
+std::string
+Fingerprint(const katana::GraphStats& stats) {
+  nlohmann::json topology{
+      {"num_nodes", stats.num_nodes},
+      {"num_edges", stats.num_edges},
+      {"out_degree", stats.out_degree},
+      {"in_degree", stats.in_degree},
+      {"num_self_loops", stats.num_self_loops},
+      {"num_duplicate_edges", stats.num_duplicate_edges},
+      {"num_components", stats.num_components},
+  };
+  // FNV-1a, which unlike std::hash is stable across builds
+  uint64_t hash = UINT64_C(14695981039346656037);
+  for (char c : topology.dump()) {
+    hash ^= static_cast<uint8_t>(c);
+    hash *= UINT64_C(1099511628211);
+  }
+  return fmt::format("{}-{}-{:016x}", stats.num_nodes, stats.num_edges, hash);
+}
+
+/// Tuned plans of a profile, keyed by graph fingerprint, number of threads
+/// and algorithm
+class Profile {
+public:
+  static katana::Result<Profile> Load(const PlanTunerOptions& options) {
+    Profile profile;
+    profile.path_ = options.profile_path;
+    if (profile.path_.empty()) {
+      katana::GetEnv(kProfileEnvVar, &profile.path_);
+    }
+    if (auto res = profile.Read(); !res) {
+      return res.error();
+    }
+    return profile;
+  }
+
+  const nlohmann::json* Find(
+      const std::string& fingerprint, const std::string& algorithm) const {
+    auto graph = entries_.find(fingerprint);
+    if (graph == entries_.end()) {
+      return nullptr;
+    }
+    auto threads = graph->find(ThreadsKey());
+    if (threads == graph->end()) {
+      return nullptr;
+    }
+    auto plan = threads->find(algorithm);
+    if (plan == threads->end()) {
+      return nullptr;
+    }
+    return &*plan;
+  }
+
+  /// Record plan and write the profile, merging it with whatever other
+  /// processes recorded since it was loaded
+  katana::Result<void> Record(
+      const std::string& fingerprint, const std::string& algorithm,
+      nlohmann::json plan) {
+    if (path_.empty()) {
+      return katana::ResultSuccess();
+    }
+    if (auto res = Read(); !res) {
+      return res.error();
+    }
+    entries_[fingerprint][ThreadsKey()][algorithm] = std::move(plan);
+
+    auto dump_res = katana::JsonDump(entries_);
+    if (!dump_res) {
+      return dump_res.error();
+    }
+    // write a temporary file first so that readers never see a partial
+    // profile; its name is unique so that concurrent writers do not write
+    // the same file
+    std::string tmp_path = path_ + ".XXXXXX";
+    int fd = mkstemp(tmp_path.data());
+    if (fd < 0) {
+      return KATANA_ERROR(
+          katana::ResultErrno(), "creating temporary plan profile {}",
+          tmp_path);
+    }
+    auto res = WriteAll(fd, dump_res.value());
+    // mkstemp creates the file readable only by its owner
+    if (res && fchmod(fd, 0644) != 0) {
+      res = KATANA_ERROR(katana::ResultErrno(), "fchmod");
+    }
+    if (close(fd) != 0 && res) {
+      res = KATANA_ERROR(katana::ResultErrno(), "close");
+    }
+    if (res && std::rename(tmp_path.c_str(), path_.c_str()) != 0) {
+      res = KATANA_ERROR(katana::ResultErrno(), "rename");
+    }
+    if (!res) {
+      unlink(tmp_path.c_str());
+      return res.error().WithContext("writing plan profile {}", path_);
+    }
+    return katana::ResultSuccess();
+  }
+
+  const std::string& path() const { return path_; }
+
+private:
+  static std::string ThreadsKey() {
+    return std::to_string(katana::getActiveThreads());
+  }
+
+  static katana::Result<void> WriteAll(int fd, const std::string& contents) {
+    size_t done = 0;
+    while (done < contents.size()) {
+      ssize_t ret = write(fd, contents.data() + done, contents.size() - done);
+      if (ret < 0) {
+        if (errno == EINTR) {
+          continue;
+        }
+        return KATANA_ERROR(katana::ResultErrno(), "write");
+      }
+      done += ret;
+    }
+    return katana::ResultSuccess();
+  }
+
+  katana::Result<void> Read() {
+    entries_ = nlohmann::json::object();
+    if (path_.empty()) {
+      return katana::ResultSuccess();
+    }
+    std::ifstream in(path_);
+    if (!in) {
+      // not tuned yet
+      return katana::ResultSuccess();
+    }
+    std::stringstream buffer;
+    buffer << in.rdbuf();
+    std::string contents = buffer.str();
+    if (auto res = katana::JsonParse(contents, &entries_); !res) {
+      return res.error().WithContext("plan profile {}", path_);
+    }
+    if (!entries_.is_object()) {
+      return KATANA_ERROR(
+          katana::ErrorCode::JsonParseFailed,
+          "plan profile {} is not an object", path_);
+    }
+    return katana::ResultSuccess();
+  }
+
+  std::string path_;
+  nlohmann::json entries_ = nlohmann::json::object();
+};
+
+//
+// Conversions between plans and their descriptions in profiles
+//
+
+nlohmann::json
+Describe(const SsspPlan& plan) {
+  const char* name = "";
+  switch (plan.algorithm()) {
+  case SsspPlan::kDeltaTile:
+    name = "DeltaTile";
+    break;
+  case SsspPlan::kDeltaStep:
+    name = "DeltaStep";
+    break;
+  case SsspPlan::kDeltaStepBarrier:
+    name = "DeltaStepBarrier";
+    break;
+  default:
+    KATANA_LOG_FATAL(
+        "SSSP algorithm {} is not tuned", static_cast<int>(plan.algorithm()));
+  }
+  return {
+      {"algorithm", name},
+      {"delta", plan.delta()},
+      {"edge_tile_size", plan.edge_tile_size()},
+      {"fusion_threshold", plan.fusion_threshold()},
+  };
+}
+
+std::optional<SsspPlan>
+MakeSsspPlan(const nlohmann::json& j) {
+  std::string name = j.at("algorithm");
+  unsigned delta = j.at("delta");
+  ptrdiff_t edge_tile_size = j.at("edge_tile_size");
+  unsigned fusion_threshold =
+      j.value("fusion_threshold", SsspPlan::kDefaultFusionThreshold);
+  if (name == "DeltaTile") {
+    return SsspPlan::DeltaTile(delta, edge_tile_size, fusion_threshold);
+  }
+  if (name == "DeltaStep") {
+    return SsspPlan::DeltaStep(delta, fusion_threshold);
+  }
+  if (name == "DeltaStepBarrier") {
+    return SsspPlan::DeltaStepBarrier(delta, fusion_threshold);
+  }
+  return std::nullopt;
+}
+
+nlohmann::json
+Describe(const BfsPlan& plan) {
+  const char* name = "";
+  switch (plan.algorithm()) {
+  case BfsPlan::kAsynchronousTile:
+    name = "AsynchronousTile";
+    break;
+  case BfsPlan::kAsynchronous:
+    name = "Asynchronous";
+    break;
+  case BfsPlan::kSynchronousTile:
+    name = "SynchronousTile";
+    break;
+  case BfsPlan::kSynchronous:
+    name = "Synchronous";
+    break;
+  }
+  return {
+      {"algorithm", name},
+      {"edge_tile_size", plan.edge_tile_size()},
+  };
+}
+
+std::optional<BfsPlan>
+MakeBfsPlan(const nlohmann::json& j) {
+  std::string name = j.at("algorithm");
+  ptrdiff_t edge_tile_size = j.at("edge_tile_size");
+  if (name == "AsynchronousTile") {
+    return BfsPlan::AsynchronousTile(edge_tile_size);
+  }
+  if (name == "Asynchronous") {
+    return BfsPlan::Asynchronous();
+  }
+  if (name == "SynchronousTile") {
+    return BfsPlan::SynchronousTile(edge_tile_size);
+  }
+  if (name == "Synchronous") {
+    return BfsPlan::Synchronous();
+  }
+  return std::nullopt;
+}
+
+nlohmann::json
+Describe(const ConnectedComponentsPlan& plan) {
+  const char* name = "";
+  switch (plan.algorithm()) {
+  case ConnectedComponentsPlan::kAsynchronous:
+    name = "Asynchronous";
+    break;
+  case ConnectedComponentsPlan::kEdgeTiledAsynchronous:
+    name = "EdgeTiledAsynchronous";
+    break;
+  case ConnectedComponentsPlan::kBlockedAsynchronous:
+    name = "BlockedAsynchronous";
+    break;
+  case ConnectedComponentsPlan::kAfforest:
+    name = "Afforest";
+    break;
+  case ConnectedComponentsPlan::kEdgeAfforest:
+    name = "EdgeAfforest";
+    break;
+  case ConnectedComponentsPlan::kEdgeTiledAfforest:
+    name = "EdgeTiledAfforest";
+    break;
+  default:
+    KATANA_LOG_FATAL(
+        "connected components algorithm {} is not tuned",
+        static_cast<int>(plan.algorithm()));
+  }
+  return {
+      {"algorithm", name},
+      {"edge_tile_size", plan.edge_tile_size()},
+  };
+}
+
+std::optional<ConnectedComponentsPlan>
+MakeConnectedComponentsPlan(const nlohmann::json& j) {
+  std::string name = j.at("algorithm");
+  ptrdiff_t edge_tile_size = j.at("edge_tile_size");
+  if (name == "Asynchronous") {
+    return ConnectedComponentsPlan::Asynchronous();
+  }
+  if (name == "EdgeTiledAsynchronous") {
+    return ConnectedComponentsPlan::EdgeTiledAsynchronous(edge_tile_size);
+  }
+  if (name == "BlockedAsynchronous") {
+    return ConnectedComponentsPlan::BlockedAsynchronous();
+  }
+  if (name == "Afforest") {
+    return ConnectedComponentsPlan::Afforest();
+  }
+  if (name == "EdgeAfforest") {
+    return ConnectedComponentsPlan::EdgeAfforest();
+  }
+  if (name == "EdgeTiledAfforest") {
+    return ConnectedComponentsPlan::EdgeTiledAfforest(edge_tile_size);
+  }
+  return std::nullopt;
+}
+
+nlohmann::json
+Describe(const TriangleCountPlan& plan) {
+  const char* name = "";
+  switch (plan.algorithm()) {
+  case TriangleCountPlan::kNodeIteration:
+    name = "NodeIteration";
+    break;
+  case TriangleCountPlan::kEdgeIteration:
+    name = "EdgeIteration";
+    break;
+  case TriangleCountPlan::kOrderedCount:
+    name = "OrderedCount";
+    break;
+  }
+  return {
+      {"algorithm", name},
+      {"edges_sorted", plan.edges_sorted()},
+      {"relabel", plan.relabeling() == TriangleCountPlan::kRelabel},
+  };
+}
+
+std::optional<TriangleCountPlan>
+MakeTriangleCountPlan(const nlohmann::json& j) {
+  std::string name = j.at("algorithm");
+  bool edges_sorted = j.at("edges_sorted");
+  TriangleCountPlan::Relabeling relabeling = TriangleCountPlan::kNoRelabel;
+  if (j.at("relabel").get<bool>()) {
+    relabeling = TriangleCountPlan::kRelabel;
+  }
+  if (name == "NodeIteration") {
+    return TriangleCountPlan::NodeIteration(edges_sorted, relabeling);
+  }
+  if (name == "EdgeIteration") {
+    return TriangleCountPlan::EdgeIteration(edges_sorted, relabeling);
+  }
+  if (name == "OrderedCount") {
+    return TriangleCountPlan::OrderedCount(edges_sorted, relabeling);
+  }
+  return std::nullopt;
+}
+
+//
+// Trials
+//
+
+template <typename PlanType>
+struct Trial {
+  PlanType plan;
+  double seconds;
+};
+
+/// The time left for the trials of one tuning
+class Budget {
+  using Clock = std::chrono::steady_clock;
+  std::optional<Clock::time_point> deadline_;
+
+public:
+  explicit Budget(double seconds) {
+    if (seconds > 0) {
+      deadline_ = Clock::now() + std::chrono::duration_cast<Clock::duration>(
+                                     std::chrono::duration<double>(seconds));
+    }
+  }
+
+  bool exhausted() const { return deadline_ && Clock::now() >= *deadline_; }
+};
+
+/// Time each candidate, which consists of num_runs calls run(plan, i), and
+/// replace best with the fastest candidate if it beats best. A candidate is
+/// abandoned as soon as it takes longer than best, and once the budget is
+/// exhausted the remaining candidates are skipped.
+template <typename PlanType, typename RunFn>
+katana::Result<void>
+RunTrials(
+    const std::vector<PlanType>& candidates, uint32_t num_runs,
+    const PlanTunerOptions& options, const Budget& budget, const RunFn& run,
+    std::optional<Trial<PlanType>>* best) {
+  for (const PlanType& plan : candidates) {
+    if (*best && budget.exhausted()) {
+      KATANA_LOG_VERBOSE(
+          "tuning budget exhausted, skipping {}", Describe(plan).dump());
+      continue;
+    }
+    double seconds = std::numeric_limits<double>::infinity();
+    for (uint32_t rep = 0; rep < std::max(options.num_repetitions, 1U);
+         ++rep) {
+      double elapsed = 0;
+      for (uint32_t i = 0; i < num_runs; ++i) {
+        katana::Timer timer;
+        timer.start();
+        if (auto res = run(plan, i); !res) {
+          return res.error().WithContext(
+              "running candidate {}", Describe(plan).dump());
+        }
+        timer.stop();
+        elapsed += timer.get_usec() / 1e6;
+        if (*best && elapsed >= (*best)->seconds) {
+          break;
+        }
+      }
+      seconds = std::min(seconds, elapsed);
+    }
+    KATANA_LOG_VERBOSE("candidate {}: {}s", Describe(plan).dump(), seconds);
+    if (!*best || seconds < (*best)->seconds) {
+      *best = Trial<PlanType>{plan, seconds};
+    }
+  }
+  return katana::ResultSuccess();
+}
+
+/// Return the plan for algorithm recorded in the profile or, failing that,
+/// the winner of search, which is then recorded
+template <typename PlanType, typename MakeFn, typename SearchFn>
+katana::Result<PlanType>
+TunePlan(
+    katana::PropertyGraph* pg, const std::string& algorithm,
+    const PlanTunerOptions& options, const MakeFn& make,
+    const SearchFn& search) {
+  auto stats_res = katana::GetGraphStats(pg);
+  if (!stats_res) {
+    return stats_res.error();
+  }
+  const katana::GraphStats& stats = stats_res.value();
+  std::string fingerprint = Fingerprint(stats);
+
+  auto profile_res = Profile::Load(options);
+  if (!profile_res) {
+    return profile_res.error();
+  }
+  Profile& profile = profile_res.value();
+
+  if (const nlohmann::json* recorded = profile.Find(fingerprint, algorithm);
+      recorded && !options.retune) {
+    std::optional<PlanType> plan;
+    try {
+      plan = make(*recorded);
+    } catch (const std::exception& exp) {
+      KATANA_LOG_DEBUG("malformed plan: {}", exp.what());
+    }
+    if (plan) {
+      return plan.value();
+    }
+    KATANA_LOG_WARN(
+        "ignoring unknown {} plan in {}: {}", algorithm, profile.path(),
+        recorded->dump());
+  }
+
+  std::optional<Trial<PlanType>> best;
+  Budget budget(options.time_budget_seconds);
+  if (auto res = search(stats, budget, &best); !res) {
+    return res.error();
+  }
+  KATANA_LOG_ASSERT(best);
+
+  nlohmann::json description = Describe(best->plan);
+  description["seconds"] = best->seconds;
+  if (auto res = profile.Record(fingerprint, algorithm, description); !res) {
+    return res.error();
+  }
+  return best->plan;
+}
+
+std::vector<uint32_t>
+PickSources(const katana::PropertyGraph& pg, uint32_t num_sources) {
+  std::vector<uint32_t> sources;
+  if (pg.num_edges() == 0) {
+    // SourcePicker looks for a node with edges
+    sources.emplace_back(0);
+    return sources;
+  }
+  katana::analytics::SourcePicker picker(pg);
+  for (uint32_t i = 0; i < std::max(num_sources, 1U); ++i) {
+    sources.emplace_back(picker.PickNext());
+  }
+  return sources;
+}
+
+/// Tile sizes tried in addition to the default one
+std::vector<ptrdiff_t>
+TileSizes(ptrdiff_t default_size) {
+  return {default_size / 4, default_size * 4};
+}
+
+/// Delta stepping processes one bucket of nodes per step, so a delta around
+/// the largest edge weight lets most relaxations land in the current or next
+/// bucket
+unsigned
+SuggestedDelta(const katana::GraphStats& stats, const std::string& weight) {
+  auto it = stats.edge_columns.find(weight);
+  if (it == stats.edge_columns.end() || !it->second.max ||
+      *it->second.max < 0) {
+    return SsspPlan::kDefaultDelta;
+  }
+  double bits = std::ceil(std::log2(*it->second.max + 1));
+  return std::min(static_cast<unsigned>(bits), kMaxDelta);
+}
+
+}  // namespace
+
+katana::Result<SsspPlan>
+katana::analytics::TuneSsspPlan(
+    PropertyGraph* pg, const std::string& edge_weight_property_name,
+    const PlanTunerOptions& options) {
+  auto search = [&](const GraphStats& stats, const Budget& budget,
+                    std::optional<Trial<SsspPlan>>* best) -> Result<void> {
+    std::vector<uint32_t> sources = PickSources(*pg, options.num_sources);
+    auto run = [&](const SsspPlan& plan, uint32_t i) -> Result<void> {
+      TemporaryPropertyGuard output(pg);
+      return Sssp(
+          pg, sources[i], edge_weight_property_name, output.name(), plan);
+    };
+
+    unsigned delta = SuggestedDelta(stats, edge_weight_property_name);
+    if (auto res = RunTrials<SsspPlan>(
+            {SsspPlan::DeltaStep(delta), SsspPlan::DeltaStepBarrier(delta),
+             SsspPlan::DeltaTile(delta),
+             SsspPlan::DeltaStep(
+                 SsspPlan::kAdaptiveDelta,
+                 SsspPlan::kAdaptiveFusionThreshold)},
+            sources.size(), options, budget, run, best);
+        !res) {
+      return res;
+    }
+
+    std::vector<SsspPlan> candidates;
+    const SsspPlan winner = (*best)->plan;
+    const unsigned default_delta = SsspPlan::kDefaultDelta;
+    for (unsigned d : {delta - 2, delta + 2, default_delta}) {
+      // delta - 2 wraps around for small deltas
+      if (d == delta || d > kMaxDelta) {
+        continue;
+      }
+      switch (winner.algorithm()) {
+      case SsspPlan::kDeltaTile:
+        candidates.emplace_back(SsspPlan::DeltaTile(
+            d, winner.edge_tile_size(), winner.fusion_threshold()));
+        break;
+      case SsspPlan::kDeltaStep:
+        candidates.emplace_back(
+            SsspPlan::DeltaStep(d, winner.fusion_threshold()));
+        break;
+      default:
+        candidates.emplace_back(
+            SsspPlan::DeltaStepBarrier(d, winner.fusion_threshold()));
+        break;
+      }
+    }
+    if (auto res = RunTrials(
+            candidates, sources.size(), options, budget, run, best);
+        !res) {
+      return res;
+    }
+
+    if ((*best)->plan.algorithm() != SsspPlan::kDeltaTile) {
+      return ResultSuccess();
+    }
+    candidates.clear();
+    for (ptrdiff_t size : TileSizes(SsspPlan::kDefaultEdgeTileSize)) {
+      candidates.emplace_back(
+          SsspPlan::DeltaTile((*best)->plan.delta(), size));
+    }
+    return RunTrials(candidates, sources.size(), options, budget, run, best);
+  };
+
+  return TunePlan<SsspPlan>(
+      pg, "sssp:" + edge_weight_property_name, options, MakeSsspPlan, search);
+}
+
+katana::Result<BfsPlan>
+katana::analytics::TuneBfsPlan(
+    PropertyGraph* pg, const PlanTunerOptions& options) {
+  auto search = [&](const GraphStats&, const Budget& budget,
+                    std::optional<Trial<BfsPlan>>* best) -> Result<void> {
+    std::vector<uint32_t> sources = PickSources(*pg, options.num_sources);
+    auto run = [&](const BfsPlan& plan, uint32_t i) -> Result<void> {
+      TemporaryPropertyGuard output(pg);
+      return Bfs(pg, sources[i], output.name(), plan);
+    };
+
+    if (auto res = RunTrials<BfsPlan>(
+            {BfsPlan::SynchronousTile(), BfsPlan::Synchronous(),
+             BfsPlan::AsynchronousTile(), BfsPlan::Asynchronous()},
+            sources.size(), options, budget, run, best);
+        !res) {
+      return res;
+    }
+
+    const BfsPlan winner = (*best)->plan;
+    std::vector<BfsPlan> candidates;
+    for (ptrdiff_t size : TileSizes(BfsPlan::kDefaultEdgeTileSize)) {
+      if (winner.algorithm() == BfsPlan::kSynchronousTile) {
+        candidates.emplace_back(BfsPlan::SynchronousTile(size));
+      } else if (winner.algorithm() == BfsPlan::kAsynchronousTile) {
+        candidates.emplace_back(BfsPlan::AsynchronousTile(size));
+      }
+    }
+    return RunTrials(candidates, sources.size(), options, budget, run, best);
+  };
+
+  return TunePlan<BfsPlan>(pg, "bfs", options, MakeBfsPlan, search);
+}
+
+katana::Result<ConnectedComponentsPlan>
+katana::analytics::TuneConnectedComponentsPlan(
+    PropertyGraph* pg, const PlanTunerOptions& options) {
+  using CcPlan = ConnectedComponentsPlan;
+  auto search = [&](const GraphStats&, const Budget& budget,
+                    std::optional<Trial<CcPlan>>* best) -> Result<void> {
+    auto run = [&](const CcPlan& plan, uint32_t) -> Result<void> {
+      TemporaryPropertyGuard output(pg);
+      return ConnectedComponents(pg, output.name(), plan);
+    };
+
+    if (auto res = RunTrials<CcPlan>(
+            {CcPlan::Afforest(), CcPlan::EdgeAfforest(),
+             CcPlan::EdgeTiledAfforest(), CcPlan::Asynchronous(),
+             CcPlan::EdgeTiledAsynchronous(), CcPlan::BlockedAsynchronous()},
+            1, options, budget, run, best);
+        !res) {
+      return res;
+    }
+
+    const CcPlan winner = (*best)->plan;
+    std::vector<CcPlan> candidates;
+    for (ptrdiff_t size : TileSizes(CcPlan::kDefaultEdgeTileSize)) {
+      if (winner.algorithm() == CcPlan::kEdgeTiledAfforest) {
+        candidates.emplace_back(CcPlan::EdgeTiledAfforest(size));
+      } else if (winner.algorithm() == CcPlan::kEdgeTiledAsynchronous) {
+        candidates.emplace_back(CcPlan::EdgeTiledAsynchronous(size));
+      }
+    }
+    return RunTrials(candidates, 1, options, budget, run, best);
+  };
+
+  return TunePlan<CcPlan>(
+      pg, "connected_components", options, MakeConnectedComponentsPlan,
+      search);
+}
+
+katana::Result<TriangleCountPlan>
+katana::analytics::TuneTriangleCountPlan(
+    PropertyGraph* pg, const PlanTunerOptions& options) {
+  using TcPlan = TriangleCountPlan;
+  auto search = [&](const GraphStats& stats, const Budget& budget,
+                    std::optional<Trial<TcPlan>>* best) -> Result<void> {
+    auto run = [&](const TcPlan& plan, uint32_t) -> Result<void> {
+      if (auto res = TriangleCount(pg, plan); !res) {
+        return res.error();
+      }
+      return ResultSuccess();
+    };
+
+    // the statistics tell whether sorting can be skipped, so only the
+    // algorithm and relabeling are left to trials
+    bool sorted = stats.edges_sorted();
+    if (auto res = RunTrials<TcPlan>(
+            {TcPlan::OrderedCount(sorted, TcPlan::kNoRelabel),
+             TcPlan::NodeIteration(sorted, TcPlan::kNoRelabel),
+             TcPlan::EdgeIteration(sorted, TcPlan::kNoRelabel)},
+            1, options, budget, run, best);
+        !res) {
+      return res;
+    }
+
+    std::vector<TcPlan> candidates;
+    switch ((*best)->plan.algorithm()) {
+    case TcPlan::kNodeIteration:
+      candidates.emplace_back(TcPlan::NodeIteration(sorted, TcPlan::kRelabel));
+      break;
+    case TcPlan::kEdgeIteration:
+      candidates.emplace_back(TcPlan::EdgeIteration(sorted, TcPlan::kRelabel));
+      break;
+    case TcPlan::kOrderedCount:
+      candidates.emplace_back(TcPlan::OrderedCount(sorted, TcPlan::kRelabel));
+      break;
+    }
+    return RunTrials(candidates, 1, options, budget, run, best);
+  };
+
+  return TunePlan<TcPlan>(
+      pg, "triangle_count", options, MakeTriangleCountPlan, search);
+}
@@ -19,6 +19,7 @@
 
 #include "katana/analytics/Utils.h"
 
+#include "katana/GraphStats.h"
 #include "katana/Random.h"
 
 uint32_t
@@ -43,6 +44,17 @@ katana::analytics::IsApproximateDegreeDistributionPowerLaw(
   if (averageDegree < 10) {
     return false;
   }
+  // the cached statistics cover every node, so the sample is not needed
+  if (auto stats = CachedGraphStats(graph); stats) {
+    const DegreeDistribution& degree = stats->out_degree;
+    uint64_t num_nonzero = stats->num_nodes - degree.num_zero;
+    if (num_nonzero == 0) {
+      return false;
+    }
+    double nonzero_average =
+        static_cast<double>(stats->num_edges) / num_nonzero;
+    return nonzero_average / 1.3 > degree.nonzero_median;
+  }
   katana::StatTimer autoAlgoTimer("IsApproximateDegreeDistributionPowerLaw");
   autoAlgoTimer.start();
   SourcePicker sp(graph);
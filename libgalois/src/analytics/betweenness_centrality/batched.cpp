@@ -0,0 +1,304 @@
+/*
+ * This file belongs to the Galois project, a C++ library for exploiting
+ * parallelism. The code is being released under the terms of the 3-Clause BSD
+ * License (a copy is located in LICENSE.txt at the top-level directory).
+ *
+ * Copyright (C) 2020, The University of Texas at Austin. All rights reserved.
+ * UNIVERSITY EXPRESSLY DISCLAIMS ANY AND ALL WARRANTIES CONCERNING THIS
+ * SOFTWARE AND DOCUMENTATION, INCLUDING ANY WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR ANY PARTICULAR PURPOSE, NON-INFRINGEMENT AND WARRANTIES OF
+ * PERFORMANCE, AND ANY WARRANTY THAT MIGHT OTHERWISE ARISE FROM COURSE OF
+ * DEALING OR USAGE OF TRADE.  NO WARRANTY IS EITHER EXPRESS OR IMPLIED WITH
+ * RESPECT TO THE USE OF THE SOFTWARE OR DOCUMENTATION. Under no circumstances
+ * shall University be liable for incidental, special, indirect, direct or
+ * consequential damages or loss of profits, interruption of business, or
+ * related expenses which may arise from use of Software or Documentation,
+ * including but not limited to those resulting from defects in Software and/or
+ * Documentation, or loss or inaccuracy of data of any kind.
+ */
+
+#include "betweenness_centrality_impl.h"
+#include "katana/AtomicHelpers.h"
+#include "katana/LargeArray.h"
+#include "katana/Properties.h"
+#include "katana/TypedPropertyGraph.h"
+
+using namespace katana::analytics;
+
+namespace {
+
+constexpr static uint32_t kInfinity = std::numeric_limits<uint32_t>::max();
+
+struct NodeBC : public katana::PODProperty<float> {};
+
+using NodeDataBatched = std::tuple<NodeBC>;
+using EdgeDataBatched = std::tuple<>;
+
+typedef katana::TypedPropertyGraph<NodeDataBatched, EdgeDataBatched>
+    BatchedGraph;
+typedef typename BatchedGraph::Node BatchedGNode;
+
+using BatchedWorklistType = katana::InsertBag<BatchedGNode, 4096>;
+
+/// One bit per source of a batch.
+using LaneMask = uint64_t;
+
+constexpr static const unsigned kBatchedChunkSize = 64u;
+
+/**
+ * Brandes over up to kMaxBatchSize sources at once.
+ *
+ * Every source of a batch is a lane. The distance, number of shortest paths
+ * and dependency of node n for lane l live at n * batch_size + l, so a node
+ * touches one or two cache lines for the whole batch and each edge is scanned
+ * once per level for all the lanes that reached its source at that level.
+ */
+class BatchedBrandes {
+  BatchedGraph* graph_;
+  const uint32_t batch_size_;
+
+  katana::LargeArray<std::atomic<uint32_t>> distance_;
+  katana::LargeArray<std::atomic<double>> num_shortest_paths_;
+  katana::LargeArray<float> dependency_;
+  // Last level a node was put on; a node reached by several lanes in the
+  // same level is only put on that level's worklist once.
+  katana::LargeArray<std::atomic<uint32_t>> queued_level_;
+
+  uint64_t Index(BatchedGNode n, uint32_t lane) const {
+    return uint64_t{n} * batch_size_ + lane;
+  }
+
+  LaneMask LanesAtLevel(BatchedGNode n, uint32_t level) const {
+    LaneMask lanes = 0;
+    for (uint32_t lane = 0; lane < batch_size_; ++lane) {
+      if (distance_[Index(n, lane)].load(std::memory_order_relaxed) == level) {
+        lanes |= LaneMask{1} << lane;
+      }
+    }
+    return lanes;
+  }
+
+  void Queue(BatchedGNode n, uint32_t level, BatchedWorklistType* worklist) {
+    if (queued_level_[n].exchange(level, std::memory_order_relaxed) != level) {
+      worklist->push(n);
+    }
+  }
+
+  void ResetBatch() {
+    katana::do_all(
+        katana::iterate(*graph_),
+        [&](BatchedGNode n) {
+          for (uint32_t lane = 0; lane < batch_size_; ++lane) {
+            distance_[Index(n, lane)].store(
+                kInfinity, std::memory_order_relaxed);
+            num_shortest_paths_[Index(n, lane)].store(
+                0, std::memory_order_relaxed);
+            dependency_[Index(n, lane)] = 0;
+          }
+          queued_level_[n].store(kInfinity, std::memory_order_relaxed);
+        },
+        katana::no_stats(), katana::loopname("BatchedInitializeIteration"));
+  }
+
+  /**
+   * Forward phase: level-synchronous BFS from every lane of the batch,
+   * counting shortest paths. Returns the worklist of each level for the
+   * backward phase; the last one is empty.
+   */
+  katana::gstl::Vector<BatchedWorklistType> BatchedSSSP(
+      const BatchedGNode* sources, uint32_t num_sources) {
+    katana::gstl::Vector<BatchedWorklistType> vector_of_worklists;
+    vector_of_worklists.emplace_back();
+    for (uint32_t lane = 0; lane < num_sources; ++lane) {
+      distance_[Index(sources[lane], lane)] = 0;
+      num_shortest_paths_[Index(sources[lane], lane)] = 1;
+      Queue(sources[lane], 0, &vector_of_worklists[0]);
+    }
+
+    for (uint32_t current_level = 0;
+         !vector_of_worklists[current_level].empty(); ++current_level) {
+      vector_of_worklists.emplace_back();
+      uint32_t next_level = current_level + 1;
+      BatchedWorklistType& next_worklist = vector_of_worklists[next_level];
+
+      katana::do_all(
+          katana::iterate(vector_of_worklists[current_level]),
+          [&](BatchedGNode n) {
+            LaneMask lanes = LanesAtLevel(n, current_level);
+
+            for (auto e : graph_->edges(n)) {
+              auto dest = *graph_->GetEdgeDest(e);
+
+              for (LaneMask m = lanes; m != 0; m &= m - 1) {
+                uint32_t lane = __builtin_ctzll(m);
+                auto& dest_distance = distance_[Index(dest, lane)];
+                uint32_t dist = dest_distance.load(std::memory_order_relaxed);
+                if (dist == kInfinity) {
+                  if (dest_distance.compare_exchange_strong(dist, next_level)) {
+                    dist = next_level;
+                    Queue(dest, next_level, &next_worklist);
+                  }
+                }
+                if (dist == next_level) {
+                  katana::atomicAdd(
+                      num_shortest_paths_[Index(dest, lane)],
+                      num_shortest_paths_[Index(n, lane)].load(
+                          std::memory_order_relaxed));
+                }
+              }
+            }
+          },
+          katana::steal(), katana::chunk_size<kBatchedChunkSize>(),
+          katana::no_stats(), katana::loopname("BatchedSSSP"));
+    }
+    return vector_of_worklists;
+  }
+
+  /**
+   * Backward phase: propagate dependencies level by level for every lane and
+   * accumulate the lane sum into the centrality of each node.
+   */
+  void BatchedBackwardBrandes(
+      katana::gstl::Vector<BatchedWorklistType>* vector_of_worklists) {
+    // minus 3 because last one is empty, one after is leaf nodes, and one
+    // to correct indexing to 0 index
+    if (vector_of_worklists->size() < 3) {
+      return;
+    }
+    // level 0 only holds sources, which get no dependency from their own lane
+    for (uint32_t current_level = vector_of_worklists->size() - 3;
+         current_level > 0; --current_level) {
+      uint32_t successor_level = current_level + 1;
+
+      katana::do_all(
+          katana::iterate((*vector_of_worklists)[current_level]),
+          [&](BatchedGNode n) {
+            LaneMask lanes = LanesAtLevel(n, current_level);
+
+            for (auto e : graph_->edges(n)) {
+              auto dest = *graph_->GetEdgeDest(e);
+
+              for (LaneMask m = lanes; m != 0; m &= m - 1) {
+                uint32_t lane = __builtin_ctzll(m);
+                if (distance_[Index(dest, lane)].load(
+                        std::memory_order_relaxed) == successor_level) {
+                  dependency_[Index(n, lane)] +=
+                      (1.0f + dependency_[Index(dest, lane)]) /
+                      num_shortest_paths_[Index(dest, lane)].load(
+                          std::memory_order_relaxed);
+                }
+              }
+            }
+
+            float contribution = 0;
+            for (LaneMask m = lanes; m != 0; m &= m - 1) {
+              uint32_t lane = __builtin_ctzll(m);
+              dependency_[Index(n, lane)] *=
+                  num_shortest_paths_[Index(n, lane)].load(
+                      std::memory_order_relaxed);
+              contribution += dependency_[Index(n, lane)];
+            }
+            graph_->GetData<NodeBC>(n) += contribution;
+          },
+          katana::steal(), katana::chunk_size<kBatchedChunkSize>(),
+          katana::no_stats(), katana::loopname("BatchedBrandes"));
+    }
+  }
+
+public:
+  BatchedBrandes(BatchedGraph* graph, uint32_t batch_size)
+      : graph_(graph), batch_size_(batch_size) {
+    distance_.allocateBlocked(graph->num_nodes() * batch_size);
+    num_shortest_paths_.allocateBlocked(graph->num_nodes() * batch_size);
+    dependency_.allocateBlocked(graph->num_nodes() * batch_size);
+    queued_level_.allocateBlocked(graph->num_nodes());
+  }
+
+  void Run(const BatchedGNode* sources, uint32_t num_sources) {
+    KATANA_LOG_DEBUG_ASSERT(num_sources <= batch_size_);
+    ResetBatch();
+    katana::gstl::Vector<BatchedWorklistType> worklists =
+        BatchedSSSP(sources, num_sources);
+    BatchedBackwardBrandes(&worklists);
+  }
+};
+
+}  // namespace
+
+katana::Result<void>
+BetweennessCentralityBatched(
+    katana::PropertyGraph* pg,
+    katana::analytics::BetweennessCentralitySources sources,
+    const std::string& output_property_name,
+    katana::analytics::BetweennessCentralityPlan plan) {
+  const uint32_t batch_size = plan.batch_size();
+  if (batch_size == 0 ||
+      batch_size > BetweennessCentralityPlan::kMaxBatchSize) {
+    return KATANA_ERROR(
+        katana::ErrorCode::InvalidArgument,
+        "batch size must be between 1 and {}",
+        BetweennessCentralityPlan::kMaxBatchSize);
+  }
+  katana::ReportStatSingle("BetweennessCentrality", "BatchSize", batch_size);
+  katana::reportPageAlloc("MemAllocPre");
+
+  katana::StatTimer graph_construct_timer(
+      "TimerConstructGraph", "BetweennessCentrality");
+  graph_construct_timer.start();
+
+  if (auto result = ConstructNodeProperties<NodeDataBatched>(
+          pg, {output_property_name});
+      !result) {
+    return result.error();
+  }
+
+  auto pg_result =
+      BatchedGraph::Make(pg, {output_property_name}, /* edge properties */ {});
+  if (!pg_result) {
+    return pg_result.error();
+  }
+  BatchedGraph graph = pg_result.value();
+
+  graph_construct_timer.stop();
+
+  katana::do_all(
+      katana::iterate(graph),
+      [&](BatchedGNode n) { graph.GetData<NodeBC>(n) = 0; }, katana::no_stats(),
+      katana::loopname("InitializeGraph"));
+
+  std::vector<BatchedGNode> source_vector;
+  if (std::holds_alternative<std::vector<uint32_t>>(sources)) {
+    source_vector = std::get<std::vector<uint32_t>>(sources);
+    for (auto src : source_vector) {
+      if (src >= graph.num_nodes()) {
+        return KATANA_ERROR(
+            katana::ErrorCode::InvalidArgument, "source {} is not in the graph",
+            src);
+      }
+    }
+  } else {
+    uint64_t num_sources = graph.num_nodes();
+    if (sources != kBetweennessCentralityAllNodes) {
+      num_sources =
+          std::min<uint64_t>(num_sources, std::get<uint32_t>(sources));
+    }
+    source_vector.resize(num_sources);
+    std::iota(source_vector.begin(), source_vector.end(), 0);
+  }
+
+  BatchedBrandes batched(&graph, batch_size);
+  katana::reportPageAlloc("MemAllocMid");
+
+  katana::StatTimer exec_time("Batched", "BetweennessCentrality");
+  exec_time.start();
+  for (size_t i = 0; i < source_vector.size(); i += batch_size) {
+    uint32_t num_sources =
+        std::min<size_t>(batch_size, source_vector.size() - i);
+    batched.Run(source_vector.data() + i, num_sources);
+  }
+  exec_time.stop();
+
+  katana::reportPageAlloc("MemAllocPost");
+
+  return katana::ResultSuccess();
+}
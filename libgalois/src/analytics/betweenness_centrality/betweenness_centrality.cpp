@@ -41,6 +41,12 @@ katana::analytics::BetweennessCentrality(
     return BetweennessCentralityLevel(pg, sources, output_property_name, plan);
   case BetweennessCentralityPlan::kOuter:
     return BetweennessCentralityOuter(pg, sources, output_property_name, plan);
+  case BetweennessCentralityPlan::kBatched:
+    return BetweennessCentralityBatched(
+        pg, sources, output_property_name, plan);
+  case BetweennessCentralityPlan::kAdaptiveSampling:
+    return BetweennessCentralityAdaptiveSampling(
+        pg, output_property_name, plan);
   default:
     return katana::ErrorCode::InvalidArgument;
   }
@@ -0,0 +1,347 @@
+/*
+ * This file belongs to the Galois project, a C++ library for exploiting
+ * parallelism. The code is being released under the terms of the 3-Clause BSD
+ * License (a copy is located in LICENSE.txt at the top-level directory).
+ *
+ * Copyright (C) 2020, The University of Texas at Austin. All rights reserved.
+ * UNIVERSITY EXPRESSLY DISCLAIMS ANY AND ALL WARRANTIES CONCERNING THIS
+ * SOFTWARE AND DOCUMENTATION, INCLUDING ANY WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR ANY PARTICULAR PURPOSE, NON-INFRINGEMENT AND WARRANTIES OF
+ * PERFORMANCE, AND ANY WARRANTY THAT MIGHT OTHERWISE ARISE FROM COURSE OF
+ * DEALING OR USAGE OF TRADE.  NO WARRANTY IS EITHER EXPRESS OR IMPLIED WITH
+ * RESPECT TO THE USE OF THE SOFTWARE OR DOCUMENTATION. Under no circumstances
+ * shall University be liable for incidental, special, indirect, direct or
+ * consequential damages or loss of profits, interruption of business, or
+ * related expenses which may arise from use of Software or Documentation,
+ * including but not limited to those resulting from defects in Software and/or
+ * Documentation, or loss or inaccuracy of data of any kind.
+ */
+
+#include <cmath>
+
+#include "betweenness_centrality_impl.h"
+#include "katana/LargeArray.h"
+#include "katana/ParallelSTL.h"
+#include "katana/Properties.h"
+#include "katana/TypedPropertyGraph.h"
+
+using namespace katana::analytics;
+
+namespace {
+
+constexpr static uint32_t kInfinity = std::numeric_limits<uint32_t>::max();
+
+struct NodeBC : public katana::PODProperty<float> {};
+
+using NodeDataSampling = std::tuple<NodeBC>;
+using EdgeDataSampling = std::tuple<>;
+
+typedef katana::TypedPropertyGraph<NodeDataSampling, EdgeDataSampling>
+    SamplingGraph;
+typedef typename SamplingGraph::Node SamplingGNode;
+
+/// Number of samples drawn between two evaluations of the stopping condition.
+constexpr static uint64_t kSamplesPerRound = 4096;
+
+/// Universal constant of the VC-dimension sample bound, as estimated by
+/// Loffler and Phillips and used by Riondato and Kornaropoulos.
+constexpr static double kSampleBoundConstant = 0.5;
+
+/// splitmix64; every sample seeds its own generator from its index so the
+/// result does not depend on which thread draws which sample.
+class SampleRandom {
+  uint64_t state_;
+
+public:
+  explicit SampleRandom(uint64_t seed) : state_(seed) {}
+
+  uint64_t Next() {
+    uint64_t z = (state_ += 0x9e3779b97f4a7c15ULL);
+    z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ULL;
+    z = (z ^ (z >> 27)) * 0x94d049bb133111ebULL;
+    return z ^ (z >> 31);
+  }
+
+  uint64_t Below(uint64_t bound) { return Next() % bound; }
+
+  double Uniform() { return (Next() >> 11) * 0x1.0p-53; }
+};
+
+/// Per-thread BFS state. distance and num_shortest_paths are only reset for
+/// the nodes a sample touched.
+struct SampleScratch {
+  std::vector<uint32_t> distance;
+  std::vector<double> num_shortest_paths;
+  std::vector<std::vector<SamplingGNode>> levels;
+
+  void Init(size_t num_nodes) {
+    distance.assign(num_nodes, kInfinity);
+    num_shortest_paths.assign(num_nodes, 0);
+  }
+
+  void Reset() {
+    for (auto& level : levels) {
+      for (auto n : level) {
+        distance[n] = kInfinity;
+        num_shortest_paths[n] = 0;
+      }
+      level.clear();
+    }
+  }
+};
+
+/// Passed as dst to CountShortestPaths to run the BFS to completion.
+constexpr static SamplingGNode kNoTarget = kInfinity;
+
+/**
+ * BFS from src, level by level, counting shortest paths. Unless dst is
+ * kNoTarget the search stops once the level containing dst is complete.
+ *
+ * @returns the number of non-empty levels
+ */
+uint32_t
+CountShortestPaths(
+    const SamplingGraph& graph, SamplingGNode src, SamplingGNode dst,
+    SampleScratch* scratch) {
+  auto& distance = scratch->distance;
+  auto& num_shortest_paths = scratch->num_shortest_paths;
+  auto& levels = scratch->levels;
+
+  if (levels.empty()) {
+    levels.emplace_back();
+  }
+  distance[src] = 0;
+  num_shortest_paths[src] = 1;
+  levels[0].push_back(src);
+
+  uint32_t current_level = 0;
+  while (!levels[current_level].empty() &&
+         (dst == kNoTarget || distance[dst] == kInfinity)) {
+    uint32_t next_level = current_level + 1;
+    if (levels.size() <= next_level) {
+      levels.emplace_back();
+    }
+    for (auto n : levels[current_level]) {
+      for (auto e : graph.edges(n)) {
+        auto dest = *graph.GetEdgeDest(e);
+        if (distance[dest] == kInfinity) {
+          distance[dest] = next_level;
+          levels[next_level].push_back(dest);
+        }
+        if (distance[dest] == next_level) {
+          num_shortest_paths[dest] += num_shortest_paths[n];
+        }
+      }
+    }
+    current_level = next_level;
+  }
+  return current_level;
+}
+
+/**
+ * Sample a shortest path from src to dst uniformly at random and call fn on
+ * each of its interior nodes. Nothing is counted if dst is not reachable.
+ *
+ * Predecessors are found by scanning the out edges of the previous level since
+ * the graph has no in edges; that costs no more than the BFS itself.
+ */
+template <typename Fn>
+void
+SampleShortestPath(
+    const SamplingGraph& graph, SamplingGNode src, SamplingGNode dst,
+    SampleRandom* random, SampleScratch* scratch, Fn fn) {
+  CountShortestPaths(graph, src, dst, scratch);
+
+  auto& distance = scratch->distance;
+  auto& num_shortest_paths = scratch->num_shortest_paths;
+
+  if (distance[dst] != kInfinity) {
+    SamplingGNode current = dst;
+    for (uint32_t level = distance[dst]; level > 1; --level) {
+      // pick a predecessor with probability proportional to its path count
+      double target = random->Uniform() * num_shortest_paths[current];
+      double seen = 0;
+      SamplingGNode chosen = current;
+      for (auto n : scratch->levels[level - 1]) {
+        for (auto e : graph.edges(n)) {
+          if (*graph.GetEdgeDest(e) == current) {
+            seen += num_shortest_paths[n];
+            chosen = n;
+          }
+        }
+        if (seen > target) {
+          break;
+        }
+      }
+      KATANA_LOG_DEBUG_ASSERT(chosen != current);
+      fn(chosen);
+      current = chosen;
+    }
+  }
+
+  scratch->Reset();
+}
+
+/// Upper bound on the number of nodes of a shortest path: twice the
+/// eccentricity of a random node, plus one. Exact bound for undirected
+/// graphs; a heuristic for directed ones.
+uint32_t
+EstimateVertexDiameter(
+    const SamplingGraph& graph, SampleRandom* random, SampleScratch* scratch) {
+  SamplingGNode src = random->Below(graph.num_nodes());
+  uint32_t num_levels = CountShortestPaths(graph, src, kNoTarget, scratch);
+  scratch->Reset();
+  return 2 * (num_levels - 1) + 1;
+}
+
+/// KADABRA's bound on the gap between the estimate b and the lower end of the
+/// confidence interval after tau of at most omega samples.
+double
+LowerGap(double b, double log_inv_delta, double omega, double tau) {
+  double a = 1.0 / 3 - omega / tau;
+  return log_inv_delta / tau *
+         (a + std::sqrt(a * a + 2 * b * omega / log_inv_delta));
+}
+
+/// KADABRA's bound on the gap between the estimate b and the upper end of the
+/// confidence interval after tau of at most omega samples.
+double
+UpperGap(double b, double log_inv_delta, double omega, double tau) {
+  double a = 1.0 / 3 + omega / tau;
+  return log_inv_delta / tau *
+         (a + std::sqrt(a * a + 2 * b * omega / log_inv_delta));
+}
+
+}  // namespace
+
+katana::Result<void>
+BetweennessCentralityAdaptiveSampling(
+    katana::PropertyGraph* pg, const std::string& output_property_name,
+    katana::analytics::BetweennessCentralityPlan plan) {
+  const double epsilon = plan.epsilon();
+  const double failure_probability = plan.failure_probability();
+  if (!(epsilon > 0 && epsilon < 1)) {
+    return KATANA_ERROR(
+        katana::ErrorCode::InvalidArgument, "epsilon must be in (0, 1)");
+  }
+  if (!(failure_probability > 0 && failure_probability < 1)) {
+    return KATANA_ERROR(
+        katana::ErrorCode::InvalidArgument,
+        "failure probability must be in (0, 1)");
+  }
+
+  katana::StatTimer graph_construct_timer(
+      "TimerConstructGraph", "BetweennessCentrality");
+  graph_construct_timer.start();
+
+  if (auto result = ConstructNodeProperties<NodeDataSampling>(
+          pg, {output_property_name});
+      !result) {
+    return result.error();
+  }
+
+  auto pg_result =
+      SamplingGraph::Make(pg, {output_property_name}, /* edge properties */ {});
+  if (!pg_result) {
+    return pg_result.error();
+  }
+  SamplingGraph graph = pg_result.value();
+
+  graph_construct_timer.stop();
+
+  const uint64_t num_nodes = graph.num_nodes();
+  katana::do_all(
+      katana::iterate(graph),
+      [&](SamplingGNode n) { graph.GetData<NodeBC>(n) = 0; },
+      katana::no_stats(), katana::loopname("InitializeGraph"));
+  if (num_nodes < 2) {
+    return katana::ResultSuccess();
+  }
+
+  katana::PerThreadStorage<SampleScratch> scratch;
+  katana::on_each(
+      [&](unsigned, unsigned) { scratch.getLocal()->Init(num_nodes); });
+
+  katana::StatTimer exec_time("AdaptiveSampling", "BetweennessCentrality");
+  exec_time.start();
+
+  SampleRandom seed_random(plan.seed());
+  uint32_t vertex_diameter =
+      EstimateVertexDiameter(graph, &seed_random, scratch.getLocal());
+
+  // Half of the failure probability goes to the static bound on the number of
+  // samples, the other half is split evenly among the per-node bounds.
+  double log_vd =
+      vertex_diameter > 2 ? std::floor(std::log2(vertex_diameter - 2)) : 0;
+  const double omega = kSampleBoundConstant / (epsilon * epsilon) *
+                       (log_vd + 1 + std::log(2 / failure_probability));
+  const double log_inv_delta =
+      std::log(4.0 * num_nodes / failure_probability);
+  const uint64_t max_samples = std::ceil(omega);
+
+  katana::LargeArray<std::atomic<uint64_t>> counts;
+  counts.allocateBlocked(num_nodes);
+  katana::do_all(
+      katana::iterate(uint64_t{0}, num_nodes),
+      [&](uint64_t n) { counts[n].store(0, std::memory_order_relaxed); },
+      katana::no_stats());
+
+  const uint64_t base_seed = seed_random.Next();
+  uint64_t num_samples = 0;
+  while (num_samples < max_samples) {
+    uint64_t round_end = std::min(num_samples + kSamplesPerRound, max_samples);
+
+    katana::do_all(
+        katana::iterate(num_samples, round_end),
+        [&](uint64_t sample) {
+          SampleRandom random(base_seed ^ SampleRandom(sample).Next());
+          SamplingGNode src = random.Below(num_nodes);
+          SamplingGNode dst = random.Below(num_nodes - 1);
+          if (dst >= src) {
+            ++dst;
+          }
+          SampleShortestPath(
+              graph, src, dst, &random, scratch.getLocal(),
+              [&](SamplingGNode n) {
+                counts[n].fetch_add(1, std::memory_order_relaxed);
+              });
+        },
+        katana::steal(), katana::no_stats(),
+        katana::loopname("BetweennessCentralitySample"));
+    num_samples = round_end;
+
+    // Stop early once every estimate is within epsilon with the required
+    // confidence.
+    const double tau = num_samples;
+    auto not_converged = katana::ParallelSTL::find_if(
+        counts.begin(), counts.end(), [&](const std::atomic<uint64_t>& c) {
+          double b = c.load(std::memory_order_relaxed) / tau;
+          return LowerGap(b, log_inv_delta, omega, tau) > epsilon ||
+                 UpperGap(b, log_inv_delta, omega, tau) > epsilon;
+        });
+    if (not_converged == counts.end()) {
+      break;
+    }
+  }
+
+  // Report the estimates on the scale of the exact algorithms: the normalized
+  // centrality is over the n * (n - 1) ordered pairs.
+  const double scale = static_cast<double>(num_nodes) * (num_nodes - 1) /
+                       static_cast<double>(num_samples);
+  katana::do_all(
+      katana::iterate(graph),
+      [&](SamplingGNode n) {
+        graph.GetData<NodeBC>(n) =
+            counts[n].load(std::memory_order_relaxed) * scale;
+      },
+      katana::no_stats(), katana::loopname("BetweennessCentralityScale"));
+
+  exec_time.stop();
+
+  katana::ReportStatSingle(
+      "BetweennessCentrality", "VertexDiameterEstimate", vertex_diameter);
+  katana::ReportStatSingle("BetweennessCentrality", "MaxSamples", max_samples);
+  katana::ReportStatSingle("BetweennessCentrality", "Samples", num_samples);
+
+  return katana::ResultSuccess();
+}
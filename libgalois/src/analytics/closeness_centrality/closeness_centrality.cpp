@@ -0,0 +1,521 @@
+/*
+ * This file belongs to the Galois project, a C++ library for exploiting
+ * parallelism. The code is being released under the terms of the 3-Clause BSD
+ * License (a copy is located in LICENSE.txt at the top-level directory).
+ *
+ * Copyright (C) 2020, The University of Texas at Austin. All rights reserved.
+ * UNIVERSITY EXPRESSLY DISCLAIMS ANY AND ALL WARRANTIES CONCERNING THIS
+ * SOFTWARE AND DOCUMENTATION, INCLUDING ANY WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR ANY PARTICULAR PURPOSE, NON-INFRINGEMENT AND WARRANTIES OF
+ * PERFORMANCE, AND ANY WARRANTY THAT MIGHT OTHERWISE ARISE FROM COURSE OF
+ * DEALING OR USAGE OF TRADE.  NO WARRANTY IS EITHER EXPRESS OR IMPLIED WITH
+ * RESPECT TO THE USE OF THE SOFTWARE OR DOCUMENTATION. Under no circumstances
+ * shall University be liable for incidental, special, indirect, direct or
+ * consequential damages or loss of profits, interruption of business, or
+ * related expenses which may arise from use of Software or Documentation,
+ * including but not limited to those resulting from defects in Software and/or
+ * Documentation, or loss or inaccuracy of data of any kind.
+ */
+
+#include "katana/analytics/closeness_centrality/closeness_centrality.h"
+
+#include <cmath>
+#include <cstring>
+
+#include "katana/Bag.h"
+#include "katana/DynamicBitset.h"
+#include "katana/LargeArray.h"
+#include "katana/TypedPropertyGraph.h"
+#include "katana/analytics/BfsSsspImplementationBase.h"
+
+using namespace katana::analytics;
+
+namespace {
+
+/// The tag for the output property of closeness and harmonic centrality in
+/// TypedPropertyGraphs.
+using NodeCentrality = katana::PODProperty<double>;
+
+using ClosenessImplementation = BfsSsspImplementationBase<
+    katana::TypedPropertyGraph<std::tuple<NodeCentrality>, std::tuple<>>,
+    unsigned int, false>;
+
+using Graph = ClosenessImplementation::Graph;
+using GNode = ClosenessImplementation::GNode;
+using Dist = ClosenessImplementation::Dist;
+using OutEdgeRangeFn = ClosenessImplementation::OutEdgeRangeFn;
+
+/// One bit per source of a multi-source BFS.
+using LaneMask = uint64_t;
+constexpr static uint32_t kNumLanes = 64;
+
+constexpr static unsigned kChunkSize = 256U;
+
+/// Per node: the number of other nodes reachable from it and the sum of their
+/// distances and of their inverse distances. Estimates for the approximate
+/// algorithms.
+struct DistanceSums {
+  katana::LargeArray<double> reached;
+  katana::LargeArray<double> distance_sum;
+  katana::LargeArray<double> harmonic_sum;
+
+  explicit DistanceSums(size_t num_nodes) {
+    reached.allocateBlocked(num_nodes);
+    distance_sum.allocateBlocked(num_nodes);
+    harmonic_sum.allocateBlocked(num_nodes);
+    katana::do_all(
+        katana::iterate(size_t{0}, num_nodes),
+        [&](size_t n) {
+          reached[n] = 0;
+          distance_sum[n] = 0;
+          harmonic_sum[n] = 0;
+        },
+        katana::no_stats());
+  }
+};
+
+/// splitmix64
+uint64_t
+Mix(uint64_t x) {
+  uint64_t z = x + 0x9e3779b97f4a7c15ULL;
+  z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ULL;
+  z = (z ^ (z >> 27)) * 0x94d049bb133111ebULL;
+  return z ^ (z >> 31);
+}
+
+/**
+ * Multi-source BFS (Then et al., "The More the Merrier") over up to kNumLanes
+ * sources. Bit l of a node's masks stands for the l-th source, so a single
+ * scan of an edge advances every source whose frontier contains the edge's
+ * source node.
+ */
+class MultiSourceBfs {
+  Graph* graph_;
+  OutEdgeRangeFn out_edges_;
+  katana::LargeArray<LaneMask> seen_;
+  katana::LargeArray<LaneMask> frontier_;
+  katana::LargeArray<std::atomic<LaneMask>> next_;
+
+public:
+  explicit MultiSourceBfs(Graph* graph) : graph_(graph), out_edges_{graph} {
+    seen_.allocateBlocked(graph->num_nodes());
+    frontier_.allocateBlocked(graph->num_nodes());
+    next_.allocateBlocked(graph->num_nodes());
+  }
+
+  /// Calls visit(node, lanes, level) concurrently, once per node and level,
+  /// with the lanes whose source first reaches node at that level (>= 1).
+  template <typename Visit>
+  void Run(const GNode* sources, uint32_t num_sources, const Visit& visit) {
+    KATANA_LOG_DEBUG_ASSERT(num_sources <= kNumLanes);
+    katana::do_all(
+        katana::iterate(*graph_),
+        [&](GNode n) {
+          seen_[n] = 0;
+          frontier_[n] = 0;
+          next_[n].store(0, std::memory_order_relaxed);
+        },
+        katana::no_stats(), katana::loopname("MultiSourceBfsReset"));
+
+    auto current = std::make_unique<katana::InsertBag<GNode>>();
+    auto next = std::make_unique<katana::InsertBag<GNode>>();
+    katana::InsertBag<GNode> touched;
+
+    for (uint32_t lane = 0; lane < num_sources; ++lane) {
+      GNode src = sources[lane];
+      if (frontier_[src] == 0) {
+        current->push(src);
+      }
+      seen_[src] |= LaneMask{1} << lane;
+      frontier_[src] |= LaneMask{1} << lane;
+    }
+
+    for (Dist level = 1; !current->empty(); ++level) {
+      katana::do_all(
+          katana::iterate(*current),
+          [&](GNode n) {
+            LaneMask lanes = frontier_[n];
+            for (auto e : out_edges_(n)) {
+              auto dest = *graph_->GetEdgeDest(e);
+              if (next_[dest].fetch_or(lanes, std::memory_order_relaxed) == 0) {
+                touched.push(dest);
+              }
+            }
+          },
+          katana::steal(), katana::chunk_size<kChunkSize>(),
+          katana::no_stats(), katana::loopname("MultiSourceBfsExpand"));
+
+      katana::do_all(
+          katana::iterate(touched),
+          [&](GNode n) {
+            LaneMask lanes =
+                next_[n].exchange(0, std::memory_order_relaxed) & ~seen_[n];
+            if (lanes != 0) {
+              seen_[n] |= lanes;
+              frontier_[n] = lanes;
+              next->push(n);
+              visit(n, lanes, level);
+            }
+          },
+          katana::steal(), katana::chunk_size<kChunkSize>(),
+          katana::no_stats(), katana::loopname("MultiSourceBfsVisit"));
+
+      touched.clear();
+      current->clear();
+      std::swap(current, next);
+    }
+  }
+};
+
+/// Distance sums of every node from a multi-source BFS out of every node.
+void
+ExactDistanceSums(Graph* graph, DistanceSums* sums) {
+  struct LaneTotals {
+    double reached[kNumLanes];
+    double distance_sum[kNumLanes];
+    double harmonic_sum[kNumLanes];
+
+    void Reset() {
+      std::fill(std::begin(reached), std::end(reached), 0);
+      std::fill(std::begin(distance_sum), std::end(distance_sum), 0);
+      std::fill(std::begin(harmonic_sum), std::end(harmonic_sum), 0);
+    }
+  };
+  katana::PerThreadStorage<LaneTotals> totals;
+  for (unsigned i = 0; i < totals.size(); ++i) {
+    totals.getRemote(i)->Reset();
+  }
+
+  MultiSourceBfs bfs(graph);
+  std::vector<GNode> sources(kNumLanes);
+  const uint64_t num_nodes = graph->num_nodes();
+
+  for (uint64_t begin = 0; begin < num_nodes; begin += kNumLanes) {
+    uint32_t num_sources = std::min<uint64_t>(kNumLanes, num_nodes - begin);
+    std::iota(sources.begin(), sources.begin() + num_sources, begin);
+
+    bfs.Run(
+        sources.data(), num_sources, [&](GNode, LaneMask lanes, Dist level) {
+          LaneTotals& local = *totals.getLocal();
+          for (LaneMask m = lanes; m != 0; m &= m - 1) {
+            uint32_t lane = __builtin_ctzll(m);
+            local.reached[lane] += 1;
+            local.distance_sum[lane] += level;
+            local.harmonic_sum[lane] += 1.0 / level;
+          }
+        });
+
+    for (unsigned i = 0; i < totals.size(); ++i) {
+      LaneTotals& remote = *totals.getRemote(i);
+      for (uint32_t lane = 0; lane < num_sources; ++lane) {
+        sums->reached[begin + lane] += remote.reached[lane];
+        sums->distance_sum[begin + lane] += remote.distance_sum[lane];
+        sums->harmonic_sum[begin + lane] += remote.harmonic_sum[lane];
+      }
+      remote.Reset();
+    }
+  }
+}
+
+/// Distance sums of every node estimated from BFSs out of num_samples random
+/// nodes, scaled up to all n - 1 other nodes.
+void
+SampledDistanceSums(
+    Graph* graph, uint32_t num_samples, uint64_t seed, DistanceSums* sums) {
+  const uint64_t num_nodes = graph->num_nodes();
+  num_samples = std::min<uint64_t>(num_samples, num_nodes);
+
+  // Partial Fisher-Yates shuffle picks distinct sources
+  std::vector<GNode> sources(num_nodes);
+  std::iota(sources.begin(), sources.end(), 0);
+  uint64_t state = seed;
+  for (uint32_t i = 0; i < num_samples; ++i) {
+    state = Mix(state);
+    uint64_t j = i + state % (num_nodes - i);
+    std::swap(sources[i], sources[j]);
+  }
+  sources.resize(num_samples);
+
+  katana::DynamicBitset is_source;
+  is_source.resize(num_nodes);
+  for (auto src : sources) {
+    is_source.set(src);
+  }
+
+  MultiSourceBfs bfs(graph);
+  for (uint32_t begin = 0; begin < num_samples; begin += kNumLanes) {
+    uint32_t num_sources = std::min(kNumLanes, num_samples - begin);
+    bfs.Run(
+        sources.data() + begin, num_sources,
+        [&](GNode n, LaneMask lanes, Dist level) {
+          double count = __builtin_popcountll(lanes);
+          sums->reached[n] += count;
+          sums->distance_sum[n] += count * level;
+          sums->harmonic_sum[n] += count / level;
+        });
+  }
+
+  katana::do_all(
+      katana::iterate(*graph),
+      [&](GNode n) {
+        // A source never samples its distance to itself
+        double samples = num_samples - (is_source.test(n) ? 1 : 0);
+        double scale = samples > 0 ? (num_nodes - 1) / samples : 0;
+        sums->reached[n] *= scale;
+        sums->distance_sum[n] *= scale;
+        sums->harmonic_sum[n] *= scale;
+      },
+      katana::no_stats(), katana::loopname("SampledDistanceSumsScale"));
+}
+
+/// HyperLogLog estimate of the number of distinct elements of a counter.
+double
+EstimateCardinality(const uint8_t* registers, uint32_t num_registers) {
+  double alpha;
+  switch (num_registers) {
+  case 16:
+    alpha = 0.673;
+    break;
+  case 32:
+    alpha = 0.697;
+    break;
+  case 64:
+    alpha = 0.709;
+    break;
+  default:
+    alpha = 0.7213 / (1 + 1.079 / num_registers);
+  }
+
+  double sum = 0;
+  uint32_t zeros = 0;
+  for (uint32_t j = 0; j < num_registers; ++j) {
+    sum += std::ldexp(1.0, -registers[j]);
+    zeros += registers[j] == 0 ? 1 : 0;
+  }
+  double estimate = alpha * num_registers * num_registers / sum;
+  // small range correction
+  if (estimate <= 2.5 * num_registers && zeros != 0) {
+    estimate = num_registers * std::log(double(num_registers) / zeros);
+  }
+  return estimate;
+}
+
+/**
+ * Distance sums of every node estimated from its neighborhood function
+ * (HyperBall). After t rounds the counter of a node holds the nodes within
+ * distance t of it; the growth of its estimate in round t is the number of
+ * nodes at distance exactly t.
+ */
+void
+HyperBallDistanceSums(
+    Graph* graph, uint32_t log2_registers, uint64_t seed,
+    DistanceSums* sums) {
+  const uint64_t num_nodes = graph->num_nodes();
+  const uint32_t num_registers = uint32_t{1} << log2_registers;
+
+  katana::LargeArray<uint8_t> registers_a;
+  katana::LargeArray<uint8_t> registers_b;
+  registers_a.allocateBlocked(num_nodes * num_registers);
+  registers_b.allocateBlocked(num_nodes * num_registers);
+  uint8_t* current = registers_a.data();
+  uint8_t* next = registers_b.data();
+
+  katana::LargeArray<double> previous_estimate;
+  previous_estimate.allocateBlocked(num_nodes);
+
+  katana::do_all(
+      katana::iterate(*graph),
+      [&](GNode n) {
+        uint8_t* counter = current + uint64_t{n} * num_registers;
+        std::memset(counter, 0, num_registers);
+        uint64_t hash = Mix(n ^ Mix(seed));
+        uint32_t index = hash >> (64 - log2_registers);
+        uint64_t rest = hash << log2_registers;
+        counter[index] =
+            rest == 0 ? 64 - log2_registers + 1 : __builtin_clzll(rest) + 1;
+        previous_estimate[n] = EstimateCardinality(counter, num_registers);
+      },
+      katana::no_stats(), katana::loopname("HyperBallInitialize"));
+
+  OutEdgeRangeFn out_edges{graph};
+  for (Dist level = 1;; ++level) {
+    katana::GAccumulator<uint64_t> changed;
+
+    katana::do_all(
+        katana::iterate(*graph),
+        [&](GNode n) {
+          const uint8_t* own = current + uint64_t{n} * num_registers;
+          uint8_t* counter = next + uint64_t{n} * num_registers;
+          std::memcpy(counter, own, num_registers);
+          for (auto e : out_edges(n)) {
+            const uint8_t* neighbor =
+                current + uint64_t{*graph->GetEdgeDest(e)} * num_registers;
+            for (uint32_t j = 0; j < num_registers; ++j) {
+              counter[j] = std::max(counter[j], neighbor[j]);
+            }
+          }
+          if (std::memcmp(counter, own, num_registers) == 0) {
+            return;
+          }
+          changed += 1;
+          double estimate = EstimateCardinality(counter, num_registers);
+          double at_level = std::max(0.0, estimate - previous_estimate[n]);
+          sums->distance_sum[n] += at_level * level;
+          sums->harmonic_sum[n] += at_level / level;
+          previous_estimate[n] = std::max(estimate, previous_estimate[n]);
+        },
+        katana::steal(), katana::chunk_size<kChunkSize>(),
+        katana::loopname("HyperBallIteration"));
+
+    std::swap(current, next);
+    if (changed.reduce() == 0) {
+      katana::ReportStatSingle("ClosenessCentrality", "HyperBallRounds", level);
+      break;
+    }
+  }
+
+  katana::do_all(
+      katana::iterate(*graph),
+      [&](GNode n) {
+        sums->reached[n] = std::max(0.0, previous_estimate[n] - 1);
+      },
+      katana::no_stats(), katana::loopname("HyperBallReached"));
+}
+
+katana::Result<Graph>
+MakeOutputGraph(
+    katana::PropertyGraph* pg, const std::string& output_property_name) {
+  if (auto result = ConstructNodeProperties<std::tuple<NodeCentrality>>(
+          pg, {output_property_name});
+      !result) {
+    return result.error();
+  }
+  return Graph::Make(pg, {output_property_name}, {});
+}
+
+katana::Result<void>
+ComputeDistanceSums(
+    Graph* graph, ClosenessCentralityPlan plan, DistanceSums* sums) {
+  katana::StatTimer exec_time("ClosenessCentrality");
+  exec_time.start();
+  switch (plan.algorithm()) {
+  case ClosenessCentralityPlan::kExact:
+    ExactDistanceSums(graph, sums);
+    break;
+  case ClosenessCentralityPlan::kSampled:
+    if (plan.num_samples() == 0) {
+      return KATANA_ERROR(
+          katana::ErrorCode::InvalidArgument,
+          "number of samples must be positive");
+    }
+    SampledDistanceSums(graph, plan.num_samples(), plan.seed(), sums);
+    break;
+  case ClosenessCentralityPlan::kHyperBall:
+    if (plan.log2_registers() < ClosenessCentralityPlan::kMinLog2Registers ||
+        plan.log2_registers() > ClosenessCentralityPlan::kMaxLog2Registers) {
+      return KATANA_ERROR(
+          katana::ErrorCode::InvalidArgument,
+          "log2 of the number of registers must be between {} and {}",
+          ClosenessCentralityPlan::kMinLog2Registers,
+          ClosenessCentralityPlan::kMaxLog2Registers);
+    }
+    HyperBallDistanceSums(graph, plan.log2_registers(), plan.seed(), sums);
+    break;
+  default:
+    return katana::ErrorCode::InvalidArgument;
+  }
+  exec_time.stop();
+  return katana::ResultSuccess();
+}
+
+}  // namespace
+
+katana::Result<void>
+katana::analytics::ClosenessCentrality(
+    katana::PropertyGraph* pg, const std::string& output_property_name,
+    ClosenessCentralityPlan plan) {
+  auto graph_result = MakeOutputGraph(pg, output_property_name);
+  if (!graph_result) {
+    return graph_result.error();
+  }
+  Graph graph = graph_result.value();
+
+  DistanceSums sums(graph.num_nodes());
+  if (auto r = ComputeDistanceSums(&graph, plan, &sums); !r) {
+    return r.error();
+  }
+
+  const double others = graph.num_nodes() > 1 ? graph.num_nodes() - 1 : 1;
+  katana::do_all(
+      katana::iterate(graph),
+      [&](GNode n) {
+        double reached = sums.reached[n];
+        double distance_sum = sums.distance_sum[n];
+        graph.GetData<NodeCentrality>(n) =
+            reached > 0 && distance_sum > 0
+                ? (reached / others) * (reached / distance_sum)
+                : 0;
+      },
+      katana::no_stats(), katana::loopname("ClosenessCentralityFinalize"));
+
+  return katana::ResultSuccess();
+}
+
+katana::Result<void>
+katana::analytics::HarmonicCentrality(
+    katana::PropertyGraph* pg, const std::string& output_property_name,
+    ClosenessCentralityPlan plan) {
+  auto graph_result = MakeOutputGraph(pg, output_property_name);
+  if (!graph_result) {
+    return graph_result.error();
+  }
+  Graph graph = graph_result.value();
+
+  DistanceSums sums(graph.num_nodes());
+  if (auto r = ComputeDistanceSums(&graph, plan, &sums); !r) {
+    return r.error();
+  }
+
+  katana::do_all(
+      katana::iterate(graph),
+      [&](GNode n) {
+        graph.GetData<NodeCentrality>(n) = sums.harmonic_sum[n];
+      },
+      katana::no_stats(), katana::loopname("HarmonicCentralityFinalize"));
+
+  return katana::ResultSuccess();
+}
+
+void
+ClosenessCentralityStatistics::Print(std::ostream& os) const {
+  os << "Maximum centrality = " << max_centrality << std::endl;
+  os << "Minimum centrality = " << min_centrality << std::endl;
+  os << "Average centrality = " << average_centrality << std::endl;
+}
+
+katana::Result<ClosenessCentralityStatistics>
+ClosenessCentralityStatistics::Compute(
+    katana::PropertyGraph* pg, const std::string& output_property_name) {
+  auto values_result = pg->GetNodePropertyTyped<double>(output_property_name);
+  if (!values_result) {
+    return values_result.error();
+  }
+  auto values = values_result.value();
+
+  katana::GReduceMax<double> accum_max;
+  katana::GReduceMin<double> accum_min;
+  katana::GAccumulator<double> accum_sum;
+
+  katana::do_all(
+      katana::iterate(uint64_t{0}, pg->num_nodes()),
+      [&](uint64_t n) {
+        accum_max.update(values->Value(n));
+        accum_min.update(values->Value(n));
+        accum_sum += values->Value(n);
+      },
+      katana::no_stats(), katana::loopname("Closeness Centrality Statistics"));
+
+  return ClosenessCentralityStatistics{
+      accum_max.reduce(), accum_min.reduce(),
+      pg->num_nodes() > 0 ? accum_sum.reduce() / pg->num_nodes() : 0};
+}
@@ -0,0 +1,458 @@
+/*
+ * This file belongs to the Galois project, a C++ library for exploiting
+ * parallelism. The code is being released under the terms of the 3-Clause BSD
+ * License (a copy is located in LICENSE.txt at the top-level directory).
+ *
+ * Copyright (C) 2018, The University of Texas at Austin. All rights reserved.
+ * UNIVERSITY EXPRESSLY DISCLAIMS ANY AND ALL WARRANTIES CONCERNING THIS
+ * SOFTWARE AND DOCUMENTATION, INCLUDING ANY WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR ANY PARTICULAR PURPOSE, NON-INFRINGEMENT AND WARRANTIES OF
+ * PERFORMANCE, AND ANY WARRANTY THAT MIGHT OTHERWISE ARISE FROM COURSE OF
+ * DEALING OR USAGE OF TRADE.  NO WARRANTY IS EITHER EXPRESS OR IMPLIED WITH
+ * RESPECT TO THE USE OF THE SOFTWARE OR DOCUMENTATION. Under no circumstances
+ * shall University be liable for incidental, special, indirect, direct or
+ * consequential damages or loss of profits, interruption of business, or
+ * related expenses which may arise from use of Software or Documentation,
+ * including but not limited to those resulting from defects in Software and/or
+ * Documentation, or loss or inaccuracy of data of any kind.
+ */
+
+#include "katana/analytics/label_propagation/label_propagation.h"
+
+#include <algorithm>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "katana/Bag.h"
+#include "katana/DynamicBitset.h"
+#include "katana/PerThreadStorage.h"
+#include "katana/TypedPropertyGraph.h"
+
+using namespace katana::analytics;
+
+const int LabelPropagationPlan::kChunkSize = 64;
+
+namespace {
+
+struct NodeLabel {
+  using ArrowType = arrow::CTypeTraits<uint64_t>::ArrowType;
+  using ViewType = katana::PODPropertyView<std::atomic<uint64_t>>;
+};
+
+template <typename EdgeWeightType>
+struct EdgeWeight : public katana::PODProperty<EdgeWeightType> {};
+
+/// Mix a label with the seed so that ties between equally heavy labels are
+/// broken consistently across rounds and threads, but without biasing
+/// towards small node ids (splitmix64 finalizer).
+uint64_t
+HashLabel(uint64_t label, uint64_t seed) {
+  uint64_t z = label + seed * 0x9e3779b97f4a7c15ULL + 0x9e3779b97f4a7c15ULL;
+  z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ULL;
+  z = (z ^ (z >> 27)) * 0x94d049bb133111ebULL;
+  return z ^ (z >> 31);
+}
+
+/// Label propagation over a graph whose edge properties are either empty
+/// (every edge weighs 1) or a single edge weight.
+template <typename EdgeData>
+struct LabelPropagationAlgo {
+  using NodeData = std::tuple<NodeLabel>;
+  using Graph = katana::TypedPropertyGraph<NodeData, EdgeData>;
+  using GNode = typename Graph::Node;
+
+  using LabelWeight = std::pair<uint64_t, double>;
+  using Scratch = katana::PerThreadStorage<std::vector<LabelWeight>>;
+
+  const LabelPropagationPlan& plan_;
+  Scratch scratch_;
+
+  LabelPropagationAlgo(const LabelPropagationPlan& plan) : plan_(plan) {}
+
+  static double EdgeWeightOf(
+      const Graph& graph, const typename Graph::edge_iterator& e) {
+    if constexpr (std::tuple_size_v<EdgeData> == 0) {
+      return 1.0;
+    } else {
+      using Weight = std::tuple_element_t<0, EdgeData>;
+      return static_cast<double>(graph.template GetEdgeData<Weight>(e));
+    }
+  }
+
+  /// Pick the label with the largest total incident edge weight. The current
+  /// label wins any tie it participates in, which keeps stable nodes from
+  /// oscillating; other ties go to the label with the smallest hash.
+  template <typename LabelFn>
+  uint64_t ChooseLabel(
+      const Graph& graph, GNode n, uint64_t current, LabelFn&& label_of) {
+    std::vector<LabelWeight>& votes = *scratch_.getLocal();
+    votes.clear();
+    for (auto e : graph.edges(n)) {
+      auto dest = graph.GetEdgeDest(e);
+      if (*dest == n) {
+        continue;
+      }
+      votes.emplace_back(label_of(*dest), EdgeWeightOf(graph, e));
+    }
+    if (votes.empty()) {
+      return current;
+    }
+
+    std::sort(
+        votes.begin(), votes.end(),
+        [](const LabelWeight& a, const LabelWeight& b) {
+          return a.first < b.first;
+        });
+
+    const uint64_t seed = plan_.seed();
+    uint64_t best_label = current;
+    double best_weight = 0;
+    bool have_best = false;
+
+    auto consider = [&](uint64_t label, double weight) {
+      if (!have_best || weight > best_weight) {
+        best_label = label;
+        best_weight = weight;
+        have_best = true;
+        return;
+      }
+      if (weight < best_weight || best_label == current) {
+        return;
+      }
+      if (label == current) {
+        best_label = label;
+        return;
+      }
+      uint64_t h = HashLabel(label, seed);
+      uint64_t best_h = HashLabel(best_label, seed);
+      if (h < best_h || (h == best_h && label < best_label)) {
+        best_label = label;
+      }
+    };
+
+    uint64_t run_label = votes.front().first;
+    double run_weight = 0;
+    for (const auto& [label, weight] : votes) {
+      if (label != run_label) {
+        consider(run_label, run_weight);
+        run_label = label;
+        run_weight = 0;
+      }
+      run_weight += weight;
+    }
+    consider(run_label, run_weight);
+
+    return best_label;
+  }
+
+  void Initialize(Graph* graph) {
+    katana::do_all(
+        katana::iterate(*graph),
+        [&](const GNode& node) {
+          graph->template GetData<NodeLabel>(node).store(node);
+        },
+        katana::no_stats());
+  }
+
+  /// Synchronous rounds: compute every node's next label from the labels of
+  /// the previous round, then publish them all at once.
+  void Synchronous(Graph* graph) {
+    katana::LargeArray<uint64_t> next_label;
+    next_label.allocateBlocked(graph->size());
+
+    auto label_of = [&](GNode n) {
+      return graph->template GetData<NodeLabel>(n).load(
+          std::memory_order_relaxed);
+    };
+
+    katana::GAccumulator<uint64_t> changed;
+    uint32_t rounds = 0;
+    do {
+      changed.reset();
+      ++rounds;
+
+      katana::do_all(
+          katana::iterate(*graph),
+          [&](const GNode& src) {
+            next_label[src] =
+                ChooseLabel(*graph, src, label_of(src), label_of);
+          },
+          katana::steal(),
+          katana::chunk_size<LabelPropagationPlan::kChunkSize>(),
+          katana::loopname("LabelPropagation-Synchronous"));
+
+      katana::do_all(
+          katana::iterate(*graph),
+          [&](const GNode& src) {
+            auto& label = graph->template GetData<NodeLabel>(src);
+            if (label.load(std::memory_order_relaxed) != next_label[src]) {
+              label.store(next_label[src], std::memory_order_relaxed);
+              changed += 1;
+            }
+          },
+          katana::no_stats());
+    } while (changed.reduce() != 0 && rounds < plan_.max_iterations());
+
+    katana::ReportStatSingle("LabelPropagation-Synchronous", "rounds", rounds);
+  }
+
+  /// Asynchronous rounds: labels are updated in place, and only nodes with a
+  /// neighbor whose label changed in the previous round are re-evaluated.
+  void Asynchronous(Graph* graph) {
+    auto current = std::make_unique<katana::InsertBag<GNode>>();
+    auto next = std::make_unique<katana::InsertBag<GNode>>();
+
+    // Every node is scheduled for the first round, so a node whose neighbor
+    // changes before it runs is not also pushed to the next round.
+    katana::DynamicBitset scheduled;
+    scheduled.resize(graph->size());
+    scheduled.bitwise_not();
+
+    auto label_of = [&](GNode n) {
+      return graph->template GetData<NodeLabel>(n).load(
+          std::memory_order_relaxed);
+    };
+
+    katana::GAccumulator<uint64_t> evaluated;
+    uint32_t rounds = 0;
+    bool first_round = true;
+    while (rounds < plan_.max_iterations()) {
+      ++rounds;
+      next->clear();
+
+      auto update = [&](const GNode& src) {
+        scheduled.reset(src);
+        evaluated += 1;
+        auto& label = graph->template GetData<NodeLabel>(src);
+        uint64_t old_label = label.load(std::memory_order_relaxed);
+        uint64_t new_label = ChooseLabel(*graph, src, old_label, label_of);
+        if (new_label == old_label) {
+          return;
+        }
+        label.store(new_label, std::memory_order_relaxed);
+        for (auto e : graph->edges(src)) {
+          auto dest = graph->GetEdgeDest(e);
+          if (!scheduled.set(*dest)) {
+            next->push(*dest);
+          }
+        }
+      };
+
+      // The first frontier is every node; avoid materializing it.
+      if (first_round) {
+        first_round = false;
+        katana::do_all(
+            katana::iterate(*graph), update, katana::steal(),
+            katana::chunk_size<LabelPropagationPlan::kChunkSize>(),
+            katana::loopname("LabelPropagation-Asynchronous"));
+      } else {
+        katana::do_all(
+            katana::iterate(*current), update, katana::steal(),
+            katana::chunk_size<LabelPropagationPlan::kChunkSize>(),
+            katana::loopname("LabelPropagation-Asynchronous"));
+      }
+
+      if (next->empty()) {
+        break;
+      }
+      std::swap(current, next);
+    }
+
+    katana::ReportStatSingle("LabelPropagation-Asynchronous", "rounds", rounds);
+    katana::ReportStatSingle(
+        "LabelPropagation-Asynchronous", "evaluated", evaluated.reduce());
+  }
+
+  katana::Result<void> operator()(Graph* graph) {
+    switch (plan_.algorithm()) {
+    case LabelPropagationPlan::kSynchronous:
+      Synchronous(graph);
+      break;
+    case LabelPropagationPlan::kAsynchronous:
+      Asynchronous(graph);
+      break;
+    default:
+      return katana::ErrorCode::InvalidArgument;
+    }
+    return katana::ResultSuccess();
+  }
+};
+
+template <typename EdgeData>
+katana::Result<void>
+LabelPropagationWithWrap(
+    katana::PropertyGraph* pg, const std::string& edge_weight_property_name,
+    const std::string& output_property_name, LabelPropagationPlan plan) {
+  using Algo = LabelPropagationAlgo<EdgeData>;
+
+  if (auto r = ConstructNodeProperties<typename Algo::NodeData>(
+          pg, {output_property_name});
+      !r) {
+    return r.error();
+  }
+
+  std::vector<std::string> edge_properties;
+  if constexpr (std::tuple_size_v<EdgeData> != 0) {
+    edge_properties.emplace_back(edge_weight_property_name);
+  }
+
+  auto pg_result =
+      Algo::Graph::Make(pg, {output_property_name}, edge_properties);
+  if (!pg_result) {
+    return pg_result.error();
+  }
+  auto graph = pg_result.value();
+
+  Algo algo(plan);
+  algo.Initialize(&graph);
+
+  katana::StatTimer exec_time("LabelPropagation");
+  exec_time.start();
+  auto r = algo(&graph);
+  exec_time.stop();
+
+  return r;
+}
+
+}  // namespace
+
+katana::Result<void>
+katana::analytics::LabelPropagation(
+    katana::PropertyGraph* pg, const std::string& edge_weight_property_name,
+    const std::string& output_property_name, LabelPropagationPlan plan) {
+  if (edge_weight_property_name.empty()) {
+    return LabelPropagationWithWrap<std::tuple<>>(
+        pg, edge_weight_property_name, output_property_name, plan);
+  }
+
+  auto edge_weight = pg->GetEdgeProperty(edge_weight_property_name);
+  if (!edge_weight) {
+    return katana::ErrorCode::PropertyNotFound;
+  }
+
+  switch (edge_weight->type()->id()) {
+  case arrow::UInt32Type::type_id:
+    return LabelPropagationWithWrap<std::tuple<EdgeWeight<uint32_t>>>(
+        pg, edge_weight_property_name, output_property_name, plan);
+  case arrow::Int32Type::type_id:
+    return LabelPropagationWithWrap<std::tuple<EdgeWeight<int32_t>>>(
+        pg, edge_weight_property_name, output_property_name, plan);
+  case arrow::UInt64Type::type_id:
+    return LabelPropagationWithWrap<std::tuple<EdgeWeight<uint64_t>>>(
+        pg, edge_weight_property_name, output_property_name, plan);
+  case arrow::Int64Type::type_id:
+    return LabelPropagationWithWrap<std::tuple<EdgeWeight<int64_t>>>(
+        pg, edge_weight_property_name, output_property_name, plan);
+  case arrow::FloatType::type_id:
+    return LabelPropagationWithWrap<std::tuple<EdgeWeight<float>>>(
+        pg, edge_weight_property_name, output_property_name, plan);
+  case arrow::DoubleType::type_id:
+    return LabelPropagationWithWrap<std::tuple<EdgeWeight<double>>>(
+        pg, edge_weight_property_name, output_property_name, plan);
+  default:
+    return katana::ErrorCode::TypeError;
+  }
+}
+
+katana::Result<void>
+katana::analytics::LabelPropagationAssertValid(
+    katana::PropertyGraph* pg, const std::string& property_name) {
+  auto labels_result = pg->GetNodePropertyTyped<uint64_t>(property_name);
+  if (!labels_result) {
+    return labels_result.error();
+  }
+  auto labels = labels_result.value();
+  const uint64_t num_nodes = pg->num_nodes();
+
+  // Labels only ever travel along edges, so every label must be the id of a
+  // node, and an isolated node must keep its own label.
+  auto is_bad = [&](const uint32_t& n) {
+    uint64_t label = labels->Value(n);
+    if (label >= num_nodes) {
+      KATANA_LOG_DEBUG("{} has invalid label {}", n, label);
+      return true;
+    }
+    if (pg->edges(n).empty() && label != n) {
+      KATANA_LOG_DEBUG("isolated node {} has foreign label {}", n, label);
+      return true;
+    }
+    return false;
+  };
+
+  if (katana::ParallelSTL::find_if(pg->begin(), pg->end(), is_bad) !=
+      pg->end()) {
+    return katana::ErrorCode::AssertionFailed;
+  }
+
+  return katana::ResultSuccess();
+}
+
+katana::Result<LabelPropagationStatistics>
+katana::analytics::LabelPropagationStatistics::Compute(
+    katana::PropertyGraph* pg, const std::string& property_name) {
+  auto labels_result = pg->GetNodePropertyTyped<uint64_t>(property_name);
+  if (!labels_result) {
+    return labels_result.error();
+  }
+  auto labels = labels_result.value();
+  const uint64_t num_nodes = pg->num_nodes();
+
+  // Community ids are node ids, so a dense count array replaces a map
+  // reduction.
+  katana::LargeArray<std::atomic<uint64_t>> community_size;
+  community_size.allocateBlocked(num_nodes);
+  katana::do_all(
+      katana::iterate(uint64_t{0}, num_nodes),
+      [&](uint64_t n) { community_size[n].store(0); }, katana::no_stats());
+
+  katana::do_all(
+      katana::iterate(uint64_t{0}, num_nodes),
+      [&](uint64_t n) {
+        uint64_t label = labels->Value(n);
+        if (label >= num_nodes) {
+          return;
+        }
+        community_size[label].fetch_add(1, std::memory_order_relaxed);
+      },
+      katana::loopname("CountCommunities"));
+
+  katana::GAccumulator<uint64_t> total_communities;
+  katana::GAccumulator<uint64_t> non_trivial_communities;
+  katana::GReduceMax<uint64_t> largest_community;
+  katana::do_all(
+      katana::iterate(uint64_t{0}, num_nodes),
+      [&](uint64_t n) {
+        uint64_t size = community_size[n].load(std::memory_order_relaxed);
+        if (size == 0) {
+          return;
+        }
+        total_communities += 1;
+        if (size > 1) {
+          non_trivial_communities += 1;
+        }
+        largest_community.update(size);
+      },
+      katana::no_stats());
+
+  uint64_t largest_community_size = largest_community.reduce();
+  double largest_community_ratio = 0;
+  if (num_nodes != 0) {
+    largest_community_ratio = double(largest_community_size) / num_nodes;
+  }
+
+  return LabelPropagationStatistics{
+      total_communities.reduce(), non_trivial_communities.reduce(),
+      largest_community_size, largest_community_ratio};
+}
+
+void
+katana::analytics::LabelPropagationStatistics::Print(std::ostream& os) const {
+  os << "Total number of communities = " << total_communities << std::endl;
+  os << "Total number of non trivial communities = "
+     << total_non_trivial_communities << std::endl;
+  os << "Number of nodes in the largest community = " << largest_community_size
+     << std::endl;
+  os << "Ratio of nodes in the largest community = " << largest_community_ratio
+     << std::endl;
+}
@@ -108,10 +108,10 @@ struct LouvainClusteringImplementation
             uint64_t degree =
                 std::distance(graph.edge_begin(n), graph.edge_end(n));
             uint64_t local_target = Base::UNASSIGNED;
-            std::map<uint64_t, uint64_t>
+            katana::arena::Map<uint64_t, uint64_t>
                 cluster_local_map;  // Map each neighbor's cluster to local number:
                                     // Community --> Index
-            std::vector<EdgeWeightType>
+            katana::arena::Vector<EdgeWeightType>
                 counter;  // Number of edges to each unique cluster
             EdgeWeightType self_loop_wt = 0;
 
@@ -142,7 +142,7 @@ struct LouvainClusteringImplementation
               n_data_curr_comm_id = local_target;
             }
           },
-          katana::loopname("louvain algo: Phase 1"));
+          katana::thread_arena(), katana::loopname("louvain algo: Phase 1"));
 
       /* Calculate the overall modularity */
       double e_xx = 0;
@@ -0,0 +1,441 @@
+/*
+ * This file belongs to the Galois project, a C++ library for exploiting
+ * parallelism. The code is being released under the terms of the 3-Clause BSD
+ * License (a copy is located in LICENSE.txt at the top-level directory).
+ *
+ * Copyright (C) 2018, The University of Texas at Austin. All rights reserved.
+ * UNIVERSITY EXPRESSLY DISCLAIMS ANY AND ALL WARRANTIES CONCERNING THIS
+ * SOFTWARE AND DOCUMENTATION, INCLUDING ANY WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR ANY PARTICULAR PURPOSE, NON-INFRINGEMENT AND WARRANTIES OF
+ * PERFORMANCE, AND ANY WARRANTY THAT MIGHT OTHERWISE ARISE FROM COURSE OF
+ * DEALING OR USAGE OF TRADE.  NO WARRANTY IS EITHER EXPRESS OR IMPLIED WITH
+ * RESPECT TO THE USE OF THE SOFTWARE OR DOCUMENTATION. Under no circumstances
+ * shall University be liable for incidental, special, indirect, direct or
+ * consequential damages or loss of profits, interruption of business, or
+ * related expenses which may arise from use of Software or Documentation,
+ * including but not limited to those resulting from defects in Software and/or
+ * Documentation, or loss or inaccuracy of data of any kind.
+ */
+
+#include <algorithm>
+#include <cmath>
+#include <unordered_map>
+#include <utility>
+
+#include "katana/LargeArray.h"
+#include "katana/PerThreadStorage.h"
+#include "katana/TypedPropertyGraph.h"
+#include "pagerank-impl.h"
+
+using katana::analytics::PersonalizedPagerankPlan;
+using katana::analytics::PersonalizedPagerankVector;
+
+namespace {
+
+using Graph = katana::TypedPropertyGraph<std::tuple<NodeValue>, std::tuple<>>;
+using GNode = typename Graph::Node;
+
+using RankEntries = std::vector<std::pair<uint32_t, PRTy>>;
+
+constexpr static const unsigned kPersonalizedChunkSize = 4u;
+
+uint64_t
+OutDegree(const katana::GraphTopology& topology, uint32_t n) {
+  auto [begin, end] = topology.edge_range(n);
+  return end - begin;
+}
+
+/// Sparse state of one forward push. The maps only hold the nodes reached
+/// from the seeds; they are kept per thread and reused between seeds so that
+/// their buckets are allocated once per thread rather than once per seed.
+struct ForwardPushState {
+  std::unordered_map<uint32_t, PRTy> rank;
+  std::unordered_map<uint32_t, PRTy> residual;
+  // FIFO of the nodes whose residual crossed their push threshold
+  std::vector<uint32_t> queue;
+};
+
+/**
+ * Andersen-Chung-Lang forward push from a uniform distribution over seeds.
+ *
+ * Invariant: rank + PPR(residual) = PPR(seeds). A node is queued when its
+ * residual reaches epsilon * out-degree and, when popped, keeps 1 - alpha of
+ * its residual and spreads the rest evenly over its out-neighbors. Like the
+ * global push algorithms, the share of dangling nodes is dropped.
+ *
+ * Returns the number of pushes.
+ */
+uint64_t
+ForwardPush(
+    const katana::GraphTopology& topology, const uint32_t* seeds,
+    size_t num_seeds, PersonalizedPagerankPlan plan, ForwardPushState* state) {
+  state->rank.clear();
+  state->residual.clear();
+  state->queue.clear();
+
+  const PRTy epsilon = plan.epsilon();
+  const PRTy alpha = plan.alpha();
+
+  auto add_residual = [&](uint32_t n, PRTy amount) {
+    PRTy threshold = epsilon * std::max<uint64_t>(OutDegree(topology, n), 1);
+    PRTy& residual = state->residual[n];
+    bool was_below = residual < threshold;
+    residual += amount;
+    if (was_below && residual >= threshold) {
+      state->queue.push_back(n);
+    }
+  };
+
+  const PRTy seed_mass = PRTy{1} / num_seeds;
+  for (size_t i = 0; i < num_seeds; ++i) {
+    add_residual(seeds[i], seed_mass);
+  }
+
+  uint64_t pushes = 0;
+  for (size_t head = 0; head < state->queue.size(); ++head) {
+    uint32_t src = state->queue[head];
+    // Copy out: inserting neighbors below may rehash the map.
+    PRTy residual = std::exchange(state->residual[src], 0);
+    state->rank[src] += (1 - alpha) * residual;
+    ++pushes;
+
+    auto [begin, end] = topology.edge_range(src);
+    if (begin == end) {
+      continue;
+    }
+    PRTy share = alpha * residual / (end - begin);
+    for (auto e = begin; e < end; ++e) {
+      add_residual(topology.edge_dest(e), share);
+    }
+  }
+  return pushes;
+}
+
+PersonalizedPagerankVector
+TopRanks(RankEntries* entries, uint32_t top_k) {
+  auto by_rank = [](const auto& a, const auto& b) {
+    return a.second > b.second || (a.second == b.second && a.first < b.first);
+  };
+  if (top_k != 0 && top_k < entries->size()) {
+    std::partial_sort(
+        entries->begin(), entries->begin() + top_k, entries->end(), by_rank);
+    entries->resize(top_k);
+  } else {
+    std::sort(entries->begin(), entries->end(), by_rank);
+  }
+
+  PersonalizedPagerankVector result;
+  result.nodes.reserve(entries->size());
+  result.ranks.reserve(entries->size());
+  for (const auto& [node, rank] : *entries) {
+    result.nodes.emplace_back(node);
+    result.ranks.emplace_back(rank);
+  }
+  return result;
+}
+
+/// Teleport mass of one personalization vector onto one node.
+struct Teleport {
+  uint32_t node;
+  uint32_t lane;
+  PRTy mass;
+};
+
+/**
+ * Power iteration over up to kMaxBatchSize personalization vectors at once.
+ *
+ * Every personalization vector of a batch is a lane. The rank of node n for
+ * lane l lives at n * num_lanes + l, so each iteration reads one contiguous
+ * block per in-edge for the whole batch: one sweep of the transposed edges
+ * multiplies the transition matrix with every lane.
+ */
+class MultiVectorPagerank {
+  const katana::GraphTopology& transpose_;
+  PersonalizedPagerankPlan plan_;
+  const uint32_t num_lanes_;
+
+  // 1 / out-degree in the original graph, 0 for dangling nodes
+  katana::LargeArray<PRTy> inverse_out_degree_;
+  katana::LargeArray<PRTy> rank_;
+  katana::LargeArray<PRTy> next_rank_;
+
+  uint64_t Index(uint32_t n, uint32_t lane) const {
+    return uint64_t{n} * num_lanes_ + lane;
+  }
+
+  void Reset() {
+    katana::do_all(
+        katana::iterate(transpose_),
+        [&](uint32_t n) {
+          for (uint32_t lane = 0; lane < num_lanes_; ++lane) {
+            rank_[Index(n, lane)] = 0;
+          }
+        },
+        katana::no_stats(), katana::loopname("PersonalizedPagerankReset"));
+  }
+
+  /// next_rank = alpha * P^T * rank for every lane.
+  void Pull(uint32_t active_lanes) {
+    katana::do_all(
+        katana::iterate(transpose_),
+        [&](uint32_t dest) {
+          PRTy sums[PersonalizedPagerankPlan::kMaxBatchSize] = {};
+          for (auto e : transpose_.edges(dest)) {
+            uint32_t src = transpose_.edge_dest(e);
+            PRTy weight = inverse_out_degree_[src];
+            if (weight == 0) {
+              continue;
+            }
+            const PRTy* src_rank = &rank_[Index(src, 0)];
+            for (uint32_t lane = 0; lane < active_lanes; ++lane) {
+              sums[lane] += src_rank[lane] * weight;
+            }
+          }
+          for (uint32_t lane = 0; lane < active_lanes; ++lane) {
+            next_rank_[Index(dest, lane)] = plan_.alpha() * sums[lane];
+          }
+        },
+        katana::steal(),
+        katana::chunk_size<katana::analytics::PagerankPlan::kChunkSize>(),
+        katana::no_stats(), katana::loopname("PersonalizedPagerankPull"));
+  }
+
+  /// Swap in next_rank and return the L1 change summed over the lanes.
+  double Update(uint32_t active_lanes) {
+    katana::GAccumulator<double> change;
+    katana::do_all(
+        katana::iterate(transpose_),
+        [&](uint32_t n) {
+          for (uint32_t lane = 0; lane < active_lanes; ++lane) {
+            change += std::fabs(
+                next_rank_[Index(n, lane)] - rank_[Index(n, lane)]);
+            rank_[Index(n, lane)] = next_rank_[Index(n, lane)];
+          }
+        },
+        katana::no_stats(), katana::loopname("PersonalizedPagerankUpdate"));
+    return change.reduce();
+  }
+
+public:
+  MultiVectorPagerank(
+      const katana::GraphTopology& topology,
+      const katana::GraphTopology& transpose, PersonalizedPagerankPlan plan,
+      uint32_t num_lanes)
+      : transpose_(transpose), plan_(plan), num_lanes_(num_lanes) {
+    inverse_out_degree_.allocateBlocked(topology.num_nodes());
+    rank_.allocateBlocked(topology.num_nodes() * num_lanes);
+    next_rank_.allocateBlocked(topology.num_nodes() * num_lanes);
+
+    katana::do_all(
+        katana::iterate(topology),
+        [&](uint32_t n) {
+          uint64_t degree = OutDegree(topology, n);
+          inverse_out_degree_[n] = degree == 0 ? 0 : PRTy{1} / degree;
+        },
+        katana::no_stats(), katana::loopname("InverseOutDegree"));
+  }
+
+  PRTy rank(uint32_t n, uint32_t lane) const { return rank_[Index(n, lane)]; }
+
+  /// Iterate rank = (1 - alpha) * teleport + alpha * P^T * rank until the L1
+  /// change per lane drops below the tolerance. Returns the number of
+  /// iterations.
+  unsigned int Run(
+      const std::vector<Teleport>& teleports, uint32_t active_lanes) {
+    KATANA_LOG_DEBUG_ASSERT(active_lanes <= num_lanes_);
+    Reset();
+
+    unsigned int iteration = 0;
+    while (iteration < plan_.max_iterations()) {
+      Pull(active_lanes);
+      for (const Teleport& teleport : teleports) {
+        next_rank_[Index(teleport.node, teleport.lane)] +=
+            (1 - plan_.alpha()) * teleport.mass;
+      }
+      ++iteration;
+      if (Update(active_lanes) <= plan_.tolerance() * active_lanes) {
+        break;
+      }
+    }
+    return iteration;
+  }
+};
+
+katana::Result<void>
+CheckArguments(
+    katana::PropertyGraph* pg, const std::vector<uint32_t>& seeds,
+    PersonalizedPagerankPlan plan) {
+  if (!(plan.alpha() > 0 && plan.alpha() < 1)) {
+    return KATANA_ERROR(
+        katana::ErrorCode::InvalidArgument, "alpha must be in (0, 1)");
+  }
+  switch (plan.algorithm()) {
+  case PersonalizedPagerankPlan::kForwardPush:
+    if (!(plan.epsilon() > 0)) {
+      return KATANA_ERROR(
+          katana::ErrorCode::InvalidArgument, "epsilon must be positive");
+    }
+    break;
+  case PersonalizedPagerankPlan::kPowerIteration:
+    if (plan.batch_size() == 0 ||
+        plan.batch_size() > PersonalizedPagerankPlan::kMaxBatchSize) {
+      return KATANA_ERROR(
+          katana::ErrorCode::InvalidArgument,
+          "batch size must be between 1 and {}",
+          PersonalizedPagerankPlan::kMaxBatchSize);
+    }
+    break;
+  default:
+    return katana::ErrorCode::InvalidArgument;
+  }
+  for (auto seed : seeds) {
+    if (seed >= pg->num_nodes()) {
+      return KATANA_ERROR(
+          katana::ErrorCode::InvalidArgument, "seed {} is not in the graph",
+          seed);
+    }
+  }
+  return katana::ResultSuccess();
+}
+
+}  // namespace
+
+katana::Result<void>
+katana::analytics::PersonalizedPagerank(
+    katana::PropertyGraph* pg, const std::vector<uint32_t>& seeds,
+    const std::string& output_property_name, PersonalizedPagerankPlan plan) {
+  if (seeds.empty()) {
+    return KATANA_ERROR(
+        katana::ErrorCode::InvalidArgument, "at least one seed is required");
+  }
+  if (auto result = CheckArguments(pg, seeds, plan); !result) {
+    return result.error();
+  }
+
+  if (auto result = ConstructNodeProperties<std::tuple<NodeValue>>(
+          pg, {output_property_name});
+      !result) {
+    return result.error();
+  }
+  auto graph_result = Graph::Make(pg, {output_property_name}, {});
+  if (!graph_result) {
+    return graph_result.error();
+  }
+  Graph graph = graph_result.value();
+
+  katana::do_all(
+      katana::iterate(graph),
+      [&](const GNode& n) { graph.GetData<NodeValue>(n) = 0; },
+      katana::no_stats(), katana::loopname("Initialize"));
+
+  if (plan.algorithm() == PersonalizedPagerankPlan::kForwardPush) {
+    katana::StatTimer exec_time("ForwardPush", "PersonalizedPagerank");
+    exec_time.start();
+    ForwardPushState state;
+    uint64_t pushes =
+        ForwardPush(pg->topology(), seeds.data(), seeds.size(), plan, &state);
+    for (const auto& [node, rank] : state.rank) {
+      graph.GetData<NodeValue>(node) = rank;
+    }
+    exec_time.stop();
+    katana::ReportStatSingle("PersonalizedPagerank", "Pushes", pushes);
+    return katana::ResultSuccess();
+  }
+
+  auto transpose_result = katana::CreateTransposeGraph(pg);
+  if (!transpose_result) {
+    return transpose_result.error();
+  }
+  std::unique_ptr<katana::PropertyGraph> transpose =
+      std::move(transpose_result.value());
+
+  katana::StatTimer exec_time("PowerIteration", "PersonalizedPagerank");
+  exec_time.start();
+  MultiVectorPagerank power(pg->topology(), transpose->topology(), plan, 1);
+  std::vector<Teleport> teleports;
+  for (auto seed : seeds) {
+    teleports.emplace_back(Teleport{seed, 0, PRTy{1} / seeds.size()});
+  }
+  unsigned int iterations = power.Run(teleports, 1);
+  katana::do_all(
+      katana::iterate(graph),
+      [&](const GNode& n) { graph.GetData<NodeValue>(n) = power.rank(n, 0); },
+      katana::no_stats(), katana::loopname("CopyRank"));
+  exec_time.stop();
+  katana::ReportStatSingle("PersonalizedPagerank", "Iterations", iterations);
+
+  return katana::ResultSuccess();
+}
+
+katana::Result<std::vector<PersonalizedPagerankVector>>
+katana::analytics::PersonalizedPagerankBatch(
+    katana::PropertyGraph* pg, const std::vector<uint32_t>& seeds,
+    uint32_t top_k, PersonalizedPagerankPlan plan) {
+  if (auto result = CheckArguments(pg, seeds, plan); !result) {
+    return result.error();
+  }
+  std::vector<PersonalizedPagerankVector> results(seeds.size());
+
+  if (plan.algorithm() == PersonalizedPagerankPlan::kForwardPush) {
+    katana::StatTimer exec_time("ForwardPushBatch", "PersonalizedPagerank");
+    exec_time.start();
+    katana::PerThreadStorage<ForwardPushState> states;
+    katana::GAccumulator<uint64_t> pushes;
+    katana::do_all(
+        katana::iterate(uint64_t{0}, uint64_t{seeds.size()}),
+        [&](uint64_t i) {
+          ForwardPushState* state = states.getLocal();
+          pushes += ForwardPush(pg->topology(), &seeds[i], 1, plan, state);
+          RankEntries entries(state->rank.begin(), state->rank.end());
+          results[i] = TopRanks(&entries, top_k);
+        },
+        katana::steal(), katana::chunk_size<kPersonalizedChunkSize>(),
+        katana::no_stats(), katana::loopname("ForwardPushBatch"));
+    exec_time.stop();
+    katana::ReportStatSingle(
+        "PersonalizedPagerank", "Pushes", pushes.reduce());
+    return results;
+  }
+
+  auto transpose_result = katana::CreateTransposeGraph(pg);
+  if (!transpose_result) {
+    return transpose_result.error();
+  }
+  std::unique_ptr<katana::PropertyGraph> transpose =
+      std::move(transpose_result.value());
+
+  const uint32_t batch_size = plan.batch_size();
+  katana::ReportStatSingle("PersonalizedPagerank", "BatchSize", batch_size);
+
+  katana::StatTimer exec_time("PowerIterationBatch", "PersonalizedPagerank");
+  exec_time.start();
+  MultiVectorPagerank power(
+      pg->topology(), transpose->topology(), plan, batch_size);
+  uint64_t iterations = 0;
+  for (size_t first = 0; first < seeds.size(); first += batch_size) {
+    uint32_t active_lanes = std::min<size_t>(batch_size, seeds.size() - first);
+    std::vector<Teleport> teleports;
+    for (uint32_t lane = 0; lane < active_lanes; ++lane) {
+      teleports.emplace_back(Teleport{seeds[first + lane], lane, 1});
+    }
+    iterations += power.Run(teleports, active_lanes);
+
+    katana::do_all(
+        katana::iterate(uint32_t{0}, active_lanes),
+        [&](uint32_t lane) {
+          RankEntries entries;
+          for (uint32_t n = 0; n < pg->num_nodes(); ++n) {
+            if (PRTy rank = power.rank(n, lane); rank > 0) {
+              entries.emplace_back(n, rank);
+            }
+          }
+          results[first + lane] = TopRanks(&entries, top_k);
+        },
+        katana::steal(), katana::chunk_size<1>(), katana::no_stats(),
+        katana::loopname("PowerIterationTopRanks"));
+  }
+  exec_time.stop();
+  katana::ReportStatSingle("PersonalizedPagerank", "Iterations", iterations);
+
+  return results;
+}
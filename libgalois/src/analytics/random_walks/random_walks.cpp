@@ -19,6 +19,7 @@
 
 #include "katana/analytics/random_walks/random_walks.h"
 
+#include "katana/ThreadArena.h"
 #include "katana/TypedPropertyGraph.h"
 
 using namespace katana::analytics;
@@ -91,7 +92,8 @@ struct Node2VecAlgo {
           std::uniform_real_distribution<double>* dist =
               *distribution.getLocal();
 
-          std::vector<uint32_t> walk;
+          // grown in the arena and copied out once it has its final size
+          katana::arena::Vector<uint32_t> walk;
           walk.push_back(n);
 
           //random value between 0 and 1
@@ -153,10 +155,11 @@ struct Node2VecAlgo {
             }
           }
 
-          (*walks).push(std::move(walk));
+          walks->emplace(walk.begin(), walk.end());
         },
         katana::steal(), katana::chunk_size<RandomWalksPlan::kChunkSize>(),
-        katana::loopname("Node2vec walks"), katana::no_stats());
+        katana::thread_arena(), katana::loopname("Node2vec walks"),
+        katana::no_stats());
 
     for (uint32_t i = 0; i < distribution.size(); i++) {
       delete (*distribution.getRemote(i));
@@ -246,8 +249,9 @@ struct Edge2VecAlgo {
           std::uniform_real_distribution<double>* dist =
               *distribution.getLocal();
 
-          std::vector<uint32_t> walk;
-          std::vector<uint32_t> types_vec;
+          // grown in the arena and copied out once they have their final size
+          katana::arena::Vector<uint32_t> walk;
+          katana::arena::Vector<uint32_t> types_vec;
 
           walk.push_back(n);
 
@@ -314,11 +318,12 @@ struct Edge2VecAlgo {
 
           }  //end for
 
-          (*walks).push(std::move(walk));
-          (*types_walks).push(std::move(types_vec));
+          walks->emplace(walk.begin(), walk.end());
+          types_walks->emplace(types_vec.begin(), types_vec.end());
         },
         katana::steal(), katana::chunk_size<RandomWalksPlan::kChunkSize>(),
-        katana::loopname("Edge2vec walks"), katana::no_stats());
+        katana::thread_arena(), katana::loopname("Edge2vec walks"),
+        katana::no_stats());
   }
 
   //compute the histogram of edge types for each walk
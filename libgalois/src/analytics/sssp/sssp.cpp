@@ -19,6 +19,10 @@
 
 #include "katana/analytics/sssp/sssp.h"
 
+#include <cmath>
+#include <type_traits>
+#include <vector>
+
 #include "katana/TypedPropertyGraph.h"
 #include "katana/analytics/BfsSsspImplementationBase.h"
 
@@ -65,64 +69,188 @@ struct SsspImplementation : public katana::analytics::BfsSsspImplementationBase<
   static constexpr unsigned kChunkSize = 64;
   static constexpr Dist kDistanceInfinity = Base::kDistanceInfinity;
 
+  /// Number of edge weights sampled to choose an adaptive delta
+  static constexpr uint64_t kDeltaSamples = 1024;
+  static constexpr unsigned kMaxShift = 31;
+
+  /// Distance, rounded down to an integer, as the priority of a request for
+  /// the adaptive OBIM, which groups distances into buckets itself and
+  /// adjusts their width while the loop runs. Delta stepping keeps
+  /// correcting distances until they settle, so changing the width only
+  /// reorders the remaining work.
+  struct AdaptiveIndexer {
+    template <typename R>
+    uint64_t operator()(const R& req) const {
+      return static_cast<uint64_t>(req.dist);
+    }
+  };
+
+  /// Worklist adaptor for bucket fusion: work for the bucket being processed
+  /// (or an earlier one) goes to a thread-local list while that list is
+  /// short, and everything else goes to the shared worklist
+  template <typename T, typename Context, typename Indexer>
+  struct FusedPush {
+    Context& ctx;
+    std::vector<T>& local;
+    const Indexer& indexer;
+    std::invoke_result_t<const Indexer&, const T&> bucket;
+    unsigned threshold;
+
+    void push(const T& item) {
+      if (local.size() < threshold && indexer(item) <= bucket) {
+        local.emplace_back(item);
+      } else {
+        ctx.push(item);
+      }
+    }
+  };
+
+  /// Priority of a request for the MultiQueue, which orders requests by
+  /// their exact distance rather than by bucket
+  struct DistIndexer {
+    template <typename R>
+    Dist operator()(const R& req) const {
+      return req.dist;
+    }
+  };
+
   using PSchunk = katana::PerSocketChunkFIFO<kChunkSize>;
   using OBIM = katana::OrderedByIntegerMetric<UpdateRequestIndexer, PSchunk>;
   using OBIMBarrier = typename katana::OrderedByIntegerMetric<
       UpdateRequestIndexer, PSchunk>::template with_barrier<true>::type;
+  using AdaptiveOBIM = typename katana::OrderedByIntegerMetric<
+      AdaptiveIndexer, PSchunk>::template with_adaptive<true>::type;
+  using MultiQueueWL = katana::MultiQueue<DistIndexer>;
+
+  /// Choose the delta exponent from a sample of the edge weights: a bucket
+  /// should span a few average edge weights on sparse graphs like road
+  /// networks, and less on dense graphs where each bucket reaches more nodes.
+  static unsigned SampleDelta(const Graph& graph) {
+    const uint64_t num_edges = graph.num_edges();
+    if (num_edges == 0) {
+      return SsspPlan::kDefaultDelta;
+    }
+    const uint64_t stride = std::max(num_edges / kDeltaSamples, uint64_t{1});
+    double sum = 0;
+    uint64_t count = 0;
+    for (uint64_t e = 0; e < num_edges; e += stride) {
+      Dist weight = graph.template GetEdgeData<EdgeWeight>(
+          typename Graph::edge_iterator(e));
+      sum += std::max(static_cast<double>(weight), 0.0);
+      ++count;
+    }
+    const double avg_degree = static_cast<double>(num_edges) / graph.size();
+    const double delta = 8 * (sum / count) / avg_degree;
+    if (delta <= 1) {
+      return 0;
+    }
+    return std::min(
+        static_cast<unsigned>(std::lround(std::log2(delta))), kMaxShift);
+  }
 
-  template <typename T, typename OBIMTy = OBIM, typename P, typename R>
+  /// Delta stepping on a worklist of type OBIMTy constructed from wlArgs.
+  /// Bucket fusion groups work by the buckets of indexer.
+  template <
+      typename T, typename OBIMTy, typename P, typename R, typename I,
+      typename... WLArgs>
   static void DeltaStepAlgo(
       Graph* graph, const typename Graph::Node& source, const P& pushWrap,
-      const R& edgeRange, unsigned stepShift) {
+      const R& edgeRange, const I& indexer, unsigned fusion_threshold,
+      const WLArgs&... wlArgs) {
     //! [reducible for self-defined stats]
     katana::GAccumulator<size_t> BadWork;
     //! [reducible for self-defined stats]
     katana::GAccumulator<size_t> WLEmptyWork;
+    katana::GAccumulator<size_t> FusedWork;
 
     graph->template GetData<NodeDistance>(source) = 0;
 
     katana::InsertBag<T> init_bag;
     pushWrap(init_bag, source, 0, "parallel");
 
+    katana::PerThreadStorage<std::vector<T>> fused;
+
+    auto relax = [&](const T& item, auto& wl) {
+      const auto& sdata = graph->template GetData<NodeDistance>(item.src);
+
+      if (sdata < item.dist) {
+        if (kTrackWork) {
+          WLEmptyWork += 1;
+        }
+        return;
+      }
+
+      for (auto ii : edgeRange(item)) {
+        auto dest = graph->GetEdgeDest(ii);
+        auto& ddist = graph->template GetData<NodeDistance>(dest);
+        Dist ew = graph->template GetEdgeData<EdgeWeight>(ii);
+        const Dist new_dist = sdata + ew;
+        Dist old_dist = katana::atomicMin(ddist, new_dist);
+        if (new_dist < old_dist) {
+          if (kTrackWork) {
+            //! [per-thread contribution of self-defined stats]
+            if (old_dist != kDistanceInfinity) {
+              BadWork += 1;
+            }
+            //! [per-thread contribution of self-defined stats]
+          }
+          pushWrap(wl, *dest, new_dist);
+        }
+      }
+    };
+
     katana::for_each(
         katana::iterate(init_bag),
         [&](const T& item, auto& ctx) {
-          const auto& sdata = graph->template GetData<NodeDistance>(item.src);
-
-          if (sdata < item.dist) {
-            if (kTrackWork) {
-              WLEmptyWork += 1;
-            }
+          if (fusion_threshold == 0) {
+            relax(item, ctx);
             return;
           }
 
-          for (auto ii : edgeRange(item)) {
-            auto dest = graph->GetEdgeDest(ii);
-            auto& ddist = graph->template GetData<NodeDistance>(dest);
-            Dist ew = graph->template GetEdgeData<EdgeWeight>(ii);
-            const Dist new_dist = sdata + ew;
-            Dist old_dist = katana::atomicMin(ddist, new_dist);
-            if (new_dist < old_dist) {
-              if (kTrackWork) {
-                //! [per-thread contribution of self-defined stats]
-                if (old_dist != kDistanceInfinity) {
-                  BadWork += 1;
-                }
-                //! [per-thread contribution of self-defined stats]
-              }
-              pushWrap(ctx, *dest, new_dist);
-            }
+          std::vector<T>& local = *fused.getLocal();
+          FusedPush<T, std::remove_reference_t<decltype(ctx)>, I> wl{
+              ctx, local, indexer, indexer(item), fusion_threshold};
+          relax(item, wl);
+          for (size_t i = 0; i < local.size(); ++i) {
+            // relax may grow local
+            const T next = local[i];
+            relax(next, wl);
           }
+          if (kTrackWork) {
+            FusedWork += local.size();
+          }
+          local.clear();
         },
-        katana::wl<OBIMTy>(UpdateRequestIndexer{stepShift}),
-        katana::disable_conflict_detection(), katana::loopname("SSSP"));
+        katana::wl<OBIMTy>(wlArgs...), katana::disable_conflict_detection(),
+        katana::loopname("SSSP"));
 
     if (kTrackWork) {
       //! [report self-defined stats]
       katana::ReportStatSingle("SSSP", "BadWork", BadWork.reduce());
       //! [report self-defined stats]
       katana::ReportStatSingle("SSSP", "WLEmptyWork", WLEmptyWork.reduce());
+      katana::ReportStatSingle("SSSP", "FusedWork", FusedWork.reduce());
+    }
+  }
+
+  /// Delta stepping without barriers, with a delta adjusted as the loop runs
+  /// if the plan asks for an adaptive one
+  template <typename T, typename P, typename R>
+  static void DeltaStepAlgo(
+      Graph* graph, const typename Graph::Node& source, const P& pushWrap,
+      const R& edgeRange, unsigned stepShift, const SsspPlan& plan) {
+    UpdateRequestIndexer indexer{stepShift};
+    if (!plan.adaptive_delta()) {
+      DeltaStepAlgo<T, OBIM>(
+          graph, source, pushWrap, edgeRange, indexer, plan.fusion_threshold(),
+          indexer);
+      return;
     }
+
+    // bucket fusion keeps the initial delta
+    DeltaStepAlgo<T, AdaptiveOBIM>(
+        graph, source, pushWrap, edgeRange, indexer, plan.fusion_threshold(),
+        AdaptiveIndexer{}, stepShift);
   }
 
   template <typename T, typename P, typename R>
@@ -327,24 +455,30 @@ public:
       plan = SsspPlan(&graph.GetPropertyGraph());
     }
 
+    unsigned delta = plan.delta();
+    if (plan.adaptive_delta()) {
+      delta = SampleDelta(graph);
+      katana::ReportStatSingle("SSSP", "InitialDelta", delta);
+    }
+
     switch (plan.algorithm()) {
     case SsspPlan::kDeltaTile:
       DeltaStepAlgo<SrcEdgeTile>(
           &graph, source, SrcEdgeTilePushWrap{&graph, *this}, TileRangeFn(),
-          plan.delta());
+          delta, plan);
       break;
     case SsspPlan::kDeltaStep:
       DeltaStepAlgo<UpdateRequest>(
-          &graph, source, ReqPushWrap(), OutEdgeRangeFn{&graph}, plan.delta());
+          &graph, source, ReqPushWrap(), OutEdgeRangeFn{&graph}, delta, plan);
       break;
     case SsspPlan::kSerialDeltaTile:
       SerDeltaAlgo<SrcEdgeTile>(
           &graph, source, SrcEdgeTilePushWrap{&graph, *this}, TileRangeFn(),
-          plan.delta());
+          delta);
       break;
     case SsspPlan::kSerialDelta:
       SerDeltaAlgo<UpdateRequest>(
-          &graph, source, ReqPushWrap(), OutEdgeRangeFn{&graph}, plan.delta());
+          &graph, source, ReqPushWrap(), OutEdgeRangeFn{&graph}, delta);
       break;
     case SsspPlan::kDijkstraTile:
       DijkstraAlgo<SrcEdgeTile>(
@@ -360,9 +494,18 @@ public:
     case SsspPlan::kTopologicalTile:
       TopoTileAlgo(&graph, source);
       break;
+    case SsspPlan::kMultiQueue:
+      // relaxed priority order needs no delta
+      DeltaStepAlgo<UpdateRequest, MultiQueueWL>(
+          &graph, source, ReqPushWrap(), OutEdgeRangeFn{&graph}, DistIndexer{},
+          plan.fusion_threshold(), DistIndexer{});
+      break;
     case SsspPlan::kDeltaStepBarrier:
+      // the barrier keeps buckets in order, so delta stays fixed
       DeltaStepAlgo<UpdateRequest, OBIMBarrier>(
-          &graph, source, ReqPushWrap(), OutEdgeRangeFn{&graph}, plan.delta());
+          &graph, source, ReqPushWrap(), OutEdgeRangeFn{&graph},
+          UpdateRequestIndexer{delta}, plan.fusion_threshold(),
+          UpdateRequestIndexer{delta});
       break;
     default:
       return katana::ErrorCode::InvalidArgument;
@@ -19,84 +19,269 @@
 
 #include "katana/analytics/subgraph_extraction/subgraph_extraction.h"
 
+#include <cstring>
 #include <iostream>
 
+#include <arrow/compute/api.h>
+
+#include "katana/Bag.h"
+#include "katana/DynamicBitset.h"
+#include "katana/ParallelSTL.h"
 #include "katana/TypedPropertyGraph.h"
 #include "katana/analytics/Utils.h"
 
 namespace {
 
 using namespace katana::analytics;
-using edge_iterator = boost::counting_iterator<uint64_t>;
+using Node = katana::GraphTopology::Node;
+using Edge = katana::GraphTopology::Edge;
+
+template <typename T>
+katana::Result<std::shared_ptr<arrow::Buffer>>
+AllocateArrowBuffer(uint64_t num_elements) {
+  auto buffer_result = arrow::AllocateBuffer(num_elements * sizeof(T));
+  if (!buffer_result.ok()) {
+    return KATANA_ERROR(
+        katana::ErrorCode::ArrowError, "allocating {} elements: {}",
+        num_elements, buffer_result.status());
+  }
+  return std::shared_ptr<arrow::Buffer>(std::move(buffer_result.ValueOrDie()));
+}
+
+template <typename T, typename IdType>
+void
+GatherFixedWidth(
+    const uint8_t* src, uint8_t* dst, const IdType* ids, uint64_t num_rows) {
+  const T* typed_src = reinterpret_cast<const T*>(src);
+  T* typed_dst = reinterpret_cast<T*>(dst);
+  katana::do_all(
+      katana::iterate(uint64_t{0}, num_rows),
+      [&](uint64_t i) { typed_dst[i] = typed_src[ids[i]]; },
+      katana::no_stats());
+}
+
+/// Gather rows ids[0..num_rows) of column into a new column. Fixed width
+/// columns without nulls are gathered in parallel; anything else (strings,
+/// booleans, dictionaries, nullable columns, ...) falls back to
+/// arrow::compute::Take.
+template <typename IdType>
+katana::Result<std::shared_ptr<arrow::ChunkedArray>>
+GatherProperty(
+    const std::shared_ptr<arrow::ChunkedArray>& column, const IdType* ids,
+    uint64_t num_rows) {
+  // dictionary arrays are fixed width too, but their buffer holds indices
+  // into a dictionary that the gathered array would have to keep
+  auto fixed_width =
+      std::dynamic_pointer_cast<arrow::FixedWidthType>(column->type());
+  if (fixed_width && column->type()->id() != arrow::Type::DICTIONARY &&
+      fixed_width->bit_width() % 8 == 0 &&
+      column->num_chunks() == 1 && column->null_count() == 0) {
+    const auto& data = column->chunk(0)->data();
+    const size_t width = fixed_width->bit_width() / 8;
+    const uint8_t* src = data->buffers[1]->data() + data->offset * width;
+
+    auto buffer_result = AllocateArrowBuffer<uint8_t>(num_rows * width);
+    if (!buffer_result) {
+      return buffer_result.error();
+    }
+    std::shared_ptr<arrow::Buffer> buffer = std::move(buffer_result.value());
+    uint8_t* dst = buffer->mutable_data();
+
+    switch (width) {
+    case 1:
+      GatherFixedWidth<uint8_t>(src, dst, ids, num_rows);
+      break;
+    case 2:
+      GatherFixedWidth<uint16_t>(src, dst, ids, num_rows);
+      break;
+    case 4:
+      GatherFixedWidth<uint32_t>(src, dst, ids, num_rows);
+      break;
+    case 8:
+      GatherFixedWidth<uint64_t>(src, dst, ids, num_rows);
+      break;
+    default:
+      katana::do_all(
+          katana::iterate(uint64_t{0}, num_rows),
+          [&](uint64_t i) {
+            std::memcpy(dst + i * width, src + ids[i] * width, width);
+          },
+          katana::no_stats());
+    }
+
+    auto array = arrow::MakeArray(arrow::ArrayData::Make(
+        column->type(), num_rows, {nullptr, std::move(buffer)}, 0));
+    return std::make_shared<arrow::ChunkedArray>(array);
+  }
+
+  using IndexArray = typename arrow::CTypeTraits<IdType>::ArrayType;
+  auto indices = std::make_shared<IndexArray>(
+      num_rows, arrow::Buffer::Wrap(ids, num_rows));
+  auto take_result = arrow::compute::Take(column, indices);
+  if (!take_result.ok()) {
+    return KATANA_ERROR(
+        katana::ErrorCode::ArrowError, "gathering property of type {}: {}",
+        column->type()->name(), take_result.status());
+  }
+  return take_result.ValueOrDie().chunked_array();
+}
 
+template <typename IdType>
+katana::Result<std::shared_ptr<arrow::Table>>
+GatherProperties(
+    const std::shared_ptr<arrow::Table>& table,
+    const std::vector<std::string>& names, const IdType* ids,
+    uint64_t num_rows) {
+  std::vector<std::shared_ptr<arrow::Field>> fields;
+  std::vector<std::shared_ptr<arrow::ChunkedArray>> columns;
+  for (const auto& name : names) {
+    int index = table->schema()->GetFieldIndex(name);
+    if (index < 0) {
+      return KATANA_ERROR(
+          katana::ErrorCode::PropertyNotFound, "property {} not found", name);
+    }
+    auto column_result = GatherProperty(table->column(index), ids, num_rows);
+    if (!column_result) {
+      return column_result.error().WithContext("property {}", name);
+    }
+    fields.emplace_back(table->schema()->field(index));
+    columns.emplace_back(std::move(column_result.value()));
+  }
+  return arrow::Table::Make(arrow::schema(fields), columns, num_rows);
+}
+
+/// Build the sub-graph induced by the nodes set in `nodes`, keeping only the
+/// edges set in `edges` when it is given.
+///
+/// Nodes are renumbered with a parallel prefix sum over the node mask, edges
+/// with a prefix sum over the per-node kept degree; properties are then
+/// gathered through the resulting new-to-old id arrays.
 katana::Result<std::unique_ptr<katana::PropertyGraph>>
-SubGraphNodeSet(
-    katana::PropertyGraph* graph, const std::vector<uint32_t>& node_set) {
+ExtractSubGraph(
+    katana::PropertyGraph* pg, const katana::DynamicBitset& nodes,
+    const katana::DynamicBitset* edges,
+    const SubGraphExtractionProperties& properties) {
+  const katana::GraphTopology& topology = pg->topology();
+  const uint64_t num_nodes = topology.num_nodes();
   auto subgraph = std::make_unique<katana::PropertyGraph>();
-  if (node_set.empty()) {
+
+  // new_id[n] - 1 is the sub-graph id of n, if n is selected
+  katana::LargeArray<uint32_t> new_id;
+  new_id.allocateBlocked(num_nodes);
+  katana::do_all(
+      katana::iterate(uint64_t{0}, num_nodes),
+      [&](uint64_t n) { new_id[n] = nodes.test(n) ? 1 : 0; },
+      katana::no_stats());
+  katana::ParallelSTL::partial_sum(
+      new_id.begin(), new_id.end(), new_id.begin());
+  const uint64_t num_sub_nodes = num_nodes > 0 ? new_id[num_nodes - 1] : 0;
+
+  if (!properties.subgraph_id_property.empty()) {
+    auto buffer_result = AllocateArrowBuffer<uint32_t>(num_nodes);
+    if (!buffer_result) {
+      return buffer_result.error();
+    }
+    auto buffer = std::move(buffer_result.value());
+    uint32_t* subgraph_id = reinterpret_cast<uint32_t*>(buffer->mutable_data());
+    katana::do_all(
+        katana::iterate(uint64_t{0}, num_nodes),
+        [&](uint64_t n) {
+          subgraph_id[n] = nodes.test(n)
+                               ? new_id[n] - 1
+                               : SubGraphExtractionProperties::kNotInSubGraph;
+        },
+        katana::no_stats());
+    auto column = std::make_shared<arrow::UInt32Array>(num_nodes, buffer);
+    auto table = arrow::Table::Make(
+        arrow::schema(
+            {arrow::field(properties.subgraph_id_property, arrow::uint32())}),
+        {column});
+    if (auto r = pg->AddNodeProperties(table); !r) {
+      return r.error();
+    }
+  }
+
+  if (num_sub_nodes == 0) {
     return std::unique_ptr<katana::PropertyGraph>(std::move(subgraph));
   }
 
-  uint64_t num_nodes = node_set.size();
-  // Subgraph topology : out indices
-  auto out_indices = std::make_unique<katana::LargeArray<uint64_t>>();
-  out_indices->allocateInterleaved(num_nodes);
+  auto old_id_result = AllocateArrowBuffer<uint32_t>(num_sub_nodes);
+  if (!old_id_result) {
+    return old_id_result.error();
+  }
+  std::shared_ptr<arrow::Buffer> old_id_buffer =
+      std::move(old_id_result.value());
+  uint32_t* old_id = reinterpret_cast<uint32_t*>(old_id_buffer->mutable_data());
+  katana::do_all(
+      katana::iterate(uint64_t{0}, num_nodes),
+      [&](uint64_t n) {
+        if (nodes.test(n)) {
+          old_id[new_id[n] - 1] = n;
+        }
+      },
+      katana::no_stats());
 
-  katana::gstl::Vector<katana::gstl::Vector<uint32_t>> subgraph_edges;
-  subgraph_edges.resize(num_nodes);
+  auto keep_edge = [&](Edge e) {
+    return nodes.test(topology.edge_dest(e)) && (!edges || edges->test(e));
+  };
 
+  // Subgraph topology : out indices
+  auto out_indices = std::make_unique<katana::LargeArray<uint64_t>>();
+  out_indices->allocateInterleaved(num_sub_nodes);
   katana::do_all(
-      katana::iterate(uint32_t(0), uint32_t(num_nodes)),
-      [&](const uint32_t& n) {
-        uint32_t src = node_set[n];
-        auto edge_range = graph->topology().edge_range(src);
-        for (auto dest : node_set) {
-          // Binary search on the edges sorted by destination id
-          auto edge_matched = std::lower_bound(
-              edge_iterator(edge_range.first), edge_iterator(edge_range.second),
-              dest);
-          if (*edge_matched != edge_range.second) {
-            while (*edge_matched == dest) {
-              subgraph_edges[n].push_back(dest);
-              edge_matched++;
-            }
-          }
-          (*out_indices)[n] = subgraph_edges[n].size();
+      katana::iterate(uint64_t{0}, num_sub_nodes),
+      [&](uint64_t n) {
+        uint64_t degree = 0;
+        for (auto e : topology.edges(old_id[n])) {
+          degree += keep_edge(e) ? 1 : 0;
         }
+        (*out_indices)[n] = degree;
       },
-      katana::steal(), katana::no_stats(),
-      katana::loopname("SubgraphExtraction"));
+      katana::steal(), katana::loopname("SubGraphExtraction-Degrees"));
+  katana::ParallelSTL::partial_sum(
+      out_indices->begin(), out_indices->end(), out_indices->begin());
+  const uint64_t num_sub_edges = (*out_indices)[num_sub_nodes - 1];
 
-  // Prefix sum
-  for (uint64_t i = 1; i < num_nodes; ++i) {
-    (*out_indices)[i] += (*out_indices)[i - 1];
-  }
-  uint64_t num_edges = (*out_indices)[num_nodes - 1];
   // Subgraph topology : out dests
   auto out_dests = std::make_unique<katana::LargeArray<uint32_t>>();
-  out_dests->allocateInterleaved(num_edges);
+  out_dests->allocateInterleaved(num_sub_edges);
+  auto old_edge_id_result = AllocateArrowBuffer<uint64_t>(num_sub_edges);
+  if (!old_edge_id_result) {
+    return old_edge_id_result.error();
+  }
+  std::shared_ptr<arrow::Buffer> old_edge_id_buffer =
+      std::move(old_edge_id_result.value());
+  uint64_t* old_edge_id =
+      reinterpret_cast<uint64_t*>(old_edge_id_buffer->mutable_data());
 
   katana::do_all(
-      katana::iterate(uint32_t(0), uint32_t(num_nodes)),
-      [&](const uint32_t& n) {
-        uint64_t offset = (*out_indices)[n];
-        for (uint32_t dest : subgraph_edges[n]) {
-          (*out_dests)[offset] = dest;
-          offset++;
+      katana::iterate(uint64_t{0}, num_sub_nodes),
+      [&](uint64_t n) {
+        uint64_t offset = n > 0 ? (*out_indices)[n - 1] : 0;
+        for (auto e : topology.edges(old_id[n])) {
+          if (!keep_edge(e)) {
+            continue;
+          }
+          (*out_dests)[offset] = new_id[topology.edge_dest(e)] - 1;
+          old_edge_id[offset] = e;
+          ++offset;
         }
+        KATANA_LOG_DEBUG_ASSERT(offset == (*out_indices)[n]);
       },
-      katana::no_stats(), katana::loopname("ConstructTopology"));
+      katana::steal(), katana::loopname("SubGraphExtraction-Topology"));
 
   // Set new topology
   auto numeric_array_out_indices =
       std::make_shared<arrow::NumericArray<arrow::UInt64Type>>(
-          static_cast<int64_t>(num_nodes),
-          arrow::MutableBuffer::Wrap(out_indices.release()->data(), num_nodes));
+          static_cast<int64_t>(num_sub_nodes),
+          arrow::MutableBuffer::Wrap(
+              out_indices.release()->data(), num_sub_nodes));
 
   auto numeric_array_out_dests =
       std::make_shared<arrow::NumericArray<arrow::UInt32Type>>(
-          static_cast<int64_t>(num_edges),
-          arrow::MutableBuffer::Wrap(out_dests.release()->data(), num_edges));
+          static_cast<int64_t>(num_sub_edges),
+          arrow::MutableBuffer::Wrap(
+              out_dests.release()->data(), num_sub_edges));
 
   if (auto r = subgraph->SetTopology(katana::GraphTopology{
           .out_indices = std::move(numeric_array_out_indices),
@@ -106,35 +291,200 @@ SubGraphNodeSet(
     return r.error();
   }
 
+  // Carry over properties
+  std::vector<std::string> node_properties = properties.all_node_properties
+                                                 ? pg->GetNodePropertyNames()
+                                                 : properties.node_properties;
+  std::vector<std::string> edge_properties = properties.all_edge_properties
+                                                 ? pg->GetEdgePropertyNames()
+                                                 : properties.edge_properties;
+  if (!properties.subgraph_id_property.empty()) {
+    // The mapping just added to the original graph is meaningless in the
+    // sub-graph.
+    node_properties.erase(
+        std::remove(
+            node_properties.begin(), node_properties.end(),
+            properties.subgraph_id_property),
+        node_properties.end());
+  }
+
+  auto node_table_result = GatherProperties(
+      pg->node_properties(), node_properties, old_id, num_sub_nodes);
+  if (!node_table_result) {
+    return node_table_result.error();
+  }
+  std::shared_ptr<arrow::Table> node_table =
+      std::move(node_table_result.value());
+  if (!properties.original_id_property.empty()) {
+    auto result = node_table->AddColumn(
+        node_table->num_columns(),
+        arrow::field(properties.original_id_property, arrow::uint32()),
+        std::make_shared<arrow::ChunkedArray>(
+            std::make_shared<arrow::UInt32Array>(
+                num_sub_nodes, old_id_buffer)));
+    if (!result.ok()) {
+      return KATANA_ERROR(
+          katana::ErrorCode::ArrowError, "adding original id property: {}",
+          result.status());
+    }
+    node_table = std::move(result.ValueOrDie());
+  }
+  if (auto r = subgraph->AddNodeProperties(node_table); !r) {
+    return r.error();
+  }
+
+  auto edge_table_result = GatherProperties(
+      pg->edge_properties(), edge_properties, old_edge_id, num_sub_edges);
+  if (!edge_table_result) {
+    return edge_table_result.error();
+  }
+  if (auto r = subgraph->AddEdgeProperties(edge_table_result.value()); !r) {
+    return r.error();
+  }
+
   return std::unique_ptr<katana::PropertyGraph>(std::move(subgraph));
 }
+
+katana::Result<void>
+SelectNodeSet(
+    katana::PropertyGraph* pg, const std::vector<uint32_t>& node_set,
+    katana::DynamicBitset* nodes) {
+  for (auto n : node_set) {
+    if (n >= pg->num_nodes()) {
+      return KATANA_ERROR(
+          katana::ErrorCode::InvalidArgument, "node {} is not in the graph", n);
+    }
+    nodes->set(n);
+  }
+  return katana::ResultSuccess();
+}
+
+/// Select every node within num_hops out-edges of a seed node.
+katana::Result<void>
+SelectKHop(
+    katana::PropertyGraph* pg, const std::vector<uint32_t>& seeds,
+    uint32_t num_hops, katana::DynamicBitset* nodes) {
+  auto current = std::make_unique<katana::InsertBag<Node>>();
+  auto next = std::make_unique<katana::InsertBag<Node>>();
+
+  for (auto n : seeds) {
+    if (n >= pg->num_nodes()) {
+      return KATANA_ERROR(
+          katana::ErrorCode::InvalidArgument, "node {} is not in the graph", n);
+    }
+    if (!nodes->set(n)) {
+      next->push(n);
+    }
+  }
+
+  for (uint32_t hop = 0; hop < num_hops && !next->empty(); ++hop) {
+    std::swap(current, next);
+    next->clear();
+    katana::do_all(
+        katana::iterate(*current),
+        [&](const Node& src) {
+          for (auto e : pg->edges(src)) {
+            auto dest = *pg->GetEdgeDest(e);
+            if (!nodes->set(dest)) {
+              next->push(dest);
+            }
+          }
+        },
+        katana::steal(), katana::loopname("SubGraphExtraction-KHop"));
+  }
+  return katana::ResultSuccess();
+}
+
 }  // namespace
 
 katana::Result<std::unique_ptr<katana::PropertyGraph>>
 katana::analytics::SubGraphExtraction(
     katana::PropertyGraph* pg, const std::vector<uint32_t>& node_vec,
     SubGraphExtractionPlan plan) {
-  if (auto r = katana::SortAllEdgesByDest(pg); !r) {
-    return r.error();
-  }
+  return SubGraphExtraction(pg, node_vec, SubGraphExtractionProperties{}, plan);
+}
 
-  // Remove duplicates from the node vector
-  std::unordered_set<uint32_t> set;
-  std::vector<uint32_t> dedup_node_vec;
-  for (auto i : node_vec) {
-    set.insert(i);
-  }
-  dedup_node_vec.assign(set.begin(), set.end());
+katana::Result<std::unique_ptr<katana::PropertyGraph>>
+katana::analytics::SubGraphExtraction(
+    katana::PropertyGraph* pg, const std::vector<uint32_t>& node_vec,
+    const SubGraphExtractionProperties& properties,
+    SubGraphExtractionPlan plan) {
+  katana::DynamicBitset nodes;
+  nodes.resize(pg->num_nodes());
 
   katana::StatTimer execTime("SubGraph-Extraction");
+  execTime.start();
   switch (plan.algorithm()) {
-  case SubGraphExtractionPlan::kNodeSet: {
-    execTime.start();
-    auto subgraph = SubGraphNodeSet(pg, dedup_node_vec);
-    execTime.stop();
-    return std::move(subgraph.value());
-  }
+  case SubGraphExtractionPlan::kNodeSet:
+    if (auto r = SelectNodeSet(pg, node_vec, &nodes); !r) {
+      return r.error();
+    }
+    break;
+  case SubGraphExtractionPlan::kKHop:
+    if (auto r = SelectKHop(pg, node_vec, plan.num_hops(), &nodes); !r) {
+      return r.error();
+    }
+    break;
   default:
     return katana::ErrorCode::InvalidArgument;
   }
+  auto subgraph = ExtractSubGraph(pg, nodes, nullptr, properties);
+  execTime.stop();
+  return subgraph;
+}
+
+katana::Result<std::unique_ptr<katana::PropertyGraph>>
+katana::analytics::SubGraphExtractionByNodePredicate(
+    katana::PropertyGraph* pg,
+    const std::function<bool(GraphTopology::Node)>& node_predicate,
+    const SubGraphExtractionProperties& properties) {
+  katana::DynamicBitset nodes;
+  nodes.resize(pg->num_nodes());
+
+  katana::StatTimer execTime("SubGraph-Extraction");
+  execTime.start();
+  katana::do_all(
+      katana::iterate(*pg),
+      [&](const Node& n) {
+        if (node_predicate(n)) {
+          nodes.set(n);
+        }
+      },
+      katana::loopname("SubGraphExtraction-NodePredicate"));
+  auto subgraph = ExtractSubGraph(pg, nodes, nullptr, properties);
+  execTime.stop();
+  return subgraph;
+}
+
+katana::Result<std::unique_ptr<katana::PropertyGraph>>
+katana::analytics::SubGraphExtractionByEdgePredicate(
+    katana::PropertyGraph* pg,
+    const std::function<bool(GraphTopology::Edge)>& edge_predicate,
+    const SubGraphExtractionProperties& properties) {
+  katana::DynamicBitset nodes;
+  nodes.resize(pg->num_nodes());
+  katana::DynamicBitset edges;
+  edges.resize(pg->num_edges());
+
+  katana::StatTimer execTime("SubGraph-Extraction");
+  execTime.start();
+  katana::do_all(
+      katana::iterate(*pg),
+      [&](const Node& n) {
+        bool any = false;
+        for (auto e : pg->edges(n)) {
+          if (edge_predicate(e)) {
+            edges.set(e);
+            nodes.set(*pg->GetEdgeDest(e));
+            any = true;
+          }
+        }
+        if (any) {
+          nodes.set(n);
+        }
+      },
+      katana::steal(), katana::loopname("SubGraphExtraction-EdgePredicate"));
+  auto subgraph = ExtractSubGraph(pg, nodes, &edges, properties);
+  execTime.stop();
+  return subgraph;
 }
@@ -0,0 +1,85 @@
+#include <atomic>
+#include <vector>
+
+#include "katana/Galois.h"
+#include "katana/Logging.h"
+#include "katana/Obim.h"
+#include "katana/SharedMemSys.h"
+#include "katana/ThreadPool.h"
+#include "katana/Threads.h"
+
+namespace {
+
+constexpr uint32_t kNumItems = 1 << 18;
+
+struct Indexer {
+  uint32_t operator()(uint32_t i) const { return i; }
+};
+
+using PSchunk = katana::PerSocketChunkFIFO<32>;
+using AdaptiveOBIM = katana::OrderedByIntegerMetric<
+    Indexer, PSchunk>::with_adaptive<true>::type;
+
+// Every pushed item, including the items pushed by the loop itself, is
+// processed exactly once while the worklist changes its buckets and chunks
+template <typename WL>
+void
+TestForEach(unsigned initial_shift) {
+  std::vector<std::atomic<uint32_t>> seen(kNumItems);
+  for (auto& s : seen) {
+    s = 0;
+  }
+
+  katana::for_each(
+      katana::iterate({uint32_t{1}}),
+      [&](uint32_t i, auto& ctx) {
+        seen[i] += 1;
+        if (2 * i < kNumItems) {
+          ctx.push(2 * i);
+          ctx.push(2 * i + 1);
+        }
+      },
+      katana::wl<WL>(Indexer(), initial_shift),
+      katana::disable_conflict_detection(),
+      katana::loopname("AdaptiveOBIM"));
+
+  KATANA_LOG_ASSERT(seen[0] == 0);
+  for (uint32_t i = 1; i < kNumItems; ++i) {
+    KATANA_LOG_ASSERT(seen[i] == 1);
+  }
+}
+
+// On a single thread the worklist follows priority order up to its bucket
+// width
+void
+TestOrder() {
+  using WL = AdaptiveOBIM::retype<uint32_t>::rethread<false>;
+  WL wl(Indexer(), 4);
+  for (uint32_t i = 0; i < 1000; ++i) {
+    wl.push((i * 7919) % 1000);
+  }
+  uint32_t last_bucket = 0;
+  for (uint32_t i = 0; i < 1000; ++i) {
+    auto item = wl.pop();
+    KATANA_LOG_ASSERT(item);
+    KATANA_LOG_ASSERT(*item >> 4 >= last_bucket);
+    last_bucket = *item >> 4;
+  }
+  KATANA_LOG_ASSERT(!wl.pop());
+}
+
+}  // namespace
+
+int
+main() {
+  katana::SharedMemSys sys;
+  katana::setActiveThreads(katana::GetThreadPool().getMaxThreads());
+
+  TestOrder();
+  TestForEach<AdaptiveOBIM>(0);
+  TestForEach<AdaptiveOBIM>(10);
+  TestForEach<AdaptiveOBIM::with_descending<true>::type>(3);
+  TestForEach<AdaptiveOBIM::with_barrier<true>::type>(3);
+
+  return 0;
+}
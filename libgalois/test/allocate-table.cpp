@@ -0,0 +1,71 @@
+#include <arrow/api.h>
+
+#include "katana/Logging.h"
+#include "katana/PageAlloc.h"
+#include "katana/Properties.h"
+#include "katana/SharedMemSys.h"
+
+namespace {
+
+struct Distance : public katana::PODProperty<uint64_t> {};
+struct Rank : public katana::PODProperty<float> {};
+struct Visited {
+  using ArrowType = arrow::BooleanType;
+  using ViewType = katana::BooleanPropertyReadOnlyView;
+};
+
+using Props = std::tuple<Distance, Rank, Visited>;
+
+void
+TestAllocate(uint64_t num_rows, katana::NumaPlacement placement) {
+  auto res = katana::AllocateTable<Props>(
+      num_rows, {"distance", "rank", "visited"}, placement);
+  KATANA_LOG_ASSERT(res);
+  std::shared_ptr<arrow::Table> table = res.value();
+
+  KATANA_LOG_ASSERT(table->num_rows() == static_cast<int64_t>(num_rows));
+  KATANA_LOG_ASSERT(table->num_columns() == 3);
+  KATANA_LOG_ASSERT(table->field(0)->name() == "distance");
+  KATANA_LOG_ASSERT(table->field(0)->type()->Equals(arrow::uint64()));
+  KATANA_LOG_ASSERT(table->field(1)->type()->Equals(arrow::float32()));
+  KATANA_LOG_ASSERT(table->field(2)->type()->Equals(arrow::boolean()));
+
+  auto distance =
+      std::static_pointer_cast<arrow::UInt64Array>(table->column(0)->chunk(0));
+  auto visited =
+      std::static_pointer_cast<arrow::BooleanArray>(table->column(2)->chunk(0));
+  for (uint64_t i = 0; i < num_rows; ++i) {
+    KATANA_LOG_ASSERT(distance->Value(i) == 0);
+    KATANA_LOG_ASSERT(!visited->Value(i));
+  }
+  KATANA_LOG_ASSERT(distance->null_count() == 0);
+  KATANA_LOG_ASSERT(table->ValidateFull().ok());
+
+  // columns are writable in place
+  if (num_rows > 0) {
+    auto data =
+        table->column(0)->chunk(0)->data()->GetMutableValues<uint64_t>(1);
+    data[num_rows - 1] = 7;
+    KATANA_LOG_ASSERT(distance->Value(num_rows - 1) == 7);
+  }
+}
+
+}  // namespace
+
+int
+main() {
+  katana::SharedMemSys sys;
+  katana::setActiveThreads(katana::GetThreadPool().getMaxThreads());
+
+  // spans several huge pages for every column but the boolean one
+  uint64_t large = 4 * katana::allocSize() / sizeof(float) + 3;
+
+  for (auto placement :
+       {katana::NumaPlacement::kInterleaved, katana::NumaPlacement::kBlocked}) {
+    TestAllocate(0, placement);
+    TestAllocate(100, placement);
+    TestAllocate(large, placement);
+  }
+
+  return 0;
+}
@@ -0,0 +1,143 @@
+#include <cstring>
+#include <limits>
+#include <thread>
+#include <vector>
+
+#include <arrow/api.h>
+
+#include "katana/ArrowInterchange.h"
+#include "katana/ArrowMemoryPool.h"
+#include "katana/Logging.h"
+#include "katana/NumaBuffer.h"
+#include "katana/PageAlloc.h"
+#include "katana/SharedMemSys.h"
+#include "katana/ThreadPool.h"
+#include "katana/Threads.h"
+
+namespace {
+
+void
+TestAllocate(katana::NumaPlacement placement) {
+  katana::ArrowMemoryPool pool("TestPool", placement);
+  const int64_t huge = 3 * katana::allocSize() + 5;
+
+  uint8_t* small{};
+  KATANA_LOG_ASSERT(pool.Allocate(100, &small).ok());
+  uint8_t* large{};
+  KATANA_LOG_ASSERT(pool.Allocate(huge, &large).ok());
+  KATANA_LOG_ASSERT(pool.bytes_allocated() == 100 + huge);
+  KATANA_LOG_ASSERT(reinterpret_cast<uintptr_t>(large) % 64 == 0);
+  std::memset(large, 1, huge);
+
+  // growing within the mapped pages keeps the allocation in place
+  uint8_t* before = large;
+  KATANA_LOG_ASSERT(pool.Reallocate(huge, huge + 10, &large).ok());
+  KATANA_LOG_ASSERT(large == before);
+
+  // growing a small allocation into a huge one copies it
+  std::memset(small, 2, 100);
+  KATANA_LOG_ASSERT(pool.Reallocate(100, huge, &small).ok());
+  KATANA_LOG_ASSERT(small[99] == 2);
+
+  // and shrinking moves it back
+  KATANA_LOG_ASSERT(pool.Reallocate(huge + 10, 10, &large).ok());
+  KATANA_LOG_ASSERT(large[9] == 1);
+
+  KATANA_LOG_ASSERT(pool.bytes_allocated() == 10 + huge);
+  pool.Free(small, huge);
+  pool.Free(large, 10);
+  KATANA_LOG_ASSERT(pool.bytes_allocated() == 0);
+  KATANA_LOG_ASSERT(pool.max_memory() >= 2 * huge);
+  pool.ReportStats();
+}
+
+void
+TestDefault() {
+  KATANA_LOG_ASSERT(
+      katana::DefaultArrowMemoryPool() == katana::ArrowMemoryPool::Default());
+
+  // builders allocate from the default pool
+  int64_t before = katana::ArrowMemoryPool::Default()->bytes_allocated();
+  std::vector<uint64_t> values(katana::allocSize(), 1);
+  auto res = katana::VectorToArrowTable("value", values);
+  KATANA_LOG_ASSERT(res);
+  KATANA_LOG_ASSERT(
+      katana::ArrowMemoryPool::Default()->bytes_allocated() > before);
+}
+
+/// Allocations too large to map fail with OutOfMemory instead of aborting
+void
+TestOutOfMemory() {
+  katana::ArrowMemoryPool pool("TestPool");
+  const int64_t too_large = std::numeric_limits<int64_t>::max() / 2;
+
+  uint8_t* data{};
+  arrow::Status status = pool.Allocate(too_large, &data);
+  KATANA_LOG_ASSERT(status.IsOutOfMemory());
+  KATANA_LOG_ASSERT(data == nullptr);
+
+  KATANA_LOG_ASSERT(pool.Allocate(100, &data).ok());
+  uint8_t* before = data;
+  status = pool.Reallocate(100, too_large, &data);
+  KATANA_LOG_ASSERT(status.IsOutOfMemory());
+  KATANA_LOG_ASSERT(data == before);
+  pool.Free(data, 100);
+  KATANA_LOG_ASSERT(pool.bytes_allocated() == 0);
+
+  KATANA_LOG_ASSERT(!katana::AllocateNumaBuffer(too_large));
+}
+
+/// Huge allocations from threads outside the thread pool, like the
+/// std::async readers of ParquetReader, race with each other and with the
+/// master; they must neither deadlock nor start loops on the pool
+void
+TestConcurrentHuge() {
+  constexpr int kNumThreads = 8;
+  constexpr int kNumRounds = 4;
+  const int64_t huge = 2 * katana::allocSize() + 7;
+
+  auto allocate = [&](uint8_t fill) {
+    for (int round = 0; round < kNumRounds; ++round) {
+      uint8_t* data{};
+      KATANA_LOG_ASSERT(
+          katana::DefaultArrowMemoryPool()->Allocate(huge, &data).ok());
+      std::memset(data, fill, huge);
+      KATANA_LOG_ASSERT(data[huge - 1] == fill);
+      katana::DefaultArrowMemoryPool()->Free(data, huge);
+
+      auto res =
+          katana::AllocateNumaBuffer(huge, katana::NumaPlacement::kBlocked);
+      KATANA_LOG_ASSERT(res);
+      std::shared_ptr<arrow::Buffer> buffer = res.value();
+      KATANA_LOG_ASSERT(buffer->data()[0] == 0);
+      KATANA_LOG_ASSERT(buffer->data()[huge - 1] == 0);
+    }
+  };
+
+  std::vector<std::thread> threads;
+  for (int i = 0; i < kNumThreads; ++i) {
+    threads.emplace_back(allocate, static_cast<uint8_t>(i + 1));
+  }
+  // the master fans its first-touch out over the pool meanwhile
+  allocate(0xff);
+  for (std::thread& t : threads) {
+    t.join();
+  }
+}
+
+}  // namespace
+
+int
+main() {
+  katana::SharedMemSys sys;
+  katana::setActiveThreads(katana::GetThreadPool().getMaxThreads());
+
+  TestAllocate(katana::NumaPlacement::kInterleaved);
+  TestAllocate(katana::NumaPlacement::kBlocked);
+  TestAllocate(katana::NumaPlacement::kLocal);
+  TestDefault();
+  TestOutOfMemory();
+  TestConcurrentHuge();
+
+  return 0;
+}
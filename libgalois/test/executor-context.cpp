@@ -0,0 +1,120 @@
+#include <thread>
+
+#include "katana/ExecutorContext.h"
+#include "katana/Galois.h"
+#include "katana/Logging.h"
+#include "katana/Reduction.h"
+#include "katana/SharedMemSys.h"
+#include "katana/ThreadPool.h"
+#include "katana/Threads.h"
+
+namespace {
+
+constexpr uint64_t kNumItems = 100000;
+
+// Runs loops on the calling context and checks that they only see its threads
+void
+RunLoops(unsigned num_threads) {
+  KATANA_LOG_ASSERT(katana::getActiveThreads() == num_threads);
+
+  katana::GAccumulator<unsigned> seen;
+  katana::on_each([&](unsigned tid, unsigned total) {
+    KATANA_LOG_ASSERT(total == num_threads);
+    KATANA_LOG_ASSERT(tid < num_threads);
+    KATANA_LOG_ASSERT(katana::ThreadPool::getTID() == tid);
+    seen += 1;
+  });
+  KATANA_LOG_ASSERT(seen.reduce() == num_threads);
+
+  for (int round = 0; round < 10; ++round) {
+    katana::GAccumulator<uint64_t> sum;
+    katana::do_all(katana::iterate(uint64_t{0}, kNumItems), [&](uint64_t i) {
+      KATANA_LOG_ASSERT(katana::ThreadPool::getTID() < num_threads);
+      sum += i;
+    });
+    KATANA_LOG_ASSERT(sum.reduce() == kNumItems * (kNumItems - 1) / 2);
+
+    katana::GAccumulator<uint64_t> count;
+    katana::for_each(
+        katana::iterate({uint64_t{1}}),
+        [&](uint64_t i, auto& ctx) {
+          count += 1;
+          if (2 * i < kNumItems) {
+            ctx.push(2 * i);
+            ctx.push(2 * i + 1);
+          }
+        },
+        katana::disable_conflict_detection());
+    KATANA_LOG_ASSERT(count.reduce() == kNumItems - 1);
+  }
+
+  // changing the active threads of a context does not leak out of it
+  KATANA_LOG_ASSERT(katana::setActiveThreads(1) == 1);
+  KATANA_LOG_ASSERT(katana::getActiveThreads() == 1);
+  katana::on_each([](unsigned, unsigned total) {
+    KATANA_LOG_ASSERT(total == 1);
+  });
+  katana::setActiveThreads(num_threads);
+}
+
+void
+TestConcurrent(unsigned max_threads) {
+  unsigned num_a = (max_threads - 1) / 2;
+  unsigned num_b = max_threads - 1 - num_a;
+
+  auto a_res = katana::ExecutorContext::Make(num_a);
+  KATANA_LOG_ASSERT(a_res);
+  auto b_res = katana::ExecutorContext::Make(num_b);
+  KATANA_LOG_ASSERT(b_res);
+  std::unique_ptr<katana::ExecutorContext> a = std::move(a_res.value());
+  std::unique_ptr<katana::ExecutorContext> b = std::move(b_res.value());
+
+  // only thread 0 is left for the system pool
+  KATANA_LOG_ASSERT(katana::GetThreadPool().getMaxUsableThreads() == 1);
+  KATANA_LOG_ASSERT(katana::getActiveThreads() == 1);
+  KATANA_LOG_ASSERT(!katana::ExecutorContext::Make(1));
+
+  std::thread ta([&]() { a->Run([=]() { RunLoops(num_a); }); });
+  std::thread tb([&]() { b->Run([=]() { RunLoops(num_b); }); });
+  ta.join();
+  tb.join();
+
+  auto current = b->Submit([]() { return katana::ExecutorContext::Current(); });
+  KATANA_LOG_ASSERT(current.get() == b.get());
+  KATANA_LOG_ASSERT(katana::ExecutorContext::Current() == nullptr);
+
+  // the system pool keeps working while contexts exist
+  katana::GAccumulator<uint64_t> sum;
+  katana::do_all(
+      katana::iterate(uint64_t{0}, kNumItems), [&](uint64_t i) { sum += i; });
+  KATANA_LOG_ASSERT(sum.reduce() == kNumItems * (kNumItems - 1) / 2);
+}
+
+}  // namespace
+
+int
+main() {
+  katana::SharedMemSys sys;
+  unsigned max_threads = katana::GetThreadPool().getMaxThreads();
+  katana::setActiveThreads(max_threads);
+
+  KATANA_LOG_ASSERT(!katana::ExecutorContext::Make(0));
+  KATANA_LOG_ASSERT(!katana::ExecutorContext::Make(max_threads));
+
+  if (max_threads < 3) {
+    KATANA_LOG_WARN("skipping concurrent contexts: need at least 3 threads");
+    return 0;
+  }
+
+  TestConcurrent(max_threads);
+
+  // destroying the contexts returns their threads
+  KATANA_LOG_ASSERT(
+      katana::GetThreadPool().getMaxUsableThreads() == max_threads);
+  KATANA_LOG_ASSERT(katana::setActiveThreads(max_threads) == max_threads);
+  katana::on_each([&](unsigned, unsigned total) {
+    KATANA_LOG_ASSERT(total == max_threads);
+  });
+
+  return 0;
+}
@@ -0,0 +1,138 @@
+#include <arrow/api.h>
+
+#include "katana/ArrowInterchange.h"
+#include "katana/GraphStats.h"
+#include "katana/Logging.h"
+#include "katana/PropertyGraph.h"
+#include "katana/SharedMemSys.h"
+
+namespace {
+
+std::shared_ptr<arrow::Table>
+MakeProps(const std::string& name, size_t size) {
+  katana::TableBuilder builder{size};
+
+  katana::ColumnOptions options;
+  options.name = name;
+  options.ascending_values = true;
+  builder.AddColumn<int32_t>(options);
+  return builder.Finish();
+}
+
+katana::GraphTopology
+MakeTopology(std::vector<uint64_t> indices, std::vector<uint32_t> dests) {
+  return katana::GraphTopology{
+      .out_indices = std::static_pointer_cast<arrow::UInt64Array>(
+          katana::BuildArray(indices)),
+      .out_dests = std::static_pointer_cast<arrow::UInt32Array>(
+          katana::BuildArray(dests)),
+  };
+}
+
+/// Two components: 0 -> {1, 1, 0}, 1 -> 2 and 3 -> 4 -> 5
+std::unique_ptr<katana::PropertyGraph>
+MakeGraph() {
+  auto g = std::make_unique<katana::PropertyGraph>();
+  auto res = g->SetTopology(
+      MakeTopology({3, 4, 4, 5, 6, 6}, {1, 1, 0, 2, 4, 5}));
+  KATANA_LOG_ASSERT(res);
+  KATANA_LOG_ASSERT(g->AddNodeProperties(MakeProps("node-value", 6)));
+  return g;
+}
+
+void
+TestCompute() {
+  auto g = MakeGraph();
+  auto res = katana::ComputeGraphStats(*g);
+  KATANA_LOG_ASSERT(res);
+  const katana::GraphStats& stats = res.value();
+
+  KATANA_LOG_ASSERT(stats.num_nodes == 6);
+  KATANA_LOG_ASSERT(stats.num_edges == 6);
+  KATANA_LOG_ASSERT(stats.out_degree.min == 0);
+  KATANA_LOG_ASSERT(stats.out_degree.max == 3);
+  KATANA_LOG_ASSERT(stats.out_degree.num_zero == 2);
+  KATANA_LOG_ASSERT(stats.out_degree.nonzero_median == 1);
+  KATANA_LOG_ASSERT(
+      (stats.out_degree.log2_histogram == std::vector<uint64_t>{2, 3, 1}));
+  KATANA_LOG_ASSERT(stats.in_degree.max == 2);
+  KATANA_LOG_ASSERT(stats.in_degree.num_zero == 1);
+  KATANA_LOG_ASSERT(stats.num_self_loops == 1);
+  KATANA_LOG_ASSERT(stats.num_duplicate_edges == 1);
+  KATANA_LOG_ASSERT(stats.num_unsorted_nodes == 1);
+  KATANA_LOG_ASSERT(!stats.edges_sorted());
+  KATANA_LOG_ASSERT(stats.num_components == 2);
+  KATANA_LOG_ASSERT(stats.approximate_diameter == 2);
+
+  KATANA_LOG_ASSERT(stats.node_columns.size() == 1);
+  const katana::ColumnSummary& column = stats.node_columns.at("node-value");
+  KATANA_LOG_ASSERT(column.type == "int32");
+  KATANA_LOG_ASSERT(column.null_count == 0);
+  KATANA_LOG_ASSERT(column.min && column.max && *column.min <= *column.max);
+  KATANA_LOG_ASSERT(stats.edge_columns.empty());
+
+  katana::GraphStats copy = nlohmann::json(stats).get<katana::GraphStats>();
+  KATANA_LOG_ASSERT(nlohmann::json(copy) == nlohmann::json(stats));
+}
+
+void
+TestCache() {
+  auto g = MakeGraph();
+  KATANA_LOG_ASSERT(!katana::CachedGraphStats(*g));
+
+  auto res = katana::GetGraphStats(g.get());
+  KATANA_LOG_ASSERT(res);
+  auto cached = katana::CachedGraphStats(*g);
+  KATANA_LOG_ASSERT(cached);
+  KATANA_LOG_ASSERT(cached->num_components == 2);
+
+  // new properties are summarized on top of the cache
+  KATANA_LOG_ASSERT(g->AddNodeProperties(MakeProps("node-other", 6)));
+  res = katana::GetGraphStats(g.get());
+  KATANA_LOG_ASSERT(res);
+  KATANA_LOG_ASSERT(res.value().node_columns.size() == 2);
+  KATANA_LOG_ASSERT(katana::CachedGraphStats(*g)->node_columns.size() == 2);
+
+  // upserting a property only forgets its summary; the topology statistics
+  // are still cached
+  KATANA_LOG_ASSERT(g->UpsertNodeProperties(MakeProps("node-value", 6)));
+  cached = katana::CachedGraphStats(*g);
+  KATANA_LOG_ASSERT(cached);
+  KATANA_LOG_ASSERT(cached->num_components == 2);
+  KATANA_LOG_ASSERT(cached->approximate_diameter == 2);
+  KATANA_LOG_ASSERT(cached->out_degree.max == 3);
+  KATANA_LOG_ASSERT(cached->node_columns.count("node-value") == 0);
+  KATANA_LOG_ASSERT(cached->node_columns.count("node-other") == 1);
+  res = katana::GetGraphStats(g.get());
+  KATANA_LOG_ASSERT(res);
+  KATANA_LOG_ASSERT(res.value().node_columns.count("node-value") == 1);
+
+  // removing a property only forgets its summary
+  KATANA_LOG_ASSERT(g->RemoveNodeProperty("node-other"));
+  cached = katana::CachedGraphStats(*g);
+  KATANA_LOG_ASSERT(cached);
+  KATANA_LOG_ASSERT(cached->node_columns.size() == 1);
+  KATANA_LOG_ASSERT(cached->num_components == 2);
+
+  // replacing the topology drops the cache
+  KATANA_LOG_ASSERT(
+      g->SetTopology(MakeTopology({1, 2, 3, 3, 3, 3}, {1, 2, 0})));
+  KATANA_LOG_ASSERT(!katana::CachedGraphStats(*g));
+  res = katana::GetGraphStats(g.get());
+  KATANA_LOG_ASSERT(res);
+  KATANA_LOG_ASSERT(res.value().num_components == 4);
+  KATANA_LOG_ASSERT(res.value().num_edges == 3);
+}
+
+}  // namespace
+
+int
+main() {
+  katana::SharedMemSys sys;
+  katana::setActiveThreads(katana::GetThreadPool().getMaxThreads());
+
+  TestCompute();
+  TestCache();
+
+  return 0;
+}
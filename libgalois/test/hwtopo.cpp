@@ -21,21 +21,48 @@
 
 #include <iostream>
 
+#include "katana/Logging.h"
 #include "katana/gIO.h"
 
 void
 printMyTopo() {
   auto t = katana::getHWTopo();
-  std::cout << "T,C,P,N: " << t.machineTopoInfo.maxThreads << " "
+  std::cout << "T,C,P,N,L: " << t.machineTopoInfo.maxThreads << " "
             << t.machineTopoInfo.maxCores << " " << t.machineTopoInfo.maxSockets
-            << " " << t.machineTopoInfo.maxNumaNodes << "\n";
+            << " " << t.machineTopoInfo.maxNumaNodes << " "
+            << t.machineTopoInfo.maxCacheDomains << "\n";
   for (unsigned i = 0; i < t.machineTopoInfo.maxThreads; ++i) {
     auto& c = t.threadTopoInfo[i];
     std::cout << "tid: " << c.tid << " leader: " << c.socketLeader
               << " socket: " << c.socket << " numaNode: " << c.numaNode
               << " cumulativeMaxSocket: " << c.cumulativeMaxSocket
               << " osContext: " << c.osContext
-              << " osNumaNode: " << c.osNumaNode << "\n";
+              << " osNumaNode: " << c.osNumaNode << " core: " << c.core
+              << " cacheDomain: " << c.cacheDomain
+              << " cacheLeader: " << c.cacheLeader << "\n";
+  }
+}
+
+//! Check that cores and cache domains nest in sockets and that leaders are
+//! the first thread of their domain
+void
+checkMyTopo() {
+  auto t = katana::getHWTopo();
+  const auto& tti = t.threadTopoInfo;
+  for (unsigned i = 0; i < t.machineTopoInfo.maxThreads; ++i) {
+    const auto& c = tti[i];
+    KATANA_LOG_ASSERT(c.cacheDomain < t.machineTopoInfo.maxCacheDomains);
+    KATANA_LOG_ASSERT(c.cacheLeader <= i && c.socketLeader <= c.cacheLeader);
+    KATANA_LOG_ASSERT(tti[c.cacheLeader].cacheDomain == c.cacheDomain);
+    KATANA_LOG_ASSERT(tti[c.cacheLeader].cacheLeader == c.cacheLeader);
+    for (unsigned j = 0; j < i; ++j) {
+      if (tti[j].core == c.core || tti[j].cacheDomain == c.cacheDomain) {
+        KATANA_LOG_ASSERT(tti[j].socket == c.socket);
+      }
+      if (tti[j].core == c.core) {
+        KATANA_LOG_ASSERT(tti[j].cacheDomain == c.cacheDomain);
+      }
+    }
   }
 }
 
@@ -64,6 +91,7 @@ test(
 int
 main() {
   printMyTopo();
+  checkMyTopo();
 
   using namespace katana;
 
@@ -0,0 +1,93 @@
+#include <atomic>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "katana/Galois.h"
+#include "katana/IdDictionary.h"
+#include "katana/Logging.h"
+#include "katana/SharedMemSys.h"
+
+namespace {
+
+constexpr size_t kNumKeys = 100000;
+
+void
+TestInsert() {
+  // every key appears twice; the first (smaller) node must win
+  katana::IdDictionary<uint64_t> dict(kNumKeys);
+  katana::do_all(katana::iterate(size_t{0}, 2 * kNumKeys), [&](size_t n) {
+    dict.Insert((n % kNumKeys) * 7919, n);
+  });
+
+  for (size_t i = 0; i < kNumKeys; ++i) {
+    auto node = dict.Find(i * 7919);
+    KATANA_LOG_ASSERT(node);
+    KATANA_LOG_ASSERT(*node == i);
+  }
+  KATANA_LOG_ASSERT(!dict.Find(1));
+
+  std::atomic<size_t> count{0};
+  dict.ForEach([&](uint64_t key, uint32_t node) {
+    KATANA_LOG_ASSERT(key == node * UINT64_C(7919));
+    count.fetch_add(1);
+  });
+  KATANA_LOG_ASSERT(count == kNumKeys);
+}
+
+void
+TestGetOrAssign() {
+  std::vector<std::string> ids;
+  for (size_t i = 0; i < kNumKeys; ++i) {
+    ids.emplace_back("node-" + std::to_string(i));
+  }
+
+  katana::IdDictionary<std::string_view> dict(kNumKeys);
+  std::vector<uint32_t> nodes(2 * kNumKeys);
+  katana::do_all(katana::iterate(size_t{0}, 2 * kNumKeys), [&](size_t n) {
+    nodes[n] = dict.GetOrAssign(ids[n % kNumKeys]);
+  });
+  KATANA_LOG_ASSERT(dict.num_assigned() == kNumKeys);
+
+  std::vector<bool> seen(kNumKeys, false);
+  for (size_t i = 0; i < kNumKeys; ++i) {
+    KATANA_LOG_ASSERT(nodes[i] == nodes[i + kNumKeys]);
+    KATANA_LOG_ASSERT(nodes[i] < kNumKeys);
+    KATANA_LOG_ASSERT(!seen[nodes[i]]);
+    seen[nodes[i]] = true;
+    KATANA_LOG_ASSERT(dict.Find(ids[i]) == nodes[i]);
+  }
+  KATANA_LOG_ASSERT(!dict.Find("node-"));
+}
+
+void
+TestUserIdArray() {
+  katana::IdDictionary<uint64_t> dict(3);
+  dict.Insert(300, 0);
+  dict.Insert(100, 2);
+
+  auto res = katana::MakeUserIdArray(dict, 3);
+  KATANA_LOG_ASSERT(res);
+  auto ids = std::static_pointer_cast<arrow::UInt64Array>(
+      res.value()->chunk(0));
+  KATANA_LOG_ASSERT(ids->length() == 3);
+  KATANA_LOG_ASSERT(ids->Value(0) == 300);
+  KATANA_LOG_ASSERT(ids->IsNull(1));
+  KATANA_LOG_ASSERT(ids->Value(2) == 100);
+
+  KATANA_LOG_ASSERT(!katana::MakeUserIdArray(dict, 2));
+}
+
+}  // namespace
+
+int
+main() {
+  katana::SharedMemSys sys;
+  katana::setActiveThreads(katana::GetThreadPool().getMaxThreads());
+
+  TestInsert();
+  TestGetOrAssign();
+  TestUserIdArray();
+
+  return 0;
+}
@@ -0,0 +1,166 @@
+#include <unistd.h>
+
+#include <cstdlib>
+#include <filesystem>
+#include <future>
+#include <memory>
+#include <vector>
+
+#include "katana/Logging.h"
+#include "katana/SharedMemSys.h"
+#include "tsuba/file.h"
+
+namespace {
+
+// large enough to be read in several segments, and not block aligned
+constexpr uint64_t kFileSize = (UINT64_C(40) << 20) + 123;
+constexpr uint64_t kNumConcurrentReads = 8;
+
+uint8_t
+ByteAt(uint64_t i) {
+  return static_cast<uint8_t>(i ^ (i >> 8) ^ (i >> 16));
+}
+
+bool
+Matches(const uint8_t* data, uint64_t begin, uint64_t size) {
+  for (uint64_t i = 0; i < size; ++i) {
+    if (data[i] != ByteAt(begin + i)) {
+      return false;
+    }
+  }
+  return true;
+}
+
+/// A block aligned buffer, so that requests on it can use O_DIRECT
+struct AlignedBuffer {
+  std::unique_ptr<uint8_t, decltype(&std::free)> data;
+
+  explicit AlignedBuffer(uint64_t size)
+      : data(
+            static_cast<uint8_t*>(std::aligned_alloc(
+                tsuba::kBlockSize, tsuba::RoundUpToBlock(size))),
+            &std::free) {
+    KATANA_LOG_ASSERT(data);
+  }
+
+  uint8_t* get() const { return data.get(); }
+};
+
+std::string
+WriteTestFile(const std::string& dir) {
+  AlignedBuffer buf(kFileSize);
+  for (uint64_t i = 0; i < kFileSize; ++i) {
+    buf.get()[i] = ByteAt(i);
+  }
+  // the parent directory does not exist yet
+  std::string path = dir + "/data/file";
+  KATANA_LOG_ASSERT(tsuba::FileStore(path, buf.get(), kFileSize));
+
+  tsuba::StatBuf stat;
+  KATANA_LOG_ASSERT(tsuba::FileStat(path, &stat));
+  KATANA_LOG_ASSERT(stat.size == kFileSize);
+  return path;
+}
+
+void
+TestSegmentedReads(const std::string& path) {
+  std::vector<uint8_t> all(kFileSize);
+  KATANA_LOG_ASSERT(tsuba::FileGet(path, all.data(), 0, kFileSize));
+  KATANA_LOG_ASSERT(Matches(all.data(), 0, kFileSize));
+
+  // unaligned, so read without O_DIRECT
+  constexpr uint64_t kUnalignedBegin = 12345;
+  constexpr uint64_t kUnalignedSize = (UINT64_C(20) << 20) + 7;
+  std::vector<uint8_t> part(kUnalignedSize);
+  KATANA_LOG_ASSERT(
+      tsuba::FileGet(path, part.data(), kUnalignedBegin, kUnalignedSize));
+  KATANA_LOG_ASSERT(Matches(part.data(), kUnalignedBegin, kUnalignedSize));
+
+  // aligned, so read with O_DIRECT where the file system supports it
+  constexpr uint64_t kAlignedBegin = tsuba::kBlockSize;
+  constexpr uint64_t kAlignedSize = UINT64_C(32) << 20;
+  AlignedBuffer aligned(kAlignedSize);
+  KATANA_LOG_ASSERT(
+      tsuba::FileGet(path, aligned.get(), kAlignedBegin, kAlignedSize));
+  KATANA_LOG_ASSERT(Matches(aligned.get(), kAlignedBegin, kAlignedSize));
+
+  // a read may run into the unaligned end of the file
+  constexpr uint64_t kTail = 100;
+  AlignedBuffer tail(tsuba::kBlockSize);
+  KATANA_LOG_ASSERT(tsuba::FileGet(
+      path, tail.get(), kFileSize - kTail, tsuba::kBlockSize));
+  KATANA_LOG_ASSERT(Matches(tail.get(), kFileSize - kTail, kTail));
+}
+
+/// More segmented reads in flight than IoPool has threads
+void
+TestConcurrentReads(const std::string& path) {
+  constexpr uint64_t kSize = UINT64_C(24) << 20;
+  std::vector<std::vector<uint8_t>> bufs(kNumConcurrentReads);
+  std::vector<std::future<katana::Result<void>>> futures;
+  for (uint64_t i = 0; i < kNumConcurrentReads; ++i) {
+    bufs[i].resize(kSize);
+    futures.emplace_back(
+        tsuba::FileGetAsync(path, bufs[i].data(), i * 1000, kSize));
+  }
+  for (uint64_t i = 0; i < kNumConcurrentReads; ++i) {
+    KATANA_LOG_ASSERT(futures[i].get());
+    KATANA_LOG_ASSERT(Matches(bufs[i].data(), i * 1000, kSize));
+  }
+
+  AlignedBuffer buf(kSize);
+  for (uint64_t i = 0; i < kSize; ++i) {
+    buf.get()[i] = ByteAt(i);
+  }
+  std::string copy = path + ".async";
+  KATANA_LOG_ASSERT(tsuba::FileStoreAsync(copy, buf.get(), kSize).get());
+  std::vector<uint8_t> back(kSize);
+  KATANA_LOG_ASSERT(tsuba::FileGet(copy, back.data(), 0, kSize));
+  KATANA_LOG_ASSERT(Matches(back.data(), 0, kSize));
+}
+
+void
+TestRemoteCopy(const std::string& path) {
+  constexpr uint64_t kBegin = 1000;
+  constexpr uint64_t kSize = UINT64_C(10) << 20;
+  std::string copy = path + ".copy";
+  KATANA_LOG_ASSERT(tsuba::FileRemoteCopy(path, copy, kBegin, kSize));
+
+  tsuba::StatBuf stat;
+  KATANA_LOG_ASSERT(tsuba::FileStat(copy, &stat));
+  KATANA_LOG_ASSERT(stat.size == kSize);
+  std::vector<uint8_t> buf(kSize);
+  KATANA_LOG_ASSERT(tsuba::FileGet(copy, buf.data(), 0, kSize));
+  KATANA_LOG_ASSERT(Matches(buf.data(), kBegin, kSize));
+
+  // a slice running past the end of the source is cut short
+  constexpr uint64_t kTail = 500;
+  KATANA_LOG_ASSERT(
+      tsuba::FileRemoteCopy(path, copy, kFileSize - kTail, kSize));
+  KATANA_LOG_ASSERT(tsuba::FileStat(copy, &stat));
+  KATANA_LOG_ASSERT(stat.size == kTail);
+  KATANA_LOG_ASSERT(tsuba::FileGet(copy, buf.data(), 0, kTail));
+  KATANA_LOG_ASSERT(Matches(buf.data(), kFileSize - kTail, kTail));
+}
+
+}  // namespace
+
+int
+main() {
+  // read by LocalStorage when tsuba starts; a pool smaller than the number
+  // of concurrent reads checks that segmented reads cannot deadlock it
+  setenv("KATANA_LOCAL_STORAGE_DIRECT_IO", "1", 1);
+  setenv("KATANA_LOCAL_STORAGE_IO_THREADS", "2", 1);
+  katana::SharedMemSys sys;
+
+  std::string dir = std::filesystem::temp_directory_path() /
+                    fmt::format("local-storage-{}", getpid());
+  std::string path = WriteTestFile(dir);
+
+  TestSegmentedReads(path);
+  TestConcurrentReads(path);
+  TestRemoteCopy(path);
+
+  std::filesystem::remove_all(dir);
+  return 0;
+}
@@ -32,6 +32,23 @@ RandomNumber() {
 }
 unsigned iter = 1;
 
+enum WaitMode { kKind, kBurn, kAdaptive };
+
+void
+setWaitMode(WaitMode mode, unsigned th) {
+  switch (mode) {
+  case kKind:
+    katana::GetThreadPool().beKind();
+    break;
+  case kBurn:
+    katana::GetThreadPool().burnPower(th);
+    break;
+  case kAdaptive:
+    katana::GetThreadPool().beAdaptive();
+    break;
+  }
+}
+
 struct emp {
   template <typename T>
   void operator()(const T& t) const {
@@ -83,11 +100,10 @@ t_omp(std::vector<unsigned>& V, unsigned num, unsigned th) {
 
 unsigned
 t_doall(
-    bool burn, bool steal, std::vector<unsigned>& V, unsigned num,
+    WaitMode mode, bool steal, std::vector<unsigned>& V, unsigned num,
     unsigned th) {
   katana::setActiveThreads(th);  // katana::LL::getMaxThreads());
-  if (burn)
-    katana::GetThreadPool().burnPower(th);
+  setWaitMode(mode, th);
 
   katana::Timer t;
   t.start();
@@ -98,10 +114,10 @@ t_doall(
 }
 
 unsigned
-t_foreach(bool burn, std::vector<unsigned>& V, unsigned num, unsigned th) {
+t_foreach(
+    WaitMode mode, std::vector<unsigned>& V, unsigned num, unsigned th) {
   katana::setActiveThreads(th);
-  if (burn)
-    katana::GetThreadPool().burnPower(th);
+  setWaitMode(mode, th);
 
   katana::Timer t;
   t.start();
@@ -164,17 +180,27 @@ main(int argc, char** argv) {
   test("omp\t", M, 16, maxVector, t_omp);
   test(
       "doall N W", M, 16, maxVector,
-      std::bind(t_doall, false, false, _1, _2, _3));
+      std::bind(t_doall, kKind, false, _1, _2, _3));
   test(
       "doall N S", M, 16, maxVector,
-      std::bind(t_doall, false, true, _1, _2, _3));
-  test("foreach N", M, 16, maxVector, std::bind(t_foreach, false, _1, _2, _3));
+      std::bind(t_doall, kKind, true, _1, _2, _3));
+  test("foreach N", M, 16, maxVector, std::bind(t_foreach, kKind, _1, _2, _3));
   test(
       "doall B W", M, 16, maxVector,
-      std::bind(t_doall, true, false, _1, _2, _3));
+      std::bind(t_doall, kBurn, false, _1, _2, _3));
   test(
       "doall B S", M, 16, maxVector,
-      std::bind(t_doall, true, true, _1, _2, _3));
-  test("foreach B", M, 16, maxVector, std::bind(t_foreach, true, _1, _2, _3));
+      std::bind(t_doall, kBurn, true, _1, _2, _3));
+  test("foreach B", M, 16, maxVector, std::bind(t_foreach, kBurn, _1, _2, _3));
+  test(
+      "doall A W", M, 16, maxVector,
+      std::bind(t_doall, kAdaptive, false, _1, _2, _3));
+  test(
+      "doall A S", M, 16, maxVector,
+      std::bind(t_doall, kAdaptive, true, _1, _2, _3));
+  test(
+      "foreach A", M, 16, maxVector,
+      std::bind(t_foreach, kAdaptive, _1, _2, _3));
+  katana::GetThreadPool().beKind();
   return 0;
 }
@@ -0,0 +1,85 @@
+#include <cmath>
+#include <vector>
+
+#include "katana/Galois.h"
+#include "katana/Logging.h"
+#include "katana/MultiQueue.h"
+#include "katana/Reduction.h"
+#include "katana/SharedMemSys.h"
+#include "katana/ThreadPool.h"
+#include "katana/Threads.h"
+
+namespace {
+
+constexpr uint32_t kNumItems = 1 << 16;
+
+struct Item {
+  uint32_t id;
+  double priority;
+};
+
+struct Indexer {
+  double operator()(const Item& item) const { return item.priority; }
+};
+
+// Every pushed item, including items pushed by the loop itself, is processed
+// exactly once
+template <typename WL>
+void
+TestForEach() {
+  std::vector<std::atomic<uint32_t>> seen(kNumItems);
+  for (auto& s : seen) {
+    s = 0;
+  }
+
+  std::vector<Item> initial;
+  for (uint32_t i = 0; i < kNumItems; i += 2) {
+    initial.emplace_back(Item{i, std::sqrt(double(kNumItems - i))});
+  }
+
+  katana::for_each(
+      katana::iterate(initial),
+      [&](const Item& item, auto& ctx) {
+        seen[item.id] += 1;
+        if (item.id % 2 == 0 && item.id + 1 < kNumItems) {
+          ctx.push(Item{item.id + 1, -item.priority});
+        }
+      },
+      katana::wl<WL>(), katana::disable_conflict_detection());
+
+  for (uint32_t i = 0; i < kNumItems; ++i) {
+    KATANA_LOG_ASSERT(seen[i] == 1);
+  }
+}
+
+// On a single thread with batches of one, items come out in priority order
+void
+TestOrder() {
+  katana::MultiQueue<Indexer, Item, double, 1, 1, 1, false, false> wl;
+  for (uint32_t i = 0; i < 1000; ++i) {
+    wl.push(Item{i, double((i * 7919) % 1000)});
+  }
+  double last = -1;
+  for (uint32_t i = 0; i < 1000; ++i) {
+    auto item = wl.pop();
+    KATANA_LOG_ASSERT(item);
+    KATANA_LOG_ASSERT(item->priority >= last);
+    last = item->priority;
+  }
+  KATANA_LOG_ASSERT(!wl.pop());
+}
+
+}  // namespace
+
+int
+main() {
+  katana::SharedMemSys sys;
+  katana::setActiveThreads(katana::GetThreadPool().getMaxThreads());
+
+  TestOrder();
+  TestForEach<katana::MultiQueue<Indexer>>();
+  TestForEach<katana::MultiQueue<Indexer>::with_descending<true>::type>();
+  TestForEach<katana::MultiQueue<Indexer>::with_batch_size<1>::type>();
+
+  return 0;
+}
@@ -0,0 +1,115 @@
+#include <string>
+#include <vector>
+
+#include "katana/Galois.h"
+#include "katana/Logging.h"
+#include "katana/PerfCounters.h"
+#include "katana/Profile.h"
+#include "katana/Reduction.h"
+#include "katana/SharedMemSys.h"
+#include "katana/Statistics.h"
+#include "katana/ThreadPool.h"
+#include "katana/Threads.h"
+
+namespace {
+
+constexpr size_t kNumItems = 1 << 20;
+
+bool
+Contains(const std::string& s, const std::string& part) {
+  return s.find(part) != std::string::npos;
+}
+
+// Returns whether the calling thread can count instructions here, which
+// depends on the kernel settings and on whether the machine is virtualized
+bool
+TestSingleThread() {
+  katana::PerfCounters counters;
+  counters.start();
+  std::vector<size_t> v(kNumItems);
+  for (size_t i = 0; i < v.size(); ++i) {
+    v[i] = i * i;
+  }
+  counters.stop();
+  KATANA_LOG_ASSERT(v.back() == (kNumItems - 1) * (kNumItems - 1));
+
+  if (!counters.has(katana::PerfCounters::kInstructions)) {
+    return false;
+  }
+  KATANA_LOG_ASSERT(counters.get(katana::PerfCounters::kInstructions) > 0);
+
+  // nested counters read the same group without disturbing each other
+  uint64_t before = counters.get(katana::PerfCounters::kInstructions);
+  katana::PerfCounters inner;
+  counters.start();
+  inner.start();
+  inner.stop();
+  counters.stop();
+  KATANA_LOG_ASSERT(
+      counters.get(katana::PerfCounters::kInstructions) >=
+      before + inner.get(katana::PerfCounters::kInstructions));
+  return true;
+}
+
+void
+TestLoops(bool available) {
+  katana::ResetStats();
+
+  std::vector<size_t> v(kNumItems);
+  katana::do_all(
+      katana::iterate(size_t{0}, kNumItems), [&](size_t i) { v[i] = i; },
+      katana::steal(), katana::perf_counters(),
+      katana::loopname("PerfDoAll"));
+
+  katana::GAccumulator<size_t> count;
+  katana::for_each(
+      katana::iterate({size_t{1}}),
+      [&](size_t i, auto& ctx) {
+        count += 1;
+        if (2 * i < kNumItems) {
+          ctx.push(2 * i);
+          ctx.push(2 * i + 1);
+        }
+      },
+      katana::disable_conflict_detection(), katana::perf_counters(),
+      katana::loopname("PerfForEach"));
+  KATANA_LOG_ASSERT(count.reduce() == kNumItems - 1);
+
+  katana::profilePerf(
+      [&]() {
+        katana::do_all(
+            katana::iterate(size_t{0}, kNumItems), [&](size_t i) { v[i]++; });
+      },
+      "PerfProfile");
+
+  std::string stats = katana::GetStatsJson();
+  bool reported = available && katana::kStatsEnabled;
+  for (const char* loop : {"PerfDoAll", "PerfForEach", "PerfProfile"}) {
+    std::string key = std::string("\"region\": \"") + loop +
+                      "\", \"category\": \"Instructions\"";
+    KATANA_LOG_ASSERT(Contains(stats, key) == reported);
+  }
+
+  // the trait needs a loop name
+  katana::ResetStats();
+  katana::do_all(
+      katana::iterate(size_t{0}, kNumItems), [&](size_t i) { v[i]++; },
+      katana::perf_counters());
+  KATANA_LOG_ASSERT(!Contains(katana::GetStatsJson(), "Instructions"));
+}
+
+}  // namespace
+
+int
+main() {
+  katana::SharedMemSys sys;
+  katana::setActiveThreads(katana::GetThreadPool().getMaxThreads());
+
+  bool available = TestSingleThread();
+  if (!available) {
+    KATANA_LOG_WARN("hardware counters are not available; checking less");
+  }
+  TestLoops(available);
+
+  return 0;
+}
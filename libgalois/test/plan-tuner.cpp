@@ -0,0 +1,169 @@
+#include <unistd.h>
+
+#include <filesystem>
+#include <fstream>
+
+#include <arrow/api.h>
+
+#include "katana/ArrowInterchange.h"
+#include "katana/Logging.h"
+#include "katana/PropertyGraph.h"
+#include "katana/SharedMemSys.h"
+#include "katana/analytics/PlanTuner.h"
+
+namespace {
+
+constexpr uint32_t kNumNodes = 1000;
+
+/// A symmetric ring with a chord from every tenth node to node 0
+std::unique_ptr<katana::PropertyGraph>
+MakeGraph() {
+  std::vector<uint64_t> indices;
+  std::vector<uint32_t> dests;
+  for (uint32_t n = 0; n < kNumNodes; ++n) {
+    dests.emplace_back((n + 1) % kNumNodes);
+    dests.emplace_back((n + kNumNodes - 1) % kNumNodes);
+    if (n != 0 && n % 10 == 0) {
+      dests.emplace_back(0);
+    }
+    if (n == 0) {
+      for (uint32_t m = 10; m < kNumNodes; m += 10) {
+        dests.emplace_back(m);
+      }
+    }
+    indices.emplace_back(dests.size());
+  }
+
+  auto g = std::make_unique<katana::PropertyGraph>();
+  auto res = g->SetTopology(katana::GraphTopology{
+      .out_indices = std::static_pointer_cast<arrow::UInt64Array>(
+          katana::BuildArray(indices)),
+      .out_dests = std::static_pointer_cast<arrow::UInt32Array>(
+          katana::BuildArray(dests)),
+  });
+  KATANA_LOG_ASSERT(res);
+
+  katana::TableBuilder builder{dests.size()};
+  katana::ColumnOptions options;
+  options.name = "weight";
+  builder.AddColumn<uint32_t>(options);
+  KATANA_LOG_ASSERT(g->AddEdgeProperties(builder.Finish()));
+  return g;
+}
+
+void
+TestTune(const std::string& profile_path) {
+  auto g = MakeGraph();
+  katana::analytics::PlanTunerOptions options;
+  options.profile_path = profile_path;
+  options.num_sources = 2;
+
+  auto sssp = katana::analytics::TuneSsspPlan(g.get(), "weight", options);
+  KATANA_LOG_ASSERT(sssp);
+  auto bfs = katana::analytics::TuneBfsPlan(g.get(), options);
+  KATANA_LOG_ASSERT(bfs);
+  auto cc = katana::analytics::TuneConnectedComponentsPlan(g.get(), options);
+  KATANA_LOG_ASSERT(cc);
+  auto tc = katana::analytics::TuneTriangleCountPlan(g.get(), options);
+  KATANA_LOG_ASSERT(tc);
+  KATANA_LOG_ASSERT(std::filesystem::exists(profile_path));
+
+  // trials leave no properties behind
+  KATANA_LOG_ASSERT(g->node_schema()->num_fields() == 0);
+
+  // a fresh copy of the graph finds its plans in the profile
+  auto copy = MakeGraph();
+  auto sssp_again =
+      katana::analytics::TuneSsspPlan(copy.get(), "weight", options);
+  KATANA_LOG_ASSERT(sssp_again);
+  KATANA_LOG_ASSERT(
+      sssp_again.value().algorithm() == sssp.value().algorithm());
+  KATANA_LOG_ASSERT(sssp_again.value().delta() == sssp.value().delta());
+  KATANA_LOG_ASSERT(
+      sssp_again.value().edge_tile_size() == sssp.value().edge_tile_size());
+
+  auto bfs_again = katana::analytics::TuneBfsPlan(copy.get(), options);
+  KATANA_LOG_ASSERT(bfs_again);
+  KATANA_LOG_ASSERT(bfs_again.value().algorithm() == bfs.value().algorithm());
+  KATANA_LOG_ASSERT(
+      bfs_again.value().edge_tile_size() == bfs.value().edge_tile_size());
+
+  auto cc_again =
+      katana::analytics::TuneConnectedComponentsPlan(copy.get(), options);
+  KATANA_LOG_ASSERT(cc_again);
+  KATANA_LOG_ASSERT(cc_again.value().algorithm() == cc.value().algorithm());
+
+  auto tc_again =
+      katana::analytics::TuneTriangleCountPlan(copy.get(), options);
+  KATANA_LOG_ASSERT(tc_again);
+  KATANA_LOG_ASSERT(tc_again.value().algorithm() == tc.value().algorithm());
+  KATANA_LOG_ASSERT(tc_again.value().relabeling() == tc.value().relabeling());
+
+  // the tuned plans work
+  KATANA_LOG_ASSERT(katana::analytics::ConnectedComponents(
+      copy.get(), "component", cc_again.value()));
+  KATANA_LOG_ASSERT(katana::analytics::ConnectedComponentsAssertValid(
+      copy.get(), "component"));
+}
+
+/// With no time left, only the first candidate is timed
+void
+TestBudget(const std::string& profile_path) {
+  auto g = MakeGraph();
+  katana::analytics::PlanTunerOptions options;
+  options.profile_path = profile_path;
+  options.retune = true;
+  options.time_budget_seconds = 1e-9;
+
+  auto sssp = katana::analytics::TuneSsspPlan(g.get(), "weight", options);
+  KATANA_LOG_ASSERT(sssp);
+  KATANA_LOG_ASSERT(
+      sssp.value().algorithm() == katana::analytics::SsspPlan::kDeltaStep);
+  auto bfs = katana::analytics::TuneBfsPlan(g.get(), options);
+  KATANA_LOG_ASSERT(bfs);
+  KATANA_LOG_ASSERT(
+      bfs.value().algorithm() == katana::analytics::BfsPlan::kSynchronousTile);
+}
+
+/// Recording writes a uniquely named temporary file and renames it over the
+/// profile, so nothing but the profile is left in its directory
+void
+TestNoTemporaryFiles(const std::string& profile_path) {
+  auto parent = std::filesystem::path(profile_path).parent_path();
+  for (const auto& entry : std::filesystem::directory_iterator(parent)) {
+    KATANA_LOG_ASSERT(entry.path() == profile_path);
+  }
+}
+
+void
+TestMalformedProfile(const std::string& profile_path) {
+  {
+    std::ofstream out(profile_path);
+    out << "[1, 2";
+  }
+  auto g = MakeGraph();
+  katana::analytics::PlanTunerOptions options;
+  options.profile_path = profile_path;
+  KATANA_LOG_ASSERT(!katana::analytics::TuneBfsPlan(g.get(), options));
+}
+
+}  // namespace
+
+int
+main() {
+  katana::SharedMemSys sys;
+  katana::setActiveThreads(katana::GetThreadPool().getMaxThreads());
+
+  std::filesystem::path dir = std::filesystem::temp_directory_path() /
+                              fmt::format("plan-tuner-{}", getpid());
+  std::filesystem::create_directory(dir);
+  std::string profile_path = dir / "profile.json";
+
+  TestTune(profile_path);
+  TestBudget(profile_path);
+  TestNoTemporaryFiles(profile_path);
+  TestMalformedProfile(profile_path);
+
+  std::filesystem::remove_all(dir);
+  return 0;
+}
@@ -1,4 +1,5 @@
 #include <arrow/api.h>
+#include <arrow/util/compression.h>
 #include <boost/filesystem.hpp>
 
 #include "TestTypedPropertyGraph.h"
@@ -130,6 +131,236 @@ TestRoundTrip() {
   }
 }
 
+void
+TestArrowIpcRoundTrip() {
+  constexpr size_t test_length = 10;
+  using NodeType = double;
+  using EdgeType = int32_t;
+
+  auto g = std::make_unique<katana::PropertyGraph>();
+
+  auto add_node_result =
+      g->AddNodeProperties(MakeProps<NodeType>("node-ipc", test_length));
+  KATANA_LOG_ASSERT(add_node_result);
+  auto add_edge_result =
+      g->AddEdgeProperties(MakeProps<EdgeType>("edge-parquet", test_length));
+  KATANA_LOG_ASSERT(add_edge_result);
+  g->MarkAllPropertiesPersistent();
+
+  // only the node property is stored as Arrow IPC; the edge property stays
+  // Parquet
+  auto format_result = g->SetNodePropertiesFileFormat(
+      {"node-ipc"}, tsuba::PropertyFileFormat::kArrowIpc);
+  KATANA_LOG_ASSERT(format_result);
+  auto missing_result = g->SetEdgePropertiesFileFormat(
+      {"no-such-property"}, tsuba::PropertyFileFormat::kArrowIpc);
+  KATANA_LOG_ASSERT(!missing_result);
+
+  auto uri_res = katana::Uri::MakeRand("/tmp/propertyfilegraph");
+  KATANA_LOG_ASSERT(uri_res);
+  std::string rdg_dir(uri_res.value().path());  // path() because local
+
+  auto write_result = g->Write(rdg_dir, command_line);
+  if (!write_result) {
+    fs::remove_all(rdg_dir);
+    KATANA_LOG_FATAL("writing result: {}", write_result.error());
+  }
+
+  katana::Result<std::unique_ptr<katana::PropertyGraph>> make_result =
+      katana::PropertyGraph::Make(rdg_dir, tsuba::RDGLoadOptions());
+  fs::remove_all(rdg_dir);
+  if (!make_result) {
+    KATANA_LOG_FATAL("making result: {}", make_result.error());
+  }
+  std::unique_ptr<katana::PropertyGraph> g2 = std::move(make_result.value());
+
+  KATANA_LOG_ASSERT(
+      g2->node_schema()->field(0)->type()->Equals(arrow::float64()));
+  KATANA_LOG_ASSERT(
+      g2->edge_schema()->field(0)->type()->Equals(arrow::int32()));
+
+  std::shared_ptr<arrow::ChunkedArray> node_property = g2->GetNodeProperty(0);
+  std::shared_ptr<arrow::ChunkedArray> edge_property = g2->GetEdgeProperty(0);
+  KATANA_LOG_ASSERT(
+      static_cast<size_t>(node_property->length()) == test_length);
+  KATANA_LOG_ASSERT(node_property->num_chunks() == 1);
+
+  auto node_data =
+      std::static_pointer_cast<arrow::DoubleArray>(node_property->chunk(0));
+  auto edge_data =
+      std::static_pointer_cast<arrow::Int32Array>(edge_property->chunk(0));
+  // mapped buffers keep the alignment they were written with
+  KATANA_LOG_ASSERT(
+      reinterpret_cast<uintptr_t>(node_data->raw_values()) % 64 == 0);
+
+  for (size_t i = 0; i < test_length; ++i) {
+    KATANA_LOG_ASSERT(
+        !node_data->IsNull(i) && node_data->Value(i) == NodeType(i));
+    KATANA_LOG_ASSERT(
+        !edge_data->IsNull(i) && edge_data->Value(i) == EdgeType(i));
+  }
+}
+
+void
+TestParquetWriteOpts() {
+  constexpr size_t test_length = 1000;
+  using ValueType = int64_t;
+
+  std::shared_ptr<arrow::Table> node_props =
+      MakeProps<ValueType>("node-compressed", test_length);
+
+  auto opts = tsuba::ParquetWriter::WriteOpts::Defaults();
+  opts.max_row_group_length = 0;
+  KATANA_LOG_ASSERT(!tsuba::ParquetWriter::Make(node_props, opts));
+
+  auto g = std::make_unique<katana::PropertyGraph>();
+
+  auto add_node_result = g->AddNodeProperties(node_props);
+  KATANA_LOG_ASSERT(add_node_result);
+  auto add_edge_result =
+      g->AddEdgeProperties(MakeProps<ValueType>("edge-plain", test_length));
+  KATANA_LOG_ASSERT(add_edge_result);
+  g->MarkAllPropertiesPersistent();
+
+  auto uri_res = katana::Uri::MakeRand("/tmp/propertyfilegraph");
+  KATANA_LOG_ASSERT(uri_res);
+  std::string rdg_dir(uri_res.value().path());  // path() because local
+
+  // many small row groups so that the reader decodes them in parallel
+  opts.max_row_group_length = 64;
+  opts.enable_dictionary = false;
+  opts.enable_statistics = false;
+  for (auto codec : {arrow::Compression::ZSTD, arrow::Compression::SNAPPY}) {
+    if (arrow::util::Codec::IsAvailable(codec)) {
+      opts.column_compression["node-compressed"] = codec;
+      break;
+    }
+  }
+
+  auto write_result = g->Write(rdg_dir, command_line, opts);
+  if (!write_result) {
+    fs::remove_all(rdg_dir);
+    KATANA_LOG_FATAL("writing result: {}", write_result.error());
+  }
+
+  katana::Result<std::unique_ptr<katana::PropertyGraph>> make_result =
+      katana::PropertyGraph::Make(rdg_dir, tsuba::RDGLoadOptions());
+  fs::remove_all(rdg_dir);
+  if (!make_result) {
+    KATANA_LOG_FATAL("making result: {}", make_result.error());
+  }
+  std::unique_ptr<katana::PropertyGraph> g2 = std::move(make_result.value());
+
+  std::shared_ptr<arrow::ChunkedArray> node_property = g2->GetNodeProperty(0);
+  std::shared_ptr<arrow::ChunkedArray> edge_property = g2->GetEdgeProperty(0);
+  KATANA_LOG_ASSERT(
+      static_cast<size_t>(node_property->length()) == test_length);
+  KATANA_LOG_ASSERT(
+      static_cast<size_t>(edge_property->length()) == test_length);
+  // row groups are combined into a single chunk again on load
+  KATANA_LOG_ASSERT(node_property->num_chunks() == 1);
+  KATANA_LOG_ASSERT(edge_property->num_chunks() == 1);
+
+  auto node_data =
+      std::static_pointer_cast<arrow::Int64Array>(node_property->chunk(0));
+  auto edge_data =
+      std::static_pointer_cast<arrow::Int64Array>(edge_property->chunk(0));
+  for (size_t i = 0; i < test_length; ++i) {
+    KATANA_LOG_ASSERT(
+        !node_data->IsNull(i) && node_data->Value(i) == ValueType(i));
+    KATANA_LOG_ASSERT(
+        !edge_data->IsNull(i) && edge_data->Value(i) == ValueType(i));
+  }
+}
+
+void
+TestIncrementalCommit() {
+  constexpr size_t test_length = 1000;
+  constexpr size_t change_stride = 100;
+  using ValueType = int64_t;
+
+  auto g = std::make_unique<katana::PropertyGraph>();
+  auto add_node_result =
+      g->AddNodeProperties(MakeProps<ValueType>("node-delta", test_length));
+  KATANA_LOG_ASSERT(add_node_result);
+  g->MarkAllPropertiesPersistent();
+
+  auto uri_res = katana::Uri::MakeRand("/tmp/propertyfilegraph");
+  KATANA_LOG_ASSERT(uri_res);
+  std::string rdg_dir(uri_res.value().path());  // path() because local
+
+  auto write_result = g->Write(rdg_dir, command_line);
+  if (!write_result) {
+    fs::remove_all(rdg_dir);
+    KATANA_LOG_FATAL("writing result: {}", write_result.error());
+  }
+
+  auto count_deltas = [&rdg_dir]() {
+    size_t count = 0;
+    for (const auto& entry : fs::directory_iterator(rdg_dir)) {
+      if (entry.path().filename().string().find("node-delta_delta") == 0) {
+        ++count;
+      }
+    }
+    return count;
+  };
+
+  auto load = [&rdg_dir]() {
+    auto make_result =
+        katana::PropertyGraph::Make(rdg_dir, tsuba::RDGLoadOptions());
+    if (!make_result) {
+      fs::remove_all(rdg_dir);
+      KATANA_LOG_FATAL("making result: {}", make_result.error());
+    }
+    return std::move(make_result.value());
+  };
+
+  auto expected = [](size_t i) {
+    return i % change_stride == 0 ? -ValueType(i) - 1 : ValueType(i);
+  };
+
+  auto check = [&](katana::PropertyGraph* pg) {
+    std::shared_ptr<arrow::ChunkedArray> property = pg->GetNodeProperty(0);
+    KATANA_LOG_ASSERT(static_cast<size_t>(property->length()) == test_length);
+    KATANA_LOG_ASSERT(property->num_chunks() == 1);
+    auto data = std::static_pointer_cast<arrow::Int64Array>(property->chunk(0));
+    for (size_t i = 0; i < test_length; ++i) {
+      KATANA_LOG_ASSERT(!data->IsNull(i) && data->Value(i) == expected(i));
+    }
+  };
+
+  // change every change_stride-th row; the commit only writes those rows
+  std::unique_ptr<katana::PropertyGraph> g2 = load();
+  arrow::Int64Builder builder;
+  for (size_t i = 0; i < test_length; ++i) {
+    KATANA_LOG_ASSERT(builder.Append(expected(i)).ok());
+  }
+  std::shared_ptr<arrow::Array> changed;
+  KATANA_LOG_ASSERT(builder.Finish(&changed).ok());
+  auto upsert_result = g2->UpsertNodeProperties(arrow::Table::Make(
+      arrow::schema({arrow::field("node-delta", arrow::int64())}), {changed}));
+  KATANA_LOG_ASSERT(upsert_result);
+
+  if (auto res = g2->Commit(command_line); !res) {
+    fs::remove_all(rdg_dir);
+    KATANA_LOG_FATAL("committing delta: {}", res.error());
+  }
+  KATANA_LOG_ASSERT(count_deltas() == 1);
+
+  std::unique_ptr<katana::PropertyGraph> g3 = load();
+  check(g3.get());
+
+  // compaction folds the delta back into a single file
+  g3->CompactProperties();
+  if (auto res = g3->Commit(command_line); !res) {
+    fs::remove_all(rdg_dir);
+    KATANA_LOG_FATAL("committing compaction: {}", res.error());
+  }
+  std::unique_ptr<katana::PropertyGraph> g4 = load();
+  fs::remove_all(rdg_dir);
+  check(g4.get());
+}
+
 void
 TestGarbageMetadata() {
   auto uri_res = katana::Uri::MakeRand("/tmp/propertyfilegraph");
@@ -255,6 +486,9 @@ main(int argc, char** argv) {
   command_line = cmdout.str();
 
   TestRoundTrip();
+  TestArrowIpcRoundTrip();
+  TestParquetWriteOpts();
+  TestIncrementalCommit();
   TestGarbageMetadata();
   TestSimplePGs();
   TestTopologyAccess();
@@ -0,0 +1,152 @@
+#include <cstring>
+#include <sstream>
+#include <string>
+
+#include "katana/Galois.h"
+#include "katana/Logging.h"
+#include "katana/Reduction.h"
+#include "katana/SharedMemSys.h"
+#include "katana/Statistics.h"
+#include "katana/ThreadPool.h"
+#include "katana/Threads.h"
+
+namespace {
+
+constexpr uint64_t kNumItems = 100000;
+
+bool
+Contains(const std::string& s, const std::string& part) {
+  return s.find(part) != std::string::npos;
+}
+
+size_t
+CountOf(const std::string& s, const std::string& part) {
+  size_t count = 0;
+  for (size_t pos = s.find(part); pos != std::string::npos;
+       pos = s.find(part, pos + part.size())) {
+    ++count;
+  }
+  return count;
+}
+
+void
+RunLoops() {
+  katana::GAccumulator<uint64_t> sum;
+  katana::do_all(
+      katana::iterate(uint64_t{0}, kNumItems), [&](uint64_t i) { sum += i; },
+      katana::steal(), katana::loopname("StatsDoAll"));
+  KATANA_LOG_ASSERT(sum.reduce() == kNumItems * (kNumItems - 1) / 2);
+
+  katana::GAccumulator<uint64_t> count;
+  katana::for_each(
+      katana::iterate({uint64_t{1}}),
+      [&](uint64_t i, auto& ctx) {
+        count += 1;
+        if (2 * i < kNumItems) {
+          ctx.push(2 * i);
+          ctx.push(2 * i + 1);
+        }
+      },
+      katana::disable_conflict_detection(), katana::loopname("StatsForEach"));
+  KATANA_LOG_ASSERT(count.reduce() == kNumItems - 1);
+}
+
+void
+TestExport() {
+  // without tracing, loops only record statistics
+  katana::ResetStats();
+  RunLoops();
+  KATANA_LOG_ASSERT(!Contains(katana::GetTraceJson(), "StatsDoAll"));
+
+  katana::SetTracing(true);
+  katana::ResetStats();
+  katana::ReportParam("StatsTest", "Quote", "say \"hi\"");
+  katana::ReportStatSingle("StatsTest", "Ratio", 0.5);
+  RunLoops();
+
+  std::string stats = katana::GetStatsJson();
+  std::string trace = katana::GetTraceJson();
+
+  if constexpr (!katana::kStatsEnabled) {
+    KATANA_LOG_ASSERT(!Contains(stats, "StatsDoAll"));
+    KATANA_LOG_ASSERT(!Contains(trace, "StatsDoAll"));
+    return;
+  }
+
+  KATANA_LOG_ASSERT(Contains(
+      stats,
+      "\"region\": \"StatsDoAll\", \"category\": \"Iterations\", "
+      "\"total_type\": \"TSUM\", \"total\": " +
+          std::to_string(kNumItems)));
+  KATANA_LOG_ASSERT(Contains(
+      stats,
+      "\"region\": \"StatsForEach\", \"category\": \"Iterations\", "
+      "\"total_type\": \"TSUM\", \"total\": " +
+          std::to_string(kNumItems - 1)));
+  KATANA_LOG_ASSERT(Contains(stats, "\"total\": 0.5"));
+  KATANA_LOG_ASSERT(Contains(stats, "\"total\": \"say \\\"hi\\\"\""));
+
+  // every thread that ran a loop has a span for it, and one for the time it
+  // spent stealing
+  KATANA_LOG_ASSERT(Contains(trace, "\"traceEvents\""));
+  KATANA_LOG_ASSERT(Contains(trace, "\"name\": \"StatsDoAll Execute\""));
+  KATANA_LOG_ASSERT(Contains(trace, "\"name\": \"StatsDoAll Steal\""));
+  KATANA_LOG_ASSERT(
+      CountOf(trace, "\"name\": \"StatsDoAll Steal\"") <=
+      katana::getActiveThreads());
+  KATANA_LOG_ASSERT(Contains(trace, "\"name\": \"StatsForEach Execute\""));
+  KATANA_LOG_ASSERT(Contains(trace, "\"name\": \"StatsForEach Init\""));
+  KATANA_LOG_ASSERT(Contains(trace, "\"name\": \"StatsForEach Barrier\""));
+  KATANA_LOG_ASSERT(Contains(trace, "\"dropped_events\": 0"));
+
+  // exporting does not consume the statistics
+  KATANA_LOG_ASSERT(katana::GetStatsJson() == stats);
+
+  // the statistics of the next call start from scratch
+  katana::ResetStats();
+  stats = katana::GetStatsJson();
+  trace = katana::GetTraceJson();
+  KATANA_LOG_ASSERT(!Contains(stats, "StatsDoAll"));
+  KATANA_LOG_ASSERT(!Contains(trace, "StatsDoAll"));
+
+  RunLoops();
+  KATANA_LOG_ASSERT(Contains(katana::GetStatsJson(), "StatsForEach"));
+
+  // loops without a name are not recorded
+  katana::ResetStats();
+  katana::do_all(katana::iterate(uint64_t{0}, kNumItems), [](uint64_t) {});
+  KATANA_LOG_ASSERT(!Contains(katana::GetTraceJson(), "Execute"));
+}
+
+/// Loop names may be temporaries, e.g., built with std::to_string each
+/// round, whose buffer is reused with different text
+void
+TestReusedNameBuffer() {
+  katana::SetTracing(true);
+  katana::ResetStats();
+  char name[32];
+  uint64_t now = katana::TraceNow();
+  std::strcpy(name, "Round_0");
+  katana::ReportTraceEvent(name, "Sync", now, now + 1);
+  std::strcpy(name, "Round_1");
+  katana::ReportTraceEvent(name, "Sync", now + 1, now + 2);
+
+  if constexpr (katana::kStatsEnabled) {
+    std::string trace = katana::GetTraceJson();
+    KATANA_LOG_ASSERT(Contains(trace, "\"name\": \"Round_0 Sync\""));
+    KATANA_LOG_ASSERT(Contains(trace, "\"name\": \"Round_1 Sync\""));
+  }
+}
+
+}  // namespace
+
+int
+main() {
+  katana::SharedMemSys sys;
+  katana::setActiveThreads(katana::GetThreadPool().getMaxThreads());
+
+  TestExport();
+  TestReusedNameBuffer();
+
+  return 0;
+}
@@ -0,0 +1,205 @@
+#include <arrow/api.h>
+
+#include "katana/ArrowInterchange.h"
+#include "katana/Logging.h"
+#include "katana/PropertyGraph.h"
+#include "katana/SharedMemSys.h"
+#include "katana/ThreadPool.h"
+#include "katana/Threads.h"
+#include "katana/analytics/subgraph_extraction/subgraph_extraction.h"
+
+namespace {
+
+using katana::analytics::SubGraphExtractionProperties;
+
+constexpr uint32_t kNumNodes = 100;
+const char* const kLabels[] = {"a", "b", "c", "d"};
+
+/// Every node n has the edges n -> n + 1 and n -> n + 2 (mod kNumNodes), in
+/// that order, so edge 2n goes to n + 1 and edge 2n + 1 to n + 2. Node n has
+/// value 10n, name n and the dictionary encoded label kLabels[n % 4]; edge e
+/// has weight e.
+std::unique_ptr<katana::PropertyGraph>
+MakeGraph() {
+  std::vector<uint64_t> indices;
+  std::vector<uint32_t> dests;
+  std::vector<uint64_t> values;
+  std::vector<int32_t> label_indices;
+  arrow::StringBuilder names;
+  for (uint32_t n = 0; n < kNumNodes; ++n) {
+    dests.emplace_back((n + 1) % kNumNodes);
+    dests.emplace_back((n + 2) % kNumNodes);
+    indices.emplace_back(dests.size());
+    values.emplace_back(10 * n);
+    label_indices.emplace_back(n % 4);
+    KATANA_LOG_ASSERT(names.Append(std::to_string(n)).ok());
+  }
+  std::vector<uint32_t> weights(dests.size());
+  for (uint32_t e = 0; e < weights.size(); ++e) {
+    weights[e] = e;
+  }
+
+  auto g = std::make_unique<katana::PropertyGraph>();
+  auto res = g->SetTopology(katana::GraphTopology{
+      .out_indices = std::static_pointer_cast<arrow::UInt64Array>(
+          katana::BuildArray(indices)),
+      .out_dests = std::static_pointer_cast<arrow::UInt32Array>(
+          katana::BuildArray(dests)),
+  });
+  KATANA_LOG_ASSERT(res);
+
+  arrow::StringBuilder dictionary;
+  KATANA_LOG_ASSERT(dictionary.AppendValues({"a", "b", "c", "d"}).ok());
+  auto label_type = arrow::dictionary(arrow::int32(), arrow::utf8());
+  auto labels = arrow::DictionaryArray::FromArrays(
+      label_type, katana::BuildArray(label_indices),
+      dictionary.Finish().ValueOrDie());
+  KATANA_LOG_ASSERT(labels.ok());
+
+  auto node_table = arrow::Table::Make(
+      arrow::schema({
+          arrow::field("value", arrow::uint64()),
+          arrow::field("name", arrow::utf8()),
+          arrow::field("label", label_type),
+      }),
+      {katana::BuildArray(values), names.Finish().ValueOrDie(),
+       labels.ValueOrDie()});
+  KATANA_LOG_ASSERT(g->AddNodeProperties(node_table));
+
+  auto edge_table = arrow::Table::Make(
+      arrow::schema({arrow::field("weight", arrow::uint32())}),
+      {katana::BuildArray(weights)});
+  KATANA_LOG_ASSERT(g->AddEdgeProperties(edge_table));
+  return g;
+}
+
+std::string
+LabelOf(katana::PropertyGraph* g, uint32_t n) {
+  auto labels = std::static_pointer_cast<arrow::DictionaryArray>(
+      g->GetNodeProperty("label")->chunk(0));
+  auto dictionary =
+      std::static_pointer_cast<arrow::StringArray>(labels->dictionary());
+  return dictionary->GetString(labels->GetValueIndex(n));
+}
+
+/// Keep the even nodes with all properties and both id mappings
+void
+TestNodePredicate() {
+  auto g = MakeGraph();
+  SubGraphExtractionProperties props = SubGraphExtractionProperties::All();
+  props.original_id_property = "original_id";
+  props.subgraph_id_property = "subgraph_id";
+
+  auto res = katana::analytics::SubGraphExtractionByNodePredicate(
+      g.get(), [](uint32_t n) { return n % 2 == 0; }, props);
+  KATANA_LOG_ASSERT(res);
+  std::unique_ptr<katana::PropertyGraph> sub = std::move(res.value());
+
+  // only the n -> n + 2 edges connect two even nodes
+  KATANA_LOG_ASSERT(sub->num_nodes() == kNumNodes / 2);
+  KATANA_LOG_ASSERT(sub->num_edges() == kNumNodes / 2);
+
+  auto original_id = sub->GetNodePropertyTyped<uint32_t>("original_id").value();
+  auto value = sub->GetNodePropertyTyped<uint64_t>("value").value();
+  auto name = std::static_pointer_cast<arrow::StringArray>(
+      sub->GetNodeProperty("name")->chunk(0));
+  auto weight = sub->GetEdgePropertyTyped<uint32_t>("weight").value();
+  KATANA_LOG_ASSERT(!sub->GetNodeProperty("subgraph_id"));
+
+  for (uint32_t i = 0; i < sub->num_nodes(); ++i) {
+    uint32_t n = 2 * i;
+    KATANA_LOG_ASSERT(original_id->Value(i) == n);
+    KATANA_LOG_ASSERT(value->Value(i) == 10 * n);
+    KATANA_LOG_ASSERT(name->GetString(i) == std::to_string(n));
+    KATANA_LOG_ASSERT(LabelOf(sub.get(), i) == kLabels[n % 4]);
+
+    auto edges = sub->edges(i);
+    KATANA_LOG_ASSERT(std::distance(edges.begin(), edges.end()) == 1);
+    auto e = *edges.begin();
+    KATANA_LOG_ASSERT(
+        sub->topology().edge_dest(e) == (i + 1) % (kNumNodes / 2));
+    KATANA_LOG_ASSERT(weight->Value(e) == 2 * n + 1);
+  }
+
+  auto subgraph_id = g->GetNodePropertyTyped<uint32_t>("subgraph_id").value();
+  for (uint32_t n = 0; n < kNumNodes; ++n) {
+    KATANA_LOG_ASSERT(
+        subgraph_id->Value(n) ==
+        (n % 2 == 0 ? n / 2 : SubGraphExtractionProperties::kNotInSubGraph));
+  }
+}
+
+/// Keep the n -> n + 1 edges of the first ten nodes, and their endpoints
+void
+TestEdgePredicate() {
+  auto g = MakeGraph();
+  SubGraphExtractionProperties props;
+  props.edge_properties = {"weight"};
+  props.original_id_property = "original_id";
+
+  auto res = katana::analytics::SubGraphExtractionByEdgePredicate(
+      g.get(), [](uint64_t e) { return e % 2 == 0 && e < 20; }, props);
+  KATANA_LOG_ASSERT(res);
+  std::unique_ptr<katana::PropertyGraph> sub = std::move(res.value());
+
+  KATANA_LOG_ASSERT(sub->num_nodes() == 11);
+  KATANA_LOG_ASSERT(sub->num_edges() == 10);
+  KATANA_LOG_ASSERT(!sub->GetNodeProperty("value"));
+
+  auto original_id = sub->GetNodePropertyTyped<uint32_t>("original_id").value();
+  auto weight = sub->GetEdgePropertyTyped<uint32_t>("weight").value();
+  for (uint32_t i = 0; i < sub->num_nodes(); ++i) {
+    KATANA_LOG_ASSERT(original_id->Value(i) == i);
+    auto edges = sub->edges(i);
+    if (i == 10) {
+      KATANA_LOG_ASSERT(edges.begin() == edges.end());
+      continue;
+    }
+    KATANA_LOG_ASSERT(std::distance(edges.begin(), edges.end()) == 1);
+    auto e = *edges.begin();
+    KATANA_LOG_ASSERT(sub->topology().edge_dest(e) == i + 1);
+    KATANA_LOG_ASSERT(weight->Value(e) == 2 * i);
+  }
+}
+
+/// Copy only the requested properties of a node set
+void
+TestSelectedProperties() {
+  auto g = MakeGraph();
+  SubGraphExtractionProperties props;
+  props.node_properties = {"label"};
+
+  auto res = katana::analytics::SubGraphExtraction(
+      g.get(), {7, 3, 5}, props,
+      katana::analytics::SubGraphExtractionPlan::NodeSet());
+  KATANA_LOG_ASSERT(res);
+  std::unique_ptr<katana::PropertyGraph> sub = std::move(res.value());
+
+  KATANA_LOG_ASSERT(sub->num_nodes() == 3);
+  // 3 -> 5 and 5 -> 7
+  KATANA_LOG_ASSERT(sub->num_edges() == 2);
+  KATANA_LOG_ASSERT(sub->GetNodePropertyNames().size() == 1);
+  KATANA_LOG_ASSERT(sub->GetEdgePropertyNames().empty());
+  KATANA_LOG_ASSERT(LabelOf(sub.get(), 0) == "d");
+  KATANA_LOG_ASSERT(LabelOf(sub.get(), 1) == "b");
+  KATANA_LOG_ASSERT(LabelOf(sub.get(), 2) == "d");
+
+  props.node_properties = {"missing"};
+  KATANA_LOG_ASSERT(!katana::analytics::SubGraphExtraction(
+      g.get(), {7, 3, 5}, props,
+      katana::analytics::SubGraphExtractionPlan::NodeSet()));
+}
+
+}  // namespace
+
+int
+main() {
+  katana::SharedMemSys sys;
+  katana::setActiveThreads(katana::GetThreadPool().getMaxThreads());
+
+  TestNodePredicate();
+  TestEdgePredicate();
+  TestSelectedProperties();
+
+  return 0;
+}
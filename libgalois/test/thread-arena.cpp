@@ -0,0 +1,145 @@
+#include <cstdint>
+#include <string>
+
+#include "katana/Galois.h"
+#include "katana/Logging.h"
+#include "katana/PageAlloc.h"
+#include "katana/Reduction.h"
+#include "katana/SharedMemSys.h"
+#include "katana/Statistics.h"
+#include "katana/ThreadArena.h"
+#include "katana/ThreadPool.h"
+#include "katana/Threads.h"
+
+namespace {
+
+constexpr uint64_t kNumItems = 10000;
+
+void
+TestArena() {
+  katana::ThreadArena& arena = katana::ThreadArena::Local();
+  arena.Reset();
+  arena.ResetHighWater();
+  KATANA_LOG_ASSERT(arena.bytes_in_use() == 0);
+
+  void* a = arena.Allocate(3, 1);
+  void* b = arena.Allocate(8, 64);
+  KATANA_LOG_ASSERT(reinterpret_cast<uintptr_t>(b) % 64 == 0);
+  KATANA_LOG_ASSERT(static_cast<char*>(b) > static_cast<char*>(a));
+
+  katana::ThreadArena::Mark mark = arena.GetMark();
+  size_t in_use = arena.bytes_in_use();
+
+  // fill more than one page and allocate something larger than a page
+  for (size_t i = 0; i < 2 * katana::allocSize() / 4096; ++i) {
+    arena.Allocate(4096);
+  }
+  arena.Allocate(3 * katana::allocSize());
+  KATANA_LOG_ASSERT(arena.bytes_in_use() > 5 * katana::allocSize());
+
+  arena.Rewind(mark);
+  KATANA_LOG_ASSERT(arena.bytes_in_use() == in_use);
+  KATANA_LOG_ASSERT(arena.high_water() > 5 * katana::allocSize());
+
+  // rewinding reuses the memory
+  KATANA_LOG_ASSERT(arena.Allocate(8, 64) == static_cast<char*>(b) + 64);
+
+  KATANA_LOG_ASSERT(arena.ResetHighWater() > 5 * katana::allocSize());
+  arena.Reset();
+  KATANA_LOG_ASSERT(arena.bytes_in_use() == 0);
+}
+
+void
+TestContainers() {
+  katana::ThreadArena& arena = katana::ThreadArena::Local();
+  katana::ThreadArena::Mark mark = arena.GetMark();
+  {
+    katana::arena::Vector<uint64_t> v;
+    katana::arena::Map<uint64_t, uint64_t> m;
+    katana::arena::UnorderedMap<uint64_t, std::string> u;
+    for (uint64_t i = 0; i < kNumItems; ++i) {
+      v.push_back(i);
+      m[i % 100] += i;
+      u[i % 10] = std::to_string(i);
+    }
+    KATANA_LOG_ASSERT(v.size() == kNumItems);
+    KATANA_LOG_ASSERT(m.size() == 100);
+    KATANA_LOG_ASSERT(u[9] == std::to_string(kNumItems - 1));
+    KATANA_LOG_ASSERT(v.get_allocator().arena() == &arena);
+    KATANA_LOG_ASSERT(arena.bytes_in_use() > kNumItems * sizeof(uint64_t));
+  }
+  arena.Rewind(mark);
+}
+
+void
+TestLoops() {
+  katana::ResetStats();
+
+  // each iteration starts from the memory the thread had before the loop
+  katana::PerThreadStorage<size_t> before;
+  katana::on_each([&](unsigned, unsigned) {
+    *before.getLocal() = katana::ThreadArena::Local().bytes_in_use();
+  });
+
+  katana::GAccumulator<uint64_t> sum;
+  katana::do_all(
+      katana::iterate(uint64_t{0}, kNumItems),
+      [&](uint64_t i) {
+        KATANA_LOG_ASSERT(
+            katana::ThreadArena::Local().bytes_in_use() == *before.getLocal());
+        katana::arena::Vector<uint64_t> v(i % 100 + 1, i);
+        sum += v.back();
+      },
+      katana::steal(), katana::thread_arena(),
+      katana::loopname("ArenaDoAll"));
+  KATANA_LOG_ASSERT(sum.reduce() == kNumItems * (kNumItems - 1) / 2);
+
+  katana::GAccumulator<uint64_t> count;
+  katana::for_each(
+      katana::iterate({uint64_t{1}}),
+      [&](uint64_t i, auto& ctx) {
+        KATANA_LOG_ASSERT(
+            katana::ThreadArena::Local().bytes_in_use() == *before.getLocal());
+        katana::arena::Set<uint64_t> s;
+        for (uint64_t j = 0; j < i % 50; ++j) {
+          s.insert(j);
+        }
+        count += 1;
+        if (2 * i < kNumItems) {
+          ctx.push(2 * i);
+          ctx.push(2 * i + 1);
+        }
+      },
+      katana::disable_conflict_detection(), katana::thread_arena(),
+      katana::loopname("ArenaForEach"));
+  KATANA_LOG_ASSERT(count.reduce() == kNumItems - 1);
+
+  katana::on_each([&](unsigned, unsigned) {
+    KATANA_LOG_ASSERT(
+        katana::ThreadArena::Local().bytes_in_use() == *before.getLocal());
+  });
+
+  if constexpr (katana::kStatsEnabled) {
+    std::string stats = katana::GetStatsJson();
+    KATANA_LOG_ASSERT(
+        stats.find("\"region\": \"ArenaDoAll\", \"category\": "
+                   "\"ArenaHighWaterBytes\"") != std::string::npos);
+    KATANA_LOG_ASSERT(
+        stats.find("\"region\": \"ArenaForEach\", \"category\": "
+                   "\"ArenaHighWaterBytes\"") != std::string::npos);
+  }
+}
+
+}  // namespace
+
+int
+main() {
+  katana::SharedMemSys sys;
+  katana::setActiveThreads(katana::GetThreadPool().getMaxThreads());
+
+  TestArena();
+  TestContainers();
+  TestLoops();
+
+  return 0;
+}
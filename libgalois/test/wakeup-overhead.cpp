@@ -19,7 +19,9 @@
 
 #include <chrono>
 #include <cmath>
+#include <ctime>
 #include <iostream>
+#include <thread>
 #include <vector>
 
 #include <boost/iterator/counting_iterator.hpp>
@@ -41,6 +43,16 @@ static cll::opt<int> trials(
     "trials", cll::desc("number of trials"), cll::init(1));
 static cll::opt<unsigned> threads(
     "threads", cll::desc("number of threads"), cll::init(2));
+static cll::opt<int> gap(
+    "gap", cll::desc("microseconds the master sleeps between rounds"),
+    cll::init(0));
+
+void
+sleepBetweenRounds() {
+  if (gap > 0) {
+    std::this_thread::sleep_for(std::chrono::microseconds(gap));
+  }
+}
 
 void
 runDoAllBurn(int num) {
@@ -50,6 +62,21 @@ runDoAllBurn(int num) {
     katana::do_all(katana::iterate(0, num), [&](int) {
       asm volatile("" ::: "memory");
     });
+    sleepBetweenRounds();
+  }
+
+  katana::GetThreadPool().beKind();
+}
+
+void
+runDoAllAdaptive(int num) {
+  katana::GetThreadPool().beAdaptive();
+
+  for (int r = 0; r < rounds; ++r) {
+    katana::do_all(katana::iterate(0, num), [&](int) {
+      asm volatile("" ::: "memory");
+    });
+    sleepBetweenRounds();
   }
 
   katana::GetThreadPool().beKind();
@@ -61,6 +88,7 @@ runDoAll(int num) {
     katana::do_all(katana::iterate(0, num), [&](int) {
       asm volatile("" ::: "memory");
     });
+    sleepBetweenRounds();
   }
 }
 
@@ -77,17 +105,25 @@ runExplicitThread(int num) {
         asm volatile("" ::: "memory");
       }
       barrier.Wait();
+      if (tid == 0) {
+        sleepBetweenRounds();
+      }
     }
   });
 }
 
 void
 run(std::function<void(int)> fn, std::string name) {
+  // CPU time of the whole process shows what waiting threads burn during
+  // gaps between rounds
+  std::clock_t cpu_start = std::clock();
   katana::Timer t;
   t.start();
   fn(size);
   t.stop();
-  std::cout << name << " time: " << t.get() << "\n";
+  double cpu_ms = 1000.0 * (std::clock() - cpu_start) / CLOCKS_PER_SEC;
+  std::cout << name << " time: " << t.get() << " cpu time: " << cpu_ms
+            << "\n";
 }
 
 std::atomic<int> EXIT;
@@ -111,13 +147,15 @@ main(int argc, char* argv[]) {
   for (int t = 0; t < trials; ++t) {
     run(runDoAll, "DoAll");
     run(runDoAllBurn, "DoAllBurn");
+    run(runDoAllAdaptive, "DoAllAdaptive");
     run(runExplicitThread, "ExplicitThread");
   }
   EXIT = 1;
 
   std::cout << "threads: " << katana::getActiveThreads() << " usable threads: "
             << katana::GetThreadPool().getMaxUsableThreads()
-            << " rounds: " << rounds << " size: " << size << "\n";
+            << " rounds: " << rounds << " size: " << size << " gap: " << gap
+            << "\n";
 
   return 0;
 }
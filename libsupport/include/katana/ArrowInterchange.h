@@ -18,6 +18,17 @@
 
 namespace katana {
 
+/// The memory pool that katana allocates arrow data from when loading graphs
+/// and constructing properties. It is arrow::default_memory_pool() unless
+/// replaced by SetDefaultArrowMemoryPool; katana::SharedMemSys installs a
+/// pool backed by huge pages.
+KATANA_EXPORT arrow::MemoryPool* DefaultArrowMemoryPool();
+
+/// Replace the pool returned by DefaultArrowMemoryPool. Passing nullptr
+/// restores arrow::default_memory_pool(). The pool must outlive every buffer
+/// allocated from it.
+KATANA_EXPORT void SetDefaultArrowMemoryPool(arrow::MemoryPool* pool);
+
 /// Perform a safe cast from \param gen_array to \tparam ArrowArrayType
 /// calls the array's `View()` member first to make sure cast is safe.
 template <typename ArrowArrayType>
@@ -101,7 +112,7 @@ katana::Result<std::shared_ptr<arrow::ChunkedArray>>
 MarshalVector(const std::vector<T>& source) {
   using Row = std::tuple<T>;
 
-  auto* pool = arrow::default_memory_pool();
+  auto* pool = DefaultArrowMemoryPool();
 
   const std::vector<Row>* source_view = TupleView(&source);
 
@@ -120,7 +131,7 @@ katana::Result<std::shared_ptr<arrow::Table>>
 VectorToArrowTable(const std::string& name, const std::vector<T>& source) {
   using Row = std::tuple<T>;
 
-  auto* pool = arrow::default_memory_pool();
+  auto* pool = DefaultArrowMemoryPool();
 
   const std::vector<Row>* source_view = TupleView(&source);
 
@@ -1,5 +1,6 @@
 #include "katana/ArrowInterchange.h"
 
+#include <atomic>
 #include <iostream>
 #include <sstream>
 
@@ -7,6 +8,8 @@
 
 namespace {
 
+std::atomic<arrow::MemoryPool*> default_pool{nullptr};
+
 katana::Result<std::shared_ptr<arrow::ChunkedArray>>
 IndexedTake(
     const std::shared_ptr<arrow::ChunkedArray>& original,
@@ -159,3 +162,14 @@ katana::DiffFormatTo(
     }
   }
 }
+
+arrow::MemoryPool*
+katana::DefaultArrowMemoryPool() {
+  arrow::MemoryPool* pool = default_pool.load(std::memory_order_acquire);
+  return pool ? pool : arrow::default_memory_pool();
+}
+
+void
+katana::SetDefaultArrowMemoryPool(arrow::MemoryPool* pool) {
+  default_pool.store(pool, std::memory_order_release);
+}
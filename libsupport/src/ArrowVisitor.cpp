@@ -2,6 +2,7 @@
 
 #include <arrow/type_traits.h>
 
+#include "katana/ArrowInterchange.h"
 #include "katana/Logging.h"
 
 struct ToArrayVisitor {
@@ -90,7 +91,7 @@ katana::ArrayFromScalars(
     const std::shared_ptr<arrow::DataType>& type) {
   std::unique_ptr<arrow::ArrayBuilder> builder;
   if (auto st =
-          arrow::MakeBuilder(arrow::default_memory_pool(), type, &builder);
+          arrow::MakeBuilder(katana::DefaultArrowMemoryPool(), type, &builder);
       !st.ok()) {
     return KATANA_ERROR(
         katana::ErrorCode::ArrowError,
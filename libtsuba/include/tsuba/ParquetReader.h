@@ -32,6 +32,10 @@ public:
     /// Slice.length rows starting from Slice.offset
     std::optional<Slice> slice{std::nullopt};
 
+    /// if true (default) the row groups of a file with more than one row group
+    /// are decoded in parallel when reading a whole table
+    bool parallel_decode{true};
+
     static ReadOpts Defaults() { return ReadOpts{}; }
   };
 
@@ -73,12 +77,19 @@ public:
   katana::Result<int64_t> NumRows(const katana::Uri& uri);
 
 private:
-  ParquetReader(std::optional<Slice> slice, bool make_cannonical)
-      : slice_(slice), make_cannonical_{make_cannonical} {}
+  ParquetReader(
+      std::optional<Slice> slice, bool make_cannonical, bool parallel_decode)
+      : slice_(slice),
+        make_cannonical_{make_cannonical},
+        parallel_decode_{parallel_decode} {}
 
   katana::Result<std::shared_ptr<arrow::Table>> ReadFromUriSliced(
       const katana::Uri& uri);
 
+  katana::Result<std::shared_ptr<arrow::Table>> ReadRowGroupsParallel(
+      const std::shared_ptr<arrow::io::RandomAccessFile>& file,
+      parquet::arrow::FileReader* reader, int num_tasks);
+
   katana::Result<std::shared_ptr<arrow::Table>> FixTable(
       std::shared_ptr<arrow::Table>&& _table);
 
@@ -88,6 +99,7 @@ private:
 
   std::optional<Slice> slice_;
   bool make_cannonical_;
+  bool parallel_decode_;
 };
 
 }  // namespace tsuba
@@ -1,7 +1,12 @@
 #ifndef KATANA_LIBTSUBA_TSUBA_PARQUETWRITER_H_
 #define KATANA_LIBTSUBA_TSUBA_PARQUETWRITER_H_
 
+#include <optional>
+#include <string>
+#include <unordered_map>
+
 #include <arrow/api.h>
+#include <arrow/util/compression.h>
 
 #include "katana/Result.h"
 #include "katana/Uri.h"
@@ -11,14 +16,53 @@ namespace tsuba {
 
 class KATANA_EXPORT ParquetWriter {
 public:
+  /// parquet's own default; large enough that small properties still fit in
+  /// one row group, small enough that large ones can be decoded in parallel
+  static constexpr int64_t kDefaultMaxRowGroupLength = 64 * 1024 * 1024;
+  static constexpr int64_t kDefaultDataPageSize = 1024 * 1024;
+
+  struct WriteOpts {
+    /// codec used for every column that has no entry in column_compression
+    arrow::Compression::type compression{arrow::Compression::UNCOMPRESSED};
+
+    /// codec specific compression level; if not provided the codec's default
+    /// is used
+    std::optional<int> compression_level{std::nullopt};
+
+    /// codec to use for particular columns, keyed by column (i.e., property)
+    /// name
+    std::unordered_map<std::string, arrow::Compression::type>
+        column_compression{};
+
+    /// if true (default) dictionary encode columns, falling back to plain
+    /// encoding when the dictionary gets too large
+    bool enable_dictionary{true};
+
+    /// if true (default) store min/max statistics for every column chunk
+    bool enable_statistics{true};
+
+    /// maximum number of rows in a row group; row groups are the unit of
+    /// parallel decode and of statistics
+    int64_t max_row_group_length{kDefaultMaxRowGroupLength};
+
+    /// target size in bytes of an encoded data page
+    int64_t data_page_size{kDefaultDataPageSize};
+
+    static WriteOpts Defaults() { return WriteOpts{}; }
+  };
+
   /// \returns a Writer that will write a table consisting of a single column
   /// \param array named \param name to a storage location
+  /// \param opts an opt structure detailing how the table should be encoded
+  ///    (see the WriteOpts struct definition for details)
   static katana::Result<std::unique_ptr<ParquetWriter>> Make(
-      std::shared_ptr<arrow::ChunkedArray> array, const std::string& name);
+      std::shared_ptr<arrow::ChunkedArray> array, const std::string& name,
+      WriteOpts opts = WriteOpts::Defaults());
 
   /// \returns a Writer that will write \param table to a storage location
   static katana::Result<std::unique_ptr<ParquetWriter>> Make(
-      std::shared_ptr<arrow::Table> table);
+      std::shared_ptr<arrow::Table> table,
+      WriteOpts opts = WriteOpts::Defaults());
 
   /// write table out to a storage location \param uri If \param group is null,
   /// the write is synchronous, if not an asynchronous write is started to be
@@ -27,10 +71,11 @@ public:
       const katana::Uri& uri, WriteGroup* group = nullptr);
 
 private:
-  ParquetWriter(std::shared_ptr<arrow::Table> table)
-      : table_(std::move(table)) {}
+  ParquetWriter(std::shared_ptr<arrow::Table> table, WriteOpts opts)
+      : table_(std::move(table)), opts_(std::move(opts)) {}
 
   std::shared_ptr<arrow::Table> table_;
+  WriteOpts opts_;
 };
 
 }  // namespace tsuba
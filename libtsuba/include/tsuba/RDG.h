@@ -15,6 +15,7 @@
 #include "tsuba/Errors.h"
 #include "tsuba/FileFrame.h"
 #include "tsuba/FileView.h"
+#include "tsuba/ParquetWriter.h"
 #include "tsuba/PartitionMetadata.h"
 #include "tsuba/RDGLineage.h"
 #include "tsuba/WriteGroup.h"
@@ -26,6 +27,16 @@ class RDGMeta;
 class RDGCore;
 struct PropStorageInfo;
 
+/// How a property column is encoded on storage
+enum class PropertyFileFormat {
+  /// Parquet: compact, but decoded into fresh Arrow buffers on load
+  kParquet,
+  /// Arrow IPC file holding the Arrow buffers as they are in memory (64 byte
+  /// aligned). Loading maps the file through a FileView and wraps the mapped
+  /// bytes as Arrow buffers without decoding or copying them.
+  kArrowIpc,
+};
+
 struct KATANA_EXPORT RDGLoadOptions {
   /// Which partition of the RDG on storage should be loaded
   /// nullopt means the partition associated with the current host's ID will be
@@ -57,10 +68,13 @@ public:
 
   /// Store this RDG at \param handle; if \param ff is not null, it is persisted
   /// as the topology for this RDG. Add \param command_line to metadata to aid
-  /// in tracking lineage
+  /// in tracking lineage. Properties stored as Parquet are encoded according
+  /// to \param opts
   katana::Result<void> Store(
       RDGHandle handle, const std::string& command_line,
-      std::unique_ptr<FileFrame> ff = nullptr);
+      std::unique_ptr<FileFrame> ff = nullptr,
+      const ParquetWriter::WriteOpts& opts =
+          ParquetWriter::WriteOpts::Defaults());
 
   katana::Result<void> AddNodeProperties(
       const std::shared_ptr<arrow::Table>& props);
@@ -84,6 +98,19 @@ public:
   katana::Result<void> MarkEdgePropertiesPersistent(
       const std::vector<std::string>& persist_edge_props);
 
+  /// Select the storage format of the named node properties; the properties
+  /// are rewritten in that format by the next Store
+  katana::Result<void> SetNodePropertiesFileFormat(
+      const std::vector<std::string>& node_props, PropertyFileFormat format);
+  katana::Result<void> SetEdgePropertiesFileFormat(
+      const std::vector<std::string>& edge_props, PropertyFileFormat format);
+
+  /// Properties upserted with only a few changed rows are stored as deltas
+  /// over their previous files, and deltas accumulate until there are too
+  /// many of them. Rewrite every such property as a single file on the next
+  /// Store
+  void CompactProperties();
+
   /// Explain to graph how it is derived from previous version
   void AddLineage(const std::string& command_line);
 
@@ -161,6 +188,13 @@ public:
   const PartitionMetadata& part_metadata() const;
   void set_part_metadata(const PartitionMetadata& metadata);
 
+  /// Summary statistics of the graph, stored with the RDG so that they need
+  /// not be recomputed on every load. The RDG resets them to null when the
+  /// topology is replaced; upserting properties only drops the summaries of
+  /// the upserted columns under "node_columns" or "edge_columns".
+  const nlohmann::json& graph_stats() const;
+  void set_graph_stats(nlohmann::json stats);
+
   const FileView& topology_file_storage() const;
 
 private:
@@ -181,7 +215,7 @@ private:
 
   katana::Result<void> DoStore(
       RDGHandle handle, const std::string& command_line,
-      std::unique_ptr<WriteGroup> desc);
+      const ParquetWriter::WriteOpts& opts, std::unique_ptr<WriteGroup> desc);
 
   //
   // Data
@@ -1,6 +1,11 @@
 #include "AddProperties.h"
 
+#include <numeric>
+
 #include <arrow/chunked_array.h>
+#include <arrow/compute/api.h>
+#include <arrow/io/memory.h>
+#include <arrow/ipc/reader.h>
 
 #include "katana/Result.h"
 #include "tsuba/Errors.h"
@@ -9,10 +14,96 @@
 
 namespace {
 
+/// The whole contents of a FileView as an arrow::Buffer. Slices of this
+/// buffer keep the FileView, and thus the mapping, alive.
+class FileViewBuffer : public arrow::Buffer {
+public:
+  FileViewBuffer(std::shared_ptr<tsuba::FileView> view)
+      : arrow::Buffer(view->ptr<uint8_t>(), view->size()),
+        view_(std::move(view)) {}
+
+private:
+  std::shared_ptr<tsuba::FileView> view_;
+};
+
+katana::Result<void>
+CheckSchema(const arrow::Table& table, const std::string& expected_name) {
+  std::shared_ptr<arrow::Schema> schema = table.schema();
+  if (schema->num_fields() != 1) {
+    return KATANA_ERROR(
+        tsuba::ErrorCode::InvalidArgument, "expected 1 field found {} instead",
+        schema->num_fields());
+  }
+
+  if (schema->field(0)->name() != expected_name) {
+    return KATANA_ERROR(
+        tsuba::ErrorCode::InvalidArgument, "expected {} found {} instead",
+        expected_name, schema->field(0)->name());
+  }
+  return katana::ResultSuccess();
+}
+
+/// Load an Arrow IPC property file without decoding: the arrays of the
+/// returned table point into the mapped file.
+katana::Result<std::shared_ptr<arrow::Table>>
+DoLoadArrowIpcProperties(
+    const std::string& expected_name, const katana::Uri& file_path,
+    std::optional<tsuba::ParquetReader::Slice> slice) {
+  auto fv = std::make_shared<tsuba::FileView>();
+  if (auto res = fv->Bind(file_path.string(), true); !res) {
+    return res.error().WithContext("loading property");
+  }
+
+  auto buffer_reader = std::make_shared<arrow::io::BufferReader>(
+      std::make_shared<FileViewBuffer>(std::move(fv)));
+  auto reader_res = arrow::ipc::RecordBatchFileReader::Open(buffer_reader);
+  if (!reader_res.ok()) {
+    return KATANA_ERROR(
+        tsuba::ErrorCode::ArrowError, "opening ipc file: {}",
+        reader_res.status());
+  }
+  std::shared_ptr<arrow::ipc::RecordBatchFileReader> reader =
+      std::move(reader_res.ValueOrDie());
+
+  std::vector<std::shared_ptr<arrow::RecordBatch>> batches;
+  for (int i = 0, n = reader->num_record_batches(); i < n; ++i) {
+    auto batch_res = reader->ReadRecordBatch(i);
+    if (!batch_res.ok()) {
+      return KATANA_ERROR(
+          tsuba::ErrorCode::ArrowError, "reading ipc record batch: {}",
+          batch_res.status());
+    }
+    batches.emplace_back(std::move(batch_res.ValueOrDie()));
+  }
+
+  auto table_res = arrow::Table::FromRecordBatches(reader->schema(), batches);
+  if (!table_res.ok()) {
+    return KATANA_ERROR(
+        tsuba::ErrorCode::ArrowError, "building table: {}",
+        table_res.status());
+  }
+  std::shared_ptr<arrow::Table> out = std::move(table_res.ValueOrDie());
+
+  if (auto res = CheckSchema(*out, expected_name); !res) {
+    return res.error();
+  }
+
+  if (slice) {
+    // zero-copy; only the slice is referenced but the whole file was read
+    out = out->Slice(slice->offset, slice->length);
+  }
+  return out;
+}
+
 katana::Result<std::shared_ptr<arrow::Table>>
 DoLoadProperties(
     const std::string& expected_name, const katana::Uri& file_path,
+    tsuba::PropertyFileFormat format,
     std::optional<tsuba::ParquetReader::Slice> slice = std::nullopt) {
+  if (format == tsuba::PropertyFileFormat::kArrowIpc) {
+    return DoLoadArrowIpcProperties(expected_name, file_path, slice);
+  }
+
   auto read_opts = tsuba::ParquetReader::ReadOpts::Defaults();
   read_opts.slice = slice;
   auto reader_res = tsuba::ParquetReader::Make(read_opts);
@@ -28,28 +119,121 @@ DoLoadProperties(
 
   std::shared_ptr<arrow::Table> out = std::move(out_res.value());
 
-  std::shared_ptr<arrow::Schema> schema = out->schema();
-  if (schema->num_fields() != 1) {
+  if (auto res = CheckSchema(*out, expected_name); !res) {
+    return res.error();
+  }
+  return out;
+}
+
+/// Load a delta file: a row column followed by a column of values for the
+/// property expected_name
+katana::Result<std::shared_ptr<arrow::Table>>
+LoadDelta(
+    const std::string& expected_name, const arrow::DataType& expected_type,
+    const katana::Uri& file_path) {
+  auto reader_res = tsuba::ParquetReader::Make();
+  if (!reader_res) {
+    return reader_res.error();
+  }
+  auto table_res = reader_res.value()->ReadTable(file_path);
+  if (!table_res) {
+    return table_res.error().WithContext("loading delta");
+  }
+  std::shared_ptr<arrow::Table> delta = std::move(table_res.value());
+
+  const std::shared_ptr<arrow::Schema>& schema = delta->schema();
+  if (schema->num_fields() != 2 ||
+      !schema->field(0)->type()->Equals(arrow::uint64()) ||
+      schema->field(1)->name() != expected_name ||
+      !schema->field(1)->type()->Equals(expected_type)) {
     return KATANA_ERROR(
-        tsuba::ErrorCode::InvalidArgument, "expected 1 field found {} instead",
-        schema->num_fields());
+        tsuba::ErrorCode::InvalidArgument,
+        "delta {} does not hold rows of {} ({})", file_path, expected_name,
+        expected_type.ToString());
   }
+  return delta;
+}
 
-  if (schema->field(0)->name() != expected_name) {
+katana::Result<std::shared_ptr<arrow::Table>>
+DoApplyPropertyDeltas(
+    const std::shared_ptr<arrow::Table>& props, const katana::Uri& dir,
+    const std::vector<std::string>& delta_paths, uint64_t first_row) {
+  std::shared_ptr<arrow::Field> field = props->schema()->field(0);
+  uint64_t num_rows = props->num_rows();
+
+  // Build the property by taking each row either from props or from the
+  // values of the last delta that replaces it
+  std::vector<uint64_t> take(num_rows);
+  std::iota(take.begin(), take.end(), 0);
+  arrow::ArrayVector values = props->column(0)->chunks();
+  uint64_t values_end = num_rows;
+
+  for (const std::string& delta_path : delta_paths) {
+    auto delta_res =
+        LoadDelta(field->name(), *field->type(), dir.Join(delta_path));
+    if (!delta_res) {
+      return delta_res.error();
+    }
+    std::shared_ptr<arrow::Table> delta = std::move(delta_res.value());
+
+    uint64_t value_index = values_end;
+    for (const auto& chunk : delta->column(0)->chunks()) {
+      const auto& rows = static_cast<const arrow::UInt64Array&>(*chunk);
+      for (int64_t i = 0, n = rows.length(); i < n; ++i, ++value_index) {
+        uint64_t row = rows.Value(i);
+        if (row >= first_row && row - first_row < num_rows) {
+          take[row - first_row] = value_index;
+        }
+      }
+    }
+    const arrow::ArrayVector& delta_values = delta->column(1)->chunks();
+    values.insert(values.end(), delta_values.begin(), delta_values.end());
+    values_end += delta->num_rows();
+  }
+
+  arrow::UInt64Builder take_builder;
+  if (auto status = take_builder.AppendValues(take); !status.ok()) {
     return KATANA_ERROR(
-        tsuba::ErrorCode::InvalidArgument, "expected {} found {} instead",
-        expected_name, schema->field(0)->name());
+        tsuba::ErrorCode::ArrowError, "building take indices: {}", status);
   }
-  return out;
+  std::shared_ptr<arrow::Array> take_indices;
+  if (auto status = take_builder.Finish(&take_indices); !status.ok()) {
+    return KATANA_ERROR(
+        tsuba::ErrorCode::ArrowError, "building take indices: {}", status);
+  }
+
+  auto all_values =
+      std::make_shared<arrow::ChunkedArray>(values, field->type());
+  auto take_res = arrow::compute::Take(all_values, take_indices);
+  if (!take_res.ok()) {
+    return KATANA_ERROR(
+        tsuba::ErrorCode::ArrowError, "applying deltas: {}",
+        take_res.status());
+  }
+  return arrow::Table::Make(
+      arrow::schema({field}), {take_res.ValueOrDie().chunked_array()});
 }
 
 }  // namespace
 
+katana::Result<std::shared_ptr<arrow::Table>>
+tsuba::ApplyPropertyDeltas(
+    const std::shared_ptr<arrow::Table>& props, const katana::Uri& dir,
+    const std::vector<std::string>& delta_paths, uint64_t first_row) {
+  try {
+    return DoApplyPropertyDeltas(props, dir, delta_paths, first_row);
+  } catch (const std::exception& exp) {
+    return KATANA_ERROR(
+        ErrorCode::ArrowError, "arrow exception: {}", exp.what());
+  }
+}
+
 katana::Result<std::shared_ptr<arrow::Table>>
 tsuba::LoadProperties(
-    const std::string& expected_name, const katana::Uri& file_path) {
+    const std::string& expected_name, const katana::Uri& file_path,
+    PropertyFileFormat format) {
   try {
-    return DoLoadProperties(expected_name, file_path);
+    return DoLoadProperties(expected_name, file_path, format);
   } catch (const std::exception& exp) {
     return KATANA_ERROR(
         ErrorCode::ArrowError, "arrow exception: {}", exp.what());
@@ -59,10 +243,10 @@ tsuba::LoadProperties(
 katana::Result<std::shared_ptr<arrow::Table>>
 tsuba::LoadPropertySlice(
     const std::string& expected_name, const katana::Uri& file_path,
-    int64_t offset, int64_t length) {
+    int64_t offset, int64_t length, PropertyFileFormat format) {
   try {
     return DoLoadProperties(
-        expected_name, file_path,
+        expected_name, file_path, format,
         ParquetReader::Slice{.offset = offset, .length = length});
   } catch (const std::exception& exp) {
     return KATANA_ERROR(
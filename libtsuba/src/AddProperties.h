@@ -10,11 +10,22 @@
 namespace tsuba {
 
 KATANA_EXPORT katana::Result<std::shared_ptr<arrow::Table>> LoadProperties(
-    const std::string& expected_name, const katana::Uri& file_path);
+    const std::string& expected_name, const katana::Uri& file_path,
+    PropertyFileFormat format = PropertyFileFormat::kParquet);
 
 KATANA_EXPORT katana::Result<std::shared_ptr<arrow::Table>> LoadPropertySlice(
     const std::string& expected_name, const katana::Uri& file_path,
-    int64_t offset, int64_t length);
+    int64_t offset, int64_t length,
+    PropertyFileFormat format = PropertyFileFormat::kParquet);
+
+/// Replace rows of the single column table props with the rows stored in the
+/// delta files named by delta_paths (relative to dir), applying later deltas
+/// over earlier ones. props holds the rows of the property starting at
+/// first_row; delta rows outside of props are ignored.
+KATANA_EXPORT katana::Result<std::shared_ptr<arrow::Table>>
+ApplyPropertyDeltas(
+    const std::shared_ptr<arrow::Table>& props, const katana::Uri& dir,
+    const std::vector<std::string>& delta_paths, uint64_t first_row = 0);
 
 template <typename AddFn>
 katana::Result<void>
@@ -24,13 +35,24 @@ AddProperties(
   for (const tsuba::PropStorageInfo& properties : properties) {
     auto p_path = uri.Join(properties.path);
 
-    auto load_result = LoadProperties(properties.name, p_path);
+    auto load_result =
+        LoadProperties(properties.name, p_path, properties.format);
     if (!load_result) {
       return load_result.error().WithContext("error loading {}", p_path);
     }
 
     std::shared_ptr<arrow::Table> props = load_result.value();
 
+    if (!properties.delta_paths.empty()) {
+      auto delta_result =
+          ApplyPropertyDeltas(props, uri, properties.delta_paths);
+      if (!delta_result) {
+        return delta_result.error().WithContext(
+            "applying deltas to {}", std::quoted(properties.name));
+      }
+      props = delta_result.value();
+    }
+
     auto add_result = add_fn(props);
     if (!add_result) {
       return add_result.error().WithContext(
@@ -51,13 +73,23 @@ AddPropertySlice(
     katana::Uri p_path = dir.Join(properties.path);
 
     auto load_result = LoadPropertySlice(
-        properties.name, p_path, range.first, range.second - range.first);
+        properties.name, p_path, range.first, range.second - range.first,
+        properties.format);
     if (!load_result) {
       return load_result.error();
     }
 
     std::shared_ptr<arrow::Table> props = load_result.value();
 
+    if (!properties.delta_paths.empty()) {
+      auto delta_result =
+          ApplyPropertyDeltas(props, dir, properties.delta_paths, range.first);
+      if (!delta_result) {
+        return delta_result.error();
+      }
+      props = delta_result.value();
+    }
+
     auto add_result = add_fn(props);
     if (!add_result) {
       return add_result.error();
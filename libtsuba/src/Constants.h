@@ -1,6 +1,7 @@
 #ifndef KATANA_LIBTSUBA_CONSTANTS_H_
 #define KATANA_LIBTSUBA_CONSTANTS_H_
 
+#include <cstdint>
 #include <string_view>
 
 namespace tsuba {
@@ -9,6 +10,13 @@ constexpr uint32_t kPartitionMagicNo = 0x4B808284;  // KPRT
 constexpr uint32_t kRDGMagicNo = 0x4B524447;        // KRDG
 // constexpr uint32_t kPropertyMagicNo  = 0x4B808280; // KPRP
 
+// A stored property with this many deltas is rewritten in full (compacted) by
+// the next store that changes it
+constexpr size_t kMaxPropertyDeltas = 8;
+// A property is rewritten in full instead of as a delta once more than
+// 1/kMaxDeltaFraction of its rows changed
+constexpr uint64_t kMaxDeltaFraction = 8;
+
 };  // namespace tsuba
 
 #endif
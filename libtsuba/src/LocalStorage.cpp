@@ -7,13 +7,17 @@
 #include <unistd.h>
 
 #include <algorithm>
-#include <fstream>
-#include <iterator>
+#include <atomic>
+#include <cerrno>
+#include <optional>
 #include <system_error>
+#include <thread>
+#include <vector>
 
 #include <boost/filesystem.hpp>
 
 #include "GlobalState.h"
+#include "katana/Env.h"
 #include "katana/Logging.h"
 #include "katana/Result.h"
 #include "katana/Uri.h"
@@ -22,6 +26,228 @@
 
 namespace fs = boost::filesystem;
 
+namespace {
+
+// reads at least this large are split into segments that are read
+// concurrently; one stream rarely saturates an NVMe device
+constexpr uint64_t kMinReadSegmentSize = UINT64_C(16) << 20;  // 16M
+constexpr uint64_t kMaxReadSegments = 16;
+// default number of IoPool threads
+constexpr int kMaxIoThreads = 16;
+// size of the bounce buffer used when copy_file_range is not usable
+constexpr uint64_t kCopyBufferSize = UINT64_C(1) << 20;  // 1M
+
+/// Closes the file descriptor it holds when it goes out of scope
+class ScopedFd {
+  int fd_;
+
+public:
+  explicit ScopedFd(int fd) : fd_(fd) {}
+  ScopedFd(const ScopedFd&) = delete;
+  ScopedFd& operator=(const ScopedFd&) = delete;
+  ~ScopedFd() {
+    if (fd_ >= 0) {
+      close(fd_);
+    }
+  }
+
+  int get() const { return fd_; }
+};
+
+bool
+IsBlockAligned(uint64_t val) {
+  return (val & tsuba::kBlockOffsetMask) == 0;
+}
+
+/// Open path, with O_DIRECT if \param direct is true and the platform and
+/// file system support it
+int
+OpenFile(const std::string& path, int flags, bool direct) {
+#ifdef O_DIRECT
+  if (direct) {
+    int fd = open(path.c_str(), flags | O_DIRECT | O_CLOEXEC, 0666);
+    // EINVAL: the file system does not support O_DIRECT
+    if (fd >= 0 || errno != EINVAL) {
+      return fd;
+    }
+  }
+#endif
+  return open(path.c_str(), flags | O_CLOEXEC, 0666);
+}
+
+/// Read until size bytes have been read or the end of file is reached
+/// \returns the number of bytes read
+katana::Result<uint64_t>
+PreadFull(int fd, uint8_t* data, uint64_t size, uint64_t offset) {
+  uint64_t done = 0;
+  while (done < size) {
+    ssize_t ret = pread(fd, data + done, size - done, offset + done);
+    if (ret < 0) {
+      if (errno == EINTR) {
+        continue;
+      }
+      return KATANA_ERROR(
+          tsuba::ErrorCode::LocalStorageError, "failed to read: {}",
+          katana::ResultErrno().message());
+    }
+    if (ret == 0) {
+      break;
+    }
+    done += ret;
+  }
+  return done;
+}
+
+katana::Result<void>
+PwriteFull(int fd, const uint8_t* data, uint64_t size, uint64_t offset) {
+  uint64_t done = 0;
+  while (done < size) {
+    ssize_t ret = pwrite(fd, data + done, size - done, offset + done);
+    if (ret < 0) {
+      if (errno == EINTR) {
+        continue;
+      }
+      return KATANA_ERROR(
+          tsuba::ErrorCode::LocalStorageError, "failed to write: {}",
+          katana::ResultErrno().message());
+    }
+    done += ret;
+  }
+  return katana::ResultSuccess();
+}
+
+/// A read split into segments. Segments are claimed in order by the thread
+/// that issued the read and by IoPool helpers; the issuing thread claims
+/// whatever the helpers have not started, so the read completes even when
+/// every pool thread is busy, e.g., with the GetAsync this read is part of.
+struct SegmentedRead {
+  int fd;
+  uint8_t* data;
+  uint64_t start;
+  uint64_t size;
+  uint64_t segment_size;
+  uint64_t num_segments;
+
+  std::atomic<uint64_t> next{0};
+  std::mutex mutex;
+  std::condition_variable done_cv;
+  uint64_t num_done{0};
+  std::vector<std::optional<katana::Result<uint64_t>>> results;
+
+  /// Read segments until none is left to claim
+  void Run() {
+    for (uint64_t i = next.fetch_add(1); i < num_segments;
+         i = next.fetch_add(1)) {
+      uint64_t off = i * segment_size;
+      uint64_t len = std::min(segment_size, size - off);
+      auto res = PreadFull(fd, data + off, len, start + off);
+
+      std::lock_guard<std::mutex> lock(mutex);
+      results[i].emplace(std::move(res));
+      if (++num_done == num_segments) {
+        done_cv.notify_all();
+      }
+    }
+  }
+
+  void Wait() {
+    std::unique_lock<std::mutex> lock(mutex);
+    done_cv.wait(lock, [this]() { return num_done == num_segments; });
+  }
+};
+
+/// Copy size bytes from offset begin of in_fd to the start of out_fd through
+/// a user space buffer
+katana::Result<void>
+BufferedCopy(int in_fd, int out_fd, uint64_t begin, uint64_t size) {
+  std::vector<uint8_t> buf(std::min(size, kCopyBufferSize));
+  for (uint64_t done = 0; done < size;) {
+    uint64_t len = std::min<uint64_t>(buf.size(), size - done);
+    auto read_res = PreadFull(in_fd, buf.data(), len, begin + done);
+    if (!read_res) {
+      return read_res.error();
+    }
+    if (read_res.value() == 0) {
+      break;
+    }
+    if (auto res = PwriteFull(out_fd, buf.data(), read_res.value(), done);
+        !res) {
+      return res.error();
+    }
+    done += read_res.value();
+  }
+  return katana::ResultSuccess();
+}
+
+std::future<katana::Result<void>>
+MakeReadyFuture(katana::Result<void> res) {
+  std::promise<katana::Result<void>> promise;
+  promise.set_value(std::move(res));
+  return promise.get_future();
+}
+
+}  // namespace
+
+tsuba::IoPool::~IoPool() {
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    stop_ = true;
+  }
+  cv_.notify_all();
+  for (auto& thread : threads_) {
+    thread.join();
+  }
+}
+
+void
+tsuba::IoPool::set_num_threads(size_t num_threads) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  num_threads_ = std::max<size_t>(num_threads, 1);
+}
+
+void
+tsuba::IoPool::Post(std::function<void()> task) {
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (threads_.empty()) {
+      for (size_t i = 0; i < num_threads_; ++i) {
+        threads_.emplace_back([this]() { Run(); });
+      }
+    }
+    tasks_.emplace_back(std::move(task));
+  }
+  cv_.notify_one();
+}
+
+void
+tsuba::IoPool::Run() {
+  std::unique_lock<std::mutex> lock(mutex_);
+  while (true) {
+    cv_.wait(lock, [this]() { return stop_ || !tasks_.empty(); });
+    if (tasks_.empty()) {
+      return;
+    }
+    std::function<void()> task = std::move(tasks_.front());
+    tasks_.pop_front();
+    lock.unlock();
+    task();
+    lock.lock();
+  }
+}
+
+katana::Result<void>
+tsuba::LocalStorage::Init() {
+  bool direct_io = false;
+  if (katana::GetEnv("KATANA_LOCAL_STORAGE_DIRECT_IO", &direct_io)) {
+    direct_io_ = direct_io;
+  }
+  int num_threads = std::clamp<int>(
+      std::thread::hardware_concurrency(), 1, kMaxIoThreads);
+  katana::GetEnv("KATANA_LOCAL_STORAGE_IO_THREADS", &num_threads);
+  pool_.set_num_threads(std::max(num_threads, 1));
+  return katana::ResultSuccess();
+}
+
 void
 tsuba::LocalStorage::CleanUri(std::string* uri) {
   if (uri->find(uri_scheme()) != 0) {
@@ -44,13 +270,16 @@ tsuba::LocalStorage::WriteFile(
     }
   }
 
-  std::ofstream ofile(uri);
-  if (!ofile.good()) {
-    return KATANA_ERROR(ErrorCode::LocalStorageError, "opening file");
+  bool direct = direct_io_ && IsBlockAligned(size) &&
+                IsBlockAligned(reinterpret_cast<uintptr_t>(data));
+  ScopedFd fd(OpenFile(uri, O_WRONLY | O_CREAT | O_TRUNC, direct));
+  if (fd.get() < 0) {
+    return KATANA_ERROR(
+        ErrorCode::LocalStorageError, "opening file: {}: {}", uri,
+        katana::ResultErrno().message());
   }
-  ofile.write(reinterpret_cast<const char*>(data), size); /* NOLINT */
-  if (!ofile.good()) {
-    return KATANA_ERROR(ErrorCode::LocalStorageError, "writing file");
+  if (auto res = PwriteFull(fd.get(), data, size, 0); !res) {
+    return res.error().WithContext("{}", uri);
   }
   return katana::ResultSuccess();
 }
@@ -62,22 +291,55 @@ tsuba::LocalStorage::RemoteCopyFile(
   CleanUri(&source_uri);
   CleanUri(&dest_uri);
 
-  std::ifstream ifile(source_uri, std::ios_base::binary);
-  if (!ifile) {
+  ScopedFd in_fd(OpenFile(source_uri, O_RDONLY, false));
+  if (in_fd.get() < 0) {
     return KATANA_ERROR(
-        ErrorCode::LocalStorageError, "failed to open source file");
+        ErrorCode::LocalStorageError, "failed to open source file: {}: {}",
+        source_uri, katana::ResultErrno().message());
   }
-  ifile.seekg(begin, std::ios_base::beg);
-
-  std::ofstream ofile(dest_uri, std::ios_base::binary | std::ios_base::trunc);
-  if (!ofile) {
+  ScopedFd out_fd(OpenFile(dest_uri, O_WRONLY | O_CREAT | O_TRUNC, false));
+  if (out_fd.get() < 0) {
     return KATANA_ERROR(
-        ErrorCode::LocalStorageError, "failed to open dest file");
+        ErrorCode::LocalStorageError, "failed to open dest file: {}: {}",
+        dest_uri, katana::ResultErrno().message());
   }
 
-  std::copy_n(
-      std::istreambuf_iterator<char>(ifile), size,
-      std::ostreambuf_iterator<char>(ofile));
+  uint64_t done = 0;
+#ifdef __linux__
+  // copy_file_range copies inside the kernel and shares extents (reflink) on
+  // file systems that support it
+  while (done < size) {
+    loff_t in_off = begin + done;
+    loff_t out_off = done;
+    ssize_t ret = copy_file_range(
+        in_fd.get(), &in_off, out_fd.get(), &out_off, size - done, 0);
+    if (ret < 0) {
+      if (errno == EINTR) {
+        continue;
+      }
+      // not supported by the kernel or between these file systems; finish
+      // with a regular copy
+      if (errno == ENOSYS || errno == EXDEV || errno == EINVAL ||
+          errno == EOPNOTSUPP) {
+        break;
+      }
+      return KATANA_ERROR(
+          ErrorCode::LocalStorageError, "copying {} to {}: {}", source_uri,
+          dest_uri, katana::ResultErrno().message());
+    }
+    if (ret == 0) {
+      return katana::ResultSuccess();
+    }
+    done += ret;
+  }
+#endif
+  if (done < size) {
+    if (auto res = BufferedCopy(
+            in_fd.get(), out_fd.get(), begin + done, size - done);
+        !res) {
+      return res.error().WithContext("copying {} to {}", source_uri, dest_uri);
+    }
+  }
   return katana::ResultSuccess();
 }
 
@@ -85,21 +347,54 @@ katana::Result<void>
 tsuba::LocalStorage::ReadFile(
     std::string uri, uint64_t start, uint64_t size, uint8_t* data) {
   CleanUri(&uri);
-  std::ifstream ifile(uri);
+  bool direct = direct_io_ && IsBlockAligned(start) && IsBlockAligned(size) &&
+                IsBlockAligned(reinterpret_cast<uintptr_t>(data));
+  ScopedFd fd(OpenFile(uri, O_RDONLY, direct));
+  if (fd.get() < 0) {
+    return KATANA_ERROR(
+        ErrorCode::LocalStorageError, "opening file: {}: {}", uri,
+        katana::ResultErrno().message());
+  }
 
-  ifile.seekg(start);
-  if (!ifile) {
-    return KATANA_ERROR(ErrorCode::LocalStorageError, "failed to seek");
+  // segments stay block aligned so that O_DIRECT applies to all of them
+  uint64_t max_segments = std::min<uint64_t>(
+      kMaxReadSegments,
+      std::max<uint64_t>(std::thread::hardware_concurrency(), 1));
+  uint64_t num_segments =
+      std::clamp<uint64_t>(size / kMinReadSegmentSize, 1, max_segments);
+  uint64_t segment_size =
+      (size / num_segments + kBlockOffsetMask) & ~kBlockOffsetMask;
+
+  auto read = std::make_shared<SegmentedRead>();
+  read->fd = fd.get();
+  read->data = data;
+  read->start = start;
+  read->size = size;
+  read->segment_size = segment_size;
+  read->num_segments =
+      size == 0 ? 1 : (size + segment_size - 1) / segment_size;
+  read->results.resize(read->num_segments);
+
+  // helpers that start after the segments are all claimed do nothing, and
+  // hold the shared state rather than this frame
+  for (uint64_t i = 1; i < read->num_segments; ++i) {
+    pool_.Post([read]() { read->Run(); });
   }
+  read->Run();
+  // every segment must be done before fd is closed
+  read->Wait();
 
-  ifile.read(reinterpret_cast<char*>(data), size); /* NOLINT */
-  if (!ifile) {
-    return KATANA_ERROR(ErrorCode::LocalStorageError, "failed to read");
+  uint64_t total = 0;
+  for (auto& res : read->results) {
+    if (!*res) {
+      return res->error().WithContext("{}", uri);
+    }
+    total += res->value();
   }
 
   // if the difference in what was read from what we wanted is less  than a
   // block it's because the file size isn't well aligned so don't complain.
-  if (size - ifile.gcount() > kBlockSize) {
+  if (size - total > kBlockSize) {
     return ErrorCode::LocalStorageError;
   }
   return katana::ResultSuccess();
@@ -118,7 +413,7 @@ tsuba::LocalStorage::Stat(const std::string& uri, StatBuf* s_buf) {
   return katana::ResultSuccess();
 }
 
-// Current implementation is not async
+// Listing is synchronous; the returned future is already satisfied
 std::future<katana::Result<void>>
 tsuba::LocalStorage::ListAsync(
     const std::string& uri, std::vector<std::string>* list,
@@ -132,17 +427,13 @@ tsuba::LocalStorage::ListAsync(
   if ((dirp = opendir(dirname.c_str())) == nullptr) {
     if (errno == ENOENT) {
       // other storage backends are flat and so return an empty list here
-      return std::async(
-          []() -> katana::Result<void> { return katana::ResultSuccess(); });
+      return MakeReadyFuture(katana::ResultSuccess());
     }
 
-    std::error_code ec = katana::ResultErrno();
-
-    return std::async([ec, dirname]() -> katana::Result<void> {
-      return KATANA_ERROR(
-          ErrorCode::LocalStorageError, "open dir failed: {}: {}", dirname,
-          ec.message());
-    });
+    katana::Result<void> res = KATANA_ERROR(
+        ErrorCode::LocalStorageError, "open dir failed: {}: {}", dirname,
+        katana::ResultErrno().message());
+    return MakeReadyFuture(std::move(res));
   }
 
   int dfd = dirfd(dirp);
@@ -170,18 +461,16 @@ tsuba::LocalStorage::ListAsync(
 
   if (errno != 0) {
     std::error_code ec = katana::ResultErrno();
-
-    return std::async([ec, dirname]() -> katana::Result<void> {
-      return KATANA_ERROR(
-          ErrorCode::LocalStorageError, "readdir failed: {}: {}", dirname,
-          ec.message());
-    });
+    (void)closedir(dirp);
+    katana::Result<void> res = KATANA_ERROR(
+        ErrorCode::LocalStorageError, "readdir failed: {}: {}", dirname,
+        ec.message());
+    return MakeReadyFuture(std::move(res));
   }
 
   (void)closedir(dirp);
 
-  return std::async(
-      []() -> katana::Result<void> { return katana::ResultSuccess(); });
+  return MakeReadyFuture(katana::ResultSuccess());
 }
 
 katana::Result<void>
@@ -1,12 +1,16 @@
 #include "tsuba/ParquetReader.h"
 
+#include <algorithm>
+#include <future>
 #include <limits>
 #include <memory>
+#include <thread>
 #include <unordered_map>
 
 #include <arrow/chunked_array.h>
 #include <arrow/type.h>
 
+#include "katana/ArrowInterchange.h"
 #include "tsuba/Errors.h"
 #include "tsuba/FileView.h"
 
@@ -83,7 +87,7 @@ MakeFileReader(
   std::unique_ptr<parquet::arrow::FileReader> reader;
 
   auto open_file_result =
-      parquet::arrow::OpenFile(fv, arrow::default_memory_pool(), &reader);
+      parquet::arrow::OpenFile(fv, katana::DefaultArrowMemoryPool(), &reader);
   if (!open_file_result.ok()) {
     return KATANA_ERROR(
         ErrorCode::ArrowError, "arrow error: {}", open_file_result);
@@ -100,7 +104,8 @@ MakeFileReader(
 Result<std::unique_ptr<tsuba::ParquetReader>>
 tsuba::ParquetReader::Make(ReadOpts opts) {
   return std::unique_ptr<ParquetReader>(
-      new ParquetReader(opts.slice, opts.make_cannonical));
+      new ParquetReader(
+          opts.slice, opts.make_cannonical, opts.parallel_decode));
 }
 
 // Internal use only, invoke iff slice_ has a value
@@ -168,14 +173,29 @@ tsuba::ParquetReader::ReadTable(const katana::Uri& uri) {
     return ReadFromUriSliced(uri);
   }
 
+  std::shared_ptr<FileView> fv;
   auto reader_res =
-      MakeFileReader(uri, 0, std::numeric_limits<uint64_t>::max());
+      MakeFileReader(uri, 0, std::numeric_limits<uint64_t>::max(), &fv);
   if (!reader_res) {
     return reader_res.error();
   }
   std::unique_ptr<parquet::arrow::FileReader> reader(
       std::move(reader_res.value()));
 
+  int num_tasks = 1;
+  if (parallel_decode_) {
+    num_tasks = std::min<int>(
+        reader->num_row_groups(),
+        std::max<int>(std::thread::hardware_concurrency(), 1));
+  }
+  if (num_tasks > 1) {
+    auto table_res = ReadRowGroupsParallel(fv, reader.get(), num_tasks);
+    if (!table_res) {
+      return table_res.error().WithContext("reading {}", uri);
+    }
+    return FixTable(std::move(table_res.value()));
+  }
+
   std::shared_ptr<arrow::Table> out;
   auto read_result = reader->ReadTable(&out);
   if (!read_result.ok()) {
@@ -184,6 +204,67 @@ tsuba::ParquetReader::ReadTable(const katana::Uri& uri) {
   return FixTable(std::move(out));
 }
 
+/// Decode contiguous ranges of row groups on num_tasks threads. Each task gets
+/// its own FileReader because readers are not thread safe; they all share
+/// file, whose reads are serialized, so only decoding proceeds in parallel.
+Result<std::shared_ptr<arrow::Table>>
+tsuba::ParquetReader::ReadRowGroupsParallel(
+    const std::shared_ptr<arrow::io::RandomAccessFile>& file,
+    parquet::arrow::FileReader* reader, int num_tasks) {
+  using TableResult = Result<std::shared_ptr<arrow::Table>>;
+  int rg_count = reader->num_row_groups();
+
+  auto read_range = [&file, rg_count, num_tasks](int task) -> TableResult {
+    std::unique_ptr<parquet::arrow::FileReader> task_reader;
+    auto open_result = parquet::arrow::OpenFile(
+        file, katana::DefaultArrowMemoryPool(), &task_reader);
+    if (!open_result.ok()) {
+      return KATANA_ERROR(
+          ErrorCode::ArrowError, "arrow error: {}", open_result);
+    }
+    std::vector<int> row_groups;
+    for (int i = rg_count * task / num_tasks,
+             end = rg_count * (task + 1) / num_tasks;
+         i < end; ++i) {
+      row_groups.push_back(i);
+    }
+    std::shared_ptr<arrow::Table> out;
+    auto read_result = task_reader->ReadRowGroups(row_groups, &out);
+    if (!read_result.ok()) {
+      return KATANA_ERROR(
+          ErrorCode::ArrowError, "arrow error: {}", read_result);
+    }
+    return out;
+  };
+
+  std::vector<std::future<TableResult>> futures;
+  for (int task = 0; task < num_tasks; ++task) {
+    futures.emplace_back(std::async(std::launch::async, read_range, task));
+  }
+
+  // wait for every task before returning, even on error, since they all
+  // reference file
+  std::vector<TableResult> results;
+  for (auto& future : futures) {
+    results.emplace_back(future.get());
+  }
+  std::vector<std::shared_ptr<arrow::Table>> tables;
+  for (auto& res : results) {
+    if (!res) {
+      return res.error();
+    }
+    tables.emplace_back(std::move(res.value()));
+  }
+
+  auto concat_result = arrow::ConcatenateTables(tables);
+  if (!concat_result.ok()) {
+    return KATANA_ERROR(
+        ErrorCode::ArrowError, "concatenating row groups: {}",
+        concat_result.status());
+  }
+  return concat_result.ValueOrDie();
+}
+
 Result<std::shared_ptr<arrow::Table>>
 tsuba::ParquetReader::DoFilteredTableRead(
     parquet::arrow::FileReader* reader, const arrow::Schema& schema,
@@ -325,7 +406,7 @@ tsuba::ParquetReader::FixTable(std::shared_ptr<arrow::Table>&& _table) {
   // combined into a single chunk due to the fact the offset type for these
   // columns is int32_t and thus the maximum size of an arrow::Array for these
   // types is 2^31.
-  auto combine_result = table->CombineChunks(arrow::default_memory_pool());
+  auto combine_result = table->CombineChunks(katana::DefaultArrowMemoryPool());
   if (!combine_result.ok()) {
     return KATANA_ERROR(
         ErrorCode::ArrowError, "arrow error: {}", combine_result.status());
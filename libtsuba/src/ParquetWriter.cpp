@@ -3,6 +3,7 @@
 #include <arrow/array/array_binary.h>
 #include <arrow/chunked_array.h>
 
+#include "katana/ArrowInterchange.h"
 #include "katana/Result.h"
 #include "tsuba/Errors.h"
 #include "tsuba/FaultTest.h"
@@ -16,14 +17,33 @@ namespace {
 constexpr uint64_t kMaxStringChunkSize = 0x7FFFFFFE;
 
 std::shared_ptr<parquet::WriterProperties>
-StandardWriterProperties() {
+StandardWriterProperties(const tsuba::ParquetWriter::WriteOpts& opts) {
   // int64 timestamps with nanosecond resolution requires Parquet version 2.0.
   // In Arrow to Parquet version 1.0, nanosecond timestamps will get truncated
   // to milliseconds.
-  return parquet::WriterProperties::Builder()
-      .version(parquet::ParquetVersion::PARQUET_2_0)
+  parquet::WriterProperties::Builder builder;
+  builder.version(parquet::ParquetVersion::PARQUET_2_0)
       ->data_page_version(parquet::ParquetDataPageVersion::V2)
-      ->build();
+      ->compression(opts.compression)
+      ->max_row_group_length(opts.max_row_group_length)
+      ->data_pagesize(opts.data_page_size);
+  if (opts.compression_level) {
+    builder.compression_level(opts.compression_level.value());
+  }
+  for (const auto& [column, codec] : opts.column_compression) {
+    builder.compression(column, codec);
+  }
+  if (opts.enable_dictionary) {
+    builder.enable_dictionary();
+  } else {
+    builder.disable_dictionary();
+  }
+  if (opts.enable_statistics) {
+    builder.enable_statistics();
+  } else {
+    builder.disable_statistics();
+  }
+  return builder.build();
 }
 
 std::shared_ptr<parquet::ArrowWriterProperties>
@@ -31,20 +51,46 @@ StandardArrowProperties() {
   return parquet::ArrowWriterProperties::Builder().build();
 }
 
+katana::Result<void>
+CheckWriteOpts(const tsuba::ParquetWriter::WriteOpts& opts) {
+  if (opts.max_row_group_length <= 0 || opts.data_page_size <= 0) {
+    return KATANA_ERROR(
+        tsuba::ErrorCode::InvalidArgument,
+        "row group length and data page size must be positive");
+  }
+  auto check_codec = [](arrow::Compression::type codec) -> Result<void> {
+    if (!arrow::util::Codec::IsAvailable(codec)) {
+      return KATANA_ERROR(
+          tsuba::ErrorCode::InvalidArgument,
+          "compression codec {} is not available in this build",
+          arrow::util::Codec::GetCodecAsString(codec));
+    }
+    return katana::ResultSuccess();
+  };
+  if (auto res = check_codec(opts.compression); !res) {
+    return res.error();
+  }
+  for (const auto& [column, codec] : opts.column_compression) {
+    if (auto res = check_codec(codec); !res) {
+      return res.error().WithContext("column {}", column);
+    }
+  }
+  return katana::ResultSuccess();
+}
+
 /// Store the arrow table in a file
 katana::Result<void>
 StoreParquet(
     const arrow::Table& table, const katana::Uri& uri,
-    tsuba::WriteGroup* desc) {
+    const tsuba::ParquetWriter::WriteOpts& opts, tsuba::WriteGroup* desc) {
   auto ff = std::make_shared<tsuba::FileFrame>();
   if (auto res = ff->Init(); !res) {
     return res.error().WithContext("creating output buffer");
   }
 
   auto write_result = parquet::arrow::WriteTable(
-      table, arrow::default_memory_pool(), ff,
-      std::numeric_limits<int64_t>::max(), StandardWriterProperties(),
-      StandardArrowProperties());
+      table, katana::DefaultArrowMemoryPool(), ff, opts.max_row_group_length,
+      StandardWriterProperties(opts), StandardArrowProperties());
 
   if (!write_result.ok()) {
     return KATANA_ERROR(
@@ -167,7 +213,11 @@ HandleBadParquetTypes(const std::shared_ptr<arrow::Table>& old_table) {
 
 Result<std::unique_ptr<tsuba::ParquetWriter>>
 tsuba::ParquetWriter::Make(
-    std::shared_ptr<arrow::ChunkedArray> array, const std::string& name) {
+    std::shared_ptr<arrow::ChunkedArray> array, const std::string& name,
+    WriteOpts opts) {
+  if (auto res = CheckWriteOpts(opts); !res) {
+    return res.error();
+  }
   auto res = HandleBadParquetTypes(array);
   if (!res) {
     return res.error().WithContext("conversion from arrow to parquet mismatch");
@@ -176,23 +226,29 @@ tsuba::ParquetWriter::Make(
 
   std::shared_ptr<arrow::Table> column = arrow::Table::Make(
       arrow::schema({arrow::field(name, array->type())}), {array});
-  return std::unique_ptr<ParquetWriter>(new ParquetWriter(column));
+  return std::unique_ptr<ParquetWriter>(
+      new ParquetWriter(column, std::move(opts)));
 }
 
 Result<std::unique_ptr<tsuba::ParquetWriter>>
-tsuba::ParquetWriter::Make(std::shared_ptr<arrow::Table> table) {
+tsuba::ParquetWriter::Make(
+    std::shared_ptr<arrow::Table> table, WriteOpts opts) {
+  if (auto res = CheckWriteOpts(opts); !res) {
+    return res.error();
+  }
   auto res = HandleBadParquetTypes(table);
   if (!res) {
     return res.error().WithContext("conversion from arrow to parquet mismatch");
   }
   table = std::move(res.value());
-  return std::unique_ptr<ParquetWriter>(new ParquetWriter(table));
+  return std::unique_ptr<ParquetWriter>(
+      new ParquetWriter(table, std::move(opts)));
 }
 
 katana::Result<void>
 tsuba::ParquetWriter::WriteToUri(const katana::Uri& uri, WriteGroup* group) {
   try {
-    return StoreParquet(*table_, uri, group);
+    return StoreParquet(*table_, uri, opts_, group);
   } catch (const std::exception& exp) {
     return KATANA_ERROR(
         tsuba::ErrorCode::ArrowError, "arrow exception: {}", exp.what());
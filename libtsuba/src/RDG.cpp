@@ -7,8 +7,11 @@
 #include <regex>
 #include <unordered_set>
 
+#include <arrow/array/concatenate.h>
 #include <arrow/chunked_array.h>
+#include <arrow/compute/api.h>
 #include <arrow/filesystem/api.h>
+#include <arrow/ipc/writer.h>
 #include <arrow/memory_pool.h>
 #include <arrow/type_fwd.h>
 #include <arrow/util/string_view.h>
@@ -20,6 +23,7 @@
 #include <parquet/properties.h>
 
 #include "AddProperties.h"
+#include "Constants.h"
 #include "GlobalState.h"
 #include "RDGCore.h"
 #include "RDGHandleImpl.h"
@@ -61,8 +65,10 @@ MasterPropName(unsigned i) {
 katana::Result<std::string>
 StoreArrowArrayAtName(
     const std::shared_ptr<arrow::ChunkedArray>& array, const katana::Uri& dir,
-    const std::string& name, tsuba::WriteGroup* desc) {
-  auto writer_res = tsuba::ParquetWriter::Make(array, name);
+    const std::string& name, tsuba::WriteGroup* desc,
+    const tsuba::ParquetWriter::WriteOpts& opts =
+        tsuba::ParquetWriter::WriteOpts::Defaults()) {
+  auto writer_res = tsuba::ParquetWriter::Make(array, name, opts);
   if (!writer_res) {
     return writer_res.error().WithContext("making property writer");
   }
@@ -75,40 +81,142 @@ StoreArrowArrayAtName(
   return new_path.BaseName();
 }
 
+/// Store the array as an Arrow IPC file whose buffers are aligned so that
+/// they can be used in place once mapped
+katana::Result<std::string>
+StoreArrowIpcAtName(
+    const std::shared_ptr<arrow::ChunkedArray>& array, const katana::Uri& dir,
+    const std::string& name, tsuba::WriteGroup* desc) {
+  std::shared_ptr<arrow::Table> table = arrow::Table::Make(
+      arrow::schema({arrow::field(name, array->type())}), {array});
+
+  auto ff = std::make_shared<tsuba::FileFrame>();
+  if (auto res = ff->Init(); !res) {
+    return res.error().WithContext("creating output buffer");
+  }
+
+  auto options = arrow::ipc::IpcWriteOptions::Defaults();
+  options.alignment = 64;
+  auto writer_res = arrow::ipc::MakeFileWriter(ff, table->schema(), options);
+  if (!writer_res.ok()) {
+    return KATANA_ERROR(
+        tsuba::ErrorCode::ArrowError, "making ipc writer: {}",
+        writer_res.status());
+  }
+  std::shared_ptr<arrow::ipc::RecordBatchWriter> writer =
+      std::move(writer_res.ValueOrDie());
+  if (auto status = writer->WriteTable(*table); !status.ok()) {
+    return KATANA_ERROR(
+        tsuba::ErrorCode::ArrowError, "writing ipc table: {}", status);
+  }
+  if (auto status = writer->Close(); !status.ok()) {
+    return KATANA_ERROR(
+        tsuba::ErrorCode::ArrowError, "closing ipc writer: {}", status);
+  }
+
+  katana::Uri new_path = dir.RandFile(name);
+  ff->Bind(new_path.string());
+  TSUBA_PTP(tsuba::internal::FaultSensitivity::Normal);
+  if (!desc) {
+    if (auto res = ff->Persist(); !res) {
+      return res.error().WithContext("writing ipc file");
+    }
+  } else {
+    desc->StartStore(std::move(ff));
+  }
+  return new_path.BaseName();
+}
+
+/// Store the dirty rows of array as a delta: a table of row indexes and the
+/// values of those rows
+katana::Result<std::string>
+StoreDeltaAtName(
+    const std::shared_ptr<arrow::ChunkedArray>& array,
+    const std::vector<uint64_t>& rows, const katana::Uri& dir,
+    const std::string& name, tsuba::WriteGroup* desc,
+    const tsuba::ParquetWriter::WriteOpts& opts) {
+  arrow::UInt64Builder rows_builder;
+  if (auto status = rows_builder.AppendValues(rows); !status.ok()) {
+    return KATANA_ERROR(
+        tsuba::ErrorCode::ArrowError, "building delta rows: {}", status);
+  }
+  std::shared_ptr<arrow::Array> rows_array;
+  if (auto status = rows_builder.Finish(&rows_array); !status.ok()) {
+    return KATANA_ERROR(
+        tsuba::ErrorCode::ArrowError, "building delta rows: {}", status);
+  }
+
+  auto values_res = arrow::compute::Take(array, rows_array);
+  if (!values_res.ok()) {
+    return KATANA_ERROR(
+        tsuba::ErrorCode::ArrowError, "selecting delta rows: {}",
+        values_res.status());
+  }
+
+  std::shared_ptr<arrow::Table> delta = arrow::Table::Make(
+      arrow::schema(
+          {arrow::field("row", arrow::uint64()),
+           arrow::field(name, array->type())}),
+      {std::make_shared<arrow::ChunkedArray>(rows_array),
+       values_res.ValueOrDie().chunked_array()});
+
+  auto writer_res = tsuba::ParquetWriter::Make(delta, opts);
+  if (!writer_res) {
+    return writer_res.error().WithContext("making delta writer");
+  }
+
+  katana::Uri new_path = dir.RandFile(name + "_delta");
+  if (auto res = writer_res.value()->WriteToUri(new_path, desc); !res) {
+    return res.error().WithContext("writing delta");
+  }
+  return new_path.BaseName();
+}
+
 katana::Result<std::vector<tsuba::PropStorageInfo>>
 WriteProperties(
     const arrow::Table& props,
     const std::vector<tsuba::PropStorageInfo>& prop_info,
-    const katana::Uri& dir, tsuba::WriteGroup* desc) {
+    const katana::Uri& dir, const tsuba::ParquetWriter::WriteOpts& opts,
+    tsuba::WriteGroup* desc) {
   const auto& schema = props.schema();
 
-  std::vector<std::string> next_paths;
-  for (size_t i = 0, n = prop_info.size(); i < n; ++i) {
-    if (!prop_info[i].persist || !prop_info[i].path.empty()) {
+  std::vector<tsuba::PropStorageInfo> next_properties = prop_info;
+  for (size_t i = 0, n = next_properties.size(); i < n; ++i) {
+    tsuba::PropStorageInfo& info = next_properties[i];
+    if (!info.persist) {
       continue;
     }
-    auto name = prop_info[i].name.empty() ? schema->field(i)->name()
-                                          : prop_info[i].name;
-    auto name_res = StoreArrowArrayAtName(props.column(i), dir, name, desc);
+    auto name = info.name.empty() ? schema->field(i)->name() : info.name;
+
+    if (!info.path.empty()) {
+      if (info.dirty_rows.empty()) {
+        continue;
+      }
+      if (info.delta_paths.size() < tsuba::kMaxPropertyDeltas) {
+        auto name_res = StoreDeltaAtName(
+            props.column(i), info.dirty_rows, dir, name, desc, opts);
+        if (!name_res) {
+          return name_res.error().WithContext("storing property delta");
+        }
+        info.delta_paths.emplace_back(std::move(name_res.value()));
+        info.dirty_rows.clear();
+        continue;
+      }
+      // every delta is applied on load; compact them into a new file
+      info.Unbind();
+    }
+
+    auto name_res =
+        info.format == tsuba::PropertyFileFormat::kArrowIpc
+            ? StoreArrowIpcAtName(props.column(i), dir, name, desc)
+            : StoreArrowArrayAtName(props.column(i), dir, name, desc, opts);
     if (!name_res) {
       return name_res.error().WithContext("storing arrow array");
     }
-    next_paths.emplace_back(name_res.value());
+    info.path = std::move(name_res.value());
   }
   TSUBA_PTP(tsuba::internal::FaultSensitivity::Normal);
 
-  if (next_paths.empty()) {
-    return prop_info;
-  }
-
-  std::vector<tsuba::PropStorageInfo> next_properties = prop_info;
-  auto it = next_paths.begin();
-  for (auto& v : next_properties) {
-    if (v.persist && v.path.empty()) {
-      v.path = *it++;
-    }
-  }
-
   return next_properties;
 }
 
@@ -186,6 +294,118 @@ AddEdgePropStorageInfo(
   }
 }
 
+/// \returns the sorted rows in which new_col differs from old_col or
+/// std::nullopt if the columns cannot be compared row by row
+std::optional<std::vector<uint64_t>>
+ChangedRows(
+    const std::shared_ptr<arrow::ChunkedArray>& old_col,
+    const std::shared_ptr<arrow::ChunkedArray>& new_col) {
+  if (!old_col || old_col->length() != new_col->length() ||
+      !old_col->type()->Equals(new_col->type())) {
+    return std::nullopt;
+  }
+
+  // not_equal is null where either side is null, so compare validity too
+  auto not_equal_res =
+      arrow::compute::CallFunction("not_equal", {old_col, new_col});
+  auto old_null_res = arrow::compute::IsNull(old_col);
+  auto new_null_res = arrow::compute::IsNull(new_col);
+  if (!not_equal_res.ok() || !old_null_res.ok() || !new_null_res.ok()) {
+    // e.g., nested types have no comparison kernel
+    return std::nullopt;
+  }
+
+  std::vector<arrow::Datum> results{
+      not_equal_res.ValueOrDie(), old_null_res.ValueOrDie(),
+      new_null_res.ValueOrDie()};
+  std::vector<std::shared_ptr<arrow::BooleanArray>> flags;
+  for (const arrow::Datum& result : results) {
+    auto concat_res = arrow::Concatenate(result.chunked_array()->chunks());
+    if (!concat_res.ok()) {
+      return std::nullopt;
+    }
+    flags.emplace_back(std::static_pointer_cast<arrow::BooleanArray>(
+        concat_res.ValueOrDie()));
+  }
+  const auto& not_equal = *flags[0];
+  const auto& old_null = *flags[1];
+  const auto& new_null = *flags[2];
+
+  std::vector<uint64_t> rows;
+  for (int64_t i = 0, n = old_col->length(); i < n; ++i) {
+    if ((not_equal.IsValid(i) && not_equal.Value(i)) ||
+        old_null.Value(i) != new_null.Value(i)) {
+      rows.emplace_back(i);
+    }
+  }
+  return rows;
+}
+
+/// Update the storage info of the properties in props, which replace columns
+/// of old_props. Stored properties of which only a few rows changed keep
+/// their files and just record the changed rows so that the next store
+/// writes a delta; everything else is rewritten in full.
+std::vector<tsuba::PropStorageInfo>
+UpsertPropStorageInfo(
+    const arrow::Table& old_props, const arrow::Table& props,
+    std::vector<tsuba::PropStorageInfo> prop_info_list) {
+  const auto& schema = props.schema();
+  for (int i = 0, end = props.num_columns(); i < end; ++i) {
+    const std::string& name = schema->field(i)->name();
+    auto info_it = std::find_if(
+        prop_info_list.begin(), prop_info_list.end(),
+        [&](const tsuba::PropStorageInfo& info) { return info.name == name; });
+    if (info_it == prop_info_list.end()) {
+      prop_info_list.emplace_back(tsuba::PropStorageInfo{
+          .name = name,
+          .path = "",
+      });
+      continue;
+    }
+    if (info_it->path.empty()) {
+      continue;
+    }
+
+    auto rows = ChangedRows(old_props.GetColumnByName(name), props.column(i));
+    if (!rows) {
+      info_it->Unbind();
+      continue;
+    }
+    std::vector<uint64_t> dirty_rows;
+    std::set_union(
+        info_it->dirty_rows.begin(), info_it->dirty_rows.end(),
+        rows->begin(), rows->end(), std::back_inserter(dirty_rows));
+    if (dirty_rows.size() * tsuba::kMaxDeltaFraction >
+        static_cast<uint64_t>(props.num_rows())) {
+      // a delta would not be much smaller than the property
+      info_it->Unbind();
+      continue;
+    }
+    info_it->dirty_rows = std::move(dirty_rows);
+  }
+  return prop_info_list;
+}
+
+/// Drop the cached graph statistics summaries, under key, of the columns of
+/// props, which are being replaced. The topology statistics and the
+/// summaries of other columns stay valid.
+void
+ForgetColumnSummaries(
+    tsuba::RDG* rdg, const char* key, const arrow::Table& props) {
+  nlohmann::json stats = rdg->graph_stats();
+  if (!stats.is_object()) {
+    return;
+  }
+  auto it = stats.find(key);
+  if (it == stats.end() || !it->is_object()) {
+    return;
+  }
+  for (const auto& field : props.schema()->fields()) {
+    it->erase(field->name());
+  }
+  rdg->set_graph_stats(std::move(stats));
+}
+
 }  // namespace
 
 katana::Result<void>
@@ -312,6 +532,7 @@ tsuba::RDG::WritePartArrays(const katana::Uri& dir, tsuba::WriteGroup* desc) {
 katana::Result<void>
 tsuba::RDG::DoStore(
     RDGHandle handle, const std::string& command_line,
+    const ParquetWriter::WriteOpts& opts,
     std::unique_ptr<WriteGroup> write_group) {
   if (core_->part_header().topology_path().empty()) {
     // No topology file; create one
@@ -329,7 +550,7 @@ tsuba::RDG::DoStore(
 
   auto node_write_result = WriteProperties(
       *core_->node_properties(), core_->part_header().node_prop_info_list(),
-      handle.impl_->rdg_meta().dir(), write_group.get());
+      handle.impl_->rdg_meta().dir(), opts, write_group.get());
   if (!node_write_result) {
     return node_write_result.error().WithContext(
         "failed to write node properties");
@@ -341,7 +562,7 @@ tsuba::RDG::DoStore(
 
   auto edge_write_result = WriteProperties(
       *core_->edge_properties(), core_->part_header().edge_prop_info_list(),
-      handle.impl_->rdg_meta().dir(), write_group.get());
+      handle.impl_->rdg_meta().dir(), opts, write_group.get());
   if (!edge_write_result) {
     return edge_write_result.error().WithContext(
         "failed to write edge properties");
@@ -423,6 +644,9 @@ tsuba::RDG::DoMake(const katana::Uri& metadata_dir) {
       // NB: this is a zero-copy slice, so the underlying data is shared
       set_local_to_user_id(local_to_global_id_->Slice(0));
     } else if (
+        // unpartitioned graphs carry user IDs (e.g., from import) but no
+        // global IDs or masters
+        local_to_global_id_->length() != 0 &&
         local_to_user_id_->length() !=
         (core_->part_header().metadata().num_owned_ +
          local_to_global_id_->length())) {
@@ -510,7 +734,7 @@ tsuba::RDG::Make(RDGHandle handle, const RDGLoadOptions& opts) {
 katana::Result<void>
 tsuba::RDG::Store(
     RDGHandle handle, const std::string& command_line,
-    std::unique_ptr<FileFrame> ff) {
+    std::unique_ptr<FileFrame> ff, const ParquetWriter::WriteOpts& opts) {
   if (!handle.impl_->AllowsWrite()) {
     return KATANA_ERROR(
         ErrorCode::InvalidArgument, "handle does not allow write");
@@ -544,7 +768,7 @@ tsuba::RDG::Store(
     core_->part_header().set_topology_path(t_path.BaseName());
   }
 
-  return DoStore(handle, command_line, std::move(desc));
+  return DoStore(handle, command_line, opts, std::move(desc));
 }
 
 katana::Result<void>
@@ -579,11 +803,14 @@ tsuba::RDG::AddEdgeProperties(const std::shared_ptr<arrow::Table>& props) {
 
 katana::Result<void>
 tsuba::RDG::UpsertNodeProperties(const std::shared_ptr<arrow::Table>& props) {
+  std::shared_ptr<arrow::Table> old_props = core_->node_properties();
   if (auto res = core_->UpsertNodeProperties(props); !res) {
     return res.error();
   }
 
-  AddNodePropStorageInfo(core_.get(), props);
+  ForgetColumnSummaries(this, "node_columns", *props);
+  core_->part_header().set_node_prop_info_list(UpsertPropStorageInfo(
+      *old_props, *props, core_->part_header().node_prop_info_list()));
 
   KATANA_LOG_DEBUG_ASSERT(
       static_cast<size_t>(core_->node_properties()->num_columns()) ==
@@ -594,11 +821,14 @@ tsuba::RDG::UpsertNodeProperties(const std::shared_ptr<arrow::Table>& props) {
 
 katana::Result<void>
 tsuba::RDG::UpsertEdgeProperties(const std::shared_ptr<arrow::Table>& props) {
+  std::shared_ptr<arrow::Table> old_props = core_->edge_properties();
   if (auto res = core_->UpsertEdgeProperties(props); !res) {
     return res.error();
   }
 
-  AddEdgePropStorageInfo(core_.get(), props);
+  ForgetColumnSummaries(this, "edge_columns", *props);
+  core_->part_header().set_edge_prop_info_list(UpsertPropStorageInfo(
+      *old_props, *props, core_->part_header().edge_prop_info_list()));
 
   KATANA_LOG_DEBUG_ASSERT(
       static_cast<size_t>(core_->edge_properties()->num_columns()) ==
@@ -634,6 +864,23 @@ tsuba::RDG::MarkEdgePropertiesPersistent(
   return core_->part_header().MarkEdgePropertiesPersistent(persist_edge_props);
 }
 
+katana::Result<void>
+tsuba::RDG::SetNodePropertiesFileFormat(
+    const std::vector<std::string>& node_props, PropertyFileFormat format) {
+  return core_->part_header().SetNodePropertiesFileFormat(node_props, format);
+}
+
+katana::Result<void>
+tsuba::RDG::SetEdgePropertiesFileFormat(
+    const std::vector<std::string>& edge_props, PropertyFileFormat format) {
+  return core_->part_header().SetEdgePropertiesFileFormat(edge_props, format);
+}
+
+void
+tsuba::RDG::CompactProperties() {
+  core_->part_header().CompactProperties();
+}
+
 const tsuba::PartitionMetadata&
 tsuba::RDG::part_metadata() const {
   return core_->part_header().metadata();
@@ -644,6 +891,16 @@ tsuba::RDG::set_part_metadata(const tsuba::PartitionMetadata& metadata) {
   core_->part_header().set_metadata(metadata);
 }
 
+const nlohmann::json&
+tsuba::RDG::graph_stats() const {
+  return core_->part_header().graph_stats();
+}
+
+void
+tsuba::RDG::set_graph_stats(nlohmann::json stats) {
+  core_->part_header().set_graph_stats(std::move(stats));
+}
+
 const std::shared_ptr<arrow::Table>&
 tsuba::RDG::node_properties() const {
   return core_->node_properties();
@@ -661,6 +918,8 @@ tsuba::RDG::topology_file_storage() const {
 
 katana::Result<void>
 tsuba::RDG::UnbindTopologyFileStorage() {
+  // the topology is about to be replaced
+  set_graph_stats(nullptr);
   return core_->topology_file_storage().Unbind();
 }
 
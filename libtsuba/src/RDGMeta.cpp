@@ -143,9 +143,13 @@ RDGMeta::FileNames() {
       auto header = std::move(header_res.value());
       for (const auto& node_prop : header.node_prop_info_list()) {
         fnames.emplace(node_prop.path);
+        fnames.insert(
+            node_prop.delta_paths.begin(), node_prop.delta_paths.end());
       }
       for (const auto& edge_prop : header.edge_prop_info_list()) {
         fnames.emplace(edge_prop.path);
+        fnames.insert(
+            edge_prop.delta_paths.begin(), edge_prop.delta_paths.end());
       }
       for (const auto& part_prop : header.part_prop_info_list()) {
         fnames.emplace(part_prop.path);
@@ -27,6 +27,10 @@ const char* kNodePropertyKey = "kg.v1.node_property";
 const char* kEdgePropertyKey = "kg.v1.edge_property";
 const char* kPartPropertyFilesKey = "kg.v1.part_property_files";
 const char* kPartProperyMetaKey = "kg.v1.part_property_meta";
+const char* kGraphStatsKey = "kg.v1.graph_stats";
+
+const char* kParquetFormatName = "parquet";
+const char* kArrowIpcFormatName = "arrow-ipc";
 //
 //constexpr std::string_view  mirror_nodes_prop_name = "mirror_nodes";
 //constexpr std::string_view  master_nodes_prop_name = "master_nodes";
@@ -66,6 +70,27 @@ MakeProperties(std::vector<std::string>&& values) {
   return prop_info_list;
 }
 
+katana::Result<void>
+SetPropertiesFileFormat(
+    const std::vector<std::string>& names, tsuba::PropertyFileFormat format,
+    std::vector<tsuba::PropStorageInfo>* prop_info_list) {
+  for (const std::string& name : names) {
+    auto it = std::find_if(
+        prop_info_list->begin(), prop_info_list->end(),
+        [&](const tsuba::PropStorageInfo& pmd) { return pmd.name == name; });
+    if (it == prop_info_list->end()) {
+      return KATANA_ERROR(
+          tsuba::ErrorCode::PropertyNotFound, "property {} not found", name);
+    }
+    if (it->format != format) {
+      it->format = format;
+      // clear the path so that the property is rewritten in the new format
+      it->Unbind();
+    }
+  }
+  return katana::ResultSuccess();
+}
+
 }  // namespace
 
 namespace tsuba {
@@ -332,7 +357,7 @@ RDGPartHeader::MarkNodePropertiesPersistent(
   for (uint32_t i = 0; i < persist_node_props.size(); ++i) {
     if (!persist_node_props[i].empty()) {
       node_prop_info_list_[i].name = persist_node_props[i];
-      node_prop_info_list_[i].path = "";
+      node_prop_info_list_[i].Unbind();
       node_prop_info_list_[i].persist = true;
       KATANA_LOG_DEBUG("node persist {}", node_prop_info_list_[i].name);
     }
@@ -352,7 +377,7 @@ RDGPartHeader::MarkEdgePropertiesPersistent(
   for (uint32_t i = 0; i < persist_edge_props.size(); ++i) {
     if (!persist_edge_props[i].empty()) {
       edge_prop_info_list_[i].name = persist_edge_props[i];
-      edge_prop_info_list_[i].path = "";
+      edge_prop_info_list_[i].Unbind();
       edge_prop_info_list_[i].persist = true;
       KATANA_LOG_DEBUG("edge persist {}", edge_prop_info_list_[i].name);
     }
@@ -360,16 +385,39 @@ RDGPartHeader::MarkEdgePropertiesPersistent(
   return katana::ResultSuccess();
 }
 
+katana::Result<void>
+RDGPartHeader::SetNodePropertiesFileFormat(
+    const std::vector<std::string>& node_props, PropertyFileFormat format) {
+  return SetPropertiesFileFormat(node_props, format, &node_prop_info_list_);
+}
+
+katana::Result<void>
+RDGPartHeader::SetEdgePropertiesFileFormat(
+    const std::vector<std::string>& edge_props, PropertyFileFormat format) {
+  return SetPropertiesFileFormat(edge_props, format, &edge_prop_info_list_);
+}
+
+void
+RDGPartHeader::CompactProperties() {
+  for (auto* list : {&node_prop_info_list_, &edge_prop_info_list_}) {
+    for (PropStorageInfo& prop : *list) {
+      if (!prop.delta_paths.empty()) {
+        prop.Unbind();
+      }
+    }
+  }
+}
+
 void
 RDGPartHeader::UnbindFromStorage() {
   for (PropStorageInfo& prop : node_prop_info_list_) {
-    prop.path = "";
+    prop.Unbind();
   }
   for (PropStorageInfo& prop : edge_prop_info_list_) {
-    prop.path = "";
+    prop.Unbind();
   }
   for (PropStorageInfo& prop : part_prop_info_list_) {
-    prop.path = "";
+    prop.Unbind();
   }
   topology_path_ = "";
 }
@@ -396,6 +444,10 @@ tsuba::to_json(json& j, const tsuba::RDGPartHeader& header) {
       {kPartPropertyFilesKey, header.part_prop_info_list_},
       {kPartProperyMetaKey, header.metadata_},
   };
+  // optional so that older readers ignore it
+  if (!header.graph_stats_.is_null()) {
+    j[kGraphStatsKey] = header.graph_stats_;
+  }
 }
 
 void
@@ -405,6 +457,11 @@ tsuba::from_json(const json& j, tsuba::RDGPartHeader& header) {
   j.at(kEdgePropertyKey).get_to(header.edge_prop_info_list_);
   j.at(kPartPropertyFilesKey).get_to(header.part_prop_info_list_);
   j.at(kPartProperyMetaKey).get_to(header.metadata_);
+  if (auto it = j.find(kGraphStatsKey); it != j.end()) {
+    header.graph_stats_ = *it;
+  } else {
+    header.graph_stats_ = nullptr;
+  }
 }
 
 void
@@ -451,16 +508,45 @@ tsuba::from_json(const json& j, tsuba::PartitionMetadata& pmd) {
   }
 }
 
+// Parquet properties are stored as [name, path] so that older readers can
+// still load them; other formats append the format name and properties with
+// deltas append the format name and then the list of delta files. Readers
+// that do not know about deltas fail on the format name instead of silently
+// loading stale values.
 void
 tsuba::from_json(const nlohmann::json& j, tsuba::PropStorageInfo& propmd) {
   j.at(0).get_to(propmd.name);
   j.at(1).get_to(propmd.path);
+  propmd.format = PropertyFileFormat::kParquet;
+  if (j.size() > 2) {
+    std::string format;
+    j.at(2).get_to(format);
+    if (format == kArrowIpcFormatName) {
+      propmd.format = PropertyFileFormat::kArrowIpc;
+    } else if (format != kParquetFormatName) {
+      // nlohmann::json reports errors using exceptions
+      throw std::runtime_error("unknown property file format " + format);
+    }
+  }
+  propmd.delta_paths.clear();
+  if (j.size() > 3) {
+    j.at(3).get_to(propmd.delta_paths);
+  }
 }
 
 void
 tsuba::to_json(json& j, const tsuba::PropStorageInfo& propmd) {
   if (propmd.persist) {
     j = json{propmd.name, propmd.path};
+    if (propmd.format == PropertyFileFormat::kArrowIpc ||
+        !propmd.delta_paths.empty()) {
+      j.push_back(
+          propmd.format == PropertyFileFormat::kArrowIpc ? kArrowIpcFormatName
+                                                         : kParquetFormatName);
+    }
+    if (!propmd.delta_paths.empty()) {
+      j.push_back(propmd.delta_paths);
+    }
   }
   // creates a null value if property wasn't supposed to be persisted
 }
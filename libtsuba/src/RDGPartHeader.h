@@ -10,6 +10,7 @@
 #include "katana/Result.h"
 #include "katana/Uri.h"
 #include "tsuba/PartitionMetadata.h"
+#include "tsuba/RDG.h"
 #include "tsuba/WriteGroup.h"
 #include "tsuba/tsuba.h"
 
@@ -19,6 +20,20 @@ struct PropStorageInfo {
   std::string name;
   std::string path;
   bool persist{false};
+  PropertyFileFormat format{PropertyFileFormat::kParquet};
+  /// Parquet files of (row, value) pairs that replace rows of the file at
+  /// path, oldest first
+  std::vector<std::string> delta_paths{};
+  /// Sorted rows that changed since the property was stored; not persisted
+  std::vector<uint64_t> dirty_rows{};
+
+  /// Forget the stored copy of the property so that the next store rewrites
+  /// all of it
+  void Unbind() {
+    path.clear();
+    delta_paths.clear();
+    dirty_rows.clear();
+  }
 };
 
 class KATANA_EXPORT RDGPartHeader {
@@ -47,7 +62,7 @@ public:
       node_prop_info_list_.emplace_back(std::move(pmd));
     } else {
       // If we already have a record, clear the path so we will rewrite it
-      pmd_it->path = "";
+      pmd_it->Unbind();
     }
   }
 
@@ -59,7 +74,7 @@ public:
       edge_prop_info_list_.emplace_back(std::move(pmd));
     } else {
       // If we already have a record, clear the path so we will rewrite it
-      pmd_it->path = "";
+      pmd_it->Unbind();
     }
   }
 
@@ -87,6 +102,20 @@ public:
   katana::Result<void> MarkEdgePropertiesPersistent(
       const std::vector<std::string>& persist_edge_props);
 
+  //
+  // Property storage format
+  //
+
+  katana::Result<void> SetNodePropertiesFileFormat(
+      const std::vector<std::string>& node_props, PropertyFileFormat format);
+
+  katana::Result<void> SetEdgePropertiesFileFormat(
+      const std::vector<std::string>& edge_props, PropertyFileFormat format);
+
+  /// Schedule every property stored as a base file plus deltas to be
+  /// rewritten as a single file by the next store
+  void CompactProperties();
+
   //
   // Accessors/Mutators
   //
@@ -120,6 +149,11 @@ public:
   const PartitionMetadata& metadata() const { return metadata_; }
   void set_metadata(const PartitionMetadata& metadata) { metadata_ = metadata; }
 
+  const nlohmann::json& graph_stats() const { return graph_stats_; }
+  void set_graph_stats(nlohmann::json graph_stats) {
+    graph_stats_ = std::move(graph_stats);
+  }
+
   friend void to_json(nlohmann::json& j, const RDGPartHeader& header);
   friend void from_json(const nlohmann::json& j, RDGPartHeader& header);
 
@@ -137,6 +171,11 @@ private:
   PartitionMetadata metadata_;
 
   std::string topology_path_;
+
+  /// Summary statistics of the graph computed by libgalois; null if they
+  /// have not been computed since the topology last changed or existing
+  /// properties were last upserted
+  nlohmann::json graph_stats_;
 };
 
 void to_json(nlohmann::json& j, const RDGPartHeader& header);
@@ -63,10 +63,36 @@ static cll::opt<BetweennessCentralityPlan::Algorithm> algo(
         // clEnumValN(BetweennessCentralityPlan::kAsynchronous, "Async", "Asynchronous"),
         clEnumValN(
             BetweennessCentralityPlan::kOuter, "Outer",
-            "Outer parallel algorithm")
+            "Outer parallel algorithm"),
+        clEnumValN(
+            BetweennessCentralityPlan::kAdaptiveSampling, "AdaptiveSampling",
+            "Approximate with adaptively sampled shortest paths; source "
+            "options are ignored"),
+        clEnumValN(
+            BetweennessCentralityPlan::kBatched, "Batched",
+            "Level parallel algorithm over batches of sources")
         // clEnumValN(BetweennessCentralityPlan::kAutoAlgo, "Auto", "Auto: choose among the algorithms automatically")
         ),
     cll::init(BetweennessCentralityPlan::kLevel));
+static cll::opt<double> epsilon(
+    "epsilon",
+    cll::desc("Maximum error of the normalized centrality for "
+              "AdaptiveSampling (default value 0.01)"),
+    cll::init(BetweennessCentralityPlan::kDefaultEpsilon));
+static cll::opt<double> failureProbability(
+    "failureProbability",
+    cll::desc("Probability that the error exceeds -epsilon for "
+              "AdaptiveSampling (default value 0.1)"),
+    cll::init(BetweennessCentralityPlan::kDefaultFailureProbability));
+static cll::opt<uint64_t> seed(
+    "seed", cll::desc("Seed of the sampler for AdaptiveSampling (default "
+                      "value 0)"),
+    cll::init(BetweennessCentralityPlan::kDefaultSeed));
+static cll::opt<uint32_t> batchSize(
+    "batchSize",
+    cll::desc("Number of sources traversed together by Batched (default "
+              "value 16, maximum 64)"),
+    cll::init(BetweennessCentralityPlan::kDefaultBatchSize));
 
 ////////////////////////////////////////////////////////////////////////////////
 
@@ -89,8 +115,18 @@ main(int argc, char** argv) {
   std::unique_ptr<katana::PropertyGraph> pg =
       MakeFileGraph(inputFile, edge_property_name);
 
-  BetweennessCentralityPlan plan =
-      BetweennessCentralityPlan::FromAlgorithm(algo);
+  BetweennessCentralityPlan plan;
+  switch (algo) {
+  case BetweennessCentralityPlan::kAdaptiveSampling:
+    plan = BetweennessCentralityPlan::AdaptiveSampling(
+        epsilon, failureProbability, seed);
+    break;
+  case BetweennessCentralityPlan::kBatched:
+    plan = BetweennessCentralityPlan::Batched(batchSize);
+    break;
+  default:
+    plan = BetweennessCentralityPlan::FromAlgorithm(algo);
+  }
 
   BetweennessCentralitySources sources = kBetweennessCentralityAllNodes;
   uint32_t num_sources = pg->num_nodes();
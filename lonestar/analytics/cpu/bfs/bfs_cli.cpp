@@ -54,6 +54,12 @@ static cll::opt<unsigned int> reportNode(
     "reportNode", cll::desc("Node to report distance to (default value 1)"),
     cll::init(1));
 
+static cll::opt<bool> userIds(
+    "userIds",
+    cll::desc("Flag to indicate that -startNodes, -startNodesFile and "
+              "-reportNode give user IDs, i.e., the IDs nodes had in the "
+              "input the graph was imported from (default value false)"),
+    cll::init(false));
 static cll::opt<bool> persistAllDistances(
     "persistAllDistances",
     cll::desc(
@@ -105,27 +111,34 @@ main(int argc, char** argv) {
 
   std::cout << "Running " << AlgorithmName(algo) << "\n";
 
-  if (reportNode >= pg->topology().num_nodes()) {
-    KATANA_LOG_FATAL("failed to set report: {}", reportNode);
+  uint32_t report_node = reportNode;
+  if (userIds) {
+    report_node = UserIdsToNodes(*pg, {reportNode}).front();
+  }
+  if (report_node >= pg->topology().num_nodes()) {
+    KATANA_LOG_FATAL("failed to set report: {}", report_node);
   }
 
   katana::reportPageAlloc("MeminfoPre");
 
-  std::vector<uint32_t> startNodes;
+  std::vector<uint64_t> startIds;
   if (!startNodesFile.getValue().empty()) {
     std::ifstream file(startNodesFile);
     if (!file.good()) {
       KATANA_LOG_FATAL("failed to open file: {}", startNodesFile);
     }
-    startNodes.insert(
-        startNodes.end(), std::istream_iterator<uint32_t>{file},
-        std::istream_iterator<uint32_t>{});
+    startIds.insert(
+        startIds.end(), std::istream_iterator<uint64_t>{file},
+        std::istream_iterator<uint64_t>{});
   } else {
     std::istringstream str(startNodesString);
-    startNodes.insert(
-        startNodes.end(), std::istream_iterator<uint32_t>{str},
-        std::istream_iterator<uint32_t>{});
+    startIds.insert(
+        startIds.end(), std::istream_iterator<uint64_t>{str},
+        std::istream_iterator<uint64_t>{});
   }
+  std::vector<uint32_t> startNodes =
+      userIds ? UserIdsToNodes(*pg, startIds)
+              : std::vector<uint32_t>(startIds.begin(), startIds.end());
   uint32_t num_sources = startNodes.size();
   std::cout << "Running BFS for " << num_sources << " sources\n";
 
@@ -163,8 +176,8 @@ main(int argc, char** argv) {
     }
     auto results = r.value();
 
-    std::cout << "Node " << reportNode << " has distance "
-              << results->Value(reportNode) << "\n";
+    std::cout << "Node " << report_node << " has distance "
+              << results->Value(report_node) << "\n";
 
     auto stats_result = BfsStatistics::Compute(pg.get(), node_distance_prop);
     if (!stats_result) {
@@ -0,0 +1,154 @@
+/*
+ * This file belongs to the Galois project, a C++ library for exploiting
+ * parallelism. The code is being released under the terms of the 3-Clause BSD
+ * License (a copy is located in LICENSE.txt at the top-level directory).
+ *
+ * Copyright (C) 2018, The University of Texas at Austin. All rights reserved.
+ * UNIVERSITY EXPRESSLY DISCLAIMS ANY AND ALL WARRANTIES CONCERNING THIS
+ * SOFTWARE AND DOCUMENTATION, INCLUDING ANY WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR ANY PARTICULAR PURPOSE, NON-INFRINGEMENT AND WARRANTIES OF
+ * PERFORMANCE, AND ANY WARRANTY THAT MIGHT OTHERWISE ARISE FROM COURSE OF
+ * DEALING OR USAGE OF TRADE.  NO WARRANTY IS EITHER EXPRESS OR IMPLIED WITH
+ * RESPECT TO THE USE OF THE SOFTWARE OR DOCUMENTATION. Under no circumstances
+ * shall University be liable for incidental, special, indirect, direct or
+ * consequential damages or loss of profits, interruption of business, or
+ * related expenses which may arise from use of Software or Documentation,
+ * including but not limited to those resulting from defects in Software and/or
+ * Documentation, or loss or inaccuracy of data of any kind.
+ */
+
+#include <iostream>
+
+#include <katana/analytics/closeness_centrality/closeness_centrality.h>
+
+#include "Lonestar/BoilerPlate.h"
+
+using namespace katana::analytics;
+
+namespace cll = llvm::cl;
+
+static const char* name = "Closeness Centrality";
+
+static const char* desc =
+    "Computes the closeness or harmonic centrality of every node in an "
+    "unweighted graph";
+
+static const char* url = "closeness_centrality";
+
+static cll::opt<std::string> inputFile(
+    cll::Positional, cll::desc("<input file>"), cll::Required);
+
+static cll::opt<bool> harmonic(
+    "harmonic",
+    cll::desc("Compute harmonic instead of closeness centrality (default "
+              "false)"),
+    cll::init(false));
+
+static cll::opt<uint32_t> numSamples(
+    "numSamples",
+    cll::desc("Number of BFS sources for Sampled (default value 256)"),
+    cll::init(ClosenessCentralityPlan::kDefaultNumSamples));
+
+static cll::opt<uint32_t> log2Registers(
+    "log2Registers",
+    cll::desc("log2 of the number of HyperLogLog registers per node for "
+              "HyperBall (default value 6)"),
+    cll::init(ClosenessCentralityPlan::kDefaultLog2Registers));
+
+static cll::opt<uint64_t> seed(
+    "seed", cll::desc("Seed for Sampled and HyperBall (default 0)"),
+    cll::init(ClosenessCentralityPlan::kDefaultSeed));
+
+static cll::opt<ClosenessCentralityPlan::Algorithm> algo(
+    "algo", cll::desc("Choose an algorithm (default value Exact):"),
+    cll::values(
+        clEnumValN(
+            ClosenessCentralityPlan::kExact, "Exact",
+            "Multi-source BFS out of every node"),
+        clEnumValN(
+            ClosenessCentralityPlan::kSampled, "Sampled",
+            "Estimate from BFSs out of random sources"),
+        clEnumValN(
+            ClosenessCentralityPlan::kHyperBall, "HyperBall",
+            "Estimate from HyperLogLog neighborhood functions")),
+    cll::init(ClosenessCentralityPlan::kExact));
+
+std::string
+AlgorithmName(ClosenessCentralityPlan::Algorithm algorithm) {
+  switch (algorithm) {
+  case ClosenessCentralityPlan::kExact:
+    return "Exact";
+  case ClosenessCentralityPlan::kSampled:
+    return "Sampled";
+  case ClosenessCentralityPlan::kHyperBall:
+    return "HyperBall";
+  default:
+    return "Unknown";
+  }
+}
+
+int
+main(int argc, char** argv) {
+  std::unique_ptr<katana::SharedMemSys> G =
+      LonestarStart(argc, argv, name, desc, url, &inputFile);
+
+  katana::StatTimer totalTime("TimerTotal");
+  totalTime.start();
+
+  std::cout << "Reading from file: " << inputFile << "\n";
+  std::unique_ptr<katana::PropertyGraph> pg =
+      MakeFileGraph(inputFile, edge_property_name);
+
+  std::cout << "Read " << pg->topology().num_nodes() << " nodes, "
+            << pg->topology().num_edges() << " edges\n";
+
+  std::cout << "Running " << AlgorithmName(algo) << " algorithm\n";
+
+  ClosenessCentralityPlan plan = ClosenessCentralityPlan();
+  switch (algo) {
+  case ClosenessCentralityPlan::kExact:
+    plan = ClosenessCentralityPlan::Exact();
+    break;
+  case ClosenessCentralityPlan::kSampled:
+    plan = ClosenessCentralityPlan::Sampled(numSamples, seed);
+    break;
+  case ClosenessCentralityPlan::kHyperBall:
+    plan = ClosenessCentralityPlan::HyperBall(log2Registers, seed);
+    break;
+  default:
+    KATANA_LOG_FATAL("invalid algorithm");
+  }
+
+  const std::string output_property_name =
+      harmonic ? "harmonic_centrality" : "closeness_centrality";
+  auto r = harmonic ? HarmonicCentrality(pg.get(), output_property_name, plan)
+                    : ClosenessCentrality(pg.get(), output_property_name, plan);
+  if (!r) {
+    KATANA_LOG_FATAL("Failed to run algorithm: {}", r.error());
+  }
+
+  auto stats_result =
+      ClosenessCentralityStatistics::Compute(pg.get(), output_property_name);
+  if (!stats_result) {
+    KATANA_LOG_FATAL("Failed to compute statistics: {}", stats_result.error());
+  }
+  auto stats = stats_result.value();
+  stats.Print();
+
+  if (output) {
+    auto results_result =
+        pg->GetNodePropertyTyped<double>(output_property_name);
+    if (!results_result) {
+      KATANA_LOG_FATAL("Failed to get results: {}", results_result.error());
+    }
+    auto results = results_result.value();
+    KATANA_LOG_DEBUG_ASSERT(
+        uint64_t(results->length()) == pg->topology().num_nodes());
+
+    writeOutput(outputLocation, results->raw_values(), results->length());
+  }
+
+  totalTime.stop();
+
+  return 0;
+}
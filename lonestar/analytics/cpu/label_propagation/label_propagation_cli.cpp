@@ -0,0 +1,147 @@
+/*
+ * This file belongs to the Galois project, a C++ library for exploiting
+ * parallelism. The code is being released under the terms of the 3-Clause BSD
+ * License (a copy is located in LICENSE.txt at the top-level directory).
+ *
+ * Copyright (C) 2018, The University of Texas at Austin. All rights reserved.
+ * UNIVERSITY EXPRESSLY DISCLAIMS ANY AND ALL WARRANTIES CONCERNING THIS
+ * SOFTWARE AND DOCUMENTATION, INCLUDING ANY WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR ANY PARTICULAR PURPOSE, NON-INFRINGEMENT AND WARRANTIES OF
+ * PERFORMANCE, AND ANY WARRANTY THAT MIGHT OTHERWISE ARISE FROM COURSE OF
+ * DEALING OR USAGE OF TRADE.  NO WARRANTY IS EITHER EXPRESS OR IMPLIED WITH
+ * RESPECT TO THE USE OF THE SOFTWARE OR DOCUMENTATION. Under no circumstances
+ * shall University be liable for incidental, special, indirect, direct or
+ * consequential damages or loss of profits, interruption of business, or
+ * related expenses which may arise from use of Software or Documentation,
+ * including but not limited to those resulting from defects in Software and/or
+ * Documentation, or loss or inaccuracy of data of any kind.
+ */
+
+#include <iostream>
+
+#include <katana/analytics/label_propagation/label_propagation.h>
+
+#include "Lonestar/BoilerPlate.h"
+
+using namespace katana::analytics;
+
+namespace cll = llvm::cl;
+
+static const char* name = "Label Propagation";
+
+static const char* desc =
+    "Computes communities in the graph using the label propagation algorithm";
+
+static const char* url = "label_propagation";
+
+static cll::opt<std::string> inputFile(
+    cll::Positional, cll::desc("<input file>"), cll::Required);
+
+static cll::opt<uint32_t> max_iterations(
+    "max_iterations",
+    cll::desc("Maximum number of rounds to execute (default value 20)"),
+    cll::init(LabelPropagationPlan::kMaxIterations));
+
+static cll::opt<uint64_t> seed(
+    "seed", cll::desc("Seed used to break ties between labels (default 0)"),
+    cll::init(LabelPropagationPlan::kDefaultSeed));
+
+static cll::opt<LabelPropagationPlan::Algorithm> algo(
+    "algo", cll::desc("Choose an algorithm (default value Asynchronous):"),
+    cll::values(
+        clEnumValN(
+            LabelPropagationPlan::kSynchronous, "Synchronous",
+            "Synchronous rounds over all nodes"),
+        clEnumValN(
+            LabelPropagationPlan::kAsynchronous, "Asynchronous",
+            "In-place updates over a frontier of changed neighborhoods")),
+    cll::init(LabelPropagationPlan::kAsynchronous));
+
+std::string
+AlgorithmName(LabelPropagationPlan::Algorithm algorithm) {
+  switch (algorithm) {
+  case LabelPropagationPlan::kSynchronous:
+    return "Synchronous";
+  case LabelPropagationPlan::kAsynchronous:
+    return "Asynchronous";
+  default:
+    return "Unknown";
+  }
+}
+
+int
+main(int argc, char** argv) {
+  std::unique_ptr<katana::SharedMemSys> G =
+      LonestarStart(argc, argv, name, desc, url, &inputFile);
+
+  katana::StatTimer totalTime("TimerTotal");
+  totalTime.start();
+
+  if (!symmetricGraph) {
+    KATANA_LOG_FATAL(
+        "This application requires a symmetric graph input;"
+        " please use the -symmetricGraph flag "
+        " to indicate the input is a symmetric graph.");
+  }
+
+  std::cout << "Reading from file: " << inputFile << "\n";
+  std::unique_ptr<katana::PropertyGraph> pg =
+      MakeFileGraph(inputFile, edge_property_name);
+
+  std::cout << "Read " << pg->topology().num_nodes() << " nodes, "
+            << pg->topology().num_edges() << " edges\n";
+
+  std::cout << "Running " << AlgorithmName(algo) << " algorithm\n";
+
+  LabelPropagationPlan plan = LabelPropagationPlan();
+  switch (algo) {
+  case LabelPropagationPlan::kSynchronous:
+    plan = LabelPropagationPlan::Synchronous(max_iterations, seed);
+    break;
+  case LabelPropagationPlan::kAsynchronous:
+    plan = LabelPropagationPlan::Asynchronous(max_iterations, seed);
+    break;
+  default:
+    KATANA_LOG_FATAL("invalid algorithm");
+  }
+
+  if (auto r =
+          LabelPropagation(pg.get(), edge_property_name, "communityId", plan);
+      !r) {
+    KATANA_LOG_FATAL("Failed to run LabelPropagation: {}", r.error());
+  }
+
+  auto stats_result =
+      LabelPropagationStatistics::Compute(pg.get(), "communityId");
+  if (!stats_result) {
+    KATANA_LOG_FATAL(
+        "Failed to compute LabelPropagation statistics: {}",
+        stats_result.error());
+  }
+  auto stats = stats_result.value();
+  stats.Print();
+
+  if (!skipVerify) {
+    if (LabelPropagationAssertValid(pg.get(), "communityId")) {
+      std::cout << "Verification successful.\n";
+    } else {
+      KATANA_LOG_FATAL("verification failed");
+    }
+  }
+
+  if (output) {
+    auto r = pg->GetNodePropertyTyped<uint64_t>("communityId");
+    if (!r) {
+      KATANA_LOG_FATAL("Failed to get node property {}", r.error());
+    }
+    auto results = r.value();
+    KATANA_LOG_DEBUG_ASSERT(
+        uint64_t(results->length()) == pg->topology().num_nodes());
+
+    writeOutput(outputLocation, results->raw_values(), results->length());
+  }
+
+  totalTime.stop();
+
+  return 0;
+}
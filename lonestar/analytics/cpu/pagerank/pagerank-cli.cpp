@@ -17,6 +17,9 @@
  * Documentation, or loss or inaccuracy of data of any kind.
  */
 
+#include <iterator>
+#include <sstream>
+
 #include "Lonestar/BoilerPlate.h"
 #include "katana/analytics/pagerank/pagerank.h"
 
@@ -50,6 +53,41 @@ static cll::opt<PagerankPlan::Algorithm> algo(
         clEnumValN(PagerankPlan::kPushAsynchronous, "PushAsync", "PushAsync")),
     cll::init(PagerankPlan::kPushAsynchronous));
 
+static cll::opt<std::string> seedsString(
+    "seeds",
+    cll::desc("String containing whitespace separated list of seed nodes; "
+              "if set, computes the Personalized Page Rank of the seeds"),
+    cll::init(""));
+static cll::opt<bool> independentSeeds(
+    "independentSeeds",
+    cll::desc("Compute one Personalized Page Rank vector per seed instead of "
+              "one for the whole seed set (default false)"),
+    cll::init(false));
+static cll::opt<PersonalizedPagerankPlan::Algorithm> personalizedAlgo(
+    "personalizedAlgo",
+    cll::desc("Choose a Personalized Page Rank algorithm:"),
+    cll::values(
+        clEnumValN(
+            PersonalizedPagerankPlan::kForwardPush, "ForwardPush",
+            "ForwardPush"),
+        clEnumValN(
+            PersonalizedPagerankPlan::kPowerIteration, "PowerIteration",
+            "PowerIteration")),
+    cll::init(PersonalizedPagerankPlan::kForwardPush));
+static cll::opt<float> epsilon(
+    "epsilon",
+    cll::desc("Residual threshold per out-edge of ForwardPush (default 1e-4)"),
+    cll::init(PersonalizedPagerankPlan::kDefaultEpsilon));
+static cll::opt<uint32_t> batchSize(
+    "batchSize",
+    cll::desc("Number of seeds per edge sweep of PowerIteration (default 16)"),
+    cll::init(PersonalizedPagerankPlan::kDefaultBatchSize));
+static cll::opt<uint32_t> topK(
+    "topK",
+    cll::desc("Number of highest ranked nodes to print per seed with "
+              "-independentSeeds (default 10)"),
+    cll::init(10));
+
 //! Flag that forces user to be aware that they should be passing in a
 //! transposed graph.
 static cll::opt<bool> transposedGraph(
@@ -85,10 +123,45 @@ main(int argc, char** argv) {
   std::cout << "Read " << pg->topology().num_nodes() << " nodes, "
             << pg->topology().num_edges() << " edges\n";
 
-  PagerankPlan plan{kCPU, algo, tolerance, maxIterations, kAlpha};
+  std::vector<uint32_t> seeds;
+  std::istringstream seeds_stream(seedsString);
+  seeds.insert(
+      seeds.end(), std::istream_iterator<uint32_t>{seeds_stream},
+      std::istream_iterator<uint32_t>{});
 
-  if (auto r = Pagerank(pg.get(), "rank", plan); !r) {
-    KATANA_LOG_FATAL("Failed to run Pagerank {}", r.error());
+  if (seeds.empty()) {
+    PagerankPlan plan{kCPU, algo, tolerance, maxIterations, kAlpha};
+
+    if (auto r = Pagerank(pg.get(), "rank", plan); !r) {
+      KATANA_LOG_FATAL("Failed to run Pagerank {}", r.error());
+    }
+  } else {
+    PersonalizedPagerankPlan plan =
+        personalizedAlgo == PersonalizedPagerankPlan::kPowerIteration
+            ? PersonalizedPagerankPlan::PowerIteration(
+                  tolerance, maxIterations, kAlpha, batchSize)
+            : PersonalizedPagerankPlan::ForwardPush(epsilon, kAlpha);
+
+    if (independentSeeds) {
+      auto r = PersonalizedPagerankBatch(pg.get(), seeds, topK, plan);
+      if (!r) {
+        KATANA_LOG_FATAL("Failed to run PersonalizedPagerank {}", r.error());
+      }
+      for (size_t i = 0; i < seeds.size(); ++i) {
+        std::cout << "Seed " << seeds[i] << ":";
+        const PersonalizedPagerankVector& ranks = r.value()[i];
+        for (size_t j = 0; j < ranks.nodes.size(); ++j) {
+          std::cout << " " << ranks.nodes[j] << "=" << ranks.ranks[j];
+        }
+        std::cout << "\n";
+      }
+      totalTime.stop();
+      return 0;
+    }
+
+    if (auto r = PersonalizedPagerank(pg.get(), seeds, "rank", plan); !r) {
+      KATANA_LOG_FATAL("Failed to run PersonalizedPagerank {}", r.error());
+    }
   }
 
   auto stats_result = PagerankStatistics::Compute(pg.get(), "rank");
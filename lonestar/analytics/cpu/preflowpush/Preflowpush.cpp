@@ -47,6 +47,11 @@ static cll::opt<uint32_t> sinkId(
     "sinkNode", cll::desc("Sink node"), cll::Required);
 static cll::opt<bool> useHLOrder(
     "useHLOrder", cll::desc("Use HL ordering heuristic"), cll::init(false));
+static cll::opt<bool> useMultiQueue(
+    "useMultiQueue",
+    cll::desc("With -useHLOrder, order by height with a MultiQueue instead "
+              "of OBIM"),
+    cll::init(false));
 static cll::opt<bool> useUnitCapacity(
     "useUnitCapacity", cll::desc("Assume all capacities are unit"),
     cll::init(false));
@@ -498,6 +503,7 @@ struct PreflowPush {
 
     typedef katana::PerSocketChunkFIFO<16> Chunk;
     typedef katana::OrderedByIntegerMetric<decltype(obimIndexer), Chunk> OBIM;
+    typedef katana::MultiQueue<decltype(obimIndexer)> MQ;
 
     katana::InsertBag<GNode> initial;
     initializePreflow(initial);
@@ -508,7 +514,9 @@ struct PreflowPush {
       Counter counter;
       switch (detAlgo) {
       case nondet:
-        if (useHLOrder) {
+        if (useHLOrder && useMultiQueue) {
+          nonDetDischarge(initial, counter, katana::wl<MQ>(obimIndexer));
+        } else if (useHLOrder) {
           nonDetDischarge(initial, counter, katana::wl<OBIM>(obimIndexer));
         } else {
           nonDetDischarge(initial, counter, katana::wl<Chunk>());
@@ -47,6 +47,12 @@ static cll::opt<std::string> startNodesString(
               "'0'); ignore if "
               "-startNodesFile is used"),
     cll::init("0"));
+static cll::opt<bool> userIds(
+    "userIds",
+    cll::desc("Flag to indicate that -startNodes, -startNodesFile and "
+              "-reportNode give user IDs, i.e., the IDs nodes had in the "
+              "input the graph was imported from (default value false)"),
+    cll::init(false));
 static cll::opt<bool> persistAllDistances(
     "persistAllDistances",
     cll::desc(
@@ -60,6 +66,19 @@ cll::opt<unsigned int> reportNode(
 cll::opt<unsigned int> stepShift(
     "delta", cll::desc("Shift value for the deltastep (default value 13)"),
     cll::init(13));
+static cll::opt<bool> adaptiveDelta(
+    "adaptiveDelta",
+    cll::desc(
+        "Choose the deltastep from a sample of the edge weights and adjust it "
+        "while running; overrides -delta (default value false)"),
+    cll::init(false));
+static cll::opt<unsigned int> fusionThreshold(
+    "fusionThreshold",
+    cll::desc(
+        "Maximum number of items a thread processes from its own bucket "
+        "before returning to the shared worklist; 0 disables bucket fusion "
+        "(default value 0, or 1000 with -adaptiveDelta)"),
+    cll::init(SsspPlan::kDefaultFusionThreshold));
 
 cll::opt<SsspPlan::Algorithm> algo(
     "algo", cll::desc("Choose an algorithm (default value auto):"),
@@ -80,6 +99,9 @@ cll::opt<SsspPlan::Algorithm> algo(
         clEnumValN(SsspPlan::kDijkstra, "Dijkstra", "Dijkstra's algorithm"),
         clEnumValN(SsspPlan::kTopological, "Topo", "Topological"),
         clEnumValN(SsspPlan::kTopologicalTile, "TopoTile", "Topological tiled"),
+        clEnumValN(
+            SsspPlan::kMultiQueue, "MultiQueue",
+            "Asynchronous on a relaxed priority MultiQueue"),
         clEnumValN(
             SsspPlan::kAutomatic, "Automatic",
             "Automatic: choose among the algorithms automatically")),
@@ -110,6 +132,8 @@ AlgorithmName(SsspPlan::Algorithm algorithm) {
     return "Topological";
   case SsspPlan::kTopologicalTile:
     return "TopologicalTile";
+  case SsspPlan::kMultiQueue:
+    return "MultiQueue";
   case SsspPlan::kAutomatic:
     return "Automatic";
   default:
@@ -152,31 +176,41 @@ main(int argc, char** argv) {
   std::cout << "Read " << pg->topology().num_nodes() << " nodes, "
             << pg->topology().num_edges() << " edges\n";
 
-  if (reportNode >= pg->topology().num_nodes()) {
-    KATANA_LOG_FATAL("failed to set report: {}", reportNode);
+  uint32_t report_node = reportNode;
+  if (userIds) {
+    report_node = UserIdsToNodes(*pg, {reportNode}).front();
+  }
+  if (report_node >= pg->topology().num_nodes()) {
+    KATANA_LOG_FATAL("failed to set report: {}", report_node);
   }
 
   katana::reportPageAlloc("MeminfoPre");
 
-  std::vector<uint32_t> startNodes;
+  std::vector<uint64_t> startIds;
   if (!startNodesFile.getValue().empty()) {
     std::ifstream file(startNodesFile);
     if (!file.good()) {
       KATANA_LOG_FATAL("failed to open file: {}", startNodesFile);
     }
-    startNodes.insert(
-        startNodes.end(), std::istream_iterator<uint64_t>{file},
+    startIds.insert(
+        startIds.end(), std::istream_iterator<uint64_t>{file},
         std::istream_iterator<uint64_t>{});
   } else {
     std::istringstream str(startNodesString);
-    startNodes.insert(
-        startNodes.end(), std::istream_iterator<uint64_t>{str},
+    startIds.insert(
+        startIds.end(), std::istream_iterator<uint64_t>{str},
         std::istream_iterator<uint64_t>{});
   }
+  std::vector<uint32_t> startNodes =
+      userIds ? UserIdsToNodes(*pg, startIds)
+              : std::vector<uint32_t>(startIds.begin(), startIds.end());
   uint32_t num_sources = startNodes.size();
   std::cout << "Running BFS for " << num_sources << " sources\n";
 
-  if (algo == SsspPlan::kDeltaStep || algo == SsspPlan::kDeltaTile ||
+  if (adaptiveDelta) {
+    std::cout << "INFO: Using adaptive delta-step\n";
+  } else if (
+      algo == SsspPlan::kDeltaStep || algo == SsspPlan::kDeltaTile ||
       algo == SsspPlan::kSerialDelta || algo == SsspPlan::kSerialDeltaTile) {
     std::cout
         << "INFO: Using delta-step of " << (1 << stepShift) << "\n"
@@ -186,22 +220,31 @@ main(int argc, char** argv) {
 
   std::cout << "Running " << AlgorithmName(algo) << " algorithm\n";
 
+  unsigned delta = stepShift;
+  unsigned fusion_threshold = fusionThreshold;
+  if (adaptiveDelta) {
+    delta = SsspPlan::kAdaptiveDelta;
+    if (fusionThreshold.getNumOccurrences() == 0) {
+      fusion_threshold = SsspPlan::kAdaptiveFusionThreshold;
+    }
+  }
   SsspPlan plan;
   switch (algo) {
   case SsspPlan::kDeltaTile:
-    plan = SsspPlan::DeltaTile(stepShift);
+    plan = SsspPlan::DeltaTile(
+        delta, SsspPlan::kDefaultEdgeTileSize, fusion_threshold);
     break;
   case SsspPlan::kDeltaStep:
-    plan = SsspPlan::DeltaStep(stepShift);
+    plan = SsspPlan::DeltaStep(delta, fusion_threshold);
     break;
   case SsspPlan::kDeltaStepBarrier:
-    plan = SsspPlan::DeltaStepBarrier(stepShift);
+    plan = SsspPlan::DeltaStepBarrier(delta, fusion_threshold);
     break;
   case SsspPlan::kSerialDeltaTile:
-    plan = SsspPlan::SerialDeltaTile(stepShift);
+    plan = SsspPlan::SerialDeltaTile(delta);
     break;
   case SsspPlan::kSerialDelta:
-    plan = SsspPlan::SerialDelta(stepShift);
+    plan = SsspPlan::SerialDelta(delta);
     break;
   case SsspPlan::kDijkstraTile:
     plan = SsspPlan::DijkstraTile();
@@ -215,6 +258,9 @@ main(int argc, char** argv) {
   case SsspPlan::kTopologicalTile:
     plan = SsspPlan::TopologicalTile();
     break;
+  case SsspPlan::kMultiQueue:
+    plan = SsspPlan::MultiQueue(fusion_threshold);
+    break;
   case SsspPlan::kAutomatic:
     plan = SsspPlan();
     break;
@@ -45,10 +45,19 @@ static cll::opt<std::string> nodesString(
     cll::init(""));
 static cll::opt<SubGraphExtractionPlan::Algorithm> algo(
     "algo", cll::desc("Choose an algorithm:"),
-    cll::values(clEnumValN(
-        SubGraphExtractionPlan::kNodeSet, "nodeSet",
-        "Extract subgraph topology from node set")),
+    cll::values(
+        clEnumValN(
+            SubGraphExtractionPlan::kNodeSet, "nodeSet",
+            "Extract subgraph topology from node set"),
+        clEnumValN(
+            SubGraphExtractionPlan::kKHop, "kHop",
+            "Extract subgraph topology within numHops of the node set")),
     cll::init(SubGraphExtractionPlan::kNodeSet));
+static cll::opt<uint32_t> numHops(
+    "numHops",
+    cll::desc("Number of hops to follow from the node set for kHop (default "
+              "value 1)"),
+    cll::init(SubGraphExtractionPlan::kDefaultNumHops));
 
 int
 main(int argc, char** argv) {
@@ -63,6 +72,16 @@ main(int argc, char** argv) {
       MakeFileGraph(inputFile, edge_property_name);
 
   SubGraphExtractionPlan plan;
+  switch (algo) {
+  case SubGraphExtractionPlan::kNodeSet:
+    plan = SubGraphExtractionPlan::NodeSet();
+    break;
+  case SubGraphExtractionPlan::kKHop:
+    plan = SubGraphExtractionPlan::KHop(numHops);
+    break;
+  default:
+    KATANA_LOG_FATAL("Invalid algorithm selected");
+  }
 
   std::vector<uint32_t> node_vec;
   if (!nodesFile.getValue().empty()) {
@@ -81,8 +100,14 @@ main(int argc, char** argv) {
   }
   uint64_t num_nodes = node_vec.size();
   std::cout << "Extracting subgraph with " << num_nodes << " num nodes\n";
-  std::cout << "INFO: This is extracting the topology containing nodes from "
-               "the user defined node set.\n";
+  if (algo == SubGraphExtractionPlan::kKHop) {
+    std::cout << "INFO: This is extracting the topology containing nodes "
+                 "within "
+              << numHops << " hops of the user defined node set.\n";
+  } else {
+    std::cout << "INFO: This is extracting the topology containing nodes from "
+                 "the user defined node set.\n";
+  }
 
   auto subgraph_result = SubGraphExtraction(pg.get(), node_vec, plan);
   if (!subgraph_result) {
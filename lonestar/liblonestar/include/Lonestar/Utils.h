@@ -24,6 +24,7 @@
 
 #include <boost/filesystem.hpp>
 
+#include "katana/IdDictionary.h"
 #include "katana/PropertyGraph.h"
 #include "katana/analytics/Utils.h"
 #include "tsuba/RDG.h"
@@ -47,6 +48,28 @@ MakeFileGraph(
   return std::move(pfg_result.value());
 }
 
+/// Translate user IDs, i.e., the IDs nodes had in the input the graph was
+/// imported from, to nodes
+inline std::vector<uint32_t>
+UserIdsToNodes(
+    const katana::PropertyGraph& pg, const std::vector<uint64_t>& user_ids) {
+  auto dict_result = katana::MakeUserIdDictionary(pg);
+  if (!dict_result) {
+    KATANA_LOG_FATAL("cannot look up user IDs: {}", dict_result.error());
+  }
+  const katana::IdDictionary<uint64_t>& dict = dict_result.value();
+  std::vector<uint32_t> nodes;
+  nodes.reserve(user_ids.size());
+  for (uint64_t user_id : user_ids) {
+    auto node = dict.Find(user_id);
+    if (!node) {
+      KATANA_LOG_FATAL("no node has user ID {}", user_id);
+    }
+    nodes.emplace_back(*node);
+  }
+  return nodes;
+}
+
 template <typename T>
 void
 writeOutput(
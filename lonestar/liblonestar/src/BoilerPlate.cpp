@@ -34,6 +34,12 @@ llvm::cl::opt<std::string> statFile(
     "statFile",
     llvm::cl::desc("ouput file to print stats to (default value empty)"),
     llvm::cl::init(""));
+llvm::cl::opt<std::string> traceFile(
+    "traceFile",
+    llvm::cl::desc(
+        "output file to write a Chrome trace of the parallel loops to "
+        "(default value empty)"),
+    llvm::cl::init(""));
 
 //! Flag that forces user to be aware that they should be passing in a
 //! symmetric graph.
@@ -82,6 +88,9 @@ LonestarStart(
   numThreads = katana::setActiveThreads(numThreads);
 
   katana::SetStatFile(statFile);
+  if (!traceFile.empty()) {
+    katana::SetTraceFile(traceFile);
+  }
 
   LonestarPrintVersion(llvm::outs());
   llvm::outs() << "Copyright (C) " << katana::getCopyrightYear()
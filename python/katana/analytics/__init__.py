@@ -69,7 +69,15 @@ from katana.analytics._independent_set import (
 from katana.analytics._jaccard import jaccard, jaccard_assert_valid, JaccardPlan, JaccardStatistics
 from katana.analytics._k_core import k_core, k_core_assert_valid, KCorePlan, KCoreStatistics
 from katana.analytics._k_truss import k_truss, k_truss_assert_valid, KTrussPlan, KTrussStatistics
-from katana.analytics._pagerank import pagerank, pagerank_assert_valid, PagerankPlan, PagerankStatistics
+from katana.analytics._pagerank import (
+    pagerank,
+    pagerank_assert_valid,
+    PagerankPlan,
+    PagerankStatistics,
+    personalized_pagerank,
+    personalized_pagerank_batch,
+    PersonalizedPagerankPlan,
+)
 from katana.analytics._sssp import sssp, sssp_assert_valid, SsspPlan, SsspStatistics
 from katana.analytics._triangle_count import triangle_count, TriangleCountPlan
 from katana.analytics._wrappers import find_edge_sorted_by_dest, sort_all_edges_by_dest, sort_nodes_by_degree
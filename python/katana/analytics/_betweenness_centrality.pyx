@@ -18,7 +18,7 @@ Betweenness Centrality
 
 from libcpp.string cimport string
 from libcpp.vector cimport vector
-from libc.stdint cimport uint32_t
+from libc.stdint cimport uint32_t, uint64_t
 
 from katana.analytics.plan cimport Plan, _Plan
 from katana.cpp.libgalois.graphs.Graph cimport _PropertyGraph
@@ -37,8 +37,14 @@ cdef extern from "katana/analytics/betweenness_centrality/betweenness_centrality
         enum Algorithm:
             kOuter "katana::analytics::BetweennessCentralityPlan::kOuter"
             kLevel "katana::analytics::BetweennessCentralityPlan::kLevel"
+            kAdaptiveSampling "katana::analytics::BetweennessCentralityPlan::kAdaptiveSampling"
+            kBatched "katana::analytics::BetweennessCentralityPlan::kBatched"
 
         _BetweennessCentralityPlan.Algorithm algorithm() const
+        double epsilon() const
+        double failure_probability() const
+        uint64_t seed() const
+        uint32_t batch_size() const
 
         BetweennessCentralityPlan()
 
@@ -47,6 +53,10 @@ cdef extern from "katana/analytics/betweenness_centrality/betweenness_centrality
         @staticmethod
         _BetweennessCentralityPlan Outer()
         @staticmethod
+        _BetweennessCentralityPlan AdaptiveSampling(double epsilon, double failure_probability, uint64_t seed)
+        @staticmethod
+        _BetweennessCentralityPlan Batched(uint32_t batch_size)
+        @staticmethod
         _BetweennessCentralityPlan FromAlgorithm(_BetweennessCentralityPlan.Algorithm algo)
 
     BetweennessCentralitySources kBetweennessCentralityAllNodes;
@@ -87,9 +97,15 @@ class _BetweennessCentralityAlgorithm(Enum):
         Parallelize outermost iteration
     Level
         Process levels in parallel
+    AdaptiveSampling
+        Approximate by sampling shortest paths until an error bound holds
+    Batched
+        Process levels in parallel for a batch of sources at once
     """
     Outer = _BetweennessCentralityPlan.Algorithm.kOuter
     Level = _BetweennessCentralityPlan.Algorithm.kLevel
+    AdaptiveSampling = _BetweennessCentralityPlan.Algorithm.kAdaptiveSampling
+    Batched = _BetweennessCentralityPlan.Algorithm.kBatched
 
 
 cdef class BetweennessCentralityPlan(Plan):
@@ -120,10 +136,43 @@ cdef class BetweennessCentralityPlan(Plan):
     def outer():
         return BetweennessCentralityPlan.make(_BetweennessCentralityPlan.Outer())
 
+    @property
+    def epsilon(self) -> float:
+        return self.underlying_.epsilon()
+
+    @property
+    def failure_probability(self) -> float:
+        return self.underlying_.failure_probability()
+
+    @property
+    def seed(self) -> int:
+        return self.underlying_.seed()
+
+    @property
+    def batch_size(self) -> int:
+        return self.underlying_.batch_size()
+
     @staticmethod
     def level():
         return BetweennessCentralityPlan.make(_BetweennessCentralityPlan.Level())
 
+    @staticmethod
+    def adaptive_sampling(double epsilon = 0.01, double failure_probability = 0.1, uint64_t seed = 0):
+        """
+        Approximate betweenness centrality by sampling shortest paths between random pairs of nodes, stopping once,
+        with probability at least 1 - failure_probability, every normalized centrality is within epsilon of its exact
+        value. The sources argument of :py:func:`betweenness_centrality` is ignored.
+        """
+        return BetweennessCentralityPlan.make(
+            _BetweennessCentralityPlan.AdaptiveSampling(epsilon, failure_probability, seed))
+
+    @staticmethod
+    def batched(uint32_t batch_size = 16):
+        """
+        Process levels in parallel for batch_size (at most 64) sources at once.
+        """
+        return BetweennessCentralityPlan.make(_BetweennessCentralityPlan.Batched(batch_size))
+
 
 def betweenness_centrality(PropertyGraph pg, str output_property_name, sources = None,
              BetweennessCentralityPlan plan = BetweennessCentralityPlan()):
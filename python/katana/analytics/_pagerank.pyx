@@ -22,8 +22,30 @@ Page Rank
     :undoc-members:
 
 .. autofunction:: katana.analytics.pagerank_assert_valid
+
+Personalized Page Rank
+----------------------
+
+.. autoclass:: katana.analytics.PersonalizedPagerankPlan
+    :members:
+    :special-members: __init__
+    :undoc-members:
+
+.. [ACL] ANDERSEN, Reid; CHUNG, Fan; LANG, Kevin. Local graph partitioning
+    using pagerank vectors. In: 47th Annual IEEE Symposium on Foundations of
+    Computer Science (FOCS'06). IEEE, 2006. p. 475-486.
+
+.. autoclass:: katana.analytics._pagerank._PersonalizedPagerankPlanAlgorithm
+    :members:
+    :undoc-members:
+
+.. autofunction:: katana.analytics.personalized_pagerank
+
+.. autofunction:: katana.analytics.personalized_pagerank_batch
 """
 from libcpp.string cimport string
+from libcpp.vector cimport vector
+from libc.stdint cimport uint32_t
 
 from katana.analytics.plan cimport Plan, _Plan
 from katana.cpp.libgalois.graphs.Graph cimport _PropertyGraph
@@ -69,6 +91,38 @@ cdef extern from "katana/analytics/pagerank/pagerank.h" namespace "katana::analy
 
     Result[void] PagerankAssertValid(_PropertyGraph* pg, string output_property_name)
 
+    cppclass _PersonalizedPagerankPlan "katana::analytics::PersonalizedPagerankPlan" (_Plan):
+        enum Algorithm:
+            kForwardPush "katana::analytics::PersonalizedPagerankPlan::kForwardPush"
+            kPowerIteration "katana::analytics::PersonalizedPagerankPlan::kPowerIteration"
+
+        _PersonalizedPagerankPlan.Algorithm algorithm() const
+        float epsilon() const
+        float tolerance() const
+        unsigned int max_iterations() const
+        float alpha() const
+        uint32_t batch_size() const
+
+        PersonalizedPagerankPlan()
+
+        @staticmethod
+        _PersonalizedPagerankPlan ForwardPush(float epsilon, float alpha)
+        @staticmethod
+        _PersonalizedPagerankPlan PowerIteration(float tolerance, unsigned int max_iterations, float alpha, uint32_t batch_size)
+
+    double kPersonalizedDefaultEpsilon "katana::analytics::PersonalizedPagerankPlan::kDefaultEpsilon"
+    double kPersonalizedDefaultTolerance "katana::analytics::PersonalizedPagerankPlan::kDefaultTolerance"
+    int kPersonalizedDefaultMaxIterations "katana::analytics::PersonalizedPagerankPlan::kDefaultMaxIterations"
+    uint32_t kPersonalizedDefaultBatchSize "katana::analytics::PersonalizedPagerankPlan::kDefaultBatchSize"
+
+    cppclass _PersonalizedPagerankVector "katana::analytics::PersonalizedPagerankVector":
+        vector[uint32_t] nodes
+        vector[float] ranks
+
+    Result[void] PersonalizedPagerank(_PropertyGraph* pg, vector[uint32_t] seeds, string output_property_name, _PersonalizedPagerankPlan plan)
+
+    Result[vector[_PersonalizedPagerankVector]] PersonalizedPagerankBatch(_PropertyGraph* pg, vector[uint32_t] seeds, uint32_t top_k, _PersonalizedPagerankPlan plan)
+
     cppclass _PagerankStatistics "katana::analytics::PagerankStatistics":
         float max_rank
         float min_rank
@@ -196,6 +250,128 @@ def pagerank_assert_valid(PropertyGraph pg, str output_property_name):
         handle_result_assert(PagerankAssertValid(pg.underlying.get(), output_property_name_cstr))
 
 
+class _PersonalizedPagerankPlanAlgorithm(Enum):
+    ForwardPush = _PersonalizedPagerankPlan.Algorithm.kForwardPush
+    PowerIteration = _PersonalizedPagerankPlan.Algorithm.kPowerIteration
+
+
+cdef class PersonalizedPagerankPlan(Plan):
+    """
+    A computational :ref:`Plan` for Personalized Page Rank.
+
+    Static methods construct PersonalizedPagerankPlans.
+    """
+    cdef:
+        _PersonalizedPagerankPlan underlying_
+
+    cdef _Plan* underlying(self) except NULL:
+        return &self.underlying_
+
+    Algorithm = _PersonalizedPagerankPlanAlgorithm
+
+    @staticmethod
+    cdef PersonalizedPagerankPlan make(_PersonalizedPagerankPlan u):
+        f = <PersonalizedPagerankPlan>PersonalizedPagerankPlan.__new__(PersonalizedPagerankPlan)
+        f.underlying_ = u
+        return f
+
+    @property
+    def algorithm(self) -> _PersonalizedPagerankPlanAlgorithm:
+        return _PersonalizedPagerankPlanAlgorithm(self.underlying_.algorithm())
+
+    @property
+    def epsilon(self) -> float:
+        return self.underlying_.epsilon()
+
+    @property
+    def tolerance(self) -> float:
+        return self.underlying_.tolerance()
+
+    @property
+    def max_iterations(self) -> int:
+        return self.underlying_.max_iterations()
+
+    @property
+    def alpha(self) -> float:
+        return self.underlying_.alpha()
+
+    @property
+    def batch_size(self) -> int:
+        return self.underlying_.batch_size()
+
+    @staticmethod
+    def forward_push(float epsilon = kPersonalizedDefaultEpsilon, float alpha = kDefaultAlpha):
+        """
+        Approximate forward push [ACL]_. Only the neighborhood of the seeds is
+        touched.
+        """
+        return PersonalizedPagerankPlan.make(_PersonalizedPagerankPlan.ForwardPush(epsilon, alpha))
+
+    @staticmethod
+    def power_iteration(float tolerance = kPersonalizedDefaultTolerance,
+                        unsigned int max_iterations = kPersonalizedDefaultMaxIterations,
+                        float alpha = kDefaultAlpha, uint32_t batch_size = kPersonalizedDefaultBatchSize):
+        """
+        Exact power iteration over batch_size personalization vectors per sweep
+        of the edges.
+        """
+        return PersonalizedPagerankPlan.make(
+            _PersonalizedPagerankPlan.PowerIteration(tolerance, max_iterations, alpha, batch_size))
+
+
+def personalized_pagerank(PropertyGraph pg, seeds, str output_property_name,
+                          PersonalizedPagerankPlan plan = PersonalizedPagerankPlan()):
+    """
+    Compute the Page Rank of each node in the graph personalized to the seed
+    nodes.
+
+    :type pg: PropertyGraph
+    :param pg: The graph to analyze.
+    :type seeds: list[int]
+    :param seeds: The nodes random walks restart from.
+    :type output_property_name: str
+    :param output_property_name: The output property to store the rank. This property must not already exist.
+    :type plan: PersonalizedPagerankPlan
+    :param plan: The execution plan to use.
+    """
+    cdef vector[uint32_t] c_seeds = seeds
+    output_property_name_bytes = bytes(output_property_name, "utf-8")
+    output_property_name_cstr = <string>output_property_name_bytes
+    with nogil:
+        handle_result_void(PersonalizedPagerank(pg.underlying.get(), c_seeds, output_property_name_cstr, plan.underlying_))
+
+
+cdef vector[_PersonalizedPagerankVector] handle_result_PersonalizedPagerankVectors(
+        Result[vector[_PersonalizedPagerankVector]] res) nogil except *:
+    if not res.has_value():
+        with gil:
+            raise_error_code(res.error())
+    return res.value()
+
+
+def personalized_pagerank_batch(PropertyGraph pg, seeds, uint32_t top_k = 0,
+                                PersonalizedPagerankPlan plan = PersonalizedPagerankPlan()):
+    """
+    Compute one Personalized Page Rank vector per seed.
+
+    :type pg: PropertyGraph
+    :param pg: The graph to analyze.
+    :type seeds: list[int]
+    :param seeds: The seeds, each of which gets its own vector.
+    :type top_k: int
+    :param top_k: The number of highest ranked nodes to return per seed, or 0 for every node with a non-zero rank.
+    :type plan: PersonalizedPagerankPlan
+    :param plan: The execution plan to use.
+    :returns: A list with, for each seed, a list of (node, rank) pairs by decreasing rank.
+    """
+    cdef vector[uint32_t] c_seeds = seeds
+    cdef vector[_PersonalizedPagerankVector] res
+    with nogil:
+        res = handle_result_PersonalizedPagerankVectors(
+            PersonalizedPagerankBatch(pg.underlying.get(), c_seeds, top_k, plan.underlying_))
+    return [list(zip(v.nodes, v.ranks)) for v in res]
+
+
 cdef _PagerankStatistics handle_result_PagerankStatistics(Result[_PagerankStatistics] res) nogil except *:
     if not res.has_value():
         with gil:
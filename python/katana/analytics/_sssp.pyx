@@ -42,6 +42,7 @@ cdef extern from "katana/analytics/sssp/sssp.h" namespace "katana::analytics" no
             kDijkstra "katana::analytics::SsspPlan::kDijkstra"
             kTopological "katana::analytics::SsspPlan::kTopological"
             kTopologicalTile "katana::analytics::SsspPlan::kTopologicalTile"
+            kMultiQueue "katana::analytics::SsspPlan::kMultiQueue"
             kAutomatic "katana::analytics::SsspPlan::kAutomatic"
 
         _SsspPlan()
@@ -49,14 +50,16 @@ cdef extern from "katana/analytics/sssp/sssp.h" namespace "katana::analytics" no
 
         _SsspPlan.Algorithm algorithm() const
         unsigned delta() const
+        bool adaptive_delta() const
         ptrdiff_t edge_tile_size() const
+        unsigned fusion_threshold() const
 
         @staticmethod
-        _SsspPlan DeltaTile(unsigned delta, ptrdiff_t edge_tile_size)
+        _SsspPlan DeltaTile(unsigned delta, ptrdiff_t edge_tile_size, unsigned fusion_threshold)
         @staticmethod
-        _SsspPlan DeltaStep(unsigned delta)
+        _SsspPlan DeltaStep(unsigned delta, unsigned fusion_threshold)
         @staticmethod
-        _SsspPlan DeltaStepBarrier(unsigned delta)
+        _SsspPlan DeltaStepBarrier(unsigned delta, unsigned fusion_threshold)
         @staticmethod
         _SsspPlan SerialDeltaTile(unsigned delta, ptrdiff_t edge_tile_size)
         @staticmethod
@@ -69,9 +72,14 @@ cdef extern from "katana/analytics/sssp/sssp.h" namespace "katana::analytics" no
         _SsspPlan Topological()
         @staticmethod
         _SsspPlan TopologicalTile(ptrdiff_t edge_tile_size)
+        @staticmethod
+        _SsspPlan MultiQueue(unsigned fusion_threshold)
 
     unsigned kDefaultDelta "katana::analytics::SsspPlan::kDefaultDelta"
     ptrdiff_t kDefaultEdgeTileSize "katana::analytics::SsspPlan::kDefaultEdgeTileSize"
+    unsigned kAdaptiveDelta "katana::analytics::SsspPlan::kAdaptiveDelta"
+    unsigned kDefaultFusionThreshold "katana::analytics::SsspPlan::kDefaultFusionThreshold"
+    unsigned kAdaptiveFusionThreshold "katana::analytics::SsspPlan::kAdaptiveFusionThreshold"
 
     Result[void] Sssp(_PropertyGraph* pg, size_t start_node,
         const string& edge_weight_property_name, const string& output_property_name, _SsspPlan plan)
@@ -114,6 +122,8 @@ class _SsspAlgorithm(Enum):
         Topological
     TopoTile
         Topological tiled
+    MultiQueue
+        Asynchronous on a relaxed priority MultiQueue
     Automatic
         Choose an algorithm using heuristics
     """
@@ -126,6 +136,7 @@ class _SsspAlgorithm(Enum):
     Dijkstra = _SsspPlan.Algorithm.kDijkstra
     Topological = _SsspPlan.Algorithm.kTopological
     TopologicalTile = _SsspPlan.Algorithm.kTopologicalTile
+    MultiQueue = _SsspPlan.Algorithm.kMultiQueue
     Automatic = _SsspPlan.Algorithm.kAutomatic
 
 
@@ -175,21 +186,46 @@ cdef class SsspPlan(Plan):
         """
         return self.underlying_.delta()
     @property
+    def adaptive_delta(self) -> bool:
+        """
+        Whether the algorithm chooses delta itself (see `SsspPlan.ADAPTIVE_DELTA`).
+        """
+        return self.underlying_.adaptive_delta()
+    @property
     def edge_tile_size(self) -> int:
         """
         The edge tile size.
         """
         return self.underlying_.edge_tile_size()
+    @property
+    def fusion_threshold(self) -> int:
+        """
+        The number of items a thread processes from its own bucket before returning to the shared worklist. 0 disables
+        bucket fusion.
+        """
+        return self.underlying_.fusion_threshold()
+
+    ADAPTIVE_DELTA = kAdaptiveDelta
+    """
+    Pass as delta to choose delta from a sample of the edge weights and adjust it while the algorithm runs.
+    """
+
+    ADAPTIVE_FUSION_THRESHOLD = kAdaptiveFusionThreshold
+    """
+    The fusion threshold to use with ADAPTIVE_DELTA. Bucket fusion is off by default.
+    """
 
     @staticmethod
-    def delta_tile(unsigned delta = kDefaultDelta, ptrdiff_t edge_tile_size = kDefaultEdgeTileSize) -> SsspPlan:
-        return SsspPlan.make(_SsspPlan.DeltaTile(delta, edge_tile_size))
+    def delta_tile(unsigned delta = kDefaultDelta, ptrdiff_t edge_tile_size = kDefaultEdgeTileSize,
+                   unsigned fusion_threshold = kDefaultFusionThreshold) -> SsspPlan:
+        return SsspPlan.make(_SsspPlan.DeltaTile(delta, edge_tile_size, fusion_threshold))
     @staticmethod
-    def delta_step(unsigned delta = kDefaultDelta) -> SsspPlan:
-        return SsspPlan.make(_SsspPlan.DeltaStep(delta))
+    def delta_step(unsigned delta = kDefaultDelta, unsigned fusion_threshold = kDefaultFusionThreshold) -> SsspPlan:
+        return SsspPlan.make(_SsspPlan.DeltaStep(delta, fusion_threshold))
     @staticmethod
-    def delta_step_barrier(unsigned delta = kDefaultDelta) -> SsspPlan:
-        return SsspPlan.make(_SsspPlan.DeltaStepBarrier(delta))
+    def delta_step_barrier(unsigned delta = kDefaultDelta,
+                           unsigned fusion_threshold = kDefaultFusionThreshold) -> SsspPlan:
+        return SsspPlan.make(_SsspPlan.DeltaStepBarrier(delta, fusion_threshold))
     @staticmethod
     def serial_delta_tile(unsigned delta = kDefaultDelta, ptrdiff_t edge_tile_size = kDefaultEdgeTileSize) -> SsspPlan:
         return SsspPlan.make(_SsspPlan.SerialDeltaTile(delta, edge_tile_size))
@@ -208,6 +244,9 @@ cdef class SsspPlan(Plan):
     @staticmethod
     def topological_tile(ptrdiff_t edge_tile_size = kDefaultEdgeTileSize) -> SsspPlan:
         return SsspPlan.make(_SsspPlan.TopologicalTile(edge_tile_size))
+    @staticmethod
+    def multi_queue(unsigned fusion_threshold = 0) -> SsspPlan:
+        return SsspPlan.make(_SsspPlan.MultiQueue(fusion_threshold))
 
 
 def sssp(PropertyGraph pg, size_t start_node, str edge_weight_property_name, str output_property_name,
@@ -0,0 +1,8 @@
+from libcpp cimport bool
+from libcpp.string cimport string
+
+cdef extern from "katana/Statistics.h" namespace "katana" nogil:
+    string GetStatsJson()
+    string GetTraceJson()
+    void ResetStats()
+    void SetTracing(bool enabled)
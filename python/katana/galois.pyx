@@ -1,5 +1,8 @@
 from .cpp.libgalois.Galois cimport setActiveThreads as c_setActiveThreads
 from .cpp.libgalois.Galois cimport getVersion as c_getVersion
+from .cpp.libgalois.Statistics cimport GetStatsJson, GetTraceJson, ResetStats, SetTracing
+
+import json
 
 
 _katana_runtime = _katana_runtime_wrapper()
@@ -10,3 +13,37 @@ def setActiveThreads(int n):
 def get_version():
     return c_getVersion()
 
+
+def reset_stats():
+    """
+    Discard the statistics and trace events collected so far.
+
+    Call this before an analytics routine to get the statistics of that call
+    alone from `get_stats` and `get_trace`.
+    """
+    with nogil:
+        ResetStats()
+
+def get_stats():
+    """
+    Return the statistics collected since the last `reset_stats` as a dict
+    with a "stats" list. Each entry has the "region" and "category" of the
+    statistic, its "total" and the "thread_values" it was computed from.
+    """
+    return json.loads(GetStatsJson())
+
+def set_tracing(bint enabled):
+    """
+    Enable or disable recording the trace events returned by `get_trace`.
+    Tracing is off by default since it costs time in every parallel loop.
+    """
+    SetTracing(enabled)
+
+def get_trace():
+    """
+    Return the trace events of named parallel loops collected since the last
+    `reset_stats`, in the Chrome trace event format, while tracing was enabled
+    by `set_tracing`. Save it with `json.dump` to view it in chrome://tracing
+    or Perfetto.
+    """
+    return json.loads(GetTraceJson())
@@ -3,6 +3,7 @@ from pyarrow import Schema, table
 from pytest import approx, raises
 
 from katana import GaloisError
+from katana.galois import get_stats, get_trace, reset_stats, set_tracing
 from katana.analytics import *
 from katana.property_graph import PropertyGraph
 from katana.example_utils import get_input
@@ -107,6 +108,41 @@ def test_sssp(property_graph: PropertyGraph):
     verify_sssp(property_graph, start_node, new_property_id)
 
 
+def test_sssp_stats(property_graph: PropertyGraph):
+    reset_stats()
+    sssp(property_graph, 0, "workFrom", "NewProp")
+
+    stats = get_stats()["stats"]
+    assert any(s["region"] == "SSSP" and s["category"] == "Iterations" for s in stats)
+    assert not get_trace()["traceEvents"]
+
+    reset_stats()
+    set_tracing(True)
+    try:
+        sssp(property_graph, 0, "workFrom", "NewProp2")
+    finally:
+        set_tracing(False)
+    events = get_trace()["traceEvents"]
+    assert any(e.get("args", {}).get("region") == "SSSP" for e in events)
+
+    reset_stats()
+    assert not get_stats()["stats"]
+
+
+def test_sssp_adaptive_delta(property_graph: PropertyGraph):
+    property_name = "NewProp"
+    weight_name = "workFrom"
+    start_node = 0
+
+    plan = SsspPlan.delta_step(SsspPlan.ADAPTIVE_DELTA)
+    assert plan.adaptive_delta
+    sssp(property_graph, start_node, weight_name, property_name, plan)
+    sssp_assert_valid(property_graph, start_node, weight_name, property_name)
+
+    stats = SsspStatistics(property_graph, property_name)
+    assert stats.max_distance == 2011.0
+
+
 def test_jaccard(property_graph: PropertyGraph):
     property_name = "NewProp"
     compare_node = 0
@@ -167,6 +203,29 @@ def test_pagerank(property_graph: PropertyGraph):
     assert stats.average_rank == approx(0.5205338001251221, abs=0.001)
 
 
+def test_personalized_pagerank(property_graph: PropertyGraph):
+    property_name = "NewProp"
+    seeds = [0, 1, 2]
+
+    personalized_pagerank(property_graph, seeds, property_name, PersonalizedPagerankPlan.power_iteration())
+
+    ranks: np.ndarray = property_graph.get_node_property(property_name).to_numpy()
+    assert 0 < ranks.sum() <= 1 + 1e-4
+    assert ranks[seeds].min() >= (1 - PersonalizedPagerankPlan.power_iteration().alpha) / len(seeds) - 1e-6
+
+
+def test_personalized_pagerank_batch(property_graph: PropertyGraph):
+    seeds = [0, 1, 2]
+
+    exact = personalized_pagerank_batch(property_graph, seeds, 10, PersonalizedPagerankPlan.power_iteration())
+    approximate = personalized_pagerank_batch(property_graph, seeds, 10, PersonalizedPagerankPlan.forward_push(1e-6))
+
+    assert len(exact) == len(seeds)
+    for exact_ranks, approximate_ranks in zip(exact, approximate):
+        assert len(exact_ranks) <= 10
+        assert approximate_ranks[0][1] == approx(exact_ranks[0][1], abs=1e-3)
+
+
 def test_betweenness_centrality_outer(property_graph: PropertyGraph):
     property_name = "NewProp"
 
@@ -201,6 +260,29 @@ def test_betweenness_centrality_level(property_graph: PropertyGraph):
     assert stats.average_centrality == approx(1.3645)
 
 
+def test_betweenness_centrality_batched(property_graph: PropertyGraph):
+    property_name = "NewProp"
+
+    betweenness_centrality(property_graph, property_name, 16, BetweennessCentralityPlan.batched(5))
+
+    stats = BetweennessCentralityStatistics(property_graph, property_name)
+
+    assert stats.min_centrality == 0
+    assert stats.max_centrality == approx(8210.38)
+    assert stats.average_centrality == approx(1.3645)
+
+
+def test_betweenness_centrality_adaptive_sampling(property_graph: PropertyGraph):
+    property_name = "NewProp"
+
+    betweenness_centrality(property_graph, property_name, plan=BetweennessCentralityPlan.adaptive_sampling(0.05))
+
+    stats = BetweennessCentralityStatistics(property_graph, property_name)
+
+    assert stats.min_centrality == 0
+    assert stats.max_centrality > 0
+
+
 def test_triangle_count():
     property_graph = PropertyGraph(get_input("propertygraphs/rmat15_cleaned_symmetric"))
     original_first_edge_list = [property_graph.get_edge_dst(e) for e in property_graph.edges(0)]
@@ -3,6 +3,7 @@
 #include <arrow/type.h>
 
 #include "TimeParser.h"
+#include "katana/ArrowInterchange.h"
 
 namespace {
 
@@ -63,9 +64,8 @@ katana::ConvertDateTime::operator()(
   is_valid.reserve(chunked_array->length());
 
   std::unique_ptr<arrow::ArrayBuilder> builder;
-  if (auto st =
-          arrow::MakeBuilder(arrow::default_memory_pool(), dtype_, &builder);
-      !st.ok()) {
+  auto* pool = katana::DefaultArrowMemoryPool();
+  if (auto st = arrow::MakeBuilder(pool, dtype_, &builder); !st.ok()) {
     KATANA_LOG_FATAL("failed to create builder");
   }
 
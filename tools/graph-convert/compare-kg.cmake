@@ -0,0 +1,41 @@
+# Converts INPUT to an RDG at OUTPUT by running GRAPH_CONVERT with the
+# arguments in ARGS, then checks that its topology, which is stored as a gr
+# file, lists the same edges as the edge list EXPECTED.
+#
+# Usage: cmake -DGRAPH_CONVERT=... -DARGS=... -DINPUT=... -DOUTPUT=...
+#   -DEXPECTED=... -P compare-kg.cmake
+
+string(REPLACE " " ";" ARGS "${ARGS}")
+
+# graph-convert refuses to overwrite an existing RDG
+file(REMOVE_RECURSE ${OUTPUT})
+
+execute_process(
+  COMMAND ${GRAPH_CONVERT} ${ARGS} ${INPUT} ${OUTPUT}
+  RESULT_VARIABLE result
+)
+if(result)
+  message(FATAL_ERROR "converting ${INPUT} failed: ${result}")
+endif()
+
+file(GLOB topology ${OUTPUT}/topology*)
+list(LENGTH topology num_topology)
+if(NOT num_topology EQUAL 1)
+  message(FATAL_ERROR "expected one topology file in ${OUTPUT}: ${topology}")
+endif()
+
+execute_process(
+  COMMAND ${GRAPH_CONVERT} -gr2edgelist ${topology} ${OUTPUT}.edgelist
+  RESULT_VARIABLE result
+)
+if(result)
+  message(FATAL_ERROR "reading the topology of ${OUTPUT} failed: ${result}")
+endif()
+
+execute_process(
+  COMMAND ${CMAKE_COMMAND} -E compare_files ${OUTPUT}.edgelist ${EXPECTED}
+  RESULT_VARIABLE result
+)
+if(result)
+  message(FATAL_ERROR "${OUTPUT}.edgelist differs from ${EXPECTED}")
+endif()
@@ -18,14 +18,22 @@
  */
 
 #include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
 
 #include <algorithm>
+#include <atomic>
+#include <cerrno>
 #include <cstdint>
 #include <cstdlib>
+#include <cstring>
 #include <deque>
 #include <fstream>
 #include <iostream>
 #include <limits>
+#include <optional>
+#include <queue>
 #include <random>
 #include <string>
 #include <vector>
@@ -49,7 +57,9 @@ enum ConvertMode {
   bipartitegr2sorteddegreegr,
   dimacs2gr,
   edgelist2gr,
+  edgelist2kg,
   csv2gr,
+  csv2kg,
   gr2biggr,
   gr2binarypbbs32,
   gr2binarypbbs64,
@@ -137,7 +147,15 @@ static cll::opt<ConvertMode> convertMode(
             "Sort nodes of bipartite binary gr by degree"),
         clEnumVal(dimacs2gr, "Convert dimacs to binary gr"),
         clEnumVal(edgelist2gr, "Convert edge list to binary gr"),
+        clEnumVal(
+            edgelist2kg,
+            "Convert edge list to a property graph for katana graph in "
+            "parallel with bounded memory"),
         clEnumVal(csv2gr, "Convert csv to binary gr"),
+        clEnumVal(
+            csv2kg,
+            "Convert csv to a property graph for katana graph in parallel "
+            "with bounded memory"),
         clEnumVal(
             gr2biggr,
             "Convert binary gr with little-endian edge data to "
@@ -226,6 +244,28 @@ static cll::opt<int> minValue(
     cll::init(1));
 static cll::opt<size_t> maxDegree(
     "maxDegree", cll::desc("maximum degree to keep"), cll::init(2 * 1024));
+static cll::opt<std::string> tmpDir(
+    "tmpDir",
+    cll::desc("directory for the temporary files of edgelist2kg and csv2kg "
+              "(default: $TMPDIR or /tmp)"),
+    cll::init(""));
+static cll::opt<size_t> ingestMemory(
+    "ingestMemory",
+    cll::desc("memory in MiB used to buffer edges in edgelist2kg and csv2kg"),
+    cll::init(1024));
+static cll::opt<unsigned> numThreads(
+    "t",
+    cll::desc("number of threads for edgelist2kg and csv2kg (default: all)"),
+    cll::init(0));
+static cll::opt<size_t> mergeFanIn(
+    "mergeFanIn",
+    cll::desc("most sorted runs merged at once by edgelist2kg and csv2kg"),
+    cll::init(64));
+static cll::opt<size_t> ingestRunEdges(
+    "ingestRunEdges",
+    cll::desc("edges per sorted run in edgelist2kg and csv2kg, for testing "
+              "(default: derived from ingestMemory)"),
+    cll::init(0));
 
 struct Conversion {};
 struct HasOnlyVoidSpecialization {};
@@ -3017,6 +3057,729 @@ struct Gr2Kg : public Conversion {
   }
 };
 
+/*
+ * Parallel edge list ingest for edgelist2kg and csv2kg.
+ *
+ * The input is mapped into memory and cut into chunks; a line belongs to the
+ * chunk that contains its first byte. Threads take chunks in turn, parse them
+ * with the hand-written parsers below and append the edges to a per-thread
+ * buffer. Full buffers are sorted by (src, dst) and spilled to a run file in
+ * tmpDir, so the memory used is bounded by ingestMemory regardless of the
+ * size of the input. The runs are then merged into the CSR topology and edge
+ * data files, which become the RDG; when there are more than mergeFanIn runs,
+ * earlier passes first merge them into fewer, longer runs.
+ */
+
+template <typename EdgeTy>
+struct EdgeRecord {
+  uint32_t src;
+  uint32_t dst;
+  EdgeTy data;
+};
+
+template <>
+struct EdgeRecord<void> {
+  uint32_t src;
+  uint32_t dst;
+};
+
+template <typename Record>
+bool
+RecordLess(const Record& a, const Record& b) {
+  return a.src < b.src || (a.src == b.src && a.dst < b.dst);
+}
+
+static bool
+IsBlank(char c) {
+  return c == ' ' || c == '\t' || c == '\r';
+}
+
+static bool
+IsDigit(char c) {
+  return c >= '0' && c <= '9';
+}
+
+static const char*
+SkipBlanks(const char* p, const char* end) {
+  while (p != end && IsBlank(*p)) {
+    ++p;
+  }
+  return p;
+}
+
+/// Parse an unsigned decimal integer at p
+/// \returns the first character after it or nullptr if there is no integer
+/// at p or it does not fit in 64 bits
+static const char*
+ParseUint(const char* p, const char* end, uint64_t* out) {
+  if (p != end && *p == '+') {
+    ++p;
+  }
+  if (p == end || !IsDigit(*p)) {
+    return nullptr;
+  }
+  uint64_t val = 0;
+  for (; p != end && IsDigit(*p); ++p) {
+    uint64_t digit = *p - '0';
+    if (val > (std::numeric_limits<uint64_t>::max() - digit) / 10) {
+      return nullptr;
+    }
+    val = val * 10 + digit;
+  }
+  *out = val;
+  return p;
+}
+
+static const char*
+ParseInt(const char* p, const char* end, int64_t* out) {
+  bool negative = p != end && *p == '-';
+  if (negative) {
+    ++p;
+  }
+  uint64_t mag;
+  p = ParseUint(p, end, &mag);
+  if (p == nullptr) {
+    return nullptr;
+  }
+  uint64_t limit = static_cast<uint64_t>(std::numeric_limits<int64_t>::max());
+  if (mag > limit + (negative ? 1 : 0)) {
+    return nullptr;
+  }
+  *out = negative ? static_cast<int64_t>(0 - mag) : static_cast<int64_t>(mag);
+  return p;
+}
+
+/// Parse a decimal floating point number at p. Numbers with at most 19
+/// significant digits and small exponents are converted exactly with one
+/// multiplication or division (the common case for edge weights); anything
+/// else goes through strtod.
+static const char*
+ParseFloat(const char* p, const char* end, double* out) {
+  constexpr double kPow10[] = {1e0,  1e1,  1e2,  1e3,  1e4,  1e5,
+                               1e6,  1e7,  1e8,  1e9,  1e10, 1e11,
+                               1e12, 1e13, 1e14, 1e15, 1e16, 1e17,
+                               1e18, 1e19, 1e20, 1e21, 1e22};
+  constexpr int kMaxExactPow10 = 22;
+  constexpr int kMaxDigits = 19;
+  constexpr int64_t kMaxExponent = 400;
+
+  const char* begin = p;
+  bool negative = false;
+  if (p != end && (*p == '-' || *p == '+')) {
+    negative = *p == '-';
+    ++p;
+  }
+
+  uint64_t mantissa = 0;
+  int64_t exponent = 0;
+  int digits = 0;
+  bool seen_digit = false;
+  bool exact = true;
+  auto add_digit = [&](char c) {
+    seen_digit = true;
+    if (digits == kMaxDigits) {
+      exact = false;
+      return;
+    }
+    mantissa = mantissa * 10 + (c - '0');
+    if (mantissa != 0) {
+      ++digits;
+    }
+  };
+
+  for (; p != end && IsDigit(*p); ++p) {
+    add_digit(*p);
+  }
+  if (p != end && *p == '.') {
+    for (++p; p != end && IsDigit(*p); ++p) {
+      add_digit(*p);
+      --exponent;
+    }
+  }
+  if (!seen_digit) {
+    return nullptr;
+  }
+  if (p != end && (*p == 'e' || *p == 'E')) {
+    // exponents of any length are accepted, as by strtod, but saturate at
+    // kMaxExponent, past which every double is inf or 0, so that adding
+    // them cannot overflow; strtod then converts the original text
+    const char* q = p + 1;
+    bool exp_negative = false;
+    if (q != end && (*q == '-' || *q == '+')) {
+      exp_negative = *q == '-';
+      ++q;
+    }
+    if (q == end || !IsDigit(*q)) {
+      return nullptr;
+    }
+    int64_t exp_part = 0;
+    for (; q != end && IsDigit(*q); ++q) {
+      exp_part = exp_part * 10 + (*q - '0');
+      if (exp_part > kMaxExponent) {
+        exp_part = kMaxExponent;
+        exact = false;
+      }
+    }
+    exponent += exp_negative ? -exp_part : exp_part;
+    p = q;
+  }
+
+  if (exact && mantissa <= (UINT64_C(1) << 53) &&
+      exponent >= -kMaxExactPow10 && exponent <= kMaxExactPow10) {
+    double val = static_cast<double>(mantissa);
+    val = exponent < 0 ? val / kPow10[-exponent] : val * kPow10[exponent];
+    *out = negative ? -val : val;
+    return p;
+  }
+
+  std::string token(begin, p);
+  *out = std::strtod(token.c_str(), nullptr);
+  return p;
+}
+
+template <typename T>
+static const char*
+ParseValue(const char* p, const char* end, T* out) {
+  if constexpr (std::is_floating_point<T>::value) {
+    double val;
+    p = ParseFloat(p, end, &val);
+    *out = static_cast<T>(val);
+    return p;
+  } else if constexpr (std::is_signed<T>::value) {
+    int64_t val;
+    p = ParseInt(p, end, &val);
+    if (p == nullptr || val < std::numeric_limits<T>::min() ||
+        val > std::numeric_limits<T>::max()) {
+      return nullptr;
+    }
+    *out = static_cast<T>(val);
+    return p;
+  } else {
+    uint64_t val;
+    p = ParseUint(p, end, &val);
+    if (p == nullptr || val > std::numeric_limits<T>::max()) {
+      return nullptr;
+    }
+    *out = static_cast<T>(val);
+    return p;
+  }
+}
+
+/// Skip blanks and the delimiter, if there is one, before the next field
+static const char*
+SkipSeparator(const char* p, const char* end, std::optional<char> delim) {
+  p = SkipBlanks(p, end);
+  if (delim) {
+    if (p == end || *p != *delim) {
+      return nullptr;
+    }
+    p = SkipBlanks(p + 1, end);
+  }
+  return p;
+}
+
+static const char*
+ParseNode(const char* p, const char* end, uint32_t* out) {
+  uint64_t val;
+  p = ParseUint(p, end, &val);
+  if (p == nullptr) {
+    return nullptr;
+  }
+  if (val > std::numeric_limits<uint32_t>::max()) {
+    KATANA_LOG_FATAL(
+        "node id {} does not fit in the 32 bits of a topology", val);
+  }
+  *out = static_cast<uint32_t>(val);
+  return p;
+}
+
+/// Parse one "src dst [weight]" line in [p, end), accepting the same lines as
+/// convertEdgelist; anything after the last field is ignored
+/// \returns true if the line matched
+template <typename EdgeTy>
+static bool
+ParseEdgeLine(
+    const char* p, const char* end, std::optional<char> delim,
+    EdgeRecord<EdgeTy>* record) {
+  p = ParseNode(SkipBlanks(p, end), end, &record->src);
+  if (p == nullptr || (p = SkipSeparator(p, end, delim)) == nullptr) {
+    return false;
+  }
+  p = ParseNode(p, end, &record->dst);
+  if (p == nullptr) {
+    return false;
+  }
+  if constexpr (!std::is_same<EdgeTy, void>::value) {
+    if ((p = SkipSeparator(p, end, delim)) == nullptr) {
+      return false;
+    }
+    if (ParseValue(p, end, &record->data) == nullptr) {
+      return false;
+    }
+  }
+  return true;
+}
+
+/// Sorts buffer and writes it to a new run file at path
+template <typename Record>
+static void
+SpillRun(std::vector<Record>* buffer, const std::string& path) {
+  std::sort(buffer->begin(), buffer->end(), RecordLess<Record>);
+  std::ofstream out(path, std::ios::binary);
+  out.write(
+      reinterpret_cast<const char*>(buffer->data()),
+      buffer->size() * sizeof(Record));
+  if (!out) {
+    KATANA_LOG_FATAL("writing run {}", path);
+  }
+  buffer->clear();
+}
+
+/// Buffered sequential reads of the records of a run
+template <typename Record>
+class RunReader {
+  std::ifstream in_;
+  std::string path_;
+  std::vector<Record> buf_;
+  size_t capacity_;
+  size_t pos_{0};
+
+  void Refill() {
+    buf_.resize(capacity_);
+    in_.read(
+        reinterpret_cast<char*>(buf_.data()), capacity_ * sizeof(Record));
+    if (in_.bad()) {
+      KATANA_LOG_FATAL("reading run {}", path_);
+    }
+    buf_.resize(in_.gcount() / sizeof(Record));
+    pos_ = 0;
+  }
+
+public:
+  RunReader(const std::string& path, size_t capacity)
+      : in_(path, std::ios::binary), path_(path), capacity_(capacity) {
+    if (!in_) {
+      KATANA_LOG_FATAL("opening run {}", path_);
+    }
+    Refill();
+  }
+
+  bool empty() const { return pos_ == buf_.size(); }
+  const Record& front() const { return buf_[pos_]; }
+  void pop() {
+    if (++pos_ == buf_.size()) {
+      Refill();
+    }
+  }
+};
+
+/// Buffered sequential writes to a file descriptor, starting at an offset
+class PositionalWriter {
+  int fd_;
+  uint64_t offset_;
+  std::vector<char> buf_;
+  size_t capacity_;
+
+public:
+  PositionalWriter(int fd, uint64_t offset, size_t capacity)
+      : fd_(fd), offset_(offset), capacity_(capacity) {
+    buf_.reserve(capacity_);
+  }
+
+  template <typename T>
+  void Append(const T& val) {
+    if (buf_.size() + sizeof(T) > capacity_) {
+      Flush();
+    }
+    const char* bytes = reinterpret_cast<const char*>(&val);
+    buf_.insert(buf_.end(), bytes, bytes + sizeof(T));
+  }
+
+  void Flush() {
+    size_t done = 0;
+    while (done < buf_.size()) {
+      ssize_t ret =
+          pwrite(fd_, buf_.data() + done, buf_.size() - done, offset_ + done);
+      if (ret < 0 && errno != EINTR) {
+        KATANA_LOG_FATAL(
+            "write failed: {}", katana::ResultErrno().message());
+      }
+      done += ret < 0 ? 0 : ret;
+    }
+    offset_ += done;
+    buf_.clear();
+  }
+};
+
+/// Merge sorted runs, calling emit on each record in RecordLess order. Each
+/// run is read through a buffer of buffer_records records.
+template <typename Record, typename Emit>
+static void
+MergeRuns(
+    const std::vector<std::string>& runs, size_t buffer_records, Emit emit) {
+  std::vector<RunReader<Record>> readers;
+  readers.reserve(runs.size());
+  for (const auto& run : runs) {
+    readers.emplace_back(run, buffer_records);
+  }
+  auto greater = [&readers](size_t a, size_t b) {
+    return RecordLess(readers[b].front(), readers[a].front());
+  };
+  std::priority_queue<size_t, std::vector<size_t>, decltype(greater)> heap(
+      greater);
+  for (size_t i = 0; i < readers.size(); ++i) {
+    if (!readers[i].empty()) {
+      heap.push(i);
+    }
+  }
+
+  while (!heap.empty()) {
+    size_t i = heap.top();
+    heap.pop();
+    emit(readers[i].front());
+    readers[i].pop();
+    if (!readers[i].empty()) {
+      heap.push(i);
+    }
+  }
+}
+
+template <typename Record>
+struct IngestThreadState {
+  std::vector<Record> buffer;
+  std::vector<std::string> runs;
+  uint64_t num_edges{0};
+  uint64_t max_node{0};
+  uint64_t skipped_lines{0};
+};
+
+/// Read an edge list in parallel and write it as an RDG at outfilename,
+/// using about ingestMemory MiB of memory for edges
+template <typename EdgeTy>
+void
+ingestEdgelist(
+    const std::string& infilename, const std::string& outfilename,
+    const bool skipFirstLine, std::optional<char> delim) {
+  using Record = EdgeRecord<EdgeTy>;
+  constexpr bool kHasValue = !std::is_same<EdgeTy, void>::value;
+  constexpr size_t kMinChunkSize = size_t{1} << 20;
+  constexpr size_t kMaxChunkSize = size_t{64} << 20;
+  constexpr size_t kChunksPerThread = 8;
+  constexpr size_t kMinBufferRecords = 4096;
+  constexpr size_t kWriterBufferSize = size_t{4} << 20;
+
+  unsigned requested_threads = numThreads;
+  katana::setActiveThreads(requested_threads ? requested_threads : 1000);
+  const size_t num_threads = katana::getActiveThreads();
+  const size_t memory = ingestMemory * (size_t{1} << 20);
+
+  std::string tmp_base = tmpDir;
+  if (tmp_base.empty()) {
+    const char* env = std::getenv("TMPDIR");
+    tmp_base = env ? env : "/tmp";
+  }
+  std::string tmp_template = tmp_base + "/graph-convert-XXXXXX";
+  if (mkdtemp(tmp_template.data()) == nullptr) {
+    KATANA_LOG_FATAL(
+        "creating temporary directory in {}: {}", tmp_base,
+        katana::ResultErrno().message());
+  }
+  const std::string tmp_path = tmp_template;
+
+  int in_fd = open(infilename.c_str(), O_RDONLY);
+  if (in_fd < 0) {
+    KATANA_LOG_FATAL(
+        "opening {}: {}", infilename, katana::ResultErrno().message());
+  }
+  struct stat in_stat;
+  if (fstat(in_fd, &in_stat) != 0) {
+    KATANA_LOG_FATAL(
+        "stat {}: {}", infilename, katana::ResultErrno().message());
+  }
+  const size_t size = in_stat.st_size;
+  const char* base = nullptr;
+  if (size > 0) {
+    void* ptr = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, in_fd, 0);
+    if (ptr == MAP_FAILED) {
+      KATANA_LOG_FATAL(
+          "mapping {}: {}", infilename, katana::ResultErrno().message());
+    }
+    madvise(ptr, size, MADV_SEQUENTIAL);
+    base = static_cast<const char*>(ptr);
+  }
+  close(in_fd);
+
+  size_t data_begin = 0;
+  if (skipFirstLine) {
+    katana::gWarn(
+        "first line is assumed to contain labels and will be ignored\n");
+    const void* eol = size ? std::memchr(base, '\n', size) : nullptr;
+    data_begin = eol ? static_cast<const char*>(eol) - base + 1 : size;
+  }
+
+  const size_t chunk_size = std::clamp(
+      (size - data_begin) / (num_threads * kChunksPerThread), kMinChunkSize,
+      kMaxChunkSize);
+  const size_t num_chunks = (size - data_begin + chunk_size - 1) / chunk_size;
+  const size_t buffer_records =
+      ingestRunEdges != 0 ? size_t{ingestRunEdges}
+                          : std::max(
+                                memory / (num_threads * sizeof(Record)),
+                                kMinBufferRecords);
+
+  // parse and spill sorted runs
+  std::atomic<size_t> next_chunk{0};
+  std::vector<IngestThreadState<Record>> states(num_threads);
+  katana::on_each([&](unsigned tid, unsigned) {
+    IngestThreadState<Record>& state = states[tid];
+    state.buffer.reserve(buffer_records);
+    const char* file_end = base + size;
+    auto spill = [&]() {
+      std::string path = fmt::format(
+          "{}/run-{}-{}", tmp_path, tid, state.runs.size());
+      SpillRun(&state.buffer, path);
+      state.runs.emplace_back(std::move(path));
+    };
+
+    for (size_t chunk = next_chunk++; chunk < num_chunks;
+         chunk = next_chunk++) {
+      size_t begin = data_begin + chunk * chunk_size;
+      const char* p = base + begin;
+      const char* chunk_end = base + std::min(begin + chunk_size, size);
+      if (begin != data_begin && p[-1] != '\n') {
+        // the line at begin belongs to the previous chunk
+        const void* eol = std::memchr(p, '\n', file_end - p);
+        p = eol ? static_cast<const char*>(eol) + 1 : file_end;
+      }
+
+      Record record;
+      while (p < chunk_end) {
+        const void* eol = std::memchr(p, '\n', file_end - p);
+        const char* line_end = eol ? static_cast<const char*>(eol) : file_end;
+        if (ParseEdgeLine(p, line_end, delim, &record)) {
+          state.max_node = std::max<uint64_t>(
+              state.max_node, std::max(record.src, record.dst));
+          ++state.num_edges;
+          state.buffer.emplace_back(record);
+          if (state.buffer.size() == buffer_records) {
+            spill();
+          }
+        } else {
+          ++state.skipped_lines;
+        }
+        p = line_end + 1;
+      }
+    }
+
+    if (!state.buffer.empty()) {
+      spill();
+    }
+    std::vector<Record>().swap(state.buffer);
+  });
+
+  if (base != nullptr) {
+    munmap(const_cast<char*>(base), size);
+  }
+
+  uint64_t num_edges = 0;
+  uint64_t max_node = 0;
+  uint64_t skipped_lines = 0;
+  std::vector<std::string> runs;
+  for (auto& state : states) {
+    num_edges += state.num_edges;
+    max_node = std::max(max_node, state.max_node);
+    skipped_lines += state.skipped_lines;
+    runs.insert(runs.end(), state.runs.begin(), state.runs.end());
+  }
+  if (skipped_lines) {
+    katana::gWarn(
+        "ignored ", skipped_lines,
+        " lines because they did not match the expected format\n");
+  }
+  katana::gPrint(
+      "Parsed ", num_edges, " edges into ", runs.size(), " sorted runs\n");
+
+  // merge groups of at most fan_in runs into longer runs until a single
+  // merge can produce the output, so the number of open files is bounded
+  const size_t fan_in = std::max<size_t>(mergeFanIn, 2);
+  auto reader_records = [&](size_t num_runs) {
+    return std::max(memory / (num_runs * sizeof(Record)), kMinBufferRecords);
+  };
+  for (size_t pass = 0; runs.size() > fan_in; ++pass) {
+    std::vector<std::string> merged;
+    for (size_t begin = 0; begin < runs.size(); begin += fan_in) {
+      std::vector<std::string> group(
+          runs.begin() + begin,
+          runs.begin() + std::min(begin + fan_in, runs.size()));
+      std::string path =
+          fmt::format("{}/merge-{}-{}", tmp_path, pass, merged.size());
+      int fd = open(path.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0666);
+      if (fd < 0) {
+        KATANA_LOG_FATAL(
+            "creating {}: {}", path, katana::ResultErrno().message());
+      }
+      PositionalWriter out(fd, 0, kWriterBufferSize);
+      MergeRuns<Record>(
+          group, reader_records(group.size()),
+          [&out](const Record& record) { out.Append(record); });
+      out.Flush();
+      close(fd);
+      for (const auto& run : group) {
+        unlink(run.c_str());
+      }
+      merged.emplace_back(std::move(path));
+    }
+    runs = std::move(merged);
+  }
+
+  // merge the runs into a CSR topology and an edge data file
+  tsuba::CSRTopologyHeader header{
+      .version = 1,
+      .edge_type_size = 0,
+      .num_nodes = num_edges == 0 ? 0 : max_node + 1,
+      .num_edges = num_edges,
+  };
+  const uint64_t top_size = tsuba::CSRTopologyFileSize(header);
+  const std::string top_path = tmp_path + "/topology";
+  int top_fd = open(top_path.c_str(), O_RDWR | O_CREAT | O_TRUNC, 0666);
+  if (top_fd < 0 || ftruncate(top_fd, top_size) != 0) {
+    KATANA_LOG_FATAL(
+        "creating {}: {}", top_path, katana::ResultErrno().message());
+  }
+  const std::string data_path = tmp_path + "/edge-data";
+  int data_fd = -1;
+  if (kHasValue) {
+    data_fd = open(data_path.c_str(), O_RDWR | O_CREAT | O_TRUNC, 0666);
+    if (data_fd < 0) {
+      KATANA_LOG_FATAL(
+          "creating {}: {}", data_path, katana::ResultErrno().message());
+    }
+  }
+
+  PositionalWriter header_writer(top_fd, 0, sizeof(header));
+  header_writer.Append(header);
+  header_writer.Flush();
+  PositionalWriter indices(top_fd, sizeof(header), kWriterBufferSize);
+  PositionalWriter dests(
+      top_fd, sizeof(header) + header.num_nodes * sizeof(uint64_t),
+      kWriterBufferSize);
+  PositionalWriter data(data_fd, 0, kWriterBufferSize);
+
+  uint64_t node = 0;
+  uint64_t edge = 0;
+  MergeRuns<Record>(
+      runs, reader_records(std::max<size_t>(runs.size(), 1)),
+      [&](const Record& record) {
+        for (; node < record.src; ++node) {
+          indices.Append<uint64_t>(edge);
+        }
+        dests.Append<uint32_t>(record.dst);
+        if constexpr (kHasValue) {
+          data.Append<EdgeTy>(record.data);
+        }
+        ++edge;
+      });
+  for (; node < header.num_nodes; ++node) {
+    indices.Append<uint64_t>(edge);
+  }
+  KATANA_LOG_ASSERT(edge == num_edges);
+  indices.Flush();
+  dests.Flush();
+  data.Flush();
+  close(top_fd);
+  for (const auto& run : runs) {
+    unlink(run.c_str());
+  }
+
+  // write the RDG
+  if (auto res = tsuba::Create(outfilename); !res) {
+    KATANA_LOG_FATAL("creating {}: {}", outfilename, res.error());
+  }
+  auto handle_res = tsuba::Open(outfilename, tsuba::kReadWrite);
+  if (!handle_res) {
+    KATANA_LOG_FATAL("opening {}: {}", outfilename, handle_res.error());
+  }
+  tsuba::RDGFile handle(std::move(handle_res.value()));
+
+  katana::Uri top_file_name = tsuba::MakeTopologyFileName(handle);
+  if (auto res = tsuba::FileRemoteCopy(
+          top_path, top_file_name.string(), 0, top_size);
+      !res) {
+    KATANA_LOG_FATAL("copying topology: {}", res.error());
+  }
+
+  tsuba::RDG rdg;
+  rdg.set_rdg_dir(tsuba::GetRDGDir(handle));
+  if (auto res = rdg.SetTopologyFile(top_file_name); !res) {
+    KATANA_LOG_FATAL("setting topology: {}", res.error());
+  }
+
+  // the edge data is mapped, not read, so it does not count against memory
+  void* data_ptr = nullptr;
+  size_t data_size = 0;
+  if constexpr (kHasValue) {
+    using ArrowType = typename arrow::CTypeTraits<EdgeTy>::ArrowType;
+    std::shared_ptr<arrow::Buffer> buffer;
+    if (num_edges > 0) {
+      data_size = num_edges * sizeof(EdgeTy);
+      data_ptr = mmap(nullptr, data_size, PROT_READ, MAP_SHARED, data_fd, 0);
+      if (data_ptr == MAP_FAILED) {
+        KATANA_LOG_FATAL(
+            "mapping {}: {}", data_path, katana::ResultErrno().message());
+      }
+      buffer = std::make_shared<arrow::Buffer>(
+          static_cast<const uint8_t*>(data_ptr), data_size);
+    } else {
+      buffer = std::make_shared<arrow::Buffer>(nullptr, 0);
+    }
+    auto values = std::make_shared<arrow::NumericArray<ArrowType>>(
+        static_cast<int64_t>(num_edges), std::move(buffer));
+    auto table = arrow::Table::Make(
+        arrow::schema({arrow::field("value", values->type())}), {values});
+    if (auto res = rdg.AddEdgeProperties(table); !res) {
+      KATANA_LOG_FATAL("could not add edge property: {}", res.error());
+    }
+    rdg.MarkAllPropertiesPersistent();
+  }
+
+  if (auto res = rdg.Store(handle, kCommandLine); !res) {
+    KATANA_LOG_FATAL("storing {}: {}", outfilename, res.error());
+  }
+
+  if (data_ptr != nullptr) {
+    munmap(data_ptr, data_size);
+  }
+  if (data_fd >= 0) {
+    close(data_fd);
+    unlink(data_path.c_str());
+  }
+  unlink(top_path.c_str());
+  rmdir(tmp_path.c_str());
+
+  printStatus(header.num_nodes, num_edges);
+}
+
+/**
+ * Parallel, bounded memory version of CSV2Gr that writes an RDG
+ */
+struct CSV2Kg : public Conversion {
+  template <typename EdgeTy>
+  void convert(const std::string& infilename, const std::string& outfilename) {
+    ingestEdgelist<EdgeTy>(infilename, outfilename, true, ',');
+  }
+};
+
+/**
+ * Parallel, bounded memory version of Edgelist2Gr that writes an RDG
+ */
+struct Edgelist2Kg : public Conversion {
+  template <typename EdgeTy>
+  void convert(const std::string& infilename, const std::string& outfilename) {
+    ingestEdgelist<EdgeTy>(
+        infilename, outfilename, false, std::optional<char>());
+  }
+};
+
 /**
  * METIS format (1-indexed). See METIS 4.10 manual, section 4.5.
  *  % comment prefix
@@ -3293,9 +4056,15 @@ main(int argc, char** argv) {
   case edgelist2gr:
     convert<Edgelist2Gr>();
     break;
+  case edgelist2kg:
+    convert<Edgelist2Kg>();
+    break;
   case csv2gr:
     convert<CSV2Gr>();
     break;
+  case csv2kg:
+    convert<CSV2Kg>();
+    break;
   case gr2biggr:
     convert<ToBigEndian>();
     break;
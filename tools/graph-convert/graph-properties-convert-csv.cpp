@@ -0,0 +1,498 @@
+#include "graph-properties-convert-csv.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+#include <boost/algorithm/string.hpp>
+#include <nlohmann/json.hpp>
+
+#include "graph-properties-convert-schema.h"
+#include "katana/Galois.h"
+#include "katana/Logging.h"
+#include "katana/Threads.h"
+
+using katana::ImportDataType;
+using katana::LabelRule;
+using katana::PropertyGraphBuilder;
+using katana::PropertyKey;
+
+namespace {
+
+/*****************************************/
+/* Functions for building graph elements */
+/*****************************************/
+
+// What a column or JSON field of an input record holds
+enum class Role { kProperty, kId, kLabels, kSource, kTarget };
+
+/*
+ * id, label(s), source, target and type are reserved names; the header
+ * names of neo4j-admin CSV files (":ID", ":LABEL", ":START_ID", ":END_ID",
+ * ":TYPE") are understood as well
+ */
+Role
+ColumnRole(const std::string& name, bool for_node) {
+  std::string lower = boost::to_lower_copy(name);
+  if (for_node) {
+    if (lower == "id" || boost::ends_with(lower, ":id")) {
+      return Role::kId;
+    }
+    if (lower == "label" || lower == "labels" ||
+        boost::ends_with(lower, ":label")) {
+      return Role::kLabels;
+    }
+    return Role::kProperty;
+  }
+  if (lower == "source" || boost::ends_with(lower, ":start_id")) {
+    return Role::kSource;
+  }
+  if (lower == "target" || boost::ends_with(lower, ":end_id")) {
+    return Role::kTarget;
+  }
+  if (lower == "label" || lower == "labels" || lower == "type" ||
+      boost::ends_with(lower, ":type")) {
+    return Role::kLabels;
+  }
+  return Role::kProperty;
+}
+
+// labels are separated by ':' (neo4j GraphML) or ';' (neo4j-admin CSV)
+void
+AddLabels(const std::string& data, std::vector<std::string>* labels) {
+  std::vector<std::string> split;
+  boost::split(split, data, boost::is_any_of(":;"));
+  for (std::string& label : split) {
+    if (!label.empty()) {
+      labels->emplace_back(std::move(label));
+    }
+  }
+}
+
+/// One node or edge of the input
+struct Element {
+  std::string id;
+  std::string source;
+  std::string target;
+  std::vector<std::string> labels;
+  // property name, text of the value
+  std::vector<std::pair<const std::string*, std::string>> properties;
+
+  void Clear() {
+    id.clear();
+    source.clear();
+    target.clear();
+    labels.clear();
+    properties.clear();
+  }
+
+  void Set(Role role, const std::string* name, std::string value) {
+    switch (role) {
+    case Role::kId:
+      id = std::move(value);
+      break;
+    case Role::kLabels:
+      AddLabels(value, &labels);
+      break;
+    case Role::kSource:
+      source = std::move(value);
+      break;
+    case Role::kTarget:
+      target = std::move(value);
+      break;
+    case Role::kProperty:
+      // empty fields are nulls
+      if (!value.empty()) {
+        properties.emplace_back(name, std::move(value));
+      }
+      break;
+    }
+  }
+};
+
+void
+AddElement(PropertyGraphBuilder* builder, const Element& elt, bool for_node) {
+  if (for_node) {
+    if (elt.id.empty()) {
+      builder->StartNode();
+    } else {
+      builder->StartNode(elt.id);
+    }
+  } else if (
+      elt.source.empty() || elt.target.empty() ||
+      !builder->StartEdge(elt.source, elt.target)) {
+    return;
+  }
+
+  for (const auto& property : elt.properties) {
+    const std::string& name = *property.first;
+    const std::string& value = property.second;
+    builder->AddValue(
+        name,
+        [&]() { return PropertyKey{name, ImportDataType::kString, false}; },
+        [&value](ImportDataType type, bool is_list) {
+          return katana::ResolveValue(value, type, is_list);
+        });
+  }
+  for (const std::string& label : elt.labels) {
+    builder->AddLabel(label);
+  }
+
+  if (for_node) {
+    builder->FinishNode();
+  } else {
+    builder->FinishEdge();
+  }
+}
+
+/***************************************/
+/* Functions for splitting input files */
+/***************************************/
+
+/*
+ * splits text into parts of whole records and at least part_bytes bytes for
+ * the threads to parse; a record ends at a newline outside of double quotes
+ * when quotes is true and at any newline otherwise
+ */
+std::vector<std::string_view>
+SplitRecords(std::string_view text, bool quotes, size_t part_bytes) {
+  size_t threads = katana::getActiveThreads();
+  size_t target =
+      std::max({part_bytes, text.size() / (threads * 4), size_t{1}});
+  size_t num_parts = std::max<size_t>((text.size() + target - 1) / target, 1);
+
+  // whether the start of each nominal part is inside quotes
+  std::vector<uint8_t> in_quotes(num_parts, 0);
+  if (quotes) {
+    katana::do_all(
+        katana::iterate(static_cast<size_t>(0), num_parts),
+        [&](const size_t& i) {
+          size_t begin = i * target;
+          size_t end = std::min(text.size(), begin + target);
+          in_quotes[i] =
+              std::count(text.begin() + begin, text.begin() + end, '"') & 1;
+        });
+    uint8_t parity = 0;
+    for (size_t i = 0; i < num_parts; ++i) {
+      uint8_t part_parity = in_quotes[i];
+      in_quotes[i] = parity;
+      parity ^= part_parity;
+    }
+  }
+
+  // move the start of each part to the start of the next record
+  std::vector<size_t> bounds(num_parts + 1, text.size());
+  bounds[0] = 0;
+  katana::do_all(
+      katana::iterate(static_cast<size_t>(1), num_parts),
+      [&](const size_t& i) {
+        size_t pos = i * target;
+        bool quoted = in_quotes[i];
+        for (; pos < text.size(); ++pos) {
+          if (quotes && text[pos] == '"') {
+            quoted = !quoted;
+          } else if (text[pos] == '\n' && !quoted) {
+            ++pos;
+            break;
+          }
+        }
+        bounds[i] = pos;
+      });
+
+  std::vector<std::string_view> parts;
+  for (size_t i = 0; i < num_parts; ++i) {
+    if (bounds[i] < bounds[i + 1]) {
+      parts.emplace_back(text.substr(bounds[i], bounds[i + 1] - bounds[i]));
+    }
+  }
+  return parts;
+}
+
+/// A part of an input file and how to read it
+struct Part {
+  std::string_view text;
+  bool for_node;
+  // column names of CSV input
+  const std::vector<std::string>* header;
+  const std::vector<Role>* roles;
+};
+
+/*****************************/
+/* Functions for parsing CSV */
+/*****************************/
+
+/*
+ * parses the record starting at pos into fields; fields may be quoted with
+ * '"', in which case they may contain the delimiter, newlines and '""' for a
+ * quote
+ *
+ * returns the position of the next record
+ */
+size_t
+ParseCsvRecord(
+    std::string_view text, size_t pos, char delimiter,
+    std::vector<std::string>* fields) {
+  fields->clear();
+  std::string field;
+  bool quoted = false;
+  while (pos < text.size()) {
+    char c = text[pos];
+    if (quoted) {
+      if (c == '"') {
+        if (pos + 1 < text.size() && text[pos + 1] == '"') {
+          field += '"';
+          ++pos;
+        } else {
+          quoted = false;
+        }
+      } else {
+        field += c;
+      }
+    } else if (c == '"') {
+      quoted = true;
+    } else if (c == delimiter) {
+      fields->emplace_back(std::move(field));
+      field.clear();
+    } else if (c == '\n' || c == '\r') {
+      break;
+    } else {
+      field += c;
+    }
+    ++pos;
+  }
+  fields->emplace_back(std::move(field));
+
+  // skip the line ending
+  if (pos < text.size() && text[pos] == '\r') {
+    ++pos;
+  }
+  if (pos < text.size() && text[pos] == '\n') {
+    ++pos;
+  }
+  return pos;
+}
+
+void
+ParseCsvPart(const Part& part, char delimiter, PropertyGraphBuilder* builder) {
+  std::vector<std::string> fields;
+  Element elt;
+  for (size_t pos = 0; pos < part.text.size();) {
+    pos = ParseCsvRecord(part.text, pos, delimiter, &fields);
+    // blank line
+    if (fields.size() == 1 && fields[0].empty()) {
+      continue;
+    }
+    elt.Clear();
+    size_t num_fields = std::min(fields.size(), part.header->size());
+    for (size_t i = 0; i < num_fields; ++i) {
+      elt.Set(part.roles->at(i), &part.header->at(i), std::move(fields[i]));
+    }
+    AddElement(builder, elt, part.for_node);
+  }
+}
+
+/************************************/
+/* Functions for parsing JSON lines */
+/************************************/
+
+// text of a JSON value in the form ResolveValue expects
+std::string
+JsonText(const nlohmann::json& value) {
+  if (value.is_string()) {
+    return value.get<std::string>();
+  }
+  if (value.is_boolean()) {
+    return value.get<bool>() ? "true" : "false";
+  }
+  return value.dump();
+}
+
+// returns the number of lines that are not JSON objects
+size_t
+ParseJsonlPart(const Part& part, PropertyGraphBuilder* builder) {
+  size_t invalid = 0;
+  Element elt;
+  for (size_t pos = 0; pos < part.text.size();) {
+    size_t end = part.text.find('\n', pos);
+    if (end == std::string_view::npos) {
+      end = part.text.size();
+    }
+    std::string_view line = part.text.substr(pos, end - pos);
+    pos = end + 1;
+    if (line.find_first_not_of(" \t\r") == std::string_view::npos) {
+      continue;
+    }
+
+    auto json = nlohmann::json::parse(line.begin(), line.end(), nullptr, false);
+    if (json.is_discarded() || !json.is_object()) {
+      ++invalid;
+      continue;
+    }
+    elt.Clear();
+    for (const auto& [name, value] :
+         json.get_ref<const nlohmann::json::object_t&>()) {
+      Role role = ColumnRole(name, part.for_node);
+      if (value.is_null()) {
+        continue;
+      }
+      if (role == Role::kLabels && value.is_array()) {
+        for (const auto& label : value) {
+          elt.Set(role, &name, JsonText(label));
+        }
+      } else {
+        elt.Set(role, &name, JsonText(value));
+      }
+    }
+    AddElement(builder, elt, part.for_node);
+  }
+  return invalid;
+}
+
+/**************************************/
+/* Functions for converting the input */
+/**************************************/
+
+enum class Format { kCsv, kJsonl };
+
+/// An input file with the column names of its header for CSV input
+struct Input {
+  std::unique_ptr<katana::MappedFile> file;
+  std::vector<std::string> header;
+  std::vector<Role> roles;
+};
+
+void
+OpenInput(
+    const std::string& filename, bool for_node, Format format, char delimiter,
+    size_t part_bytes, Input* input, std::vector<Part>* parts) {
+  if (filename.empty()) {
+    return;
+  }
+  std::cout << "Start reading " << (for_node ? "nodes" : "edges")
+            << " file: " << filename << "\n";
+  input->file = std::make_unique<katana::MappedFile>(filename);
+  std::string_view text = input->file->text();
+
+  if (format == Format::kCsv) {
+    size_t body = ParseCsvRecord(text, 0, delimiter, &input->header);
+    for (const std::string& name : input->header) {
+      input->roles.emplace_back(ColumnRole(name, for_node));
+    }
+    if (!for_node &&
+        (std::find(input->roles.begin(), input->roles.end(), Role::kSource) ==
+             input->roles.end() ||
+         std::find(input->roles.begin(), input->roles.end(), Role::kTarget) ==
+             input->roles.end())) {
+      KATANA_LOG_FATAL(
+          "{} needs source and target columns, found: {}", filename,
+          boost::join(input->header, ","));
+    }
+    text = text.substr(body);
+  }
+
+  for (std::string_view part_text :
+       SplitRecords(text, format == Format::kCsv, part_bytes)) {
+    parts->emplace_back(
+        Part{part_text, for_node, &input->header, &input->roles});
+  }
+}
+
+katana::GraphComponents
+ConvertText(
+    const std::string& nodes_filename, const std::string& edges_filename,
+    const std::string& mapping, Format format, char delimiter,
+    size_t chunk_size, size_t part_bytes) {
+  katana::setActiveThreads(1000);
+
+  std::vector<LabelRule> rules;
+  std::vector<PropertyKey> keys;
+  if (!mapping.empty()) {
+    std::tie(rules, keys) = katana::ProcessSchemaMapping(mapping);
+  }
+
+  Input nodes;
+  Input edges;
+  std::vector<Part> parts;
+  OpenInput(
+      nodes_filename, true, format, delimiter, part_bytes, &nodes, &parts);
+  OpenInput(
+      edges_filename, false, format, delimiter, part_bytes, &edges, &parts);
+
+  std::vector<PropertyGraphBuilder> builders;
+  builders.reserve(std::max<size_t>(parts.size(), 1));
+  for (size_t i = 0; i < std::max<size_t>(parts.size(), 1); ++i) {
+    builders.emplace_back(chunk_size);
+    for (const LabelRule& rule : rules) {
+      builders.back().AddLabelBuilder(rule);
+    }
+    for (const PropertyKey& key : keys) {
+      builders.back().AddBuilder(key);
+    }
+  }
+
+  std::atomic<size_t> invalid{0};
+  katana::do_all(
+      katana::iterate(static_cast<size_t>(0), parts.size()),
+      [&](const size_t& i) {
+        if (format == Format::kCsv) {
+          ParseCsvPart(parts[i], delimiter, &builders[i]);
+        } else {
+          invalid += ParseJsonlPart(parts[i], &builders[i]);
+        }
+      },
+      katana::steal(), katana::chunk_size<1>(),
+      katana::loopname("ParseRecords"));
+  if (invalid > 0) {
+    KATANA_LOG_WARN("skipped {} lines that are not JSON objects", invalid);
+  }
+
+  std::cout << "Parsed " << parts.size() << " parts of the input\n";
+  return PropertyGraphBuilder::Merge(&builders);
+}
+
+}  // end of unnamed namespace
+
+/// ConvertCsv converts delimited text files of nodes and edges into katana
+/// form
+///
+/// The first line of each file names its columns; the files are split into
+/// parts of whole records that are parsed in parallel. Property types come
+/// from the keys of the optional GraphML schema mapping and default to
+/// strings.
+///
+/// \param nodes_filename path to the nodes file, may be empty
+/// \param edges_filename path to the edges file, may be empty
+/// \param part_bytes smallest part parsed by its own thread, usually
+/// kDefaultPartBytes
+/// \returns arrow tables of node properties/labels, edge properties/types, and
+/// csr topology
+katana::GraphComponents
+katana::ConvertCsv(
+    const std::string& nodes_filename, const std::string& edges_filename,
+    const std::string& mapping, char delimiter, size_t chunk_size,
+    size_t part_bytes) {
+  return ConvertText(
+      nodes_filename, edges_filename, mapping, Format::kCsv, delimiter,
+      chunk_size, part_bytes);
+}
+
+/// ConvertJsonl converts files of nodes and edges with one JSON object per
+/// line into katana form
+///
+/// Fields are handled like the columns of ConvertCsv; arrays are lists and
+/// labels may also be given as an array of strings.
+katana::GraphComponents
+katana::ConvertJsonl(
+    const std::string& nodes_filename, const std::string& edges_filename,
+    const std::string& mapping, size_t chunk_size, size_t part_bytes) {
+  return ConvertText(
+      nodes_filename, edges_filename, mapping, Format::kJsonl, ',',
+      chunk_size, part_bytes);
+}
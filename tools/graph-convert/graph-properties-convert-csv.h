@@ -0,0 +1,19 @@
+#ifndef KATANA_TOOLS_GRAPH_CONVERT_GRAPH_PROPERTIES_CONVERT_CSV_H_
+#define KATANA_TOOLS_GRAPH_CONVERT_GRAPH_PROPERTIES_CONVERT_CSV_H_
+
+#include "katana/BuildGraph.h"
+
+namespace katana {
+
+GraphComponents ConvertCsv(
+    const std::string& nodes_filename, const std::string& edges_filename,
+    const std::string& mapping, char delimiter, size_t chunk_size,
+    size_t part_bytes);
+
+GraphComponents ConvertJsonl(
+    const std::string& nodes_filename, const std::string& edges_filename,
+    const std::string& mapping, size_t chunk_size, size_t part_bytes);
+
+}  // end namespace katana
+
+#endif
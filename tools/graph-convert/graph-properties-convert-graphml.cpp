@@ -1,8 +1,11 @@
 #include "graph-properties-convert-graphml.h"
 
 #include <algorithm>
+#include <array>
+#include <atomic>
 #include <cstdint>
 #include <cstdlib>
+#include <cstring>
 #include <deque>
 #include <fstream>
 #include <iostream>
@@ -11,6 +14,7 @@
 #include <optional>
 #include <random>
 #include <sstream>
+#include <string_view>
 #include <unordered_map>
 #include <unordered_set>
 #include <vector>
@@ -33,246 +37,6 @@ using katana::PropertyKey;
 
 namespace {
 
-/******************************/
-/* Functions for parsing data */
-/******************************/
-
-std::optional<std::vector<std::string>>
-ParseStringList(std::string raw_list) {
-  std::vector<std::string> list;
-
-  if (raw_list.size() >= 2 && raw_list.front() == '[' &&
-      raw_list.back() == ']') {
-    raw_list.erase(0, 1);
-    raw_list.erase(raw_list.length() - 1, 1);
-  } else {
-    KATANA_LOG_ERROR(
-        "The provided list was not formatted like neo4j, returning null");
-    return std::nullopt;
-  }
-
-  const char* char_list = raw_list.c_str();
-  // parse the list
-  for (size_t i = 0; i < raw_list.size();) {
-    bool first_quote_found = false;
-    bool found_end_of_elem = false;
-    size_t start_of_elem = i;
-    int consecutive_slashes = 0;
-
-    // parse the field
-    for (; !found_end_of_elem && i < raw_list.size(); i++) {
-      // if second quote not escaped then end of element reached
-      if (char_list[i] == '\"') {
-        if (consecutive_slashes % 2 == 0) {
-          if (!first_quote_found) {
-            first_quote_found = true;
-            start_of_elem = i + 1;
-          } else if (first_quote_found) {
-            found_end_of_elem = true;
-          }
-        }
-        consecutive_slashes = 0;
-      } else if (char_list[i] == '\\') {
-        consecutive_slashes++;
-      } else {
-        consecutive_slashes = 0;
-      }
-    }
-    size_t end_of_elem = i - 1;
-    size_t elem_length = end_of_elem - start_of_elem;
-
-    if (end_of_elem <= start_of_elem) {
-      list.emplace_back("");
-    } else {
-      std::string elem_rough(&char_list[start_of_elem], elem_length);
-      std::string elem("");
-      elem.reserve(elem_rough.size());
-      size_t curr_index = 0;
-      size_t next_slash = elem_rough.find_first_of('\\');
-
-      while (next_slash != std::string::npos) {
-        elem.append(
-            elem_rough.begin() + curr_index, elem_rough.begin() + next_slash);
-
-        switch (elem_rough[next_slash + 1]) {
-        case 'n':
-          elem.append("\n");
-          break;
-        case '\\':
-          elem.append("\\");
-          break;
-        case 'r':
-          elem.append("\r");
-          break;
-        case '0':
-          elem.append("\0");
-          break;
-        case 'b':
-          elem.append("\b");
-          break;
-        case '\'':
-          elem.append("\'");
-          break;
-        case '\"':
-          elem.append("\"");
-          break;
-        case 't':
-          elem.append("\t");
-          break;
-        case 'f':
-          elem.append("\f");
-          break;
-        case 'v':
-          elem.append("\v");
-          break;
-        case '\xFF':
-          elem.append("\xFF");
-          break;
-        default:
-          KATANA_LOG_WARN(
-              "Unhandled escape character: {}", elem_rough[next_slash + 1]);
-        }
-
-        curr_index = next_slash + 2;
-        next_slash = elem_rough.find_first_of('\\', curr_index);
-      }
-      elem.append(elem_rough.begin() + curr_index, elem_rough.end());
-
-      list.emplace_back(elem);
-    }
-  }
-
-  return list;
-}
-
-template <typename T>
-std::optional<std::vector<T>>
-ParseNumberList(std::string raw_list) {
-  std::vector<T> list;
-
-  if (raw_list.front() == '[' && raw_list.back() == ']') {
-    raw_list.erase(0, 1);
-    raw_list.erase(raw_list.length() - 1, 1);
-  } else {
-    KATANA_LOG_ERROR(
-        "The provided list was not formatted like neo4j, "
-        "returning empty vector");
-    return std::nullopt;
-  }
-  std::vector<std::string> elems;
-  boost::split(elems, raw_list, boost::is_any_of(","));
-
-  for (std::string s : elems) {
-    try {
-      list.emplace_back(boost::lexical_cast<T>(s));
-    } catch (const boost::bad_lexical_cast&) {
-    }
-  }
-  return list;
-}
-
-std::optional<std::vector<bool>>
-ParseBooleanList(std::string raw_list) {
-  std::vector<bool> list;
-
-  if (raw_list.front() == '[' && raw_list.back() == ']') {
-    raw_list.erase(0, 1);
-    raw_list.erase(raw_list.length() - 1, 1);
-  } else {
-    KATANA_LOG_ERROR(
-        "The provided list was not formatted like neo4j, "
-        "returning empty vector");
-    return std::nullopt;
-  }
-  std::vector<std::string> elems;
-  boost::split(elems, raw_list, boost::is_any_of(","));
-
-  for (std::string s : elems) {
-    if (!s.empty()) {
-      bool bool_val = s[0] == 't' || s[0] == 'T';
-      list.emplace_back(bool_val);
-    }
-  }
-  return list;
-}
-
-/************************************************/
-/* Functions for adding values to arrow builder */
-/************************************************/
-
-template <typename T>
-ImportData
-Resolve(ImportDataType type, bool is_list, T val) {
-  ImportData data{type, is_list};
-  data.value = val;
-  return data;
-}
-
-template <typename Fn>
-ImportData
-ResolveOptionalList(ImportDataType type, const std::string& val, Fn resolver) {
-  ImportData data{type, true};
-
-  auto res = resolver(val);
-  if (!res) {
-    data.type = ImportDataType::kUnsupported;
-  } else {
-    data.value = res.value();
-  }
-  return data;
-}
-
-ImportData
-ResolveListValue(const std::string& val, ImportDataType type) {
-  switch (type) {
-  case ImportDataType::kString:
-    return ResolveOptionalList(type, val, ParseStringList);
-  case ImportDataType::kInt64:
-    return ResolveOptionalList(type, val, ParseNumberList<int64_t>);
-  case ImportDataType::kInt32:
-    return ResolveOptionalList(type, val, ParseNumberList<int32_t>);
-  case ImportDataType::kDouble:
-    return ResolveOptionalList(type, val, ParseNumberList<double>);
-  case ImportDataType::kFloat:
-    return ResolveOptionalList(type, val, ParseNumberList<float>);
-  case ImportDataType::kBoolean:
-    return ResolveOptionalList(type, val, ParseBooleanList);
-  case ImportDataType::kTimestampMilli:
-    return ImportData{ImportDataType::kUnsupported, true};
-  default:
-    return ImportData{ImportDataType::kUnsupported, true};
-  }
-}
-
-ImportData
-ResolveValue(const std::string& val, ImportDataType type, bool is_list) {
-  if (is_list) {
-    return ResolveListValue(val, type);
-  }
-  try {
-    switch (type) {
-    case ImportDataType::kString:
-      return Resolve(type, is_list, val);
-    case ImportDataType::kInt64:
-      return Resolve(type, is_list, boost::lexical_cast<int64_t>(val));
-    case ImportDataType::kInt32:
-      return Resolve(type, is_list, boost::lexical_cast<int32_t>(val));
-    case ImportDataType::kDouble:
-      return Resolve(type, is_list, boost::lexical_cast<double>(val));
-    case ImportDataType::kFloat:
-      return Resolve(type, is_list, boost::lexical_cast<float>(val));
-    case ImportDataType::kBoolean:
-      return Resolve(type, is_list, val[0] == 't' || val[0] == 'T');
-    case ImportDataType::kTimestampMilli:
-      return ImportData{ImportDataType::kUnsupported, false};
-    default:
-      return ImportData{ImportDataType::kUnsupported, false};
-    }
-  } catch (const boost::bad_lexical_cast&) {
-    return ImportData{ImportDataType::kUnsupported, false};
-  }
-}
-
 /***************************************/
 /* Functions for parsing GraphML files */
 /***************************************/
@@ -417,7 +181,7 @@ ProcessNode(xmlTextReaderPtr reader, katana::PropertyGraphBuilder* builder) {
                         property.first, ImportDataType::kString, false};
                   },
                   [&value](ImportDataType type, bool is_list) {
-                    return ResolveValue(value, type, is_list);
+                    return katana::ResolveValue(value, type, is_list);
                   });
             }
           }
@@ -525,7 +289,7 @@ ProcessEdge(xmlTextReaderPtr reader, katana::PropertyGraphBuilder* builder) {
                         property.first, ImportDataType::kString, false};
                   },
                   [&value](ImportDataType type, bool is_list) {
-                    return ResolveValue(value, type, is_list);
+                    return katana::ResolveValue(value, type, is_list);
                   });
             }
           }
@@ -555,7 +319,9 @@ ProcessEdge(xmlTextReaderPtr reader, katana::PropertyGraphBuilder* builder) {
  * parses the graph structure from a GraphML file into Galois format
  */
 void
-ProcessGraph(xmlTextReaderPtr reader, katana::PropertyGraphBuilder* builder) {
+ProcessGraph(
+    xmlTextReaderPtr reader, katana::PropertyGraphBuilder* builder,
+    bool verbose) {
   auto minimum_depth = xmlTextReaderDepth(reader);
   int ret = xmlTextReaderRead(reader);
 
@@ -576,7 +342,9 @@ ProcessGraph(xmlTextReaderPtr reader, katana::PropertyGraphBuilder* builder) {
       } else if (xmlStrEqual(name, BAD_CAST "edge")) {
         if (!finished_nodes) {
           finished_nodes = true;
-          std::cout << "Finished processing nodes\n";
+          if (verbose) {
+            std::cout << "Finished processing nodes\n";
+          }
         }
         // if elt is an "egde" xml node read it in
         ProcessEdge(reader, builder);
@@ -590,25 +358,142 @@ ProcessGraph(xmlTextReaderPtr reader, katana::PropertyGraphBuilder* builder) {
     xmlFree(name);
     ret = xmlTextReaderRead(reader);
   }
-  std::cout << "Finished processing edges\n";
+  if (verbose) {
+    std::cout << "Finished processing edges\n";
+  }
+}
+
+/*************************************************/
+/* Functions for parsing GraphML files in chunks */
+/*************************************************/
+
+bool
+EndsTagName(char c) {
+  return c == ' ' || c == '\t' || c == '\n' || c == '\r' || c == '>' ||
+         c == '/';
+}
+
+// position of the first start tag of an element called name at or after pos
+size_t
+FindStartTag(std::string_view text, std::string_view name, size_t pos) {
+  while ((pos = text.find('<', pos)) != std::string_view::npos) {
+    size_t end = pos + 1 + name.size();
+    if (end < text.size() && text.compare(pos + 1, name.size(), name) == 0 &&
+        EndsTagName(text[end])) {
+      return pos;
+    }
+    ++pos;
+  }
+  return text.size();
+}
+
+// position of the first start tag of a node or edge element at or after pos
+size_t
+FindElementStart(std::string_view text, size_t pos) {
+  while ((pos = text.find('<', pos)) != std::string_view::npos) {
+    if (pos + 5 < text.size() &&
+        (text.compare(pos + 1, 4, "node") == 0 ||
+         text.compare(pos + 1, 4, "edge") == 0) &&
+        EndsTagName(text[pos + 5])) {
+      return pos;
+    }
+    ++pos;
+  }
+  return text.size();
+}
+
+// Feeds a parser a part of the body of the input's graph element wrapped in
+// a graph element of its own, without copying the part
+struct ChunkInput {
+  std::array<std::string_view, 3> parts;
+  size_t part{0};
+  size_t offset{0};
+};
+
+int
+ReadChunkInput(void* context, char* buffer, int len) {
+  auto* input = static_cast<ChunkInput*>(context);
+  size_t written = 0;
+  while (written < static_cast<size_t>(len) &&
+         input->part < input->parts.size()) {
+    std::string_view part = input->parts[input->part];
+    size_t n = std::min(len - written, part.size() - input->offset);
+    std::memcpy(buffer + written, part.data() + input->offset, n);
+    written += n;
+    input->offset += n;
+    if (input->offset == part.size()) {
+      input->part++;
+      input->offset = 0;
+    }
+  }
+  return static_cast<int>(written);
+}
+
+/*
+ * splits the body of the graph element of text into parts of at least
+ * part_bytes bytes that start at a node or edge element
+ *
+ * nested graphs and CDATA sections that contain node or edge tags are not
+ * supported
+ */
+std::vector<std::string_view>
+SplitGraphBody(
+    std::string_view text, const std::string& infilename, size_t part_bytes) {
+  size_t graph_start = FindStartTag(text, "graph", 0);
+  size_t body_begin = text.find('>', graph_start);
+  if (body_begin == std::string_view::npos) {
+    KATANA_LOG_FATAL("Failed to find the graph element of {}", infilename);
+  }
+  // <graph .../> has no body
+  if (text[body_begin - 1] == '/') {
+    return {};
+  }
+  ++body_begin;
+  size_t body_end = text.rfind("</graph>");
+  if (body_end == std::string_view::npos || body_end < body_begin) {
+    KATANA_LOG_FATAL("Failed to find the end of the graph of {}", infilename);
+  }
+  std::string_view body = text.substr(body_begin, body_end - body_begin);
+
+  size_t threads = katana::getActiveThreads();
+  size_t target =
+      std::max({part_bytes, body.size() / (threads * 4), size_t{1}});
+  std::vector<std::string_view> parts;
+  size_t begin = 0;
+  while (begin < body.size()) {
+    size_t end = body.size();
+    if (body.size() - begin > target) {
+      end = FindElementStart(body, begin + target);
+    }
+    parts.emplace_back(body.substr(begin, end - begin));
+    begin = end;
+  }
+  return parts;
 }
 
 }  // end of unnamed namespace
 
 /// ConvertGraphML converts a GraphML file into katana form
 ///
+/// The body of the graph is split into parts that start at node or edge
+/// elements; parts are parsed in parallel, each into its own builder, and
+/// the builders are merged once all parts are parsed.
+///
 /// \param infilename path to source graphml file
+/// \param part_bytes smallest part parsed by its own thread, usually
+/// kDefaultPartBytes
 /// \returns arrow tables of node properties/labels, edge properties/types, and
 /// csr topology
 katana::GraphComponents
-katana::ConvertGraphML(const std::string& infilename, size_t chunk_size) {
+katana::ConvertGraphML(
+    const std::string& infilename, size_t chunk_size, size_t part_bytes) {
   xmlTextReaderPtr reader;
   int ret = 0;
 
-  katana::PropertyGraphBuilder builder{chunk_size};
+  std::vector<PropertyKey> keys;
 
   katana::setActiveThreads(1000);
-  bool finishedGraph = false;
+  bool found_graph = false;
   std::cout << "Start converting GraphML file: " << infilename << "\n";
 
   reader = xmlNewTextReaderFilename(infilename.c_str());
@@ -616,10 +501,10 @@ katana::ConvertGraphML(const std::string& infilename, size_t chunk_size) {
     ret = xmlTextReaderRead(reader);
 
     // procedure:
-    // read in "key" xml nodes and add them to nodeKeys and edgeKeys
-    // once we reach the first "graph" xml node we parse it using the above keys
-    // once we have parsed the first "graph" xml node we exit
-    while (ret == 1 && !finishedGraph) {
+    // read in "key" xml nodes and add them to keys
+    // once we reach the first "graph" xml node we stop; its body is parsed in
+    // parallel below
+    while (ret == 1 && !found_graph) {
       xmlChar* name;
       name = xmlTextReaderName(reader);
       if (name == NULL) {
@@ -631,34 +516,77 @@ katana::ConvertGraphML(const std::string& infilename, size_t chunk_size) {
         if (xmlStrEqual(name, BAD_CAST "key")) {
           PropertyKey key = katana::ProcessKey(reader);
           if (!key.id.empty() && key.id != std::string("label") &&
-              key.id != std::string("IGNORE")) {
-            if (key.for_node) {
-              builder.AddBuilder(std::move(key));
-            } else if (key.for_edge) {
-              builder.AddBuilder(std::move(key));
-            }
+              key.id != std::string("IGNORE") &&
+              (key.for_node || key.for_edge)) {
+            keys.emplace_back(std::move(key));
           }
         } else if (xmlStrEqual(name, BAD_CAST "graph")) {
           std::cout << "Finished processing property headers\n";
-          ProcessGraph(reader, &builder);
-          finishedGraph = true;
+          found_graph = true;
         }
       }
 
       xmlFree(name);
-      ret = xmlTextReaderRead(reader);
+      if (!found_graph) {
+        ret = xmlTextReaderRead(reader);
+      }
     }
     xmlFreeTextReader(reader);
-    if (ret < 0) {
-      KATANA_LOG_FATAL(
-          "Failed to parse {}, incorrect xml format\n"
-          "Please verify there are no illegal characters in the GraphML file\n"
-          "To remove invalid characters use: \"sed -i $'s/[^[:print:]\t]//g' "
-          "{}\", warning this will alter the original file",
-          infilename, infilename);
-    }
   } else {
     KATANA_LOG_FATAL("Unable to open {}", infilename);
   }
-  return builder.Finish();
+
+  katana::MappedFile input(infilename);
+  std::vector<std::string_view> parts;
+  if (found_graph) {
+    parts = SplitGraphBody(input.text(), infilename, part_bytes);
+  }
+
+  std::vector<katana::PropertyGraphBuilder> builders;
+  builders.reserve(std::max<size_t>(parts.size(), 1));
+  for (size_t i = 0; i < std::max<size_t>(parts.size(), 1); ++i) {
+    builders.emplace_back(chunk_size);
+    for (const PropertyKey& key : keys) {
+      builders.back().AddBuilder(key);
+    }
+  }
+
+  // libxml2 must be initialized before it is used by several threads
+  xmlInitParser();
+  std::atomic<bool> failed{ret < 0};
+  katana::do_all(
+      katana::iterate(static_cast<size_t>(0), parts.size()),
+      [&](const size_t& i) {
+        ChunkInput chunk{{"<graph>", parts[i], "</graph>"}};
+        xmlTextReaderPtr chunk_reader = xmlReaderForIO(
+            ReadChunkInput, nullptr, &chunk, infilename.c_str(), nullptr, 0);
+        if (chunk_reader == NULL) {
+          failed = true;
+          return;
+        }
+        int chunk_ret = xmlTextReaderRead(chunk_reader);
+        if (chunk_ret == 1) {
+          ProcessGraph(chunk_reader, &builders[i], parts.size() == 1);
+          chunk_ret = xmlTextReaderRead(chunk_reader);
+        }
+        if (chunk_ret < 0) {
+          failed = true;
+        }
+        xmlFreeTextReader(chunk_reader);
+      },
+      katana::steal(), katana::chunk_size<1>(),
+      katana::loopname("ParseGraphML"));
+
+  if (failed) {
+    KATANA_LOG_FATAL(
+        "Failed to parse {}, incorrect xml format\n"
+        "Please verify there are no illegal characters in the GraphML file\n"
+        "To remove invalid characters use: \"sed -i $'s/[^[:print:]\t]//g' "
+        "{}\", warning this will alter the original file",
+        infilename, infilename);
+  }
+  if (parts.size() > 1) {
+    std::cout << "Parsed " << parts.size() << " parts of the graph\n";
+  }
+  return katana::PropertyGraphBuilder::Merge(&builders);
 }
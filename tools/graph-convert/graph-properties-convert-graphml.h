@@ -6,7 +6,7 @@
 namespace katana {
 
 GraphComponents ConvertGraphML(
-    const std::string& input_filename, size_t chunk_size);
+    const std::string& input_filename, size_t chunk_size, size_t part_bytes);
 
 }  // end namespace katana
 
@@ -3,6 +3,7 @@
 #include <llvm/Support/CommandLine.h>
 
 #include "Transforms.h"
+#include "graph-properties-convert-csv.h"
 #include "graph-properties-convert-graphml.h"
 #include "graph-properties-convert-schema.h"
 #include "katana/ErrorCode.h"
@@ -36,7 +37,14 @@ cll::opt<katana::SourceType> type(
             "source file is of type GraphML"),
         clEnumValN(
             katana::SourceType::kKatana, "katana",
-            "source file is of type Katana")),
+            "source file is of type Katana"),
+        clEnumValN(
+            katana::SourceType::kCsv, "csv",
+            "source file is a CSV file of nodes, see -edges"),
+        clEnumValN(
+            katana::SourceType::kJsonl, "jsonl",
+            "source file has a JSON object per line for each node, see "
+            "-edges")),
     cll::init(katana::SourceType::kGraphml));
 cll::opt<katana::SourceDatabase> database(
     cll::desc("Database the data is from:"),
@@ -56,10 +64,23 @@ cll::opt<int> chunk_size(
               "it can be decreased to improve memory usage when "
               "converting large inputs"),
     cll::init(25000));
+cll::opt<size_t> part_size(
+    "part-size",
+    cll::desc("Smallest part in bytes of a graphml, csv or jsonl input that "
+              "is parsed by its own thread, default is 4MiB"),
+    cll::init(katana::kDefaultPartBytes));
 cll::opt<std::string> mapping(
     "mapping",
     cll::desc("File in graphml format with a schema mapping for the database"),
     cll::init(""));
+cll::opt<std::string> edges_filename(
+    "edges",
+    cll::desc("File of edges for csv and jsonl inputs, in the format of the "
+              "nodes file"),
+    cll::init(""));
+cll::opt<char> delimiter(
+    "delimiter", cll::desc("Field delimiter of csv inputs, default is ','"),
+    cll::init(','));
 cll::opt<bool> generate_mapping(
     "generate-mapping",
     cll::desc("Generate a file in graphml format with a schema mapping for the "
@@ -139,10 +160,22 @@ ParseWild() {
   switch (type) {
   case katana::SourceType::kGraphml:
     return katana::WritePropertyGraph(
-        katana::ConvertGraphML(input_filename, chunk_size), output_directory);
+        katana::ConvertGraphML(input_filename, chunk_size, part_size),
+        output_directory);
   case katana::SourceType::kKatana:
     return katana::WritePropertyGraph(
         ConvertKatana(input_filename), output_directory);
+  case katana::SourceType::kCsv:
+    return katana::WritePropertyGraph(
+        katana::ConvertCsv(
+            input_filename, edges_filename, mapping, delimiter, chunk_size,
+            part_size),
+        output_directory);
+  case katana::SourceType::kJsonl:
+    return katana::WritePropertyGraph(
+        katana::ConvertJsonl(
+            input_filename, edges_filename, mapping, chunk_size, part_size),
+        output_directory);
   default:
     KATANA_LOG_ERROR("Unsupported input type {}", type);
   }
@@ -153,7 +186,8 @@ ParseNeo4j() {
   switch (type) {
   case katana::SourceType::kGraphml:
     return katana::WritePropertyGraph(
-        katana::ConvertGraphML(input_filename, chunk_size), output_directory);
+        katana::ConvertGraphML(input_filename, chunk_size, part_size),
+        output_directory);
   default:
     KATANA_LOG_ERROR("Unsupported input type {}", type);
   }
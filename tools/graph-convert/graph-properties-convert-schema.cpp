@@ -1,5 +1,10 @@
 #include "graph-properties-convert-schema.h"
 
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
 #include <iostream>
 
 #include <boost/algorithm/string.hpp>
@@ -7,6 +12,7 @@
 
 #include "tsuba/RDG.h"
 
+using katana::ImportData;
 using katana::ImportDataType;
 using katana::LabelRule;
 using katana::PropertyKey;
@@ -55,6 +61,45 @@ struct GraphmlList {
   }
 };
 
+/**************************/
+/* Reading of input files */
+/**************************/
+
+katana::MappedFile::MappedFile(const std::string& filename)
+    : data_(MAP_FAILED) {
+  int fd = open(filename.c_str(), O_RDONLY);
+  if (fd < 0) {
+    KATANA_LOG_FATAL("Unable to open {}", filename);
+  }
+  struct stat st;
+  if (fstat(fd, &st) != 0) {
+    KATANA_LOG_FATAL("Unable to stat {}", filename);
+  }
+  size_ = st.st_size;
+  if (size_ > 0) {
+    data_ = mmap(nullptr, size_, PROT_READ, MAP_PRIVATE, fd, 0);
+    if (data_ == MAP_FAILED) {
+      KATANA_LOG_FATAL("Unable to map {}", filename);
+    }
+    madvise(data_, size_, MADV_SEQUENTIAL);
+  }
+  close(fd);
+}
+
+katana::MappedFile::~MappedFile() {
+  if (data_ != MAP_FAILED) {
+    munmap(data_, size_);
+  }
+}
+
+std::string_view
+katana::MappedFile::text() const {
+  if (data_ == MAP_FAILED) {
+    return {};
+  }
+  return {static_cast<const char*>(data_), size_};
+}
+
 /***************************************/
 /* Functions for writing GraphML files */
 /***************************************/
@@ -795,6 +840,251 @@ katana::ProcessSchemaMapping(const std::string& mapping) {
       rules, keys);
 }
 
+namespace {
+
+/******************************/
+/* Functions for parsing data */
+/******************************/
+
+std::optional<std::vector<std::string>>
+ParseStringList(std::string raw_list) {
+  std::vector<std::string> list;
+
+  if (raw_list.size() >= 2 && raw_list.front() == '[' &&
+      raw_list.back() == ']') {
+    raw_list.erase(0, 1);
+    raw_list.erase(raw_list.length() - 1, 1);
+  } else {
+    KATANA_LOG_ERROR(
+        "The provided list was not formatted like neo4j, returning null");
+    return std::nullopt;
+  }
+
+  const char* char_list = raw_list.c_str();
+  // parse the list
+  for (size_t i = 0; i < raw_list.size();) {
+    bool first_quote_found = false;
+    bool found_end_of_elem = false;
+    size_t start_of_elem = i;
+    int consecutive_slashes = 0;
+
+    // parse the field
+    for (; !found_end_of_elem && i < raw_list.size(); i++) {
+      // if second quote not escaped then end of element reached
+      if (char_list[i] == '\"') {
+        if (consecutive_slashes % 2 == 0) {
+          if (!first_quote_found) {
+            first_quote_found = true;
+            start_of_elem = i + 1;
+          } else if (first_quote_found) {
+            found_end_of_elem = true;
+          }
+        }
+        consecutive_slashes = 0;
+      } else if (char_list[i] == '\\') {
+        consecutive_slashes++;
+      } else {
+        consecutive_slashes = 0;
+      }
+    }
+    size_t end_of_elem = i - 1;
+    size_t elem_length = end_of_elem - start_of_elem;
+
+    if (end_of_elem <= start_of_elem) {
+      list.emplace_back("");
+    } else {
+      std::string elem_rough(&char_list[start_of_elem], elem_length);
+      std::string elem("");
+      elem.reserve(elem_rough.size());
+      size_t curr_index = 0;
+      size_t next_slash = elem_rough.find_first_of('\\');
+
+      while (next_slash != std::string::npos) {
+        elem.append(
+            elem_rough.begin() + curr_index, elem_rough.begin() + next_slash);
+
+        switch (elem_rough[next_slash + 1]) {
+        case 'n':
+          elem.append("\n");
+          break;
+        case '\\':
+          elem.append("\\");
+          break;
+        case 'r':
+          elem.append("\r");
+          break;
+        case '0':
+          elem.append("\0");
+          break;
+        case 'b':
+          elem.append("\b");
+          break;
+        case '\'':
+          elem.append("\'");
+          break;
+        case '\"':
+          elem.append("\"");
+          break;
+        case 't':
+          elem.append("\t");
+          break;
+        case 'f':
+          elem.append("\f");
+          break;
+        case 'v':
+          elem.append("\v");
+          break;
+        case '\xFF':
+          elem.append("\xFF");
+          break;
+        default:
+          KATANA_LOG_WARN(
+              "Unhandled escape character: {}", elem_rough[next_slash + 1]);
+        }
+
+        curr_index = next_slash + 2;
+        next_slash = elem_rough.find_first_of('\\', curr_index);
+      }
+      elem.append(elem_rough.begin() + curr_index, elem_rough.end());
+
+      list.emplace_back(elem);
+    }
+  }
+
+  return list;
+}
+
+template <typename T>
+std::optional<std::vector<T>>
+ParseNumberList(std::string raw_list) {
+  std::vector<T> list;
+
+  if (raw_list.front() == '[' && raw_list.back() == ']') {
+    raw_list.erase(0, 1);
+    raw_list.erase(raw_list.length() - 1, 1);
+  } else {
+    KATANA_LOG_ERROR(
+        "The provided list was not formatted like neo4j, "
+        "returning empty vector");
+    return std::nullopt;
+  }
+  std::vector<std::string> elems;
+  boost::split(elems, raw_list, boost::is_any_of(","));
+
+  for (std::string s : elems) {
+    try {
+      list.emplace_back(boost::lexical_cast<T>(s));
+    } catch (const boost::bad_lexical_cast&) {
+    }
+  }
+  return list;
+}
+
+std::optional<std::vector<bool>>
+ParseBooleanList(std::string raw_list) {
+  std::vector<bool> list;
+
+  if (raw_list.front() == '[' && raw_list.back() == ']') {
+    raw_list.erase(0, 1);
+    raw_list.erase(raw_list.length() - 1, 1);
+  } else {
+    KATANA_LOG_ERROR(
+        "The provided list was not formatted like neo4j, "
+        "returning empty vector");
+    return std::nullopt;
+  }
+  std::vector<std::string> elems;
+  boost::split(elems, raw_list, boost::is_any_of(","));
+
+  for (std::string s : elems) {
+    if (!s.empty()) {
+      bool bool_val = s[0] == 't' || s[0] == 'T';
+      list.emplace_back(bool_val);
+    }
+  }
+  return list;
+}
+
+/************************************************/
+/* Functions for adding values to arrow builder */
+/************************************************/
+
+template <typename T>
+ImportData
+Resolve(ImportDataType type, bool is_list, T val) {
+  ImportData data{type, is_list};
+  data.value = val;
+  return data;
+}
+
+template <typename Fn>
+ImportData
+ResolveOptionalList(ImportDataType type, const std::string& val, Fn resolver) {
+  ImportData data{type, true};
+
+  auto res = resolver(val);
+  if (!res) {
+    data.type = ImportDataType::kUnsupported;
+  } else {
+    data.value = res.value();
+  }
+  return data;
+}
+
+ImportData
+ResolveListValue(const std::string& val, ImportDataType type) {
+  switch (type) {
+  case ImportDataType::kString:
+    return ResolveOptionalList(type, val, ParseStringList);
+  case ImportDataType::kInt64:
+    return ResolveOptionalList(type, val, ParseNumberList<int64_t>);
+  case ImportDataType::kInt32:
+    return ResolveOptionalList(type, val, ParseNumberList<int32_t>);
+  case ImportDataType::kDouble:
+    return ResolveOptionalList(type, val, ParseNumberList<double>);
+  case ImportDataType::kFloat:
+    return ResolveOptionalList(type, val, ParseNumberList<float>);
+  case ImportDataType::kBoolean:
+    return ResolveOptionalList(type, val, ParseBooleanList);
+  case ImportDataType::kTimestampMilli:
+    return ImportData{ImportDataType::kUnsupported, true};
+  default:
+    return ImportData{ImportDataType::kUnsupported, true};
+  }
+}
+
+}  // namespace
+
+katana::ImportData
+katana::ResolveValue(
+    const std::string& val, ImportDataType type, bool is_list) {
+  if (is_list) {
+    return ResolveListValue(val, type);
+  }
+  try {
+    switch (type) {
+    case ImportDataType::kString:
+      return Resolve(type, is_list, val);
+    case ImportDataType::kInt64:
+      return Resolve(type, is_list, boost::lexical_cast<int64_t>(val));
+    case ImportDataType::kInt32:
+      return Resolve(type, is_list, boost::lexical_cast<int32_t>(val));
+    case ImportDataType::kDouble:
+      return Resolve(type, is_list, boost::lexical_cast<double>(val));
+    case ImportDataType::kFloat:
+      return Resolve(type, is_list, boost::lexical_cast<float>(val));
+    case ImportDataType::kBoolean:
+      return Resolve(type, is_list, val[0] == 't' || val[0] == 'T');
+    case ImportDataType::kTimestampMilli:
+      return ImportData{ImportDataType::kUnsupported, false};
+    default:
+      return ImportData{ImportDataType::kUnsupported, false};
+    }
+  } catch (const boost::bad_lexical_cast&) {
+    return ImportData{ImportDataType::kUnsupported, false};
+  }
+}
+
 /**************************************************/
 /* Functions for converting to/from datatype enum */
 /**************************************************/
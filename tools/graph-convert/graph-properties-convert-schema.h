@@ -4,10 +4,31 @@
 #include <libxml/xmlreader.h>
 #include <libxml/xmlwriter.h>
 
+#include <string_view>
+
 #include "katana/BuildGraph.h"
 
 namespace katana {
 
+/// Inputs are split into parts of at least this many bytes for the threads
+/// to parse, so smaller inputs are parsed by a single thread
+constexpr size_t kDefaultPartBytes = size_t{4} << 20;
+
+/// Read-only mapping of a whole input file, shared by the threads that parse
+/// parts of it
+class MappedFile {
+  void* data_;
+  size_t size_{0};
+
+public:
+  explicit MappedFile(const std::string& filename);
+  MappedFile(const MappedFile&) = delete;
+  MappedFile& operator=(const MappedFile&) = delete;
+  ~MappedFile();
+
+  std::string_view text() const;
+};
+
 xmlTextWriterPtr CreateGraphmlFile(const std::string& outfile);
 void WriteGraphmlRule(xmlTextWriterPtr writer, const LabelRule& rule);
 void WriteGraphmlKey(xmlTextWriterPtr writer, const PropertyKey& key);
@@ -44,6 +65,11 @@ ProcessSchemaMapping(
 std::pair<std::vector<LabelRule>, std::vector<PropertyKey>>
 ProcessSchemaMapping(const std::string& mapping);
 
+/// Parse val, the text of a property value, as type; lists are written like
+/// neo4j exports them, e.g. ["a","b"] or [1,2]
+ImportData ResolveValue(
+    const std::string& val, ImportDataType type, bool is_list);
+
 std::string TypeName(ImportDataType type);
 ImportDataType ParseType(const std::string& in);
 ImportDataType ParseType(const std::shared_ptr<arrow::DataType>& in);
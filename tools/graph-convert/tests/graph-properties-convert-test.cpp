@@ -3,7 +3,9 @@
 
 #include <llvm/Support/CommandLine.h>
 
+#include "graph-properties-convert-csv.h"
 #include "graph-properties-convert-graphml.h"
+#include "graph-properties-convert-schema.h"
 #include "katana/Galois.h"
 #include "katana/Logging.h"
 #include "katana/config.h"
@@ -13,7 +15,7 @@
 #endif
 
 namespace {
-enum ConvertTest { kMovies, kTypes, kChunks, kMongodb };
+enum ConvertTest { kMovies, kTypes, kChunks, kCsv, kJsonl, kMongodb };
 }
 
 namespace cll = llvm::cl;
@@ -37,12 +39,27 @@ static cll::opt<ConvertTest> test_type(
             ConvertTest::kMovies, "movies",
             "source file is a test for generic conversion"),
         clEnumValN(ConvertTest::kChunks, "chunks", "this is a test for chunks"),
+        clEnumValN(
+            ConvertTest::kCsv, "csv",
+            "source file is a csv file of nodes for a test of csv conversion"),
+        clEnumValN(
+            ConvertTest::kJsonl, "jsonl",
+            "source file is a jsonl file of nodes for a test of jsonl "
+            "conversion"),
         clEnumValN(
             ConvertTest::kMongodb, "mongo", "this is a test for mongodb")),
     cll::Required);
 static cll::opt<int> chunk_size(
     "chunkSize", cll::desc("Chunk size for in memory arrow representation"),
     cll::init(25000));
+static cll::opt<std::string> edges_filename(
+    "edges", cll::desc("Edges file for csv and jsonl tests"), cll::init(""));
+static cll::opt<size_t> part_size(
+    "partSize",
+    cll::desc("Smallest part of the input parsed by its own thread; when it "
+              "is not the default, the graph is also converted in one part "
+              "and both results must be the same"),
+    cll::init(katana::kDefaultPartBytes));
 
 namespace {
 
@@ -1176,6 +1193,113 @@ GenerateAndConvertBson(size_t chunk_size) {
 }
 #endif
 
+void
+VerifyCsvSet(const katana::GraphComponents& graph) {
+  KATANA_LOG_ASSERT(graph.nodes.properties->num_columns() == 2);
+  KATANA_LOG_ASSERT(graph.nodes.labels->num_columns() == 3);
+  KATANA_LOG_ASSERT(graph.edges.properties->num_columns() == 1);
+  KATANA_LOG_ASSERT(graph.edges.labels->num_columns() == 3);
+
+  // n3 is only referenced by an edge
+  KATANA_LOG_ASSERT(graph.nodes.properties->num_rows() == 4);
+  KATANA_LOG_ASSERT(graph.nodes.labels->num_rows() == 4);
+  KATANA_LOG_ASSERT(graph.edges.properties->num_rows() == 3);
+  KATANA_LOG_ASSERT(graph.edges.labels->num_rows() == 3);
+
+  // test node properties
+  auto names = safe_cast<arrow::StringArray>(
+      graph.nodes.properties->GetColumnByName("name")->chunk(0));
+  KATANA_LOG_ASSERT(names->IsNull(0));
+  KATANA_LOG_ASSERT(names->GetString(1) == "Reeves, Keanu");
+  KATANA_LOG_ASSERT(names->GetString(2) == "Lana\nWachowski");
+  KATANA_LOG_ASSERT(names->IsNull(3));
+
+  auto released = safe_cast<arrow::StringArray>(
+      graph.nodes.properties->GetColumnByName("released")->chunk(0));
+  KATANA_LOG_ASSERT(released->GetString(0) == "1999");
+  KATANA_LOG_ASSERT(released->null_count() == 3);
+
+  // test node labels
+  auto directors = safe_cast<arrow::BooleanArray>(
+      graph.nodes.labels->GetColumnByName("Director")->chunk(0));
+  std::string directors_expected = std::string(
+      "[\n\
+  false,\n\
+  false,\n\
+  true,\n\
+  false\n\
+]");
+  KATANA_LOG_ASSERT(directors->ToString() == directors_expected);
+
+  // test edge properties, in CSR order
+  auto roles = safe_cast<arrow::StringArray>(
+      graph.edges.properties->GetColumnByName("roles")->chunk(0));
+  KATANA_LOG_ASSERT(roles->GetString(0) == "[\"Neo\"]");
+  KATANA_LOG_ASSERT(roles->IsNull(1));
+  KATANA_LOG_ASSERT(roles->IsNull(2));
+
+  // test edge types
+  auto knows = safe_cast<arrow::BooleanArray>(
+      graph.edges.labels->GetColumnByName("KNOWS")->chunk(0));
+  std::string knows_expected = std::string(
+      "[\n\
+  false,\n\
+  true,\n\
+  false\n\
+]");
+  KATANA_LOG_ASSERT(knows->ToString() == knows_expected);
+
+  // test topology
+  auto indices = graph.topology->out_indices;
+  std::string indices_expected = std::string(
+      "[\n\
+  0,\n\
+  2,\n\
+  3,\n\
+  3\n\
+]");
+  KATANA_LOG_ASSERT(indices->ToString() == indices_expected);
+
+  auto dests = graph.topology->out_dests;
+  std::string dests_expected = std::string(
+      "[\n\
+  0,\n\
+  3,\n\
+  0\n\
+]");
+  KATANA_LOG_ASSERT(dests->ToString() == dests_expected);
+}
+
+/// Checks that converting the input in several parts gives the same graph as
+/// converting it in one
+void
+VerifySamePartsGraph(
+    const katana::GraphComponents& graph,
+    const katana::GraphComponents& expected) {
+  KATANA_LOG_ASSERT(graph.nodes.properties->Equals(*expected.nodes.properties));
+  KATANA_LOG_ASSERT(graph.nodes.labels->Equals(*expected.nodes.labels));
+  KATANA_LOG_ASSERT(graph.edges.properties->Equals(*expected.edges.properties));
+  KATANA_LOG_ASSERT(graph.edges.labels->Equals(*expected.edges.labels));
+  KATANA_LOG_ASSERT(
+      graph.topology->out_indices->Equals(*expected.topology->out_indices));
+  KATANA_LOG_ASSERT(
+      graph.topology->out_dests->Equals(*expected.topology->out_dests));
+}
+
+katana::GraphComponents
+Convert(size_t part_bytes) {
+  switch (test_type) {
+  case ConvertTest::kCsv:
+    return katana::ConvertCsv(
+        input_filename, edges_filename, "", ',', chunk_size, part_bytes);
+  case ConvertTest::kJsonl:
+    return katana::ConvertJsonl(
+        input_filename, edges_filename, "", chunk_size, part_bytes);
+  default:
+    return katana::ConvertGraphML(input_filename, chunk_size, part_bytes);
+  }
+}
+
 #if defined(KATANA_MONGOC_FOUND)
 void
 VerifyMongodbSet(const katana::GraphComponents& graph) {
@@ -1268,7 +1392,10 @@ main(int argc, char** argv) {
 
   switch (fileType) {
   case katana::SourceDatabase::kNeo4j:
-    graph = katana::ConvertGraphML(input_filename, chunk_size);
+    graph = Convert(part_size);
+    if (part_size != katana::kDefaultPartBytes) {
+      VerifySamePartsGraph(graph, Convert(katana::kDefaultPartBytes));
+    }
     break;
 #if defined(KATANA_MONGOC_FOUND)
   case katana::SourceDatabase::kMongodb:
@@ -1289,6 +1416,11 @@ main(int argc, char** argv) {
   case ConvertTest::kChunks:
     VerifyChunksSet(graph);
     break;
+  case ConvertTest::kCsv:
+  case ConvertTest::kJsonl:
+    // both inputs describe the same graph
+    VerifyCsvSet(graph);
+    break;
 #if defined(KATANA_MONGOC_FOUND)
   case ConvertTest::kMongodb:
     VerifyMongodbSet(graph);
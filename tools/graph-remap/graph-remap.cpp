@@ -20,6 +20,7 @@
 #include "katana/BufferedGraph.h"
 #include "katana/FileGraph.h"
 #include "katana/Galois.h"
+#include "katana/IdDictionary.h"
 #include "llvm/Support/CommandLine.h"
 
 namespace cll = llvm::cl;
@@ -33,11 +34,15 @@ static cll::opt<std::string> outputFilename(
 
 using Writer = katana::FileGraphWriter;
 
+using NodeMap = katana::IdDictionary<uint64_t>;
+
 /**
  * Create node map from file
+ *
+ * @param numNodes set to the number of nodes in the map
  */
-std::map<uint32_t, uint32_t>
-createNodeMap() {
+NodeMap
+createNodeMap(size_t* numNodes) {
   katana::gInfo("Creating node map");
   // read new mapping
   std::ifstream mapFile(mappingFilename);
@@ -53,20 +58,32 @@ createNodeMap() {
     KATANA_DIE("failed to read file");
   }
 
-  // remap node listed on line n in the mapping to node n
-  std::map<uint32_t, uint32_t> remapper;
-  uint64_t counter = 0;
+  std::vector<uint64_t> nodeIDs;
   while (((int64_t)mapFile.tellg() + 1) != endOfFile) {
     uint64_t nodeID;
     mapFile >> nodeID;
     if (!mapFile) {
       KATANA_DIE("failed to read file");
     }
-    remapper[nodeID] = counter++;
+    nodeIDs.emplace_back(nodeID);
   }
 
-  KATANA_LOG_ASSERT(remapper.size() == counter);
-  katana::gInfo("Remapping ", counter, " nodes");
+  // remap node listed on line n in the mapping to node n
+  NodeMap remapper(nodeIDs.size());
+  katana::do_all(
+      katana::iterate(size_t{0}, nodeIDs.size()),
+      [&](size_t n) { remapper.Insert(nodeIDs[n], n); }, katana::no_stats());
+  katana::do_all(
+      katana::iterate(size_t{0}, nodeIDs.size()),
+      [&](size_t n) {
+        if (remapper.Find(nodeIDs[n]) != n) {
+          KATANA_DIE("node listed more than once: ", nodeIDs[n]);
+        }
+      },
+      katana::no_stats());
+
+  *numNodes = nodeIDs.size();
+  katana::gInfo("Remapping ", nodeIDs.size(), " nodes");
 
   katana::gInfo("Node map created");
 
@@ -78,7 +95,8 @@ main(int argc, char** argv) {
   katana::SharedMemSys G;
   llvm::cl::ParseCommandLineOptions(argc, argv);
 
-  std::map<uint32_t, uint32_t> remapper = createNodeMap();
+  size_t numRemapped = 0;
+  NodeMap remapper = createNodeMap(&numRemapped);
 
   katana::gInfo("Loading graph to remap");
   katana::BufferedGraph<void> graphToRemap;
@@ -86,7 +104,7 @@ main(int argc, char** argv) {
   katana::gInfo("Graph loaded");
 
   Writer graphWriter;
-  graphWriter.setNumNodes(remapper.size());
+  graphWriter.setNumNodes(numRemapped);
   graphWriter.setNumEdges(graphToRemap.sizeEdges());
 
   // phase 1: count degrees
@@ -96,8 +114,8 @@ main(int argc, char** argv) {
   size_t nodeIDCounter = 0;
   for (size_t i = 0; i < prevNumNodes; i++) {
     // see if current node is to be remapped, i.e. exists in the map
-    if (remapper.find(i) != remapper.end()) {
-      KATANA_LOG_ASSERT(nodeIDCounter == remapper[i]);
+    if (auto node = remapper.Find(i); node) {
+      KATANA_LOG_ASSERT(nodeIDCounter == *node);
       for (auto e = graphToRemap.edgeBegin(i); e < graphToRemap.edgeEnd(i);
            e++) {
         graphWriter.incrementDegree(nodeIDCounter);
@@ -105,7 +123,7 @@ main(int argc, char** argv) {
       nodeIDCounter++;
     }
   }
-  KATANA_LOG_ASSERT(nodeIDCounter == remapper.size());
+  KATANA_LOG_ASSERT(nodeIDCounter == numRemapped);
 
   // phase 2: edge construction
   graphWriter.phase2();
@@ -113,18 +131,19 @@ main(int argc, char** argv) {
   nodeIDCounter = 0;
   for (size_t i = 0; i < prevNumNodes; i++) {
     // see if current node is to be remapped, i.e. exists in the map
-    if (remapper.find(i) != remapper.end()) {
-      KATANA_LOG_ASSERT(nodeIDCounter == remapper[i]);
+    if (auto node = remapper.Find(i); node) {
+      KATANA_LOG_ASSERT(nodeIDCounter == *node);
       for (auto e = graphToRemap.edgeBegin(i); e < graphToRemap.edgeEnd(i);
            e++) {
         uint32_t dst = graphToRemap.edgeDestination(*e);
-        KATANA_LOG_ASSERT(remapper.find(dst) != remapper.end());
-        graphWriter.addNeighbor(nodeIDCounter, remapper[dst]);
+        auto newDst = remapper.Find(dst);
+        KATANA_LOG_ASSERT(newDst);
+        graphWriter.addNeighbor(nodeIDCounter, *newDst);
       }
       nodeIDCounter++;
     }
   }
-  KATANA_LOG_ASSERT(nodeIDCounter == remapper.size());
+  KATANA_LOG_ASSERT(nodeIDCounter == numRemapped);
 
   katana::gInfo("Finishing up: outputting graph shortly");
 
@@ -22,8 +22,11 @@
 #include <vector>
 
 #include "katana/Galois.h"
+#include "katana/GraphStats.h"
 #include "katana/LCGraph.h"
 #include "katana/OfflineGraph.h"
+#include "katana/PropertyGraph.h"
+#include "katana/SharedMemSys.h"
 #include "llvm/Support/CommandLine.h"
 
 namespace cll = llvm::cl;
@@ -61,6 +64,16 @@ static cll::opt<int> numBins(
     "numBins", cll::desc("Number of bins"), cll::init(-1));
 static cll::opt<int> columns(
     "columns", cll::desc("Columns for sparsity"), cll::init(80));
+static cll::opt<bool> propertyGraph(
+    "propertyGraph",
+    cll::desc("Input is an RDG; print its summary statistics as JSON "
+              "instead of the requested stats (default value false)"),
+    cll::init(false));
+static cll::opt<bool> persistStats(
+    "persistStats",
+    cll::desc("With -propertyGraph, store the statistics with the RDG so "
+              "that later loads reuse them (default value false)"),
+    cll::init(false));
 
 typedef katana::OfflineGraph Graph;
 typedef Graph::GraphNode GNode;
@@ -251,9 +264,39 @@ doDestinationHistogram(Graph& graph) {
   printHistogram("DestinationBin", hist);
 }
 
+int
+doPropertyGraphStats() {
+  katana::SharedMemSys sys;
+  auto pg_result = katana::PropertyGraph::Make(inputfilename);
+  if (!pg_result) {
+    std::cerr << "failed to load " << inputfilename << ": "
+              << pg_result.error() << "\n";
+    return 1;
+  }
+  std::unique_ptr<katana::PropertyGraph> pg = std::move(pg_result.value());
+
+  auto stats_result = katana::GetGraphStats(pg.get());
+  if (!stats_result) {
+    std::cerr << "failed to compute stats: " << stats_result.error() << "\n";
+    return 1;
+  }
+  std::cout << nlohmann::json(stats_result.value()).dump(2) << "\n";
+
+  if (persistStats) {
+    if (auto res = pg->Commit("graph-stats"); !res) {
+      std::cerr << "failed to store stats: " << res.error() << "\n";
+      return 1;
+    }
+  }
+  return 0;
+}
+
 int
 main(int argc, char** argv) {
   llvm::cl::ParseCommandLineOptions(argc, argv);
+  if (propertyGraph) {
+    return doPropertyGraphStats();
+  }
   try {
     Graph graph(inputfilename);
     for (unsigned i = 0; i != statModeList.size(); ++i) {